@@ -66,8 +66,6 @@ static void vTask1( void *pvParameters )
 	}
 }
 
-extern xQueueHandle xRxedChars;
-
 
 /*
  *    This task will send a line directly to uart1 once every 5 seconds.
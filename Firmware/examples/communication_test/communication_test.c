@@ -156,8 +156,6 @@ static void vDataStreamingTask( void *pvParameters )
 	}
 }
 
-extern xQueueHandle xRxedChars;
-
 
 /*
  *    This task will send a line directly to uart1 once every 5 seconds.
@@ -53,8 +53,6 @@ static void vTickTask( void *pvParameters )
 	}
 }
 
-extern xQueueHandle xRxedChars;
-
 
 /*
  *   This task will wake when a character is received on uart1.
@@ -81,7 +79,7 @@ static void vParseTask( void *pvParameters )
 	for( ;; )
 	{
 		/* Wait until it is time for the next cycle. */
-		if( xQueueReceive( xRxedChars, &tmp, portMAX_DELAY  ) )
+		if( uart1_read( (unsigned char*)&tmp, 1, portMAX_DELAY ) )
         {
             // pcRxedMessage now points to the struct AMessage variable posted
             // by vATask.
@@ -44,7 +44,7 @@ T5CONbits.TCS = 0;    \
 #define configUSE_CO_ROUTINES 		1
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
 
-#define configCHECK_FOR_STACK_OVERFLOW 0
+#define configCHECK_FOR_STACK_OVERFLOW 1   /* cheap: only the stack pointer at a task switch */
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
@@ -60,7 +60,7 @@ int bmp085ReadInt(unsigned char address)
 
 	reset_i2c_bus();
   
-  return (int) ((int) msb<<8 | lsb);
+  return (int) (short) ((unsigned int) msb<<8 | lsb);   // 16 bit signed, also where int is wider
 }
 
 // Read 2 bytes from the BMP085
@@ -135,9 +135,9 @@ void bmp085_Calibration(void)
 	ac1 = bmp085ReadInt(0xAA);
 	ac2 = bmp085ReadInt(0xAC);
 	ac3 = bmp085ReadInt(0xAE);
-	ac4 = bmp085ReadInt(0xB0);
-	ac5 = bmp085ReadInt(0xB2);
-	ac6 = bmp085ReadInt(0xB4);
+	ac4 = (unsigned short)bmp085ReadInt(0xB0);
+	ac5 = (unsigned short)bmp085ReadInt(0xB2);
+	ac6 = (unsigned short)bmp085ReadInt(0xB4);
 	b1 = bmp085ReadInt(0xB6);
 	b2 = bmp085ReadInt(0xB8);
 	mb = bmp085ReadInt(0xBA);
@@ -282,3 +282,74 @@ void bmp085_init()
 {
 	bmp085_Calibration();
 }
+
+
+static unsigned char command_byte;
+static unsigned char result_bytes[3];
+static struct I2cTransaction command = { BMP085_ADDRESS, 0xF4, &command_byte, 1, 0, 0, I2C_IDLE };
+static struct I2cTransaction result = { BMP085_ADDRESS, 0xF6, result_bytes, 2, 1, 0, I2C_IDLE };
+
+static void bmp085_queue_read(unsigned char length)
+{
+	result.length = length;
+	i2c_queue(&result);
+}
+
+static void bmp085_queue_command(unsigned char c)
+{
+	command_byte = c;
+	i2c_queue(&command);
+}
+
+/*!
+ *   Non-blocking version of the temperature and pressure cycle, using the
+ *   interrupt driven I2C transactions. Call at 10Hz, the conversions take
+ *   up to 25.5ms. The register reads are queued here and are finished long
+ *   before the next call, where the result is converted and the next
+ *   conversion is started.
+ *   Returns 1 when temperature_10 and pressure have been updated (5Hz).
+ *   Any failed transaction restarts the cycle.
+ */
+int bmp085_update(int *temperature_10, long *pressure)
+{
+	static int state = 0;
+	int updated = 0;
+
+	switch (state)
+	{
+		case 0:
+			bmp085_queue_command(0x2E);              // start the temperature conversion
+			state = 1;
+			break;
+		case 1:
+			bmp085_queue_read(2);                    // temperature
+			bmp085_queue_command(0x34 + (OSS<<6));   // start the pressure conversion
+			state = 2;
+			break;
+		case 2:
+			if (result.status != I2C_DONE || command.status != I2C_DONE)
+			{
+				state = 0;
+				break;
+			}
+			bmp085_convert_temp((long)result_bytes[0] << 8 | (long)result_bytes[1], temperature_10);
+			bmp085_queue_read(3);                    // pressure
+			bmp085_queue_command(0x2E);
+			state = 3;
+			break;
+		case 3:
+			if (result.status != I2C_DONE || command.status != I2C_DONE)
+			{
+				state = 0;
+				break;
+			}
+			bmp085_convert_pressure(((long)result_bytes[0] << 16 | (long)result_bytes[1] << 8 | (long)result_bytes[2]) >> (8-OSS),
+			                        pressure);
+			updated = 1;
+			bmp085_queue_read(2);
+			bmp085_queue_command(0x34 + (OSS<<6));
+			state = 2;
+			break;
+	}
+	return updated;
+}
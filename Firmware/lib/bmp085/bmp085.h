@@ -13,3 +13,5 @@ void bmp085_convert_pressure(long up, long* pressure);
 void bmp085_start_convert_pressure();
 
 void bmp085_start_convert_temp();
+
+int bmp085_update(int *temperature_10, long *pressure);
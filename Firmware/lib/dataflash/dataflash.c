@@ -38,6 +38,9 @@ int gp1_dataflash_read_Mbit();
 void gp1_dataflash_write(int page, int size, unsigned char *buffer);
 void gp1_dataflash_open();
 void gp1_dataflash_read(int page, int size, unsigned char *buffer);
+int gp1_dataflash_status();
+void gp1_dataflash_write_buffer(int size, unsigned char *buffer);
+void gp1_dataflash_page_operation(unsigned char opcode, int page);
  
 #define v1o_CS   PORTFbits.RF0 //CSB
 
@@ -64,6 +67,9 @@ int gp2_dataflash_read_Mbit();
 void gp2_dataflash_write(int page, int size, unsigned char *buffer);
 void gp2_dataflash_open();
 void gp2_dataflash_read(int page, int size, unsigned char *buffer);
+int gp2_dataflash_status();
+void gp2_dataflash_write_buffer(int size, unsigned char *buffer);
+void gp2_dataflash_page_operation(unsigned char opcode, int page);
 
 #define v1o_CS   PORTFbits.RF0 //CSB
 
@@ -80,8 +86,6 @@ int	LOG_INDEX_PAGE = 4;
 int	CONFIGURATION_PAGE = 0;
 int	NAVIGATION_PAGE = 2;
 
-#define STATUS_RDY 0b10000000
-
 
 /**
  *   Initializes the SPI hardware
@@ -94,6 +98,9 @@ void dataflash_open()
         dataflash.write = gp1_dataflash_write;
         dataflash.open = gp1_dataflash_open;
         dataflash.read = gp1_dataflash_read;
+        dataflash.status = gp1_dataflash_status;
+        dataflash.write_buffer = gp1_dataflash_write_buffer;
+        dataflash.page_operation = gp1_dataflash_page_operation;
         gp1_dataflash_open();
     }
     else if (HARDWARE_VERSION == V01Q)
@@ -102,8 +109,15 @@ void dataflash_open()
         dataflash.write = gp2_dataflash_write;
         dataflash.open = gp2_dataflash_open;
         dataflash.read = gp2_dataflash_read;
+        dataflash.status = gp2_dataflash_status;
+        dataflash.write_buffer = gp2_dataflash_write_buffer;
+        dataflash.page_operation = gp2_dataflash_page_operation;
         gp2_dataflash_open();
     }
+
+    // reserve the end of the flash for the flightplan, the log stops before it
+    NAVIGATION_PAGE = MAX_PAGE + 1 - NAVIGATION_PAGES;
+    MAX_PAGE = NAVIGATION_PAGE - 1;
 }
 
 /************************************ OLD GP1 *******************************/
@@ -303,11 +317,20 @@ void gp1_dataflash_write(int page, int size, unsigned char *buffer)
 	
 void gp1_dataflash_write_raw(int page, int size, unsigned char *buffer)
 {
-	int add1, add2;
+	gp1_dataflash_write_buffer(size, buffer);
+	gp1_dataflash_page_operation(0x83, page);  // write buffer 1 to memory
+
+	// Now he's probably busy writing
+}
+
+
+/*!
+ *   Loads buffer 1 of the chip (command 0x84).
+ */
+void gp1_dataflash_write_buffer(int size, unsigned char *buffer)
+{
 	int i;
-	add1 = 0;
-	add2 = 0;
-	
+
 	gp1_dataflash_disable_spi();
 	
 	microcontroller_delay_us(1);
@@ -324,7 +347,17 @@ void gp1_dataflash_write_raw(int page, int size, unsigned char *buffer)
 		gp1_spi_comm(buffer[i]);
 
 	gp1_dataflash_disable_spi();
-	
+}
+
+
+/*!
+ *   Sends a command with a page address: buffer to page, compare, auto page
+ *   rewrite... The chip is busy afterwards, see gp1_dataflash_status().
+ */
+void gp1_dataflash_page_operation(unsigned char opcode, int page)
+{
+	int add1 = 0, add2 = 0;
+
 	if (PAGE_SIZE == 528)
 	{
 		// For a page size of 528 bytes (16Mbit)
@@ -355,14 +388,24 @@ void gp1_dataflash_write_raw(int page, int size, unsigned char *buffer)
 	microcontroller_delay_us(1);
 	gp1_dataflash_enable_spi();
 
-	gp1_spi_comm(0x83); // select buffer1
+	gp1_spi_comm(opcode);
 	gp1_spi_comm(add1 & 0xFF); // select buffer1
 	gp1_spi_comm(add2 & 0xFF); // select buffer1
 	gp1_spi_comm(0x00); // select buffer1
 	
 	gp1_dataflash_disable_spi();
+}
 
-	// Now he's probably busy writing
+
+/*!
+ *   Reads the status register and releases the chip.
+ */
+int gp1_dataflash_status()
+{
+	int status = gp1_dataflash_read_status();
+
+	gp1_dataflash_disable_spi();
+	return status;
 }	
 
 
@@ -650,17 +693,26 @@ void gp2_dataflash_write(int page, int size, unsigned char *buffer)
 
 void gp2_dataflash_write_raw(int page, int size, unsigned char *buffer)
 {
-	int add1, add2;
+	gp2_dataflash_write_buffer(size, buffer);
+	gp2_dataflash_page_operation(0x83, page);  // write buffer 1 to memory
+
+	// Now he's probably busy writing
+}
+
+
+/*!
+ *   Loads buffer 1 of the chip (command 0x84).
+ */
+void gp2_dataflash_write_buffer(int size, unsigned char *buffer)
+{
 	int i;
-	add1 = 0;
-	add2 = 0;
 
 	gp2_dataflash_disable_spi();
-
+	
 	microcontroller_delay_us(1);
-
+	
 	gp2_dataflash_enable_spi();
-
+	
 	// Write to buffer 1
 	gp2_spi_comm(0x84);
 	gp2_spi_comm(0x00);   // select buffer1
@@ -671,6 +723,16 @@ void gp2_dataflash_write_raw(int page, int size, unsigned char *buffer)
 		gp2_spi_comm(buffer[i]);
 
 	gp2_dataflash_disable_spi();
+}
+
+
+/*!
+ *   Sends a command with a page address: buffer to page, compare, auto page
+ *   rewrite... The chip is busy afterwards, see gp2_dataflash_status().
+ */
+void gp2_dataflash_page_operation(unsigned char opcode, int page)
+{
+	int add1 = 0, add2 = 0;
 
 	if (PAGE_SIZE == 528)
 	{
@@ -702,14 +764,24 @@ void gp2_dataflash_write_raw(int page, int size, unsigned char *buffer)
 	microcontroller_delay_us(1);
 	gp2_dataflash_enable_spi();
 
-	gp2_spi_comm(0x83); // select buffer1
+	gp2_spi_comm(opcode);
 	gp2_spi_comm(add1 & 0xFF); // select buffer1
 	gp2_spi_comm(add2 & 0xFF); // select buffer1
 	gp2_spi_comm(0x00); // select buffer1
 
 	gp2_dataflash_disable_spi();
+}
 
-	// Now he's probably busy writing
+
+/*!
+ *   Reads the status register and releases the chip.
+ */
+int gp2_dataflash_status()
+{
+	int status = gp2_dataflash_read_status();
+
+	gp2_dataflash_disable_spi();
+	return status;
 }
 
 
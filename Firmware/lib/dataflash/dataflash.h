@@ -5,6 +5,9 @@
  *    @date    23-nov-2008
  */
 
+#ifndef DATAFLASH_H
+#define DATAFLASH_H
+
 //#define MAX_PAGE 4095 
 extern int MAX_PAGE;
 extern int PAGE_SIZE;
@@ -14,12 +17,23 @@ extern int LOG_INDEX_PAGE;
 extern int CONFIGURATION_PAGE;
 extern int NAVIGATION_PAGE;
 
+//! The flightplan is stored in the last pages of the flash, behind the log.
+#define NAVIGATION_PAGES 64
+
+
+#define STATUS_RDY 0b10000000
+#define STATUS_COMP 0b01000000   //!< set when the last compare found a difference
+
 
 struct Dataflash {
         void (*open) ();
         void (*read) (int page, int size, unsigned char *buffer);
         void (*write) (int page, int size, unsigned char *buffer);
         int (*read_Mbit) ();
+        // raw chip operations, used by dataflash_ftl.c
+        int (*status) ();
+        void (*write_buffer) (int size, unsigned char *buffer);    // into buffer 1
+        void (*page_operation) (unsigned char opcode, int page);   // AT45DB161D_* opcode on a page
 } ;
 
 extern struct Dataflash dataflash;
@@ -29,3 +43,5 @@ extern struct Dataflash dataflash;
  */
 void dataflash_open();
 
+#endif // DATAFLASH_H
+
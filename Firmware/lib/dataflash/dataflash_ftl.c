@@ -0,0 +1,400 @@
+/*!
+ *    @title  Flash translation layer for the AT45DB dataflash
+ *    @description
+ *            Sits behind dataflash.read and dataflash.write, their users
+ *            don't change:
+ *             - The pages in front of the log (configuration, stack report,
+ *               log index) are never rewritten in place. Every write goes to
+ *               the next free page of a pool and the table is written after
+ *               it: a power loss leaves the previous copy valid, and the
+ *               wear is spread over the pool.
+ *             - The table itself rotates over FTL_TABLE_SLOTS pages, with a
+ *               sequence number and a checksum.
+ *             - Every program is verified with a compare of the page with
+ *               buffer 1. For the log and the flightplan the compare is done
+ *               at the start of the next access, which waited for the chip
+ *               anyway: buffer 1 still holds the data then.
+ *             - A page that doesn't verify is programmed again in a page of
+ *               the pool, from buffer 1, and remapped.
+ *             - The AT45DB wants every page of a sector rewritten within
+ *               10000 programs in that sector. The programs per sector are
+ *               counted; a sector over FTL_REFRESH_AFTER is refreshed with
+ *               one auto page rewrite (through buffer 2) per write.
+ *            The FTL_PAGES of the FTL are taken from the end of the log.
+ *            A flash written without the FTL is taken over as it is.
+ *            Callers hold xSpiSemaphore, like for the raw functions.
+ *    @date   17-oct-2026
+ */
+
+#include "dataflash/dataflash.h"
+#include "dataflash/dataflash_ftl.h"
+#include "dataflash/AT45DB161D_COMMANDS.H"
+
+
+struct FtlStatus dataflash_ftl;
+
+static struct FtlTable table;
+static void (*raw_read) (int page, int size, unsigned char *buffer);
+static int first_page;            // first table slot, the pool follows
+static int table_slot = FTL_TABLE_SLOTS - 1;
+static int pending_logical = -1;  // last page programmed, not verified yet
+static int pending_physical;
+static unsigned int programs_since_commit = 0;
+
+static void dataflash_ftl_read(int page, int size, unsigned char *buffer);
+static void dataflash_ftl_write(int page, int size, unsigned char *buffer);
+static void ftl_verify_pending();
+static void ftl_commit();
+
+
+static int ftl_wait()
+{
+	int status;
+
+	while (((status = dataflash.status()) & STATUS_RDY) == 0)
+		;
+	return status;
+}
+
+
+static unsigned int ftl_checksum(struct FtlTable *t)
+{
+	unsigned int *w = (unsigned int*)t;
+	unsigned int sum = 0x5AA5;
+	unsigned int i;
+
+	for (i = 1; i < sizeof(struct FtlTable) / sizeof(unsigned int); i++)   // skips the checksum
+		sum += w[i] ^ i;
+	return sum;
+}
+
+
+void dataflash_ftl_open()
+{
+	struct FtlTable t;
+	int i, found = 0;
+
+	if (PAGE_SIZE == 0)   // unknown chip
+		return;
+
+	first_page = NAVIGATION_PAGE - FTL_PAGES;
+	MAX_PAGE = first_page - 1;
+	raw_read = dataflash.read;
+
+	ftl_wait();
+	for (i = 0; i < FTL_TABLE_SLOTS; i++)
+	{
+		raw_read(first_page + i, sizeof(t), (unsigned char*)&t);
+		if (t.magic == FTL_MAGIC && t.checksum == ftl_checksum(&t) && (! found || t.sequence > table.sequence))
+		{
+			table = t;
+			table_slot = i;
+			found = 1;
+		}
+	}
+
+	if (! found)
+	{
+		// the pages in front of the log are still where they were written
+		table.magic = FTL_MAGIC;
+		table.sequence = 0;
+		for (i = 0; i < FTL_FIXED_PAGES; i++)
+			table.fixed[i] = i;
+		table.remaps = 0;
+		for (i = 0; i < FTL_SECTORS; i++)
+			table.sector_programs[i] = 0;
+		table.refresh_sector = -1;
+		table.refresh_page = 0;
+		table.pool_next = 0;
+	}
+
+	dataflash.read = dataflash_ftl_read;
+	dataflash.write = dataflash_ftl_write;
+}
+
+
+/*!
+ *    Pages remapped or retired because they didn't verify.
+ */
+int dataflash_ftl_remapped_pages()
+{
+	return table.remaps;
+}
+
+
+static int ftl_physical(int logical)
+{
+	int i;
+
+	if (logical < START_LOG_PAGE)
+		return table.fixed[logical];
+	for (i = 0; i < table.remaps; i++)
+		if (table.remap[i].logical == logical)
+			return table.remap[i].physical;
+	return logical;
+}
+
+
+/*!
+ *    Points a logical page to a physical page.
+ *    @return 0 when the remap list is full
+ */
+static int ftl_set(int logical, int physical)
+{
+	int i;
+
+	if (logical >= 0 && logical < START_LOG_PAGE)
+	{
+		table.fixed[logical] = physical;
+		return 1;
+	}
+	for (i = 0; logical != FTL_RETIRED && i < table.remaps; i++)
+	{
+		if (table.remap[i].logical == logical)
+		{
+			table.remap[i].physical = physical;
+			return 1;
+		}
+	}
+	if (table.remaps >= FTL_MAX_REMAPS)
+		return 0;
+	table.remap[table.remaps].logical = logical;
+	table.remap[table.remaps].physical = physical;
+	table.remaps++;
+	return 1;
+}
+
+
+static int ftl_in_use(int physical)
+{
+	int i;
+
+	for (i = 0; i < FTL_FIXED_PAGES; i++)
+		if (table.fixed[i] == physical)
+			return 1;
+	for (i = 0; i < table.remaps; i++)
+		if (table.remap[i].physical == physical)
+			return 1;
+	return 0;
+}
+
+
+/*!
+ *    @return the next free page of the pool, -1 when there is none
+ */
+static int ftl_allocate()
+{
+	int i, page;
+
+	for (i = 0; i < FTL_POOL_PAGES; i++)
+	{
+		page = first_page + FTL_TABLE_SLOTS + table.pool_next;
+		table.pool_next = (table.pool_next + 1) % FTL_POOL_PAGES;
+		if (! ftl_in_use(page))
+			return page;
+	}
+	return -1;
+}
+
+
+/*!
+ *    Loads buffer 1, after the previous program was verified.
+ */
+static void ftl_load(int size, unsigned char *buffer)
+{
+	ftl_verify_pending();
+	dataflash.write_buffer(size, buffer);
+}
+
+
+/*!
+ *    Programs buffer 1 into a page and counts it for the refresh of its sector.
+ */
+static void ftl_program(int physical)
+{
+	int sector = physical / FTL_SECTOR_PAGES;
+
+	ftl_wait();
+	dataflash.page_operation(AT45DB161D_BUFFER_1_TO_PAGE_WITH_ERASE, physical);
+
+	table.sector_programs[sector]++;
+	if (table.refresh_sector < 0 && table.sector_programs[sector] >= FTL_REFRESH_AFTER)
+	{
+		table.refresh_sector = sector;
+		table.refresh_page = 0;
+		table.sector_programs[sector] = 0;
+	}
+	programs_since_commit++;
+}
+
+
+/*!
+ *    @return 1 when the page equals buffer 1
+ */
+static int ftl_compare(int physical)
+{
+	ftl_wait();
+	dataflash.page_operation(AT45DB161D_COMPARE_PAGE_TO_BUFFER_1, physical);
+	return (ftl_wait() & STATUS_COMP) == 0;
+}
+
+
+/*!
+ *    The program of a logical page into "failed" didn't verify: buffer 1
+ *    still holds the data, it goes to a page of the pool.
+ *    @return 0 when the data is lost
+ */
+static int ftl_remap(int logical, int failed)
+{
+	int page;
+
+	dataflash_ftl.verify_failures++;
+	for (;;)
+	{
+		if (failed >= first_page + FTL_TABLE_SLOTS && failed < NAVIGATION_PAGE && ! ftl_set(FTL_RETIRED, failed))
+			break;
+		page = ftl_allocate();
+		if (page < 0)
+			break;
+		ftl_program(page);
+		if (ftl_compare(page))
+		{
+			if (ftl_set(logical, page))
+				return 1;
+			break;
+		}
+		dataflash_ftl.verify_failures++;
+		failed = page;
+	}
+	dataflash_ftl.lost_writes++;
+	return 0;
+}
+
+
+/*!
+ *    Verifies the last program of a log or flightplan page.
+ */
+static void ftl_verify_pending()
+{
+	int logical = pending_logical;
+
+	ftl_wait();
+	if (logical < 0)
+		return;
+	pending_logical = -1;
+	if (! ftl_compare(pending_physical) && ftl_remap(logical, pending_physical))
+		ftl_commit();
+}
+
+
+/*!
+ *    Writes the table in the next slot.
+ */
+static void ftl_commit()
+{
+	int i;
+
+	ftl_verify_pending();   // may change the table
+	for (i = 0; i < FTL_TABLE_SLOTS; i++)
+	{
+		table_slot = (table_slot + 1) % FTL_TABLE_SLOTS;
+		table.sequence++;
+		table.checksum = ftl_checksum(&table);
+		ftl_load(sizeof(table), (unsigned char*)&table);
+		ftl_program(first_page + table_slot);
+		if (ftl_compare(first_page + table_slot))
+		{
+			programs_since_commit = 0;
+			return;
+		}
+		dataflash_ftl.verify_failures++;
+	}
+}
+
+
+/*!
+ *    Rewrites the next page of the sector being refreshed. Through buffer
+ *    2, so buffer 1 is left alone.
+ */
+static void ftl_refresh_step()
+{
+	int sector = table.refresh_sector;
+
+	if (sector < 0)
+		return;
+	ftl_wait();
+	dataflash.page_operation(AT45DB161D_AUTO_PAGE_REWRITE_THROUGH_BUFFER_2, sector * FTL_SECTOR_PAGES + table.refresh_page);
+	dataflash_ftl.refreshed_pages++;
+
+	if (++table.refresh_page >= FTL_SECTOR_PAGES)
+	{
+		table.refresh_sector = -1;
+		for (sector = 0; sector < FTL_SECTORS; sector++)
+		{
+			if (table.sector_programs[sector] >= FTL_REFRESH_AFTER)
+			{
+				table.refresh_sector = sector;
+				table.refresh_page = 0;
+				table.sector_programs[sector] = 0;
+				break;
+			}
+		}
+	}
+}
+
+
+static void dataflash_ftl_read(int page, int size, unsigned char *buffer)
+{
+	int n;
+
+	ftl_verify_pending();   // also waits for the chip
+	while (size > 0)
+	{
+		n = size > PAGE_SIZE ? PAGE_SIZE : size;
+		raw_read(ftl_physical(page), n, buffer);
+		size -= n;
+		buffer += n;
+		page++;
+	}
+}
+
+
+static void dataflash_ftl_write(int page, int size, unsigned char *buffer)
+{
+	int n, physical, moved = 0;
+
+	ftl_verify_pending();
+	ftl_refresh_step();
+
+	while (size > 0)
+	{
+		n = size > PAGE_SIZE ? PAGE_SIZE : size;
+		ftl_load(n, buffer);
+		if (page < START_LOG_PAGE)
+		{
+			// never in place: the old copy stays valid until the table is written
+			physical = ftl_allocate();
+			if (physical < 0)
+				physical = table.fixed[page];
+			ftl_program(physical);
+			if (ftl_compare(physical))
+				table.fixed[page] = physical;
+			else
+				ftl_remap(page, physical);
+			moved = 1;
+		}
+		else
+		{
+			physical = ftl_physical(page);
+			ftl_program(physical);
+			pending_logical = page;
+			pending_physical = physical;
+		}
+		size -= n;
+		buffer += n;
+		page++;
+	}
+
+	if (moved || programs_since_commit >= FTL_COMMIT_EVERY)
+		ftl_commit();
+}
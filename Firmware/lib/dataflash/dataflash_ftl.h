@@ -0,0 +1,63 @@
+/*!
+ *    @title  Flash translation layer for the AT45DB dataflash
+ *    @date   17-oct-2026
+ */
+
+#ifndef DATAFLASH_FTL_H
+#define DATAFLASH_FTL_H
+
+#define FTL_PAGES 64                //!< reserved between the log and the flightplan
+#define FTL_TABLE_SLOTS 8           //!< rotating copies of the table, the rest of FTL_PAGES is the pool
+#define FTL_POOL_PAGES (FTL_PAGES - FTL_TABLE_SLOTS)
+#define FTL_FIXED_PAGES 9           //!< pages in front of the log: START_LOG_PAGE is 5 or 9
+#define FTL_MAX_REMAPS 24
+#define FTL_SECTOR_PAGES 256
+#define FTL_SECTORS 16
+#define FTL_REFRESH_AFTER 8000      //!< programs in a sector, the AT45DB allows 10000 before every page needs a rewrite
+#define FTL_COMMIT_EVERY 64         //!< programs before the counters are saved
+#define FTL_MAGIC 0x4654
+#define FTL_RETIRED -1              //!< logical page of a bad page of the pool
+
+
+struct FtlRemap
+{
+	int logical;
+	int physical;
+};
+
+/*!
+ *   Written in one of the table slots. The valid copy with the highest
+ *   sequence number is the current one.
+ */
+struct FtlTable
+{
+	unsigned int checksum;
+	unsigned int magic;
+	unsigned long sequence;
+	int fixed[FTL_FIXED_PAGES];     //!< physical page of the pages in front of the log
+	int remaps;
+	struct FtlRemap remap[FTL_MAX_REMAPS];   //!< bad log and flightplan pages, retired pages of the pool
+	unsigned int sector_programs[FTL_SECTORS];
+	int refresh_sector;             //!< -1 when no sector needs a refresh
+	int refresh_page;
+	int pool_next;
+};
+
+struct FtlStatus
+{
+	unsigned int verify_failures;
+	unsigned int lost_writes;       //!< failed pages that couldn't be moved: no spare left
+	unsigned long refreshed_pages;
+};
+
+extern struct FtlStatus dataflash_ftl;
+
+/*!
+ *    Loads the table and puts the translation layer behind dataflash.read
+ *    and dataflash.write. Call it after dataflash_open().
+ */
+void dataflash_ftl_open();
+
+int dataflash_ftl_remapped_pages();
+
+#endif // DATAFLASH_FTL_H
@@ -0,0 +1,344 @@
+/*!
+ *  Table based trigonometry.
+ *
+ *  The libm functions take several thousands of cycles on the dsPIC. Here
+ *  sin/cos use a quarter wave table and atan2 an atan table on [0, 1], both with
+ *  linear interpolation. The tables are const, so they are stored in program
+ *  memory and cost no RAM. The Q15 variants use integers only; their square
+ *  roots are computed bit by bit. Accuracy is documented in fastmath.h.
+ *
+ *  @file     fastmath.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#include "fastmath.h"
+
+#define FASTMATH_PI 3.14159265f
+
+//! sin(i * PI/128), i = 0..64
+static const float sin_table[65] = {
+0.00000000f, 0.02454123f, 0.04906767f, 0.07356456f, 0.09801714f, 0.12241068f,
+	0.14673047f, 0.17096189f, 0.19509032f, 0.21910124f, 0.24298018f, 0.26671276f,
+	0.29028468f, 0.31368174f, 0.33688985f, 0.35989504f, 0.38268343f, 0.40524131f,
+	0.42755509f, 0.44961133f, 0.47139674f, 0.49289819f, 0.51410274f, 0.53499762f,
+	0.55557023f, 0.57580819f, 0.59569930f, 0.61523159f, 0.63439328f, 0.65317284f,
+	0.67155895f, 0.68954054f, 0.70710678f, 0.72424708f, 0.74095113f, 0.75720885f,
+	0.77301045f, 0.78834643f, 0.80320753f, 0.81758481f, 0.83146961f, 0.84485357f,
+	0.85772861f, 0.87008699f, 0.88192126f, 0.89322430f, 0.90398929f, 0.91420976f,
+	0.92387953f, 0.93299280f, 0.94154407f, 0.94952818f, 0.95694034f, 0.96377607f,
+	0.97003125f, 0.97570213f, 0.98078528f, 0.98527764f, 0.98917651f, 0.99247953f,
+	0.99518473f, 0.99729046f, 0.99879546f, 0.99969882f, 1.00000000f
+};
+
+//! atan(i / 64), i = 0..64
+static const float atan_table[65] = {
+	0.00000000f, 0.01562373f, 0.03123983f, 0.04684071f, 0.06241881f, 0.07796663f,
+	0.09347678f, 0.10894196f, 0.12435499f, 0.13970887f, 0.15499674f, 0.17021193f,
+	0.18534795f, 0.20039855f, 0.21535770f, 0.23021959f, 0.24497866f, 0.25962963f,
+	0.27416745f, 0.28858736f, 0.30288487f, 0.31705575f, 0.33109608f, 0.34500218f,
+	0.35877067f, 0.37239845f, 0.38588267f, 0.39922077f, 0.41241044f, 0.42544964f,
+	0.43833656f, 0.45106966f, 0.46364761f, 0.47606933f, 0.48833395f, 0.50044081f,
+	0.51238946f, 0.52417963f, 0.53581124f, 0.54728438f, 0.55859932f, 0.56975645f,
+	0.58075635f, 0.59159971f, 0.60228735f, 0.61282020f, 0.62319933f, 0.63342588f,
+	0.64350111f, 0.65342634f, 0.66320299f, 0.67283255f, 0.68231655f, 0.69165662f,
+	0.70085441f, 0.70991162f, 0.71883000f, 0.72761133f, 0.73625743f, 0.74477013f,
+	0.75315128f, 0.76140277f, 0.76952648f, 0.77752431f, 0.78539816f
+};
+
+//! 32767 * sin(i * PI/128), i = 0..64
+static const int sin_q15_table[65] = {
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179,
+	7962, 8739, 9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732,
+	15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403,
+	22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+	27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571,
+	30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+	32609, 32678, 32728, 32757, 32767
+};
+
+//! atan(i / 64) in binary angle units, i = 0..64
+static const int atan_brad_table[65] = {
+	0, 163, 326, 489, 651, 813, 975, 1136, 1297, 1457,
+	1617, 1775, 1933, 2090, 2246, 2401, 2555, 2708, 2860, 3010,
+	3159, 3307, 3453, 3599, 3742, 3884, 4025, 4164, 4302, 4438,
+	4572, 4705, 4836, 4966, 5094, 5220, 5344, 5467, 5589, 5708,
+	5826, 5943, 6058, 6171, 6282, 6392, 6500, 6607, 6712, 6815,
+	6917, 7018, 7117, 7214, 7310, 7405, 7498, 7589, 7679, 7768,
+	7856, 7942, 8026, 8110, 8192
+};
+
+
+/*!
+ *   sin(x) for any x. The angle is split in 256 steps per turn, of which
+ *   the quadrant and the position in the quarter wave table are derived.
+ */
+float fast_sin(float x)
+{
+	float index = x * (128.0f / FASTMATH_PI);
+	long n = (long)index;
+	float frac, s;
+	int i;
+
+	if (index < (float)n)   // round towards minus infinity
+		n--;
+	frac = index - (float)n;
+	i = (int)(n & 63);
+
+	switch ((int)((n >> 6) & 3))
+	{
+		case 0:
+			return sin_table[i] + frac * (sin_table[i+1] - sin_table[i]);
+		case 1:
+			return sin_table[64-i] + frac * (sin_table[63-i] - sin_table[64-i]);
+		case 2:
+			s = sin_table[i] + frac * (sin_table[i+1] - sin_table[i]);
+			return -s;
+		default:
+			s = sin_table[64-i] + frac * (sin_table[63-i] - sin_table[64-i]);
+			return -s;
+	}
+}
+
+
+float fast_cos(float x)
+{
+	return fast_sin(x + FASTMATH_PI/2.0f);
+}
+
+
+/*!
+ *   atan(z) for z in [0, 1].
+ */
+static float atan_01(float z)
+{
+	float index = z * 64.0f;
+	int i = (int)index;
+
+	if (i >= 64)
+		return atan_table[64];
+	return atan_table[i] + (index - (float)i) * (atan_table[i+1] - atan_table[i]);
+}
+
+
+/*!
+ *   atan2(y, x) in [-PI, PI]. The octant is handled by symmetry, so only
+ *   one division is needed.
+ */
+float fast_atan2(float y, float x)
+{
+	float abs_x = fabs(x), abs_y = fabs(y);
+	float a;
+
+	if (abs_x == 0.0f && abs_y == 0.0f)
+		return 0.0f;
+
+	if (abs_y <= abs_x)
+		a = atan_01(abs_y / abs_x);
+	else
+		a = FASTMATH_PI/2.0f - atan_01(abs_x / abs_y);
+
+	if (x < 0.0f)
+		a = FASTMATH_PI - a;
+	if (y < 0.0f)
+		a = -a;
+	return a;
+}
+
+
+/*!
+ *   asin(x), x is clamped to [-1, 1].
+ */
+float fast_asin(float x)
+{
+	if (x >= 1.0f)
+		return FASTMATH_PI/2.0f;
+	else if (x <= -1.0f)
+		return -FASTMATH_PI/2.0f;
+	return fast_atan2(x, fast_sqrt(1.0f - x*x));
+}
+
+
+/*!
+ *   Approximates 1/sqrt(x) using the well known bit-level initial guess and
+ *   2 Newton-Raphson iterations (relative error < 0.001%).
+ *   This avoids the sqrt and the divisions, which are slow on the dsPIC.
+ */
+float fast_inv_sqrt(float x)
+{
+	union { float f; uint32_t i; } u;   // not long: it has 64 bits on most hosts
+	float half_x = 0.5f * x;
+
+	u.f = x;
+	u.i = 0x5f3759dfUL - (u.i >> 1);
+	u.f = u.f * (1.5f - half_x * u.f * u.f);
+	u.f = u.f * (1.5f - half_x * u.f * u.f);
+	return u.f;
+}
+
+
+float fast_sqrt(float x)
+{
+	if (x <= 0.0f)
+		return 0.0f;
+	return x * fast_inv_sqrt(x);
+}
+
+
+/*!
+ *   sin of angle in [0, PI/2] (0..16384), Q15.
+ */
+static int sin_q15_quadrant(unsigned int angle)
+{
+	unsigned int i = angle >> 8;
+	int frac = (int)(angle & 0xFF);
+
+	if (i >= 64)
+		return sin_q15_table[64];
+	return sin_q15_table[i] + (int)(((long)(sin_q15_table[i+1] - sin_q15_table[i]) * frac) >> 8);
+}
+
+
+/*!
+ *   sin of a binary angle (65536 = 2*PI), Q15 (32767 = 1.0).
+ */
+int fast_sin_q15(unsigned int angle)
+{
+	angle &= 0xFFFF;
+	if (angle < 0x4000)
+		return sin_q15_quadrant(angle);
+	else if (angle < 0x8000)
+		return sin_q15_quadrant(0x8000 - angle);
+	else if (angle < 0xC000)
+		return -sin_q15_quadrant(angle - 0x8000);
+	else
+		return -sin_q15_quadrant(0x10000L - angle);
+}
+
+
+int fast_cos_q15(unsigned int angle)
+{
+	return fast_sin_q15(angle + 0x4000);
+}
+
+
+/*!
+ *   atan of a ratio in [0, 1] (0..16384), binary angle.
+ */
+static int atan_q15_01(unsigned int ratio)
+{
+	unsigned int i = ratio >> 8;
+	int frac = (int)(ratio & 0xFF);
+
+	if (i >= 64)
+		return atan_brad_table[64];
+	return atan_brad_table[i] + (int)(((long)(atan_brad_table[i+1] - atan_brad_table[i]) * frac + 128) >> 8);
+}
+
+
+/*!
+ *   atan2(y, x) as a binary angle, -32768..32767 (PI is returned as -32768).
+ *   The scale of x and y does not matter.
+ */
+int fast_atan2_q15(int y, int x)
+{
+	long abs_x = x < 0 ? -(long)x : x;
+	long abs_y = y < 0 ? -(long)y : y;
+	long a;
+
+	if (abs_x == 0 && abs_y == 0)
+		return 0;
+
+	if (abs_y <= abs_x)
+		a = atan_q15_01((unsigned int)(((abs_y << 14) + abs_x/2) / abs_x));
+	else
+		a = 0x4000 - atan_q15_01((unsigned int)(((abs_x << 14) + abs_y/2) / abs_y));
+
+	if (x < 0)
+		a = 0x8000L - a;
+	if (y < 0)
+		a = -a;
+	if (a >= 0x8000L)
+		a -= 0x10000L;
+	return (int)a;
+}
+
+
+/*!
+ *   Integer square root of x, rounded to the nearest integer. One bit of the
+ *   root per iteration, without multiplications.
+ */
+static unsigned int isqrt(unsigned long x)
+{
+	unsigned long root = 0, bit = 1UL << 30;
+
+	while (bit > x)
+		bit >>= 2;
+	while (bit != 0)
+	{
+		if (x >= root + bit)
+		{
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+	if (x > root)   // x - root^2 > root: closer to root + 1
+		root++;
+	return (unsigned int)root;
+}
+
+
+/*!
+ *   asin(x) of x in Q15, as a binary angle (-16384..16384). x is clamped to
+ *   [-1, 1].
+ */
+int fast_asin_q15(int x)
+{
+	if (x > 32767)
+		x = 32767;
+	else if (x < -32767)
+		x = -32767;
+	return fast_atan2_q15(x, (int)isqrt(32767UL * 32767UL - (unsigned long)((long)x * x)));
+}
+
+
+/*!
+ *   sqrt(x) of x in Q15 (0..32767), Q15. Negative x gives 0.
+ */
+int fast_sqrt_q15(int x)
+{
+	if (x <= 0)
+		return 0;
+	return (int)isqrt((unsigned long)x * 32767UL);
+}
+
+
+/*!
+ *   1/sqrt(x) of x in Q15 (1..32767), Q15 in a long: up to 181 * 32767.
+ *   x is shifted up by an even number of bits first, which keeps the root
+ *   above 16383 and so its rounding error small. Zero or negative x gives
+ *   the largest result.
+ */
+long fast_inv_sqrt_q15(int x)
+{
+	unsigned long shifted;
+	unsigned int root;
+	int half_shift = 0;
+
+	if (x <= 0)
+		x = 1;
+	shifted = (unsigned long)x;
+	while (shifted < 8192)
+	{
+		shifted <<= 2;
+		half_shift++;
+	}
+	root = isqrt(shifted * 32767UL);
+	return (long)((32767UL * 32767UL + root/2) / root) << half_shift;
+}
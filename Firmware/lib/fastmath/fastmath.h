@@ -0,0 +1,38 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+/*!
+ *   Table based trigonometry, shared by the AHRS, navigation and OSD code.
+ *   Maximum absolute errors against libm (double precision):
+ *
+ *   fast_sin, fast_cos           7.6e-5 for |x| < 100 rad, float resolution limits larger angles
+ *   fast_atan2                   2.1e-5 rad (0.0012 deg)
+ *   fast_asin                    2.2e-5 rad
+ *   fast_inv_sqrt, fast_sqrt     4.8e-6 relative
+ *   fast_sin_q15, fast_cos_q15   4 LSB (1.2e-4)
+ *   fast_atan2_q15               1.3e-4 rad (1.4 LSB)
+ *   fast_asin_q15                1.4e-4 rad (1.5 LSB)
+ *   fast_sqrt_q15                0.5 LSB (1.6e-5)
+ *   fast_inv_sqrt_q15            4.0e-5 relative
+ *
+ *   The fixed point functions use Q15 (32767 = 1.0) and a binary angle:
+ *   65536 = 2*PI. They need no float support at all.
+ */
+
+#define FASTMATH_BRAD_PER_RAD (32768.0f / 3.14159265f)   //!< binary angle units per radian
+
+float fast_sin(float x);
+float fast_cos(float x);
+float fast_atan2(float y, float x);
+float fast_asin(float x);
+float fast_sqrt(float x);
+float fast_inv_sqrt(float x);
+
+int fast_sin_q15(unsigned int angle);
+int fast_cos_q15(unsigned int angle);
+int fast_atan2_q15(int y, int x);
+int fast_asin_q15(int x);
+int fast_sqrt_q15(int x);
+long fast_inv_sqrt_q15(int x);
+
+#endif // FASTMATH_H
@@ -413,17 +413,17 @@ char gps_update_info(struct gps_info *gpsinfo)
 
 
 /*!
- *  Interrupt routine notifying us a new character is available from the
- *  GPS's uart module.
- *  This function buffers a valid (structure and checksum) RMC sentence. The
- *  used buffer is nmea_buffer_RMC.
+ *  Feeds one character received from the GPS to the NMEA parser.
+ *  This function buffers a valid (structure and checksum) RMC and GGA
+ *  sentence in nmea_buffer_RMC and nmea_buffer_GGA.
+ *  It doesn't touch any hardware, so it can also be fed from a recorded
+ *  NMEA stream.
+ *  @return 1 when the end of a RMC or GGA sentence was received.
  */
-void __attribute__((__interrupt__, __shadow__, __auto_psv__)) _U2RXInterrupt(void)
+char gps_parse_char(unsigned char c)
 {
-	unsigned char c = U2RXREG;
-	//uart1_putc(c);
-	
- 
+	char sentence_end = 0;
+
 	if (c == '$')   // Beginnng of new sequence
 	{
 		state = 1;
@@ -448,10 +448,7 @@ void __attribute__((__interrupt__, __shadow__, __auto_psv__)) _U2RXInterrupt(voi
 		if (checksum == 0)
 			gga_sentence_number++;
 		state = 92;
-#ifndef TEST
-		static portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE; 
-		xSemaphoreGiveFromISR( xGpsSemaphore, &xHigherPriorityTaskWoken );
-#endif		
+		sentence_end = 1;
 	}	
 	else if (state == 98)
 	{
@@ -466,12 +463,7 @@ void __attribute__((__interrupt__, __shadow__, __auto_psv__)) _U2RXInterrupt(voi
 			rmc_sentence_number++;
 
 		state = 100;
-
-// small test programs don't use FreeRTOS so we need a way to avoid 
-#ifndef TEST
-		static portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE; 
-		xSemaphoreGiveFromISR( xGpsSemaphore, &xHigherPriorityTaskWoken );
-#endif
+		sentence_end = 1;
 	}
 	else 
 	{
@@ -534,5 +526,26 @@ void __attribute__((__interrupt__, __shadow__, __auto_psv__)) _U2RXInterrupt(voi
 				nmea_buffer_GGA_counter = 0;
 		}
 	}
+	return sentence_end;
+}
+
+
+/*!
+ *  Interrupt routine notifying us a new character is available from the
+ *  GPS's uart module.
+ */
+void __attribute__((__interrupt__, __shadow__, __auto_psv__)) _U2RXInterrupt(void)
+{
+	unsigned char c = U2RXREG;
+	//uart1_putc(c);
+
+	if (gps_parse_char(c))
+	{
+// small test programs don't use FreeRTOS so we need a way to avoid 
+#ifndef TEST
+		static portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE; 
+		xSemaphoreGiveFromISR( xGpsSemaphore, &xHigherPriorityTaskWoken );
+#endif
+	}
 	_U2RXIF = 0;
 }
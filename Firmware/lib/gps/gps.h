@@ -34,6 +34,8 @@ void gps_init(struct GpsConfig *gpsconfig);
 
 char gps_update_info(struct gps_info *gpsinfo);
 
+char gps_parse_char(unsigned char c);
+
 void gps_wait_for_lock();
 
 void gps_config_output();
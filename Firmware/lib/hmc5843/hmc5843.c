@@ -73,6 +73,52 @@ void hmc5843_read(struct intvector *magdata)
     magdata->y.i16 = -magdata->y.i16;
 }
 
+static unsigned char async_bytes[6];
+static struct intvector async_vector;
+static volatile int async_updated = 0;
+
+static void hmc5843_read_done(struct I2cTransaction *t);
+
+static struct I2cTransaction async_read = { 0x03C, 3, async_bytes, 6, 1, hmc5843_read_done, I2C_IDLE };
+
+// Called from the I2C interrupt, same axes and signs as hmc5843_read
+static void hmc5843_read_done(struct I2cTransaction *t)
+{
+	if (t->status != I2C_DONE)
+		return;
+
+	async_vector.x.b2.hbyte = async_bytes[0];
+	async_vector.x.b2.lbyte = async_bytes[1];
+	async_vector.z.b2.hbyte = async_bytes[2];
+	async_vector.z.b2.lbyte = async_bytes[3];
+	async_vector.y.b2.hbyte = async_bytes[4];
+	async_vector.y.b2.lbyte = async_bytes[5];
+	async_vector.z.i16 = -async_vector.z.i16;
+	async_vector.y.i16 = -async_vector.y.i16;
+	async_updated = 1;
+}
+
+// Read the 6 data registers in the background, using the interrupt driven
+// I2C transactions. The read is queued here and completes while the caller
+// continues; its result is returned on the next call.
+// Unlike the blocking I2Cread this ACKs every byte, so the automatic
+// register indexing can be used.
+// Returns 1 when magdata has been updated, 0 otherwise.
+int hmc5843_read_async(struct intvector *magdata)
+{
+	int updated = 0;
+
+	if (async_updated)
+	{
+		*magdata = async_vector;
+		async_updated = 0;
+		updated = 1;
+	}
+	i2c_queue(&async_read);   // ignored while the previous read is still in progress
+
+	return updated;
+}
+
 // exhibit the status of the HMC5843
 void test_HMC5843() 
 {
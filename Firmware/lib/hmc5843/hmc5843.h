@@ -56,6 +56,10 @@ void hmc5843_init(void);
 // get new data 3 axis
 void hmc5843_read(struct intvector *magdata);
 
+// queue a read of the 3 axes (non-blocking), returns 1 when magdata has
+// been updated with the result of the previous call
+int hmc5843_read_async(struct intvector *magdata);
+
 // read misc registers
 void test_HMC5843(void);
 
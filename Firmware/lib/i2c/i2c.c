@@ -98,6 +98,12 @@ void i2c_init(void)
 	I2C1CONbits.I2CEN = 1; // Enable I2C Mode
 	temp = I2CRCV; // read buffer to clear buffer full
 	reset_i2c_bus(); // set bus to idle 
+
+	// The interrupt only does work when a transaction is queued, so the
+	// blocking functions keep working. It doesn't call FreeRTOS functions.
+	IPC4bits.MI2C1IP = 4;
+	IFS1bits.MI2C1IF = 0;
+	IEC1bits.MI2C1IE = 1;
 }
 
 // basic I2C byte send
@@ -176,3 +182,238 @@ char I2Cread(char addr, char subaddr)
 	reset_i2c_bus();
 	return temp;
 }
+
+
+/*
+ * Interrupt driven transactions
+ *
+ * The MI2C1 interrupt fires when the start, restart or stop condition is
+ * complete, a byte has been sent (and the slave's ACK received), a byte has
+ * been received, or the ACK has been sent. Each interrupt starts the next
+ * step of the transaction:
+ *   write: start, address, register, data..., stop
+ *   read:  start, address, register, restart, address|1, (receive, ack)..., stop
+ */
+
+enum I2cState { STATE_START, STATE_ADDRESS, STATE_REGISTER, STATE_WRITE, STATE_RESTART,
+                STATE_ADDRESS_READ, STATE_RECEIVE, STATE_ACK, STATE_STOP };
+
+static struct I2cTransaction *queue[I2C_QUEUE_LENGTH];
+static volatile unsigned char queue_first = 0, queue_count = 0;
+
+static struct I2cTransaction * volatile current = 0;
+static volatile enum I2cState state;
+static volatile unsigned char position;       // next data byte
+static volatile unsigned char failed;
+static volatile unsigned char watchdog_calls;
+
+volatile unsigned int i2c_errors = 0;
+
+static void i2c_next();
+static void i2c_finish(enum I2cStatus status);
+static void i2c_stop(unsigned char error);
+static void i2c_recover();
+
+
+int i2c_queue(struct I2cTransaction *t)
+{
+	int ok = 0;
+
+	if (t->status == I2C_QUEUED || t->status == I2C_BUSY)
+		return 0;
+
+	IEC1bits.MI2C1IE = 0;
+	if (queue_count < I2C_QUEUE_LENGTH)
+	{
+		t->status = I2C_QUEUED;
+		queue[(queue_first + queue_count) % I2C_QUEUE_LENGTH] = t;
+		queue_count++;
+		if (current == 0)
+			i2c_next();
+		ok = 1;
+	}
+	else
+		t->status = I2C_ERROR;
+	IEC1bits.MI2C1IE = 1;
+
+	return ok;
+}
+
+
+void i2c_watchdog(void)
+{
+	IEC1bits.MI2C1IE = 0;
+	if (current != 0 && ++watchdog_calls > I2C_WATCHDOG_CALLS)
+	{
+		i2c_recover();
+		i2c_finish(I2C_ERROR);
+	}
+	IEC1bits.MI2C1IE = 1;
+}
+
+
+void __attribute__((__interrupt__, __auto_psv__)) _MI2C1Interrupt(void)
+{
+	IFS1bits.MI2C1IF = 0;
+
+	if (current == 0)   // blocking functions
+		return;
+
+	if (I2C1STATbits.BCL)
+	{
+		// the module returns to idle by itself after a bus collision
+		I2C1STATbits.BCL = 0;
+		I2C1STATbits.IWCOL = 0;
+		i2c_finish(I2C_ERROR);
+		return;
+	}
+
+	switch (state)
+	{
+		case STATE_START:
+			state = STATE_ADDRESS;
+			I2CTRN = current->address & 0xFE;
+			break;
+		case STATE_ADDRESS:
+			if (I2C1STATbits.ACKSTAT)
+				i2c_stop(1);
+			else
+			{
+				state = STATE_REGISTER;
+				I2CTRN = current->reg;
+			}
+			break;
+		case STATE_REGISTER:
+			if (I2C1STATbits.ACKSTAT)
+				i2c_stop(1);
+			else if (current->read)
+			{
+				state = STATE_RESTART;
+				I2C1CONbits.RSEN = 1;
+			}
+			else
+			{
+				state = STATE_WRITE;
+				if (position < current->length)
+					I2CTRN = current->data[position++];
+				else
+					i2c_stop(0);
+			}
+			break;
+		case STATE_WRITE:
+			if (I2C1STATbits.ACKSTAT)
+				i2c_stop(1);
+			else if (position < current->length)
+				I2CTRN = current->data[position++];
+			else
+				i2c_stop(0);
+			break;
+		case STATE_RESTART:
+			state = STATE_ADDRESS_READ;
+			I2CTRN = current->address | 0x01;
+			break;
+		case STATE_ADDRESS_READ:
+			if (I2C1STATbits.ACKSTAT)
+				i2c_stop(1);
+			else
+			{
+				state = STATE_RECEIVE;
+				I2C1CONbits.RCEN = 1;
+			}
+			break;
+		case STATE_RECEIVE:
+			current->data[position++] = I2CRCV;
+			state = STATE_ACK;
+			I2C1CONbits.ACKDT = (position >= current->length);  // NACK the last byte
+			I2C1CONbits.ACKEN = 1;
+			break;
+		case STATE_ACK:
+			if (position < current->length)
+			{
+				state = STATE_RECEIVE;
+				I2C1CONbits.RCEN = 1;
+			}
+			else
+				i2c_stop(0);
+			break;
+		case STATE_STOP:
+			I2C1CONbits.ACKDT = 0;
+			i2c_finish(failed ? I2C_ERROR : I2C_DONE);
+			break;
+	}
+}
+
+
+/*!
+ *   Starts the first queued transaction, if any.
+ *   Called with the I2C interrupt disabled, or from the interrupt.
+ */
+static void i2c_next()
+{
+	if (queue_count == 0)
+	{
+		current = 0;
+		return;
+	}
+
+	current = queue[queue_first];
+	queue_first = (queue_first + 1) % I2C_QUEUE_LENGTH;
+	queue_count--;
+
+	current->status = I2C_BUSY;
+	position = 0;
+	failed = 0;
+	watchdog_calls = 0;
+	state = STATE_START;
+	I2C1CONbits.SEN = 1;
+}
+
+
+static void i2c_stop(unsigned char error)
+{
+	failed = error;
+	state = STATE_STOP;
+	I2C1CONbits.PEN = 1;
+}
+
+
+static void i2c_finish(enum I2cStatus status)
+{
+	struct I2cTransaction *t = current;
+
+	if (status == I2C_ERROR)
+		i2c_errors++;
+	t->status = status;
+	if (t->callback)
+		t->callback(t);
+
+	i2c_next();
+}
+
+
+/*!
+ *   Frees the bus after a timeout. A slave that was interrupted in the middle
+ *   of a read keeps SDA low until it has clocked out its byte, so SCL is
+ *   toggled (at most 9 times) until SDA is released. Then the module is
+ *   restarted.
+ */
+static void i2c_recover()
+{
+	int i;
+
+	I2C1CONbits.I2CEN = 0;
+	LATGbits.LATG2 = 0;
+	for (i = 0; i < 9 && PORTGbits.RG3 == 0; i++)
+	{
+		TRISGbits.TRISG2 = 0;   // SCL low
+		microcontroller_delay_us(5);
+		TRISGbits.TRISG2 = 1;   // SCL released by the pull-up
+		microcontroller_delay_us(5);
+	}
+
+	I2C1CONbits.ACKDT = 0;
+	I2C1STATbits.BCL = 0;
+	I2C1STATbits.IWCOL = 0;
+	I2C1CONbits.I2CEN = 1;
+	IFS1bits.MI2C1IF = 0;
+}
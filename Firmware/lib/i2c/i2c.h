@@ -31,3 +31,35 @@ void I2Cwrite(char addr, char subaddr, char value);
 
 //read from an address
 char I2Cread(char addr, char subaddr);
+
+
+// Interrupt driven transactions. They are executed one after the other by the
+// MI2C1 interrupt, so the calling task is not blocked during the transfer.
+// The blocking functions above may only be used while no transactions are
+// queued (e.g. during initialization).
+
+#define I2C_QUEUE_LENGTH 8      // maximum number of queued transactions
+#define I2C_WATCHDOG_CALLS 2    // a transaction may take this many i2c_watchdog() calls
+
+enum I2cStatus { I2C_IDLE = 0, I2C_QUEUED = 1, I2C_BUSY = 2, I2C_DONE = 3, I2C_ERROR = 4 };
+
+struct I2cTransaction
+{
+	unsigned char address;       // 8-bit write address, bit 0 is set for the read
+	unsigned char reg;           // register to write to, or to start reading from
+	unsigned char *data;         // bytes written after reg, or buffer for the bytes read
+	unsigned char length;        // number of data bytes, at least 1 for a read
+	unsigned char read;          // 1: read length bytes, 0: write them
+	void (*callback)(struct I2cTransaction *t);  // called from the interrupt when done or failed, may be 0
+	volatile enum I2cStatus status;
+};
+
+// queue a transaction, returns 0 when the queue is full (status is set to I2C_ERROR)
+// or when the transaction is still queued or in progress
+int i2c_queue(struct I2cTransaction *t);
+
+// call once per sensor cycle: fails a transaction that takes too long and frees the bus
+void i2c_watchdog(void);
+
+// number of failed transactions (NACK, bus collision, timeout)
+extern volatile unsigned int i2c_errors;
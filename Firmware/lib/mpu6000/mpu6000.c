@@ -11,7 +11,7 @@ unsigned char spi_comm_bitbang(unsigned char outgoing_byte);
 void spi_cs_disable();
 void spi_cs_enable();
 void spi_write_reg(unsigned char addr, unsigned char data);
-unsigned int spiGet16(void);
+int spiGet16(void);
 unsigned char spi_read_reg(unsigned char addr);
 
 struct mpu6000_raw_sensors mpu6000_raw_sensor_readings;
@@ -77,9 +77,16 @@ void mpu6000_update_sensor_readings()
     spi_cs_disable();
 }
 
-unsigned int spiGet16(void)
+/*!
+ *   Reads a big endian, signed register pair. The bytes are read in two
+ *   statements: the order of the calls in one expression isn't defined.
+ *   Through short, which has 16 bits on the dsPIC and on the host.
+ */
+int spiGet16(void)
 {
-       return ((int)spi_comm_bitbang(0) << 8) | ((int)spi_comm_bitbang(0) & 0xFF);
+       unsigned int high = spi_comm_bitbang(0);
+
+       return (short)((high << 8) | spi_comm_bitbang(0));
 }
 
 void spi_cs_disable()
@@ -12,6 +12,7 @@
  */
 
 #include <math.h>
+#include <stdint.h>
 
 #include "pid/pid.h"
 
@@ -43,10 +44,16 @@ void pid_init(struct pid *pid, float d_gain, float p_gain, float i_gain, float i
 }
 
 
-__attribute__((__const__)) int isNaN_PID (float* f)
+/*!
+ *  Tests the exponent bits of the upper word, like the dsPIC did with an
+ *  int pointer: also true for infinity and numbers above 2^127.
+ */
+__attribute__((__pure__)) int isNaN_PID (float* f)
 {
-	const int* rep = ((const int*) f) + 1;
-	return ((*rep & 0x7F00) == 0x7F00);
+	union { float f; uint32_t i; } u;   // not through an int pointer: int has 32 bits on the host
+
+	u.f = *f;
+	return ((u.i & 0x7F000000UL) == 0x7F000000UL);
 }
 
 
@@ -192,28 +192,75 @@ void ppm_in_guess_num_channels()
 }	
 
 
-// shadow: fast context save DONT USE IT HERE!!!
-// no_auto_psv: code does not access string literals or const vars
 /*!
- *  Interrupt routing that decodes the PPM signal.
- *  This routing is called on every 4th falling edge, and this to save
- *  processing power. The PPM frame is accepted when:
+ *  Decodes one pulse of the PPM signal. The PPM frame is accepted when:
  *    - Every channel is between a certain minimum and maximum
  *    - If it ends with a synch pulse
  *    - If it contains a predefined number of channels.
  *
  *  If these conditions are not met, the frame is discared. The results
  *  are saved in the global ppm_info struct.
- *
- *
- *  This routine uses the alternate interrupt vector table pwm_in uses the normal one.
+ *  It doesn't touch any hardware, so it can also be fed from a recorded
+ *  pulse train.
+ *  @param in The time between 2 captured edges, in timer ticks.
  */
-void __attribute__((__interrupt__, __auto_psv__)) _AltIC4Interrupt(void)
+void ppm_in_decode_pulse(unsigned int in)
 {
 	static volatile unsigned int counter = 0;
 	static volatile unsigned char invalid_pulse = 1;
 	static volatile int ppm_in[14];
 
+	if (in > sync_pulse)
+	{
+		// this is a valid frame if 
+		//  - the number of received channels is the same as last time
+		//  - no invalid pulses encountered
+		ppm.valid_frame = (NUM_CHANNELS == counter) && !invalid_pulse;
+		counter = 0;
+		invalid_pulse = 0;
+		if (ppm.valid_frame) //
+            {
+			for (counter=0; counter < NUM_CHANNELS; counter++)
+				ppm.channel[counter] = ppm_in[counter];
+                frame_counter++;
+            }
+		counter = 0;
+
+	}
+	else if (in < servo_pulse_max && in > servo_pulse_min && !invalid_pulse)
+	{
+		if (ppm.valid_frame) 
+		{ // last frame was valid?
+			ppm_in[counter] = ppm_in_raw_to_us(in);
+		}
+		counter++;
+	} else
+	{
+		counter++;
+		invalid_pulse = 1;
+		ppm.valid_frame = 0;
+	}
+		
+	if (counter > NUM_CHANNELS)
+	{
+		counter = 0;
+		invalid_pulse = 1;
+		ppm.valid_frame = 0;
+	}
+}
+
+
+// shadow: fast context save DONT USE IT HERE!!!
+// no_auto_psv: code does not access string literals or const vars
+/*!
+ *  Interrupt routing that decodes the PPM signal.
+ *  This routing is called on every 4th falling edge, and this to save
+ *  processing power.
+ *
+ *  This routine uses the alternate interrupt vector table pwm_in uses the normal one.
+ */
+void __attribute__((__interrupt__, __auto_psv__)) _AltIC4Interrupt(void)
+{
 	unsigned int raw_in, 
 	             last_raw_in = 0,
 	             in;
@@ -228,43 +275,7 @@ void __attribute__((__interrupt__, __auto_psv__)) _AltIC4Interrupt(void)
 		else
 			in = 0xFFFF - last_raw_in + raw_in;
 		
-		if (in > sync_pulse)
-		{
-			// this is a valid frame if 
-			//  - the number of received channels is the same as last time
-			//  - no invalid pulses encountered
-			ppm.valid_frame = (NUM_CHANNELS == counter) && !invalid_pulse;
-			counter = 0;
-			invalid_pulse = 0;
-			if (ppm.valid_frame) //
-            {
-				for (counter=0; counter < NUM_CHANNELS; counter++)
-					ppm.channel[counter] = ppm_in[counter];
-                frame_counter++;
-            }
-			counter = 0;
-
-		}
-		else if (in < servo_pulse_max && in > servo_pulse_min && !invalid_pulse)
-		{
-			if (ppm.valid_frame) 
-			{ // last frame was valid?
-				ppm_in[counter] = ppm_in_raw_to_us(in);
-			}
-			counter++;
-		} else
-		{
-			counter++;
-			invalid_pulse = 1;
-			ppm.valid_frame = 0;
-		}
-			
-		if (counter > NUM_CHANNELS)
-		{
-			counter = 0;
-			invalid_pulse = 1;
-			ppm.valid_frame = 0;
-		}
+		ppm_in_decode_pulse(in);
 			
 		last_raw_in = raw_in;
 	}	
@@ -14,6 +14,7 @@ extern volatile struct ppm_info ppm;
 
 void ppm_in_update_status(float dt);
 void ppm_in_update_status_ticks_50hz();
+void ppm_in_decode_pulse(unsigned int in);
 
 int ppm_signal_quality();
 
@@ -3,14 +3,26 @@
 #include "uart1_queue/uart1_queue.h"
 
 #include "FreeRTOS/FreeRTOS.h"
-#include "FreeRTOS/queue.h"
+#include "FreeRTOS/semphr.h"
 #include "FreeRTOS/task.h"
 
-xQueueHandle xRxedChars;
+/*
+ *  Received bytes go to a ring buffer, the reader takes them in blocks with
+ *  uart1_read(). A FreeRTOS queue costs a copy and a list update per byte,
+ *  in the interrupt and in the reader. When the buffer is full the new bytes
+ *  are dropped and counted: the data already received stays intact.
+ */
+static volatile unsigned char rx_buffer[UART1_RX_BUFFER];
+static volatile unsigned int rx_head = 0;   // written by the interrupt
+static volatile unsigned int rx_tail = 0;   // written by the reader
+static xSemaphoreHandle xRxSemaphore;       // given when bytes arrive
+
+volatile unsigned int uart1_rx_overruns = 0;
 
 void uart1_queue_init(long baud)
 {
-    xRxedChars = xQueueCreate( 300, ( unsigned portBASE_TYPE ) sizeof( char ) ); // problem in simulation mode if buffer is too small
+    vSemaphoreCreateBinary(xRxSemaphore);
+    xSemaphoreTake(xRxSemaphore, 0);
 
 	// configure U2MODE
 	U1MODEbits.UARTEN = 0;	// Bit15 TX, RX DISABLED, ENABLE at end of func
@@ -57,40 +69,32 @@ void uart1_queue_init(long baud)
     _U1RXIP = configKERNEL_INTERRUPT_PRIORITY; // same as freerots?
 }	
 
-static const char newline = '\n';
 void __attribute__((__interrupt__, auto_psv)) _U1RXInterrupt( void )
 {
-	char cChar;
+	unsigned int next;
 	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 
-	/* Get the character and post it on the queue of Rxed characters.
-	If the post causes a task to wake force a context switch as the woken task
-	may have a higher priority than the task we have interrupted. */
-
-
-    if (U1STAbits.OERR) // buffer overrun, no way we can receive correct data! (add '\n' to reset parser)
-    {
-        U1STAbits.OERR = 0;
-        //uart1_puts("\r\nreceive buffer overrun\r\n");
-        //xQueueSendFromISR( xRxedChars, &newline, &xHigherPriorityTaskWoken );  // reset parser
-    }
-	
 	while( U1STAbits.URXDA )
 	{
-		cChar = U1RXREG;
-		if (xQueueSendFromISR( xRxedChars, &cChar, &xHigherPriorityTaskWoken ) == errQUEUE_FULL)  // oh no, the queue is full
-        {
-            if (xQueueReset(xRxedChars) == pdFALSE)  // empty it to avoid another full queue in the near future
-            {
-                uart1_puts("\r\nUnable to reset a blocked queue\r\n");
-            } else
-            {
-                uart1_puts("\r\nQueue reset\r\n");
-                xQueueSendFromISR( xRxedChars, &newline, &xHigherPriorityTaskWoken );  // reset parser
-            }
-        }
+		next = (rx_head + 1) & (UART1_RX_BUFFER - 1);
+		if (next == rx_tail)   // full: the reader is too slow
+		{
+			(void)U1RXREG;
+			uart1_rx_overruns++;
+		}
+		else
+		{
+			rx_buffer[rx_head] = U1RXREG;
+			rx_head = next;
+		}
 	}
+    if (U1STAbits.OERR) // hardware buffer overrun: bytes were lost, clearing it empties the fifo (read above)
+    {
+        uart1_rx_overruns++;
+        U1STAbits.OERR = 0;
+    }
 	IFS0bits.U1RXIF = 0;
+	xSemaphoreGiveFromISR( xRxSemaphore, &xHigherPriorityTaskWoken );
 	// NO YIELDING! We are in an interrupt routine, and parsing input is not urgent anyway
     if( xHigherPriorityTaskWoken != pdFALSE )
 	{
@@ -98,6 +102,39 @@ void __attribute__((__interrupt__, auto_psv)) _U1RXInterrupt( void )
 	}
 }
 
+/*!
+ *   Copies the received bytes to buffer, at most max. Waits for at most
+ *   "wait" ticks when there are none.
+ *   @return the number of bytes copied
+ */
+int uart1_read(unsigned char *buffer, int max, portTickType wait)
+{
+	unsigned int tail = rx_tail;
+	int n = 0;
+
+	if (tail == rx_head)
+	{
+		xSemaphoreTake( xRxSemaphore, wait );
+	}
+	while (n < max && tail != rx_head)
+	{
+		buffer[n++] = rx_buffer[tail];
+		tail = (tail + 1) & (UART1_RX_BUFFER - 1);
+	}
+	rx_tail = tail;
+	return n;
+}
+
+
+/*!
+ *   Free space in the receive buffer, in bytes.
+ */
+int uart1_rx_free()
+{
+	return (int)((rx_tail - rx_head - 1) & (UART1_RX_BUFFER - 1));
+}
+
+
 void uart1_puts(char *str)
 {
 	while(*str != '\0')
@@ -1,5 +1,14 @@
 
+#include "FreeRTOS/FreeRTOS.h"
+
+#define UART1_RX_BUFFER 512   //!< power of 2
+
+//! Received bytes dropped because the buffer or the uart was full
+extern volatile unsigned int uart1_rx_overruns;
+
 void uart1_queue_init(long baud);
+int uart1_read(unsigned char *buffer, int max, portTickType wait);
+int uart1_rx_free();
 void uart1_puts(char *str);
 void uart1_putc(char c);
 void uart1_put(char *str, int len);
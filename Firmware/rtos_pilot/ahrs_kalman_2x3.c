@@ -14,29 +14,30 @@
  *  @since    0.1
  */
  
-#ifdef ENABLE_QUADROCOPTER
-#error Please use ahrs_simple_quaternion_c for multicopter use!
-#endif
+// multicopters use ahrs_quaternion.c
+#if !defined(ENABLE_QUADROCOPTER) && !defined(AHRS_QUATERNION)
 
 #include <math.h>
  
 #include "button/button.h"
+#include "fastmath/fastmath.h"
 #include "matrix/matrix.h"
 #include "pid/pid.h"
 #include "quaternion/quaternion.h"
 
 #include "sensors.h"
+#include "magnetometer.h"
+#include "sensor_health.h"
+#include "wind_estimator.h"
 #include "configuration.h"
 #include "common.h"
 
 
-static float sin_lookup[182];  // lookup table to avoid sinus calculations
+#define MAGNETOMETER_TIME_CONSTANT_S 1.0f   //!< time constant of the yaw correction by the magnetometer
 
 float gravity_to_roll(float a_y, float a_z);
 float gravity_to_pitch(float a_x, float a_z);
 
-inline float fast_sin(float x);
-inline float fast_cos(float x);
 __attribute__((__const__)) int isNaN (float* f) ;
 
 static float pitch_rad = 0.0, roll_rad = 0.0;
@@ -46,18 +47,18 @@ float roll_rad_sum_error = 0.0;
 
 void ahrs_init()
 {
-	float x;
-	int i;
-	
-	for (x=(-3.14159f), i = 0; i < 181; x+=(2.0f/180.0f*3.14159f), i++)
-	{
-		sin_lookup[i] = sinf(x);
-	}	
-	
 	// initialize our attitude with the current accelerometer's data
 	//printf("-> %f %f %f <-\r\n", sensor_data.acc_x, sensor_data.acc_y, sensor_data.acc_z);
     pitch_rad = gravity_to_pitch(sensor_data.acc_x, sensor_data.acc_z);
     roll_rad = gravity_to_roll(sensor_data.acc_y, sensor_data.acc_z);
+
+	// start with the magnetometer heading, otherwise the GPS will slowly pull us around
+	if (config.sensors.magnetometer_enabled)
+	{
+		float heading;
+		if (magnetometer_heading(fast_sin(roll_rad), fast_cos(roll_rad), fast_sin(pitch_rad), fast_cos(pitch_rad), &heading))
+			sensor_data.yaw = heading;
+	}
     
     sensor_data.p_bias = 0.0f;
 	sensor_data.q_bias = 0.0f;
@@ -211,7 +212,8 @@ void ahrs_filter(float dt)
     ////////////////////////////////
     
     if (i++ % 2 == 0 &&    // only apply every other iteration
-        fabs(sensor_data.acc_x) < 1.0f)   // only apply when the acceleration along the x-axis is not too large (take-off!)
+        fabs(sensor_data.acc_x) < 1.0f &&   // only apply when the acceleration along the x-axis is not too large (take-off!)
+        sensor_health.acc_trusted)          // or when vibration or clipping corrupts the accelerometers
     {
 	    //dh_dx = [q(i)/G*w_droll                        cos_pitch + q(i)*w_dpitch/G;...
 	    //         -cos_pitch*cos_roll + p(i)*w_droll/G   sin_roll*sin_pitch + (r(i)*u_dpitch - p(i)*w_dpitch)/G;...
@@ -226,7 +228,8 @@ void ahrs_filter(float dt)
 	    float w_dpitch = cos_roll * (cos_pitch * sensor_data.gps.speed_ms - sin_pitch * dh);*/
 	    
 	    /* Without dh: */
-	  	float u = sqrt(sensor_data.gps.speed_ms*sensor_data.gps.speed_ms + dh*dh);
+	  	float airspeed = wind_airspeed_ms();
+	  	float u = fast_sqrt(airspeed*airspeed + dh*dh);
 		float w = dh*cos_pitch*cos_roll; //cos_roll * sin_pitch * sensor_data.gps.speed_ms;
 	
 	    //float w_droll = -sin_roll * (sin_pitch * sensor_data.gps.speed_ms);
@@ -326,10 +329,9 @@ void ahrs_filter(float dt)
 				sensor_data.yaw -= DEG2RAD(360.0);
 			else if (sensor_data.yaw < DEG2RAD(0.0))
 				sensor_data.yaw += DEG2RAD(360.0);
-#ifndef F1E_STEERING
-			if (fabs(sensor_data.yaw - sensor_data.gps.heading_rad) < DEG2RAD(250.0) && sensor_data.gps.satellites_in_view > 5)  // do not change if e.g. yaw = 355 and heading = 2
+			if (!config.sensors.magnetometer_enabled &&
+			    fabs(sensor_data.yaw - sensor_data.gps.heading_rad) < DEG2RAD(250.0) && sensor_data.gps.satellites_in_view > 5)  // do not change if e.g. yaw = 355 and heading = 2
 				sensor_data.yaw = sensor_data.yaw*0.99 + sensor_data.gps.heading_rad*0.01;
-#endif
 		}
 
         normalize_pitch_roll();
@@ -345,68 +347,27 @@ void ahrs_filter(float dt)
 		roll_rad_sum_error = 0.0f;
 		pitch_rad_sum_error = 0.0f;
 	}
-#ifdef F1E_STEERING
-	if (i % 5 == 0)
+	// magnetometer heading at the sensor rate, only when the tilt compensation is reliable
+	if (config.sensors.magnetometer_enabled &&
+	    fabs(roll_rad) < DEG2RAD(60.0f) && fabs(pitch_rad) < DEG2RAD(60.0f))
 	{
-		float mx = ((float)sensor_data.magnetometer_raw.x.i16);
-		float my = ((float)sensor_data.magnetometer_raw.y.i16);
-		float mz = ((float)sensor_data.magnetometer_raw.z.i16);
-
-		float YH =                my*cos_roll           - mz*sin_roll;
-		float XH = mx*cos_pitch + my*sin_roll*sin_pitch + mz*cos_roll*sin_pitch;
-
-        
-        float magneto_yaw = atan2f (-YH, XH);
-        
-        if (magneto_yaw >= DEG2RAD(360.0))
-				magneto_yaw -= DEG2RAD(360.0);
-        else if (magneto_yaw < DEG2RAD(0.0))
-            magneto_yaw += DEG2RAD(360.0);
-
-        if (fabs(sensor_data.pitch) > DEG2RAD(30.0) || fabs(sensor_data.roll) > DEG2RAD(30.0))
-        {
-            // keep gyroscope sensor_data.yaw
-        }
-        else if (fabs(sensor_data.pitch) > DEG2RAD(5.0) || fabs(sensor_data.roll) > DEG2RAD(5.0))
-        {
-            if (magneto_yaw > DEG2RAD(250.0) && sensor_data.yaw < DEG2RAD(50.0))
-                sensor_data.yaw = (magneto_yaw - DEG2RAD(360.0)) * 0.1 + sensor_data.yaw * 0.9;
-            else if (sensor_data.yaw > DEG2RAD(250.0) && magneto_yaw < DEG2RAD(50.0))
-                sensor_data.yaw = (magneto_yaw) * 0.1 + (sensor_data.yaw  - DEG2RAD(360.0)) * 0.9;
-            else
-                sensor_data.yaw = (magneto_yaw) * 0.1 + (sensor_data.yaw) * 0.9;
-        }
-        else
-        {
-            if (magneto_yaw > DEG2RAD(250.0) && sensor_data.yaw < DEG2RAD(50.0))
-                sensor_data.yaw = (magneto_yaw - DEG2RAD(360.0)) * 0.5 + sensor_data.yaw * 0.5;
-            else if (sensor_data.yaw > DEG2RAD(250.0) && magneto_yaw < DEG2RAD(50.0))
-                sensor_data.yaw = (magneto_yaw) * 0.5 + (sensor_data.yaw  - DEG2RAD(360.0)) * 0.5;
-            else
-                sensor_data.yaw = (magneto_yaw) * 0.5 + (sensor_data.yaw) * 0.5;
-        }
+		float magneto_yaw;
 
-		if (sensor_data.yaw >= DEG2RAD(360.0))
-				sensor_data.yaw -= DEG2RAD(360.0);
-        else if (sensor_data.yaw < DEG2RAD(0.0))
-            sensor_data.yaw += DEG2RAD(360.0);
-
-		//sensor_data.yaw /= 2.0f;
+		if (magnetometer_heading(sin_roll, cos_roll, sin_pitch, cos_pitch, &magneto_yaw))
+		{
+			float e = magneto_yaw - sensor_data.yaw;
+			if (e > PI)
+				e -= 2.0f*PI;
+			else if (e < -PI)
+				e += 2.0f*PI;
 
-        /*if (i  % 25 == 0)
-        {
-            int heading = sensor_data.yaw/3.14*180.0;
-            if (heading < 0)
-                heading += 360;
-            printf("\r\nCompass: %d\r\n", heading);
-        }*/
-
-		/*printf("\r\n%5d %5d %5d -> %f\r\n",sensor_data.magnetometer_raw.x.i16,
-							sensor_data.magnetometer_raw.y.i16,
-							sensor_data.magnetometer_raw.z.i16, 
-							sensor_data.yaw*180.0/3.14159);*/
-	}	
-#endif	
+			sensor_data.yaw += e * dt / MAGNETOMETER_TIME_CONSTANT_S;
+			if (sensor_data.yaw >= DEG2RAD(360.0))
+				sensor_data.yaw -= DEG2RAD(360.0);
+			else if (sensor_data.yaw < DEG2RAD(0.0))
+				sensor_data.yaw += DEG2RAD(360.0);
+		}
+	}
    
     /*int p = (int)pitch_rad;   
     if (p == -1 || (int)roll_rad == -1)   // we have a NaN -> ALERT
@@ -447,15 +408,7 @@ __attribute__((__const__)) int isNaN (float* f)
  */
 float gravity_to_roll(float a_y, float a_z)
 {
-	float roll_acc = atan(a_y / a_z);
-	if (a_z > 0.0f)
-	{
-		if (a_y < 0.0f)	
-			roll_acc =  roll_acc + 3.14159f;
-		else
-			roll_acc =  roll_acc - 3.14159f;
-	}	
-	return roll_acc;	
+	return fast_atan2(-a_y, -a_z);
 }	
 
 
@@ -466,37 +419,8 @@ float gravity_to_roll(float a_y, float a_z)
  */
 float gravity_to_pitch(float a_x, float a_z)
 {
-	float pitch_acc = -atan(a_x / a_z); // replace with asin?
-
-	if (a_z > 0.0f)
-		pitch_acc =  -pitch_acc;
-
-	return pitch_acc;
+	return fast_atan2(a_x, fabs(a_z));
 }
 
 
-inline float fast_sin(float x)
-{
-	// -180..180 -> -60..60
-	//int i = (int)(x/(2.0f/(180.0f/3.14159f))) + (180/2);
-
-
-    // improve rounding
-	int i = (int)(x/0.034906585f) + 90;  // 0 = -180.. 180=+180
-
-    if (i < 0 || i > 180)
-        printf("\r\nSIN error: %d\r\n",(int) RAD2DEG(x));
-    if (i > 180)
-        i -= 180;
-    else if (i < 0)
-        i += 180;
-	return sin_lookup[i];
-}	
-inline float fast_cos(float x)
-{
-	// -180..180 -> 270..-90
-    double a = DEG2RAD(90.0f) - x;
-    if (a > DEG2RAD(180.0f))
-        a -= DEG2RAD(360.0f);
-	return fast_sin(a);
-}	
+#endif // !ENABLE_QUADROCOPTER && !AHRS_QUATERNION
@@ -0,0 +1,176 @@
+/*!
+ *  Filters the sensor input, calculates pitch, roll and yaw.
+ *
+ *  The gyroscope rates are integrated in a quaternion, so there is no gimbal
+ *  lock and no trigonometry in the inner loop. The attitude is pulled towards
+ *  the gravity vector measured by the accelerometers (fixed wing: compensated
+ *  for the centripetal acceleration using the estimated airspeed), the
+ *  heading towards the calibrated magnetometer heading, or the GPS course when
+ *  there is no magnetometer. The same error drives 3 gyro bias states.
+ *  Euler angles are only calculated once per call, for the output.
+ *
+ *  Used for multicopters, and for fixed wing when AHRS_QUATERNION is defined.
+ *  Otherwise ahrs_kalman_2x3.c is used.
+ *
+ *  @file     ahrs_quaternion.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#if defined(ENABLE_QUADROCOPTER) || defined(AHRS_QUATERNION)
+
+#include <math.h>
+
+#include "fastmath/fastmath.h"
+#include "quaternion/quaternion.h"
+
+#include "ahrs.h"
+#include "sensors.h"
+#include "magnetometer.h"
+#include "sensor_health.h"
+#include "wind_estimator.h"
+#include "configuration.h"
+#include "common.h"
+
+#ifdef ENABLE_QUADROCOPTER
+	#define KP_ATTITUDE 2.0f      //!< rad/s per unit of gravity error
+#else
+	#define KP_ATTITUDE 0.5f
+#endif
+#define KP_HEADING 0.3f           //!< rad/s per rad of heading error
+#define KI_BIAS 0.05f             //!< bias rate per rad/s of correction
+#define MAX_BIAS DEG2RAD(10.0f)
+
+#define GPS_MIN_SPEED_MS 5.0f     //!< don't trust the GPS course below this speed
+
+//! Rotation from the body to the earth frame.
+static float quat[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+
+static void ahrs_update_euler();
+
+
+void ahrs_init()
+{
+	float roll = 0.0f, pitch = 0.0f, yaw = 0.0f;
+	float yz = fast_sqrt(sensor_data.acc_y*sensor_data.acc_y + sensor_data.acc_z*sensor_data.acc_z);
+
+	// initialize our attitude with the current accelerometer's data
+	if (yz > 0.1f)
+	{
+		roll = fast_atan2(-sensor_data.acc_y, -sensor_data.acc_z);
+		pitch = fast_atan2(sensor_data.acc_x, yz);
+	}
+
+	yaw = sensor_data.gps.heading_rad;
+	if (config.sensors.magnetometer_enabled)
+		magnetometer_heading(fast_sin(roll), fast_cos(roll), fast_sin(pitch), fast_cos(pitch), &yaw);
+
+	quaternion_from_attitude(roll, pitch, yaw, quat);
+
+	sensor_data.p_bias = 0.0f;
+	sensor_data.q_bias = 0.0f;
+	sensor_data.r_bias = 0.0f;
+
+	ahrs_update_euler();
+}
+
+
+void ahrs_filter(float dt)
+{
+	float vx, vy, vz;          // estimated down direction in the body frame
+	float ax, ay, az, norm2;   // measured down direction
+	float cx = 0.0f, cy = 0.0f, cz = 0.0f;   // correction of the rates
+	float heading;
+	int heading_valid = 0;
+
+	sensor_data.p -= sensor_data.p_bias;
+	sensor_data.q -= sensor_data.q_bias;
+	sensor_data.r -= sensor_data.r_bias;
+
+	vx = 2.0f * (quat[1]*quat[3] - quat[0]*quat[2]);
+	vy = 2.0f * (quat[2]*quat[3] + quat[0]*quat[1]);
+	vz = quat[0]*quat[0] - quat[1]*quat[1] - quat[2]*quat[2] + quat[3]*quat[3];
+
+	// the accelerometers measure minus gravity, plus the centripetal acceleration
+	// (rates times the velocity relative to the air mass)
+	ax = -sensor_data.acc_x;
+#ifdef ENABLE_QUADROCOPTER
+	ay = -sensor_data.acc_y;
+	az = -sensor_data.acc_z;
+#else
+	{
+		float airspeed = wind_airspeed_ms();
+		ay = -sensor_data.acc_y + sensor_data.r * airspeed / G;
+		az = -sensor_data.acc_z - sensor_data.q * airspeed / G;
+	}
+#endif
+	norm2 = ax*ax + ay*ay + az*az;
+
+	// only trust the accelerometers when they measure about 1G, the acceleration along
+	// the x-axis is not too large (take-off!) and they are not shaken or clipping
+	if (norm2 > 0.5f*0.5f && norm2 < 1.5f*1.5f && fabs(sensor_data.acc_x) < 1.0f && sensor_health.acc_trusted)
+	{
+		float inv_norm = fast_inv_sqrt(norm2);
+		ax *= inv_norm;
+		ay *= inv_norm;
+		az *= inv_norm;
+
+		// cross product rotates the estimated towards the measured direction
+		cx = KP_ATTITUDE * (ay*vz - az*vy);
+		cy = KP_ATTITUDE * (az*vx - ax*vz);
+		cz = KP_ATTITUDE * (ax*vy - ay*vx);
+	}
+
+	if (config.sensors.magnetometer_enabled)
+	{
+		float roll = sensor_data.roll, pitch = sensor_data.pitch + config.sensors.neutral_pitch;
+		heading_valid = magnetometer_heading(fast_sin(roll), fast_cos(roll), fast_sin(pitch), fast_cos(pitch), &heading);
+	}
+	else if (sensor_data.gps.satellites_in_view > 5 && sensor_data.gps.speed_ms > GPS_MIN_SPEED_MS)
+	{
+		heading = sensor_data.gps.heading_rad;
+		heading_valid = 1;
+	}
+
+	// only rotate around the vertical: the heading shouldn't affect pitch and roll
+	if (heading_valid)
+	{
+		float e = heading - sensor_data.yaw;
+		if (e > PI)
+			e -= 2.0f*PI;
+		else if (e < -PI)
+			e += 2.0f*PI;
+
+		e *= KP_HEADING;
+		cx += e * vx;
+		cy += e * vy;
+		cz += e * vz;
+	}
+
+	sensor_data.p_bias = BIND(sensor_data.p_bias - KI_BIAS * cx * dt, -MAX_BIAS, MAX_BIAS);
+	sensor_data.q_bias = BIND(sensor_data.q_bias - KI_BIAS * cy * dt, -MAX_BIAS, MAX_BIAS);
+	sensor_data.r_bias = BIND(sensor_data.r_bias - KI_BIAS * cz * dt, -MAX_BIAS, MAX_BIAS);
+
+	quaternion_update_with_rates(sensor_data.p + cx, sensor_data.q + cy, sensor_data.r + cz, quat, dt);
+
+	ahrs_update_euler();
+}
+
+
+/*!
+ *   Calculates the euler angles from the quaternion.
+ *   Yaw is in [0, 2*PI), like the GPS heading.
+ */
+static void ahrs_update_euler()
+{
+	float yaw = quaternion_to_yaw(quat);
+
+	if (yaw < 0.0f)
+		yaw += 2.0f*PI;
+
+	sensor_data.roll = quaternion_to_roll(quat);
+	sensor_data.pitch = quaternion_to_pitch(quat) - config.sensors.neutral_pitch;
+	sensor_data.yaw = yaw;
+}
+
+#endif // ENABLE_QUADROCOPTER || AHRS_QUATERNION
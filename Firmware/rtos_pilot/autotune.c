@@ -0,0 +1,216 @@
+/*!
+ *  In-flight tuning of the roll2aileron or pitch2elevator pid by relay
+ *  feedback (Astrom-Hagglund).
+ *
+ *  Started from the ground station, the experiment runs as soon as the pilot
+ *  switches to stabilized mode. The pid of the axis is replaced by a relay
+ *  with a little hysteresis: full positive surface when the attitude is
+ *  below the stick's setpoint, full negative when above. The aircraft then
+ *  oscillates around the setpoint at the ultimate period Tu, with an
+ *  amplitude a that gives the ultimate gain
+ *      Ku = 4 d / (pi sqrt(a^2 - h^2))
+ *  for a relay amplitude d and hysteresis h. The gains follow from the
+ *  Tyreus-Luyben rule: Ziegler-Nichols overshoots a lot on an attitude loop,
+ *  which integrates the rate.
+ *
+ *  The experiment stops when the pilot leaves stabilized mode, when the
+ *  attitude error grows beyond the aircraft's limits or when no steady
+ *  oscillation shows up in time. The pid takes over again right away.
+ *  The result is only proposed: the ground station applies it with UA,
+ *  within bounds around the current gains.
+ *
+ *  @file     autotune.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+#include "autotune.h"
+#include "gain_schedule.h"
+#include "configuration.h"
+#include "common.h"
+
+#define MIN_RELAY_DEG 3.0f
+#define MAX_RELAY_DEG 15.0f
+#define HYSTERESIS_RAD 0.0175f      //!< 1 degree, above the attitude noise
+#define SETTLE_CYCLES 2             //!< not measured, the first one is a partial cycle
+#define MEASURE_CYCLES 4
+#define MAX_TIME_S 30.0f
+#define MAX_PERIOD_SPREAD 0.25f     //!< of the mean period, or the oscillation is not steady
+#define MAX_GAIN_CHANGE 3.0f        //!< the proposed p gain stays within this factor of the current one
+#define MAX_P_GAIN 3.0f
+#define MAX_I_GAIN 3.0f
+#define MAX_D_GAIN 0.5f
+
+struct Autotune autotune = { .state = AUTOTUNE_IDLE, .axis = AUTOTUNE_NONE };
+
+static float output;                //!< relay output, +-relay_rad
+static float time_s, cycle_s;       //!< since the start and since the last rising switch
+static float error_min, error_max;  //!< during the current cycle
+static float period_sum, period_min, period_max, amplitude_sum;
+
+static void autotune_stop(enum AutotuneStates state);
+static void autotune_cycle();
+static void autotune_compute();
+
+
+/*!
+ *   Arms the experiment on the given axis, it starts in stabilized mode.
+ *   AUTOTUNE_NONE stops a running experiment.
+ */
+void autotune_start(enum AutotuneAxis axis, float relay_deg)
+{
+	if (axis != AUTOTUNE_ROLL && axis != AUTOTUNE_PITCH)
+	{
+		if (autotune.state == AUTOTUNE_ARMED || autotune.state == AUTOTUNE_RUNNING)
+			autotune_stop(AUTOTUNE_ABORTED);
+		return;
+	}
+
+	autotune.state = AUTOTUNE_IDLE;  // the control task ignores it while being set up
+	autotune.axis = axis;
+	autotune.relay_rad = DEG2RAD(BIND(relay_deg, MIN_RELAY_DEG, MAX_RELAY_DEG));
+	autotune.cycles = 0;
+	autotune.ku = 0.0f;
+	autotune.tu_s = 0.0f;
+	autotune.state = AUTOTUNE_ARMED;
+	autotune.report = 1;
+}
+
+
+/*!
+ *   Copies the proposed gains into the configuration. Returns 0 when there is
+ *   no result.
+ */
+int autotune_apply()
+{
+	struct pid *pid;
+
+	if (autotune.state != AUTOTUNE_DONE)
+		return 0;
+
+	pid = autotune.axis == AUTOTUNE_ROLL ? &config.control.pid_roll2aileron : &config.control.pid_pitch2elevator;
+	pid->p_gain = autotune.proposed.p_gain;
+	pid->i_gain = autotune.proposed.i_gain;
+	pid->d_gain = autotune.proposed.d_gain;
+
+	autotune.state = AUTOTUNE_IDLE;
+	autotune.report = 1;
+	return 1;
+}
+
+
+/*!
+ *   Starts and stops the experiment on the flight mode. Called by the control
+ *   task at the end of every tick.
+ */
+void autotune_flight_mode(enum FlightModes flight_mode)
+{
+	if (autotune.state == AUTOTUNE_ARMED && flight_mode == STABILIZED)
+	{
+		output = autotune.relay_rad;
+		time_s = cycle_s = 0.0f;
+		error_min = error_max = 0.0f;
+		period_sum = amplitude_sum = 0.0f;
+		period_min = MAX_TIME_S;
+		period_max = 0.0f;
+		autotune.state = AUTOTUNE_RUNNING;
+		autotune.report = 1;
+	}
+	else if (autotune.state == AUTOTUNE_RUNNING && flight_mode != STABILIZED)
+		autotune_stop(AUTOTUNE_ABORTED);
+}
+
+
+/*!
+ *   Replaces the pid of the axis while running.
+ *   @param error Setpoint - attitude of the axis (rad)
+ *   @return The control surface (rad)
+ */
+float autotune_relay(float error, float dt)
+{
+	float limit = autotune.axis == AUTOTUNE_ROLL ? config.control.max_roll : config.control.max_pitch;
+
+	time_s += dt;
+	cycle_s += dt;
+
+	if (fabs(error) > limit || time_s > MAX_TIME_S)
+	{
+		autotune_stop(AUTOTUNE_ABORTED);
+		return 0.0f;
+	}
+
+	error_min = MIN(error_min, error);
+	error_max = MAX(error_max, error);
+
+	if (error > HYSTERESIS_RAD && output < 0.0f)
+	{
+		output = autotune.relay_rad;
+		autotune_cycle();
+	}
+	else if (error < -HYSTERESIS_RAD && output > 0.0f)
+		output = -autotune.relay_rad;
+
+	return autotune.state == AUTOTUNE_RUNNING ? output : 0.0f;
+}
+
+
+static void autotune_stop(enum AutotuneStates state)
+{
+	autotune.state = state;
+	autotune.report = 1;
+}
+
+
+/*!
+ *   A full oscillation ended at a rising switch of the relay.
+ */
+static void autotune_cycle()
+{
+	if (++autotune.cycles > SETTLE_CYCLES)
+	{
+		period_sum += cycle_s;
+		period_min = MIN(period_min, cycle_s);
+		period_max = MAX(period_max, cycle_s);
+		amplitude_sum += (error_max - error_min) * 0.5f;
+		autotune.report = 1;
+
+		if (autotune.cycles >= SETTLE_CYCLES + MEASURE_CYCLES)
+			autotune_compute();
+	}
+	cycle_s = 0.0f;
+	error_min = error_max = 0.0f;
+}
+
+
+/*!
+ *   Ku and Tu from the measured cycles, and the gains that follow.
+ */
+static void autotune_compute()
+{
+	const struct pid *current = autotune.axis == AUTOTUNE_ROLL ? &config.control.pid_roll2aileron : &config.control.pid_pitch2elevator;
+	float a = amplitude_sum / (float)MEASURE_CYCLES;
+	float p;
+
+	autotune.tu_s = period_sum / (float)MEASURE_CYCLES;
+
+	if (a < 2.0f * HYSTERESIS_RAD || period_max - period_min > MAX_PERIOD_SPREAD * autotune.tu_s)
+	{
+		autotune_stop(AUTOTUNE_ABORTED);
+		return;
+	}
+	autotune.ku = 4.0f * autotune.relay_rad / (PI * sqrtf(a*a - HYSTERESIS_RAD*HYSTERESIS_RAD));
+
+	// measured at the current airspeed, the configuration holds the gains for the cruising speed
+	p = 0.45f * autotune.ku / gain_schedule.factor;
+	if (current->p_gain > 0.0f)
+		p = BIND(p, current->p_gain / MAX_GAIN_CHANGE, current->p_gain * MAX_GAIN_CHANGE);
+
+	autotune.proposed = *current;
+	autotune.proposed.p_gain = MIN(p, MAX_P_GAIN);
+	autotune.proposed.i_gain = MIN(autotune.proposed.p_gain / (2.2f * autotune.tu_s), MAX_I_GAIN);   // Ti = 2.2 Tu
+	autotune.proposed.d_gain = MIN(autotune.proposed.p_gain * autotune.tu_s / 6.3f, MAX_D_GAIN);     // Td = Tu/6.3
+
+	autotune_stop(AUTOTUNE_DONE);
+}
@@ -0,0 +1,34 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include "task_control.h"
+
+enum AutotuneAxis { AUTOTUNE_NONE = 0, AUTOTUNE_ROLL = 1, AUTOTUNE_PITCH = 2 };
+
+enum AutotuneStates { AUTOTUNE_IDLE = 0, AUTOTUNE_ARMED = 1, AUTOTUNE_RUNNING = 2, AUTOTUNE_DONE = 3, AUTOTUNE_ABORTED = 4 };
+
+/*!
+ *   Relay feedback experiment on one attitude axis, and its result.
+ */
+struct Autotune
+{
+	enum AutotuneStates state;
+	enum AutotuneAxis axis;
+	float relay_rad;                 //!< Amplitude of the relay on the control surface
+	int cycles;                      //!< Oscillations measured so far
+
+	float ku;                        //!< Ultimate gain, surface rad / attitude rad
+	float tu_s;                      //!< Ultimate period
+	struct pid proposed;             //!< Gains for the cruising speed, valid when DONE
+
+	unsigned int report : 1;         //!< Set on every change, cleared by the telemetry task
+};
+
+extern struct Autotune autotune;
+
+void autotune_start(enum AutotuneAxis axis, float relay_deg);
+int autotune_apply();
+void autotune_flight_mode(enum FlightModes flight_mode);
+float autotune_relay(float error, float dt);
+
+#endif // AUTOTUNE_H
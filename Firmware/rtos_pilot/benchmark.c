@@ -0,0 +1,380 @@
+/*!
+ *  Deterministic benchmarks of the AHRS, PID, navigation and trigonometry kernels.
+ *
+ *  Every kernel is fed the same synthetic trace on every run, so the results
+ *  of two firmware versions can be compared directly. For each kernel the
+ *  execution time per call, the heap usage and the accuracy against a reference
+ *  are reported. Only the kernel call itself is timed, the generation of the
+ *  trace and the reference are not.
+ *
+ *  Started with the BM command (simulation mode only, the sensor task must not
+ *  overwrite sensor_data), results are sent as BM lines. Every call is timed
+ *  with the interrupts off, so neither the interrupts nor the other tasks are
+ *  counted. These are the figures of the dsPIC; the replay of recorded traces
+ *  with a baseline to compare against is tools/replay_bench, on the host.
+ *  In the MPLAB simulator, put a breakpoint around one of the benchmark_xxx
+ *  functions to count the cycles with the stopwatch.
+ *
+ *  @file     benchmark.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+// Include all FreeRTOS header files
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#include "microcontroller/microcontroller.h"
+#include "pid/pid.h"
+#include "fastmath/fastmath.h"
+
+#include "benchmark.h"
+#include "ahrs.h"
+#include "sensors.h"
+#include "configuration.h"
+#include "handler_navigation.h"
+#include "common.h"
+
+extern float cos_latitude;
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+#define AHRS_CALLS 3000          // 60s at 50Hz
+#define AHRS_SETTLE_CALLS 500    // not included in the error
+#define PID_CALLS 1000
+#define NAVIGATION_CALLS 500
+#define TRIGONOMETRY_CALLS 500
+
+#define BENCHMARK_LATITUDE_RAD DEG2RAD(50.9f)
+#define EARTH_RADIUS_M 6371000.0
+
+
+/*!
+ *   Microseconds since startup, based on the FreeRTOS tick and timer 1.
+ *   Timer 1 runs at 5MHz and overflows every tick (1ms).
+ */
+unsigned long benchmark_time_us()
+{
+	unsigned int tmr;
+	unsigned int overflow;
+	portTickType ticks;
+
+	INTERRUPT_PROTECT(tmr = TMR1; overflow = IFS0bits.T1IF; ticks = xTaskGetTickCount());
+	if (overflow && tmr < 2500)  // the tick interrupt is pending
+		ticks++;
+	return (unsigned long)ticks * 1000UL + (unsigned long)(tmr / 5);
+}
+
+
+static char saved_ipl;
+static unsigned long start_us;
+
+
+/*!
+ *   Starts the measurement of a call and turns the interrupts off. The call
+ *   has to end within a tick: benchmark_time_us() sees one pending tick.
+ */
+static void timing_start()
+{
+	SET_AND_SAVE_CPU_IPL(saved_ipl, 7);
+	start_us = benchmark_time_us();
+}
+
+
+static unsigned long timing_stop()
+{
+	unsigned long us = benchmark_time_us() - start_us;
+
+	RESTORE_CPU_IPL(saved_ipl);
+	return us;
+}
+
+
+/*!
+ *   Time of an empty measurement, substracted from every measured call.
+ */
+static unsigned long overhead_us()
+{
+	timing_start();
+	return timing_stop();
+}
+
+
+static void result_init(struct BenchmarkResult *result, const char *name)
+{
+	result->name = name;
+	result->calls = 0;
+	result->us_per_call = 0.0f;
+	result->error = 0.0f;
+	result->heap_used = 0;
+}
+
+
+static void result_finish(struct BenchmarkResult *result, unsigned long total_us, size_t heap_free_before)
+{
+	result->us_per_call = (float)total_us / (float)result->calls;
+	result->heap_used = (int)(heap_free_before - xPortGetFreeHeapSize());
+}
+
+
+/*!
+ *   Runs ahrs_filter() at 50Hz on a plane swinging in roll (+-30 deg, 8s) and
+ *   pitch (+-15 deg, 11s) without linear accelerations. The gyro has a constant
+ *   bias of 1 deg/s on p, which the filter has to remove.
+ *   Error: RMS of the roll and pitch error in degrees, after the filter settled.
+ *   Assumes config.sensors.neutral_pitch is 0.
+ */
+void benchmark_ahrs(struct BenchmarkResult *result)
+{
+	const float dt = 0.02f;
+	unsigned long total = 0, overhead = overhead_us();
+	size_t heap_free = xPortGetFreeHeapSize();
+	float sum_squared = 0.0f;
+	int i;
+
+	result_init(result, "ahrs");
+
+	sensor_data.gps.speed_ms = 0.0f;
+	sensor_data.gps.heading_rad = 0.0f;
+	sensor_data.vertical_speed = 0.0f;
+	sensor_data.yaw = 0.0f;
+	sensor_data.acc_x = 0.0f;
+	sensor_data.acc_y = 0.0f;
+	sensor_data.acc_z = -1.0f;
+	ahrs_init();
+
+	for (i = 1; i <= AHRS_CALLS; i++)
+	{
+		float time = (float)i * dt;
+		float roll = DEG2RAD(30.0f) * sinf(2.0f*PI/8.0f * time);
+		float pitch = DEG2RAD(15.0f) * sinf(2.0f*PI/11.0f * time);
+		float roll_dot = DEG2RAD(30.0f) * 2.0f*PI/8.0f * cosf(2.0f*PI/8.0f * time);
+		float pitch_dot = DEG2RAD(15.0f) * 2.0f*PI/11.0f * cosf(2.0f*PI/11.0f * time);
+
+		// inverse euler kinematics with a constant heading
+		sensor_data.p = roll_dot + DEG2RAD(1.0f);
+		sensor_data.q = pitch_dot * cosf(roll);
+		sensor_data.r = -pitch_dot * sinf(roll);
+		sensor_data.acc_x = sinf(pitch);
+		sensor_data.acc_y = -cosf(pitch) * sinf(roll);
+		sensor_data.acc_z = -cosf(pitch) * cosf(roll);
+
+		timing_start();
+		ahrs_filter(dt);
+		total += timing_stop() - overhead;
+
+		if (i > AHRS_SETTLE_CALLS)
+		{
+			float roll_error = RAD2DEG(sensor_data.roll - roll);
+			float pitch_error = RAD2DEG(sensor_data.pitch - pitch);
+			sum_squared += roll_error*roll_error + pitch_error*pitch_error;
+		}
+	}
+	result->calls = AHRS_CALLS;
+	result->error = sqrtf(sum_squared / (2.0f * (float)(AHRS_CALLS - AHRS_SETTLE_CALLS)));
+	result_finish(result, total, heap_free);
+}
+
+
+/*!
+ *   Runs pid_update() on a slowly varying error.
+ *   Error: maximum deviation from a textbook PID with the same gains.
+ */
+void benchmark_pid(struct BenchmarkResult *result)
+{
+	const float dt = 0.02f;
+	struct pid pid;
+	unsigned long total = 0, overhead = overhead_us();
+	size_t heap_free = xPortGetFreeHeapSize();
+	float i_state = 0.0f, last_position = 0.0f;
+	float max_error = 0.0f;
+	int i;
+
+	result_init(result, "pid");
+	pid_init(&pid, 0.1f, 1.2f, 0.3f, -0.5f, 0.5f, 0.0f);
+
+	for (i = 0; i < PID_CALLS; i++)
+	{
+		float position = 0.8f * sinf((float)i * 0.013f) + 0.1f * sinf((float)i * 0.17f);
+		float output, reference;
+
+		timing_start();
+		output = pid_update(&pid, position, dt);
+		total += timing_stop() - overhead;
+
+		i_state = BIND(i_state + position * dt, -0.5f, 0.5f);
+		reference = 1.2f * position + 0.3f * i_state + 0.1f * (position - last_position) / dt;
+		last_position = position;
+
+		max_error = MAX(max_error, fabs(output - reference));
+	}
+	result->calls = PID_CALLS;
+	result->error = max_error;
+	result_finish(result, total, heap_free);
+}
+
+
+/*!
+ *   Runs navigation_heading_rad_fromto() on points around a 1km circle.
+ *   Error: maximum deviation from atan2 in degrees.
+ */
+void benchmark_navigation_heading(struct BenchmarkResult *result)
+{
+	unsigned long total = 0, overhead = overhead_us();
+	size_t heap_free = xPortGetFreeHeapSize();
+	float saved_cos_latitude = cos_latitude;
+	float max_error = 0.0f;
+	int i;
+
+	result_init(result, "heading");
+	cos_latitude = cosf(BENCHMARK_LATITUDE_RAD);
+
+	for (i = 0; i < NAVIGATION_CALLS; i++)
+	{
+		float bearing = (float)i * (2.0f*PI / (float)NAVIGATION_CALLS) + 0.001f;
+		// difference between the current position and the waypoint
+		float diff_lat = -1000.0f * cosf(bearing) / latitude_meter_per_radian;
+		float diff_long = -1000.0f * sinf(bearing) / (latitude_meter_per_radian * cos_latitude);
+		float heading, error;
+
+		timing_start();
+		heading = navigation_heading_rad_fromto(diff_long, diff_lat);
+		total += timing_stop() - overhead;
+
+		error = fabs(heading - bearing);
+		if (error > PI)
+			error = 2.0f*PI - error;
+		max_error = MAX(max_error, RAD2DEG(error));
+	}
+	cos_latitude = saved_cos_latitude;
+
+	result->calls = NAVIGATION_CALLS;
+	result->error = max_error;
+	result_finish(result, total, heap_free);
+}
+
+
+/*!
+ *   Runs navigation_distance_between_meter() on pairs of points up to 2km apart.
+ *   Error: maximum deviation from the haversine formula in meter.
+ */
+void benchmark_navigation_distance(struct BenchmarkResult *result)
+{
+	unsigned long total = 0, overhead = overhead_us();
+	size_t heap_free = xPortGetFreeHeapSize();
+	float saved_longitude_meter_per_radian = longitude_meter_per_radian;
+	float max_error = 0.0f;
+	int i;
+
+	result_init(result, "distance");
+	longitude_meter_per_radian = latitude_meter_per_radian * cosf(BENCHMARK_LATITUDE_RAD);
+
+	for (i = 0; i < NAVIGATION_CALLS; i++)
+	{
+		float lat1 = BENCHMARK_LATITUDE_RAD;
+		float long1 = DEG2RAD(4.0f);
+		float lat2 = lat1 + (float)(i % 23 - 11) * (180.0f / 11.0f) / latitude_meter_per_radian;
+		float long2 = long1 + (float)(i % 19 - 9) * (220.0f / 9.0f) / longitude_meter_per_radian;
+		float distance;
+		double a;
+
+		timing_start();
+		distance = navigation_distance_between_meter(long1, long2, lat1, lat2);
+		total += timing_stop() - overhead;
+
+		a = sin((lat2 - lat1) / 2.0) * sin((lat2 - lat1) / 2.0) +
+		    cos(lat1) * cos(lat2) * sin((long2 - long1) / 2.0) * sin((long2 - long1) / 2.0);
+		max_error = MAX(max_error, fabs(distance - 2.0 * EARTH_RADIUS_M * atan2(sqrt(a), sqrt(1.0 - a))));
+	}
+	longitude_meter_per_radian = saved_longitude_meter_per_radian;
+
+	result->calls = NAVIGATION_CALLS;
+	result->error = max_error;
+	result_finish(result, total, heap_free);
+}
+
+
+/*!
+ *   Runs sin, cos, atan2 and sqrt on angles between -PI and PI, using either
+ *   the fastmath library or libm.
+ *   Error: maximum deviation of the fastmath results from libm.
+ */
+static void benchmark_trigonometry(struct BenchmarkResult *result, int use_libm)
+{
+	unsigned long total = 0, overhead = overhead_us();
+	size_t heap_free = xPortGetFreeHeapSize();
+	float max_error = 0.0f;
+	int i;
+
+	result_init(result, use_libm ? "libm" : "fastmath");
+
+	for (i = 0; i < TRIGONOMETRY_CALLS; i++)
+	{
+		float x = (float)i * (2.0f*PI / (float)TRIGONOMETRY_CALLS) - PI;
+		float s, c, a, r;
+
+		timing_start();
+		if (use_libm)
+		{
+			s = sinf(x);
+			c = cosf(x);
+			a = atan2f(s, c);
+			r = sqrtf(s*s + 1.0f);
+		}
+		else
+		{
+			s = fast_sin(x);
+			c = fast_cos(x);
+			a = fast_atan2(s, c);
+			r = fast_sqrt(s*s + 1.0f);
+		}
+		total += timing_stop() - overhead;
+
+		max_error = MAX(max_error, fabs(s - sinf(x)));
+		max_error = MAX(max_error, fabs(c - cosf(x)));
+		max_error = MAX(max_error, fabs(a - atan2f(s, c)));
+		max_error = MAX(max_error, fabs(r - sqrtf(s*s + 1.0f)));
+	}
+	result->calls = TRIGONOMETRY_CALLS;
+	result->error = max_error;
+	result_finish(result, total, heap_free);
+}
+
+
+void benchmark_fastmath(struct BenchmarkResult *result)
+{
+	benchmark_trigonometry(result, 0);
+}
+
+
+void benchmark_libm(struct BenchmarkResult *result)
+{
+	benchmark_trigonometry(result, 1);
+}
+
+
+/*!
+ *   Runs all benchmarks and passes each result to printer.
+ *   The attitude filter is re-initialized afterwards.
+ */
+void benchmark_run(void (*printer)(struct BenchmarkResult *))
+{
+	struct BenchmarkResult result;
+
+	benchmark_ahrs(&result);
+	printer(&result);
+	benchmark_pid(&result);
+	printer(&result);
+	benchmark_navigation_heading(&result);
+	printer(&result);
+	benchmark_navigation_distance(&result);
+	printer(&result);
+	benchmark_fastmath(&result);
+	printer(&result);
+	benchmark_libm(&result);
+	printer(&result);
+
+	ahrs_init();
+}
@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*!
+ *   Result of one benchmarked kernel.
+ *   The error is kernel specific: RMS attitude error (deg) for the AHRS,
+ *   maximum deviation from the reference implementation for the others.
+ */
+struct BenchmarkResult
+{
+	const char *name;
+	unsigned int calls;
+	float us_per_call;
+	float error;
+	int heap_used;                   //!< Bytes allocated from the FreeRTOS heap during the run, should be 0
+};
+
+unsigned long benchmark_time_us();
+
+void benchmark_ahrs(struct BenchmarkResult *result);
+void benchmark_pid(struct BenchmarkResult *result);
+void benchmark_navigation_heading(struct BenchmarkResult *result);
+void benchmark_navigation_distance(struct BenchmarkResult *result);
+void benchmark_fastmath(struct BenchmarkResult *result);
+void benchmark_libm(struct BenchmarkResult *result);
+
+void benchmark_run(void (*printer)(struct BenchmarkResult *));
+
+#endif // BENCHMARK_H
@@ -20,6 +20,8 @@ struct TelemetryConfig
  *    FreeRTOS task that sends telemetry to uart1
  */
 void communication_telemetry_task( void *parameters );
+int communication_telemetry_init();
+int communication_telemetry_step();
 
 void communication_input_task( void *parameters );
 
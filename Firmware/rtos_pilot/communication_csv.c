@@ -4,8 +4,10 @@
  *  Consists of 2 tasks: telemetry (continuous output) and input (respond to commands).
  *
  *   Commands:
- *   Telemetry: TR, TP, TA, TH, TT, TG
- *   Other: ST, SA, SI, SG, PP, PR, PH, FC, LC, LD, RC
+ *   Telemetry: TR, TV, TP, TA, TH, TT, TG, TW
+ *   Other: ST, SA, SI, SG, SH, PP, PR, PH, CM, GT, FC, LC, LD, RC, HI, BM
+ *   Binary hardware-in-the-loop frames are mixed in the same stream, see hil.h
+ *   Uplink frames: $#sequence;command...*checksum, acknowledged, see uplink_receive()
  *
  *  @file     communication_csv.c
  *  @author   Tom Pycke
@@ -37,7 +39,18 @@
 #include "configuration.h"
 #include "task_datalogger.h"
 #include "handler_navigation.h"
+#include "wind_estimator.h"
+#include "handler_geofence.h"
 #include "handler_alarms.h"
+#include "hil.h"
+#include "benchmark.h"
+#include "autotune.h"
+#include "stack_monitor.h"
+#include "jobs.h"
+#include "geotag.h"
+#include "magnetometer.h"
+#include "gyro_temperature.h"
+#include "sensor_health.h"
 
 #include "common.h"
 
@@ -46,6 +59,11 @@ void print_signed_integer(int x, void (*printer)(char[]));
 void print_unsigned_integer(unsigned int x, void (*printer)(char[]));
 void print_logline(struct LogLine *l);
 void print_logline_simulation(struct LogLine *l);
+void print_benchmark_result(struct BenchmarkResult *r);
+void print_stack_report();
+void print_jobs();
+void print_geotag_event(struct GeotagEvent *e);
+static int uplink_busy();
 
 void print_configuration();
 void print_navigation();
@@ -96,23 +114,15 @@ int check_checksum(char *s);
 
 xSemaphoreHandle xUart1Semaphore;
 
+static struct TelemetryConfig counters;
+
 /*!
- *    This task will send telemetry directly to uart1 at a rate of maximum 
- *    20 times a second.
- *
- *    Used stackspace: 356 / 860 bytes
+ *    Prepares the telemetry and sends the configuration and the flightplan
+ *    once.
  */
-void communication_telemetry_task( void *parameters )
+int communication_telemetry_init()
 {
-	int c = 0;
-	struct TelemetryConfig counters;
-		
-	/* Used to wake the task at the correct frequency. */
-	portTickType xLastExecutionTime;
-
-
 	uart1_puts("Telemetry task initializing...");
-	vTaskSetApplicationTaskTag( NULL, ( void * ) 6 );
 	vSemaphoreCreateBinary(xUart1Semaphore);
 	
 	counters.stream_PPM = 0;
@@ -131,6 +141,23 @@ void communication_telemetry_task( void *parameters )
 	print_configuration();
 	vTaskDelay( ( ( portTickType ) 100 / portTICK_RATE_MS ) ); 
 	print_navigation();
+	return 1;
+}
+
+
+/*!
+ *    This task will send telemetry directly to uart1 at a rate of maximum 
+ *    20 times a second.
+ *
+ *    Used stackspace: 356 / 860 bytes
+ */
+void communication_telemetry_task( void *parameters )
+{
+	/* Used to wake the task at the correct frequency. */
+	portTickType xLastExecutionTime;
+
+	vTaskSetApplicationTaskTag( NULL, ( void * ) 6 );
+	communication_telemetry_init();
 
 	/* Initialise xLastExecutionTime so the first call to vTaskDelayUntil() works correctly. */
 	xLastExecutionTime = xTaskGetTickCount();
@@ -138,188 +165,333 @@ void communication_telemetry_task( void *parameters )
 	for( ;; )
 	{
 		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 100 / portTICK_RATE_MS ) );  // 10Hz
-		counters.stream_PPM++;
-		counters.stream_GyroAccRaw++;
-		counters.stream_GyroAccProc++;
-		counters.stream_PressureTemp++;
-		counters.stream_GpsBasic++;
-		counters.stream_Attitude++;
-		counters.stream_Control++;
-		
-		if (c++ % 5 == 0)  // this counter will never be used at 20Hz
-			led1_on();
-		else
-			led1_off();
+		communication_telemetry_step();
+	}
+}
 
+
+/*!
+ *    Sends the telemetry streams that are due. Called at 10Hz, by the
+ *    telemetry task or as a job (see jobs.c).
+ */
+int communication_telemetry_step()
+{
+	static int c = 0;
 #ifdef ENABLE_XBEE_RESET
-		if (c % 3000 == 0) // reset Xbee every 5 minutes to prevent a lock-up (duty cycle)
-		{
-			//uart1_puts("\r\nResetting XBEE...\r\n") ;
-			vTaskDelay( ( ( portTickType ) 1001 / portTICK_RATE_MS ) ); // guard time wait 1000ms
+	static int xbee_reset = 0;
+#endif
+
+	counters.stream_PPM++;
+	counters.stream_GyroAccRaw++;
+	counters.stream_GyroAccProc++;
+	counters.stream_PressureTemp++;
+	counters.stream_GpsBasic++;
+	counters.stream_Attitude++;
+	counters.stream_Control++;
+	
+	if (c++ % 5 == 0)  // this counter will never be used at 20Hz
+		led1_on();
+	else
+		led1_off();
+
+	if (c % 100 == 0)
+		stack_monitor_update();
+
+#ifdef ENABLE_XBEE_RESET
+	if (c % 3000 == 0) // reset Xbee every 5 minutes to prevent a lock-up (duty cycle)
+		xbee_reset = 1;
+	if (xbee_reset > 0)
+	{
+		// no telemetry during the guard times of 1s, without blocking: this may run as a job
+		//uart1_puts("\r\nResetting XBEE...\r\n") ;
+		if (xbee_reset == 11)
 			uart1_puts("+++");
-			vTaskDelay( ( ( portTickType ) 1001 / portTICK_RATE_MS ) ); // guard time wait 1000ms
-			uart1_puts("ATFR\r\n") ;
-			vTaskDelay( ( ( portTickType ) 10 / portTICK_RATE_MS ) ); // wait 10ms
-		}	
-#endif 
-		if (battery_alarm.alarm_battery_warning == 1)
-		{
-			printf_message("Warning: Battery low\r\n");
-			// clear the flag so it is printed every few seconds
-			battery_alarm.alarm_battery_warning = 0;
-		}
-		else if (battery_alarm.alarm_battery_panic == 1)
+		else if (xbee_reset == 22)
 		{
-			// print this once 
-			printf_message("!!! Panic: Battery low !!!\r\n");
-			battery_alarm.alarm_battery_panic++; // an ugly hack to make sure it's never printed again
+			uart1_puts("ATFR\r\n") ;
+			xbee_reset = -1;
 		}
-				
-		///////////////////////////////////////////////////////////////
-		//               GYRO AND ACCELEROMETER RAW                  //
-		///////////////////////////////////////////////////////////////
-		if (counters.stream_GyroAccRaw == config.telemetry.stream_GyroAccRaw)
-		{
-			printf_checksum_direct("TR;%u;%u;%u;%u;%u;%u", (sensor_data.acc_x_raw), (sensor_data.acc_y_raw),
-			                                    (sensor_data.acc_z_raw), (sensor_data.gyro_x_raw),
-			                                    (sensor_data.gyro_y_raw), (sensor_data.gyro_z_raw));
-			counters.stream_GyroAccRaw = 0;
-		} 
-		else if (counters.stream_GyroAccRaw > config.telemetry.stream_GyroAccRaw)
-			counters.stream_GyroAccRaw = 0;
-		
-		///////////////////////////////////////////////////////////////
-		//            GYRO AND ACCELEROMETER PROCESSED              //
-		///////////////////////////////////////////////////////////////
-		if (counters.stream_GyroAccProc == config.telemetry.stream_GyroAccProc)
-		{
-			printf_checksum_direct("TP;%d;%d;%d;%d;%d;%d", (int)(sensor_data.acc_x*1000), (int)(sensor_data.acc_y*1000),
-			                                        (int)(sensor_data.acc_z*1000), (int)(sensor_data.p*1000),
-			                                        (int)(sensor_data.q*1000), (int)(sensor_data.r*1000));
-		}	
-		else if (counters.stream_GyroAccProc > config.telemetry.stream_GyroAccProc)
-			counters.stream_GyroAccProc = 0;
-		
-		///////////////////////////////////////////////////////////////
-		//                         ATTITUDE                          //
-		///////////////////////////////////////////////////////////////	
-		if (counters.stream_Attitude == config.telemetry.stream_Attitude)
-		{
-            int *t = (int*)&sensor_data.pitch;
-
-			printf_checksum_direct("TA;%d;%d;%d;%x;%x", (int)(sensor_data.roll*1000), (int)(sensor_data.pitch*1000), (int)(sensor_data.yaw*1000), t[1], t[0]);
-
-			if (control_state.simulation_mode)
-			{
-				printf_checksum_direct("TS;%d;%d;%d", servo_read_us(2), servo_read_us(0), servo_read_us(3));
-			}
-			counters.stream_Attitude = 0;
-		} 
-		else if (counters.stream_Attitude > config.telemetry.stream_Attitude)
-			counters.stream_Attitude = 0;
+		xbee_reset++;
+		return 1;
+	}
+#endif 
+	if (uplink_busy())   // an upload is going on: leave the link to its acks
+		return 1;
+
+	if (battery_alarm.alarm_battery_warning == 1)
+	{
+		printf_message("Warning: Battery low\r\n");
+		// clear the flag so it is printed every few seconds
+		battery_alarm.alarm_battery_warning = 0;
+	}
+	else if (battery_alarm.alarm_battery_panic == 1)
+	{
+		// print this once 
+		printf_message("!!! Panic: Battery low !!!\r\n");
+		battery_alarm.alarm_battery_panic++; // an ugly hack to make sure it's never printed again
+	}
+
+	///////////////////////////////////////////////////////////////
+	//                    PID AUTO-TUNE STATUS                   //
+	///////////////////////////////////////////////////////////////
+	if (autotune.report)
+	{
+		// state; axis; cycles; Ku x1000; Tu (ms); proposed p, i, d x1000
+		autotune.report = 0;
+		printf_checksum("TU;%d;%d;%d;%d;%d;%d;%d;%d", (int)autotune.state, (int)autotune.axis, autotune.cycles,
+		                (int)(autotune.ku*1000.0f), (int)(autotune.tu_s*1000.0f),
+		                (int)(autotune.proposed.p_gain*1000.0f), (int)(autotune.proposed.i_gain*1000.0f),
+		                (int)(autotune.proposed.d_gain*1000.0f));
+	}
 			
-		///////////////////////////////////////////////////////////////
-		//           SCP1000: PRESSURE & TEMPERATURE                 //
-		///////////////////////////////////////////////////////////////
-		if (counters.stream_PressureTemp == config.telemetry.stream_PressureTemp)
+	///////////////////////////////////////////////////////////////
+	//               GYRO AND ACCELEROMETER RAW                  //
+	///////////////////////////////////////////////////////////////
+	if (counters.stream_GyroAccRaw == config.telemetry.stream_GyroAccRaw)
+	{
+		printf_checksum_direct("TR;%u;%u;%u;%u;%u;%u", (sensor_data.acc_x_raw), (sensor_data.acc_y_raw),
+		                                    (sensor_data.acc_z_raw), (sensor_data.gyro_x_raw),
+		                                    (sensor_data.gyro_y_raw), (sensor_data.gyro_z_raw));
+		printf_checksum_direct("TV;%u;%u;%u;%u;%u;%u;%u;%u;%u", sensor_health.acc_vibration[0], sensor_health.acc_vibration[1],
+		                       sensor_health.acc_vibration[2], sensor_health.gyro_vibration[0],
+		                       sensor_health.gyro_vibration[1], sensor_health.gyro_vibration[2],
+		                       sensor_health.acc_clipped, sensor_health.gyro_clipped, (unsigned int)sensor_health_flags());
+		counters.stream_GyroAccRaw = 0;
+	} 
+	else if (counters.stream_GyroAccRaw > config.telemetry.stream_GyroAccRaw)
+		counters.stream_GyroAccRaw = 0;
+	
+	///////////////////////////////////////////////////////////////
+	//            GYRO AND ACCELEROMETER PROCESSED              //
+	///////////////////////////////////////////////////////////////
+	if (counters.stream_GyroAccProc == config.telemetry.stream_GyroAccProc)
+	{
+		printf_checksum_direct("TP;%d;%d;%d;%d;%d;%d", (int)(sensor_data.acc_x*1000), (int)(sensor_data.acc_y*1000),
+		                                        (int)(sensor_data.acc_z*1000), (int)(sensor_data.p*1000),
+		                                        (int)(sensor_data.q*1000), (int)(sensor_data.r*1000));
+	}	
+	else if (counters.stream_GyroAccProc > config.telemetry.stream_GyroAccProc)
+		counters.stream_GyroAccProc = 0;
+	
+	///////////////////////////////////////////////////////////////
+	//                         ATTITUDE                          //
+	///////////////////////////////////////////////////////////////	
+	if (counters.stream_Attitude == config.telemetry.stream_Attitude)
+	{
+        int *t = (int*)&sensor_data.pitch;
+
+		printf_checksum_direct("TA;%d;%d;%d;%x;%x", (int)(sensor_data.roll*1000), (int)(sensor_data.pitch*1000), (int)(sensor_data.yaw*1000), t[1], t[0]);
+
+		if (control_state.simulation_mode)
 		{
-			printf_checksum_direct("TH;%lu;%d", (unsigned long)(sensor_data.pressure), (int)sensor_data.temperature);
-			counters.stream_PressureTemp = 0;
+			printf_checksum_direct("TS;%d;%d;%d", servo_read_us(2), servo_read_us(0), servo_read_us(3));
 		}
-		else if (counters.stream_PressureTemp > config.telemetry.stream_PressureTemp)
-			counters.stream_PressureTemp = 0;
+		counters.stream_Attitude = 0;
+	} 
+	else if (counters.stream_Attitude > config.telemetry.stream_Attitude)
+		counters.stream_Attitude = 0;
 		
-		///////////////////////////////////////////////////////////////
-		//                   RC TRANSMITTER INPUT                    //
-		///////////////////////////////////////////////////////////////
-		if (counters.stream_PPM == config.telemetry.stream_PPM)
-		{
-			//vTaskGetRunTimeStats( buffer );
-			//uart1_puts(buffer);
-			printf_checksum_direct("TT;%u;%u;%u;%u;%u;%u;%u;%u", (unsigned int)ppm.channel[0], (unsigned int)ppm.channel[1],
-			                                          (unsigned int)ppm.channel[2], (unsigned int)ppm.channel[3],
-			                                          (unsigned int)ppm.channel[4], (unsigned int)ppm.channel[5],
-			                                          (unsigned int)ppm.channel[6], (unsigned int)ppm.channel[7]);
-			counters.stream_PPM = 0;
-		}
-		else if (counters.stream_PPM > config.telemetry.stream_PPM)
-			counters.stream_PPM = 0;
+	///////////////////////////////////////////////////////////////
+	//           SCP1000: PRESSURE & TEMPERATURE                 //
+	///////////////////////////////////////////////////////////////
+	if (counters.stream_PressureTemp == config.telemetry.stream_PressureTemp)
+	{
+		printf_checksum_direct("TH;%lu;%d", (unsigned long)(sensor_data.pressure), (int)sensor_data.temperature);
+		counters.stream_PressureTemp = 0;
+	}
+	else if (counters.stream_PressureTemp > config.telemetry.stream_PressureTemp)
+		counters.stream_PressureTemp = 0;
+	
+	///////////////////////////////////////////////////////////////
+	//                   RC TRANSMITTER INPUT                    //
+	///////////////////////////////////////////////////////////////
+	if (counters.stream_PPM == config.telemetry.stream_PPM)
+	{
+		//vTaskGetRunTimeStats( buffer );
+		//uart1_puts(buffer);
+		printf_checksum_direct("TT;%u;%u;%u;%u;%u;%u;%u;%u", (unsigned int)ppm.channel[0], (unsigned int)ppm.channel[1],
+		                                          (unsigned int)ppm.channel[2], (unsigned int)ppm.channel[3],
+		                                          (unsigned int)ppm.channel[4], (unsigned int)ppm.channel[5],
+		                                          (unsigned int)ppm.channel[6], (unsigned int)ppm.channel[7]);
+		counters.stream_PPM = 0;
+	}
+	else if (counters.stream_PPM > config.telemetry.stream_PPM)
+		counters.stream_PPM = 0;
+	
+	///////////////////////////////////////////////////////////////
+	//                        GPS BASIC                          //
+	///////////////////////////////////////////////////////////////
+	if (counters.stream_GpsBasic == config.telemetry.stream_GpsBasic)
+	{
+		printf_checksum_direct("TG;%c;%.9f;%.9f;%u;%u;%u;%u", '0' + (unsigned char)sensor_data.gps.status,
+		                                            sensor_data.gps.latitude_rad, sensor_data.gps.longitude_rad,
+		                                            (unsigned int)(sensor_data.gps.speed_ms*10),
+		                                            (unsigned int)(sensor_data.gps.heading_rad*100),
+		                                            (unsigned int)(sensor_data.gps.satellites_in_view),
+		                                            (unsigned int)(sensor_data.gps.height_m));
+		// wind: speed (0.1m/s); comes from (deg); airspeed (0.1m/s); confidence (%)
+		printf_checksum_direct("TW;%u;%u;%u;%u", (unsigned int)(wind_estimate.speed_ms*10),
+		                       (unsigned int)RAD2DEG(wind_estimate.from_rad),
+		                       (unsigned int)(wind_estimate.airspeed_ms*10),
+		                       (unsigned int)wind_estimate.confidence);
+		counters.stream_GpsBasic = 0;
+	}
+	else if (counters.stream_GpsBasic > config.telemetry.stream_GpsBasic)
+		counters.stream_GpsBasic = 0;
 		
-		///////////////////////////////////////////////////////////////
-		//                        GPS BASIC                          //
-		///////////////////////////////////////////////////////////////
-		if (counters.stream_GpsBasic == config.telemetry.stream_GpsBasic)
-		{
-			printf_checksum_direct("TG;%c;%.9f;%.9f;%u;%u;%u;%u", '0' + (unsigned char)sensor_data.gps.status,
-			                                            sensor_data.gps.latitude_rad, sensor_data.gps.longitude_rad,
-			                                            (unsigned int)(sensor_data.gps.speed_ms*10),
-			                                            (unsigned int)(sensor_data.gps.heading_rad*100),
-			                                            (unsigned int)(sensor_data.gps.satellites_in_view),
-			                                            (unsigned int)(sensor_data.gps.height_m));
-			counters.stream_GpsBasic = 0;
-		}
-		else if (counters.stream_GpsBasic > config.telemetry.stream_GpsBasic)
-			counters.stream_GpsBasic = 0;
-			
-		///////////////////////////////////////////////////////////////
-		//                          CONTROL                          //
-		///////////////////////////////////////////////////////////////
-		//printf("TC;CONTROL_STATUS;LINE;HEIGHT(;CARROTX;CARROTY;CARROTH)");
-		if (counters.stream_Control == config.telemetry.stream_Control)
+	///////////////////////////////////////////////////////////////
+	//                          CONTROL                          //
+	///////////////////////////////////////////////////////////////
+	//printf("TC;CONTROL_STATUS;LINE;HEIGHT(;CARROTX;CARROTY;CARROTH)");
+	if (counters.stream_Control == config.telemetry.stream_Control)
+	{
+		int sig_quality = 0;
+		if (config.control.use_pwm)
+        {
+        	if (ppm.connection_alive)
+        		sig_quality = 100;
+        	else
+        		sig_quality = 0;
+        } else // ppm
+        	sig_quality = (100-ppm_signal_quality()*4);  // %
+        	
+		int throttle = (config.control.servo_neutral[3] - (int)servo_read_us(3))/10;
+		if (! config.control.reverse_servo4)
+			throttle = -throttle;
+		if (throttle < 0 || throttle > 100)
+			throttle = 0;
+		//printf("\r\n %d %d\r\n", config.control.servo_neutral[3], (int)servo_read_us(3));
+		
+        int altitude = (int)gluonscript_live_variable(HEIGHT);
+        
+		printf_checksum_direct("TC;%d;%d;%d;%u;%d;%d;%d;%d;%d;%d;%u", (int)control_state.flight_mode,
+		       gluonscript_context.current_codeline, altitude,
+		       sensor_data.battery1_voltage_10,
+		       navigation_data.time_airborne_s, gluonscript_context.time_block_s,
+		       sig_quality, throttle, (int)navigation_data.desired_altitude_agl,
+               sensor_data.battery2_voltage_10,(unsigned int)(sensor_data.battery1_mAh/10.0));
+
+		// gluonscript context: line; return addresses; the last one; stack errors
 		{
-			int sig_quality = 0;
-			if (config.control.use_pwm)
-            {
-	        	if (ppm.connection_alive)
-	        		sig_quality = 100;
-	        	else
-	        		sig_quality = 0;
-	        } else // ppm
-            	sig_quality = (100-ppm_signal_quality()*4);  // %
-            	
-			int throttle = (config.control.servo_neutral[3] - (int)servo_read_us(3))/10;
-			if (! config.control.reverse_servo4)
-				throttle = -throttle;
-			if (throttle < 0 || throttle > 100)
-				throttle = 0;
-			//printf("\r\n %d %d\r\n", config.control.servo_neutral[3], (int)servo_read_us(3));
-			
-            int altitude;
-            if (config.control.altitude_mode == GPS_ABSOLUTE)
-                altitude =  sensor_data.gps.height_m;
-            else if (config.control.altitude_mode == GPS_RELATIVE)
-                altitude = sensor_data.gps.height_m - navigation_data.home_gps_height;
-            else //if (config.control.altitude_mode == PRESSURE)
-                altitude = (int)(sensor_data.pressure_height - navigation_data.home_pressure_height);
-            
-			printf_checksum_direct("TC;%d;%d;%d;%u;%d;%d;%d;%d;%d;%d;%u", (int)control_state.flight_mode,
-			       gluonscript_data.current_codeline, altitude,
-			       sensor_data.battery1_voltage_10,
-			       navigation_data.time_airborne_s, navigation_data.time_block_s,
-			       sig_quality, throttle, (int)navigation_data.desired_altitude_agl,
-                   sensor_data.battery2_voltage_10,(unsigned int)(sensor_data.battery1_mAh/10.0));
-			 
-			counters.stream_Control = 0;
-			//printf_checksum_poll("-- %lu --", idle_counter);
-            //idle_counter = 0;
-			//printf_checksum_poll("-- %lu --", idle_counter);
+			struct GluonscriptContext context;
+			gluonscript_get_context(&context);
+			printf_checksum_direct("TN;%d;%d;%d;%u", context.current_codeline, context.stack_depth,
+			                       context.stack_depth > 0 ? context.stack[context.stack_depth - 1] : -1,
+			                       context.stack_errors);
 		}
-		else if (counters.stream_Control > config.telemetry.stream_Control)
-			counters.stream_Control = 0;
+		 
+		counters.stream_Control = 0;
+		//printf_checksum_poll("-- %lu --", idle_counter);
+        //idle_counter = 0;
+		//printf_checksum_poll("-- %lu --", idle_counter);
+	}
+	else if (counters.stream_Control > config.telemetry.stream_Control)
+		counters.stream_Control = 0;
+
+	return 1;
+}
+
+
+#define MAX_TOKEN 11
+#define UPLINK_SEQUENCES 256
+#define UPLINK_QUIET_MS 500         //!< telemetry is paused until this long after the last frame
+
+/*!
+ *   Uplink frames are command lines with a sequence number in front:
+ *   $#12;WN;3;...*checksum. They are executed in order, each one once:
+ *    - the expected frame is executed and acknowledged: KA;sequence;free
+ *    - a frame that was executed before (its ack was lost) is acknowledged
+ *      again, not executed
+ *    - a damaged frame, or one further than the expected (frames were lost),
+ *      is answered with KN;expected;free, once per expected frame: the
+ *      sender goes back to it. Lost acks and nacks are covered by the
+ *      timeout of the sender.
+ *   "free" is the free space in the receive buffer (bytes): the sender keeps
+ *   less than that in flight. KR starts at sequence 0.
+ *   While frames arrive, telemetry is paused so the acks get through quickly.
+ *   Lines without a sequence number work as before.
+ */
+static struct
+{
+	unsigned int expected;
+	int nacked;                     //!< expected sequence that was nacked, -1 when none
+	portTickType last_frame;
+	int active;
+	unsigned int frames;
+	unsigned int duplicates;
+	unsigned int nacks;
+} uplink = { 0, -1, 0, 0, 0, 0, 0 };
+
+
+static void uplink_acknowledge(unsigned int sequence)
+{
+	printf_checksum("KA;%u;%d", sequence, uart1_rx_free());
+}
+
+
+static void uplink_nack()
+{
+	if (uplink.nacked == (int)uplink.expected)
+		return;
+	uplink.nacked = uplink.expected;
+	uplink.nacks++;
+	printf_checksum("KN;%u;%d", uplink.expected, uart1_rx_free());
+}
+
+
+/*!
+ *   Decides what to do with a frame, answers the ones that aren't executed.
+ *   @param valid 0 when the checksum was wrong
+ *   @return 1 when the command is to be executed and acknowledged
+ */
+static int uplink_receive(int valid, unsigned int sequence)
+{
+	unsigned int behind;
+
+	uplink.last_frame = xTaskGetTickCount();
+	uplink.active = 1;
+	if (! valid)
+	{
+		uplink_nack();
+		return 0;
+	}
 
+	sequence %= UPLINK_SEQUENCES;
+	if (sequence == uplink.expected)
+	{
+		uplink.expected = (uplink.expected + 1) % UPLINK_SEQUENCES;
+		uplink.nacked = -1;
+		uplink.frames++;
+		return 1;
+	}
+	behind = (uplink.expected + UPLINK_SEQUENCES - sequence) % UPLINK_SEQUENCES;
+	if (behind <= UPLINK_SEQUENCES / 2)
+	{
+		uplink.duplicates++;
+		uplink_acknowledge(sequence);
 	}
+	else
+		uplink_nack();
+	return 0;
 }
 
 
-extern xQueueHandle xRxedChars;
+/*!
+ *   @return 1 during an upload: no telemetry
+ */
+static int uplink_busy()
+{
+	if (uplink.active && (portTickType)(xTaskGetTickCount() - uplink.last_frame) > UPLINK_QUIET_MS / portTICK_RATE_MS)
+		uplink.active = 0;
+	return uplink.active;
+}
 
-#define MAX_TOKEN 10
 
 /*!
  *   This task parses and executes all commands coming from the groundstation
  *   or configuration utility. It depends on uart1_queue.c because all data received
- *   on the uart1 is stored in a FreeRTOS queue. When there is data in the queue, the
- *   RTOS executes this function so the data can be parsed.
+ *   on the uart1 is stored in its receive buffer. The bytes are taken from it in
+ *   blocks and parsed one by one.
  *
  *   Measured used stackspace: 388 / 2150 bytes
  *
@@ -330,10 +502,15 @@ void communication_input_task( void *parameters )
 	static int   buffer_position;
 	static int   token[MAX_TOKEN+1] = {0,0,0,0,0,0,0,0,0,0,0};
 	static int   current_token;
+	static unsigned char rx_block[64];
+	int rx_length = 0, rx_position = 0;
 	
 	char tmp;
+	int i;
 
     int with_checksum = 0;  // did we receive the last line with a checksum?
+    int framed = 0;         // uplink frame: with a sequence number
+    unsigned int sequence = 0;
 
     vTaskSetApplicationTaskTag( NULL, ( void * ) 4 );
 
@@ -343,12 +520,29 @@ void communication_input_task( void *parameters )
 	for( ;; )
 	{
 		/* Wait until it is time for the next cycle. */
-		if( xQueueReceive( xRxedChars, &tmp, portMAX_DELAY  ) )
+		if (rx_position >= rx_length)
+		{
+			rx_length = uart1_read(rx_block, sizeof(rx_block), portMAX_DELAY);
+			rx_position = 0;
+		}
+		if (rx_position < rx_length)
         {           
+            tmp = (char)rx_block[rx_position++];
+            if (hil_parse_byte((unsigned char)tmp))  // binary hardware-in-the-loop frame
+                continue;
+
             if (tmp == '\n' || tmp == '\r')
             {
 	            buffer[buffer_position] = '\0';
 	            //printf("\r\nChecking checksum: %s\r\n", buffer);
+	            framed = buffer[0] == '$' && buffer[1] == '#' && current_token > 0;
+	            if (framed)
+	            {
+	                sequence = (unsigned int)atol(&(buffer[2]));
+	                for (i = 0; i < current_token; i++)   // the command starts after the sequence
+	                    token[i] = token[i + 1];
+	                current_token--;
+	            }
 	            if (buffer[0] == '$')  // with checksum
 	            {
 		        	if (check_checksum(buffer))
@@ -370,7 +564,11 @@ void communication_input_task( void *parameters )
                     char c1 = buffer[token[0]];
                     char c2 = buffer[token[0] + 1];
 
-                    if (!with_checksum) // don't parse data without a valid or without any checksum
+                    int accepted = ! framed || uplink_receive(with_checksum, sequence);
+
+                    if (! accepted)
+                        ;   // answered by uplink_receive()
+                    else if (!with_checksum) // don't parse data without a valid or without any checksum
                     {
                         printf_nochecksum_direct("Data with invalid or no checksum received: %s\r\n", buffer);
                     }
@@ -388,21 +586,27 @@ void communication_input_task( void *parameters )
             //if (i < 2)
                 uart1_puts("Not allowed in Limited Edition!\r\n");
         #else
-                            if (i < MAX_GLUONSCRIPTCODES)
+                            if (i >= 0 && i < MAX_GLUONSCRIPTCODES)
                             {
-                                gluonscript_data.codes[i].opcode = atoi(&(buffer[token[2]]));
-                                gluonscript_data.codes[i].x = atof(&(buffer[token[3]]));
-                                gluonscript_data.codes[i].y = atof(&(buffer[token[4]]));
-                                gluonscript_data.codes[i].a = atoi(&(buffer[token[5]]));
-                                gluonscript_data.codes[i].b = atoi(&(buffer[token[6]]));
-
-                                if (navigation_data.relative_positions_calculated)
-                                    navigation_calculate_relative_position(i);
-
-                                // confirm by sending it back...
-                                printf_checksum("ND;%d;%d;%f;%f;%d;%d", i+1, gluonscript_data.codes[i].opcode,
-                                                gluonscript_data.codes[i].x, gluonscript_data.codes[i].y,
-                                                gluonscript_data.codes[i].a, gluonscript_data.codes[i].b);
+                                struct GluonscriptCode code;
+                                code.opcode = atoi(&(buffer[token[2]]));
+                                code.x = atof(&(buffer[token[3]]));
+                                code.y = atof(&(buffer[token[4]]));
+                                code.a = atoi(&(buffer[token[5]]));
+                                code.b = atoi(&(buffer[token[6]]));
+
+                                // written to the flash right away
+                                if (gluonscript_set_code(i, &code))
+                                {
+                                    if (geofence.active && code.opcode == GEOFENCE_VERTEX)
+                                        geofence.rebuild = 1;   // by the GPS task, while the control task keeps checking the old fence
+
+                                    // confirm by sending it back...
+                                    printf_checksum("ND;%d;%d;%f;%f;%d;%d", i+1, code.opcode,
+                                                    code.x, code.y, code.a, code.b);
+                                }
+                                else
+                                    printf("\r\nSPI Flash not available\r\n");
                             }
         #endif
                         }
@@ -419,7 +623,7 @@ void communication_input_task( void *parameters )
                         ///////////////////////////////////////////////////////////////
                         else if (c1 == 'F')
                         {
-                            gluonscript_burn();
+                            // every line was already written to the flash when it was received
                             printf_message("\r\nScript burned to flash\r\n");
                         }
                         ///////////////////////////////////////////////////////////////
@@ -428,8 +632,6 @@ void communication_input_task( void *parameters )
                         else if (c1 == 'L')
                         {
                             gluonscript_load();
-                            if (navigation_data.relative_positions_calculated)
-                                navigation_calculate_relative_positions();
                         }
                         ///////////////////////////////////////////////////////////////
                         //                       READ NAVIGATION                     //
@@ -569,6 +771,51 @@ void communication_input_task( void *parameters )
                         }
                     }
                     ///////////////////////////////////////////////////////////////
+                    //                HARDWARE IN THE LOOP ON/OFF                //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'H' && c2 == 'I')    // HI;1 enables, HI;0 disables
+                    {
+                        hil.active = atoi(&(buffer[token[1]])) == 1;
+                        if (hil.active)
+                        {
+                            printf_message("Hardware in the loop enabled\r\n");
+                        }
+                        else
+                        {
+                            printf_message("Hardware in the loop disabled\r\n");
+                        }
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                      RUN BENCHMARKS                       //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'B' && c2 == 'M')    // BM
+                    {
+                        if (control_state.simulation_mode == 1)
+                            benchmark_run(&print_benchmark_result);
+                        else
+                            printf_message("Enable simulation first\r\n");
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                       PID AUTO-TUNE                       //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'U' && c2 == 'T')    // UT;axis;relay_deg  (1 roll, 2 pitch, 0 stop)
+                    {
+                        autotune_start((enum AutotuneAxis)atoi(&(buffer[token[1]])), (float)atof(&(buffer[token[2]])));
+                        if (autotune.state == AUTOTUNE_ARMED)
+                            printf_message("Auto-tune starts in stabilized mode\r\n");
+                    }
+                    else if (c1 == 'U' && c2 == 'A')    // UA: apply the proposed gains (burn with FC)
+                    {
+                        if (autotune_apply())
+                        {
+                            printf_message("Auto-tune gains applied\r\n");
+                        }
+                        else
+                        {
+                            printf_message("No auto-tune result\r\n");
+                        }
+                    }
+                    ///////////////////////////////////////////////////////////////
                     //                      SET TELEMETRY                        //
                     ///////////////////////////////////////////////////////////////
                     else if (c1 == 'S' && c2 == 'T')    // Set Telemetry
@@ -621,16 +868,28 @@ void communication_input_task( void *parameters )
                             z += sensor_data.gyro_z_raw;
                             vTaskDelay(( ( portTickType ) 10 / portTICK_RATE_MS ) );  // delay 10ms
                         }
-                        config.sensors.gyro_x_neutral = (float)(x / 10);
-                        config.sensors.gyro_y_neutral = (float)(y / 10);
-                        config.sensors.gyro_z_neutral = (float)(z / 10);
+                        gyro_temperature_set_neutral((float)(x / 10), (float)(y / 10), (float)(z / 10));
 
                         // reset bias offsets
                         sensor_data.p_bias = 0.0;
                         sensor_data.q_bias = 0.0;
+                        sensor_data.r_bias = 0.0;
                         printf("Gyros calibrated\r\n");
                     }
                     ///////////////////////////////////////////////////////////////
+                    //                 GYRO TEMPERATURE MODEL                    //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'G' && c2 == 'T')    // GT prints the gyro temperature model, GT;0 clears it
+                    {
+                        if (current_token > 0 && atoi(&(buffer[token[1]])) == 0)
+                            gyro_temperature_reset();
+                        printf_checksum("GT;%d;%.1f;%.1f;%.3f;%.4f;%.1f;%.3f;%.4f;%.1f;%.3f;%.4f",
+                                        gyro_temperature_samples(), sensor_data.imu_temperature,
+                                        config.sensors.gyro_x_neutral, config.sensors.gyro_temperature[0][0], config.sensors.gyro_temperature[0][1],
+                                        config.sensors.gyro_y_neutral, config.sensors.gyro_temperature[1][0], config.sensors.gyro_temperature[1][1],
+                                        config.sensors.gyro_z_neutral, config.sensors.gyro_temperature[2][0], config.sensors.gyro_temperature[2][1]);
+                    }
+                    ///////////////////////////////////////////////////////////////
                     //                    CALIBRATE ACCELERO                     //
                     ///////////////////////////////////////////////////////////////
                     else if (c1 == 'C' && c2 == 'A')    // Calibrate accelerometer
@@ -663,6 +922,36 @@ void communication_input_task( void *parameters )
                         printf("Accelerometers calibrated\r\n");
                     }
                     ///////////////////////////////////////////////////////////////
+                    //                  CALIBRATE MAGNETOMETER                   //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'C' && c2 == 'M')    // CM;1 starts collecting, CM;0 fits and stores the calibration
+                    {
+                        if (atoi(&(buffer[token[1]])) == 1)
+                        {
+                            magnetometer_calibration_start();
+                            printf_message("Rotate the plane in all directions\r\n");
+                        }
+                        else if (magnetometer_calibration_finish())
+                        {
+                            printf_checksum("CM;%d;%d;%d;%.6f;%.6f;%.6f",
+                                            config.sensors.magnetometer_offset_x, config.sensors.magnetometer_offset_y, config.sensors.magnetometer_offset_z,
+                                            config.sensors.magnetometer_scale_x, config.sensors.magnetometer_scale_y, config.sensors.magnetometer_scale_z);
+                            printf_message("Magnetometer calibrated\r\n");
+                        }
+                        else
+                        {
+                            printf_message("Magnetometer calibration failed, not enough rotation\r\n");
+                        }
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                   SET HEADING SENSOR                      //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'S' && c2 == 'H')    // SH;magnetometer_enabled;declination_deg
+                    {
+                        config.sensors.magnetometer_enabled = atoi(&(buffer[token[1]]));
+                        config.sensors.magnetic_declination = DEG2RAD((float)atof(&(buffer[token[2]])));
+                    }
+                    ///////////////////////////////////////////////////////////////
                     //                    SET INPUT CHANNELS                     //
                     ///////////////////////////////////////////////////////////////
                     else if (c1 == 'S' && c2 == 'I')    // Set Input Channel
@@ -803,7 +1092,11 @@ void communication_input_task( void *parameters )
                     ///////////////////////////////////////////////////////////////
                     else if (c1 == 'L' && c2 == 'C')    // Load configuration from flash!
                     {
-                        configuration_load();
+                        int loaded = configuration_load();
+                        if (loaded == CONFIGURATION_DEFAULTS)
+                            printf_message("Unknown configuration: defaults loaded\r\n");
+                        else if (loaded == CONFIGURATION_CONVERTED)
+                            printf_message("Configuration of an older firmware converted\r\n");
                     }
                     ///////////////////////////////////////////////////////////////
                     //                LOAD DEFAULT CONFIGURATION                 //
@@ -826,12 +1119,52 @@ void communication_input_task( void *parameters )
                             }
                         }
                     }
+                    ///////////////////////////////////////////////////////////////
+                    //                 READ STACK HIGH-WATER MARKS               //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'R' && c2 == 'K')    // RK;x  x=1: clear the report
+                    {
+                        if (buffer[token[1]] == '1')
+                            stack_monitor_clear();
+                        print_stack_report();
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                 READ COOPERATIVE JOBS                     //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'R' && c2 == 'J')
+                    {
+                        print_jobs();
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                  READ CAMERA TRIGGER EVENTS               //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'R' && c2 == 'G')
+                    {
+                        geotag_print(&print_geotag_event);
+                        printf_checksum("GS;%u;%u", geotag.events, geotag.lost);
+                    }
+                    ///////////////////////////////////////////////////////////////
+                    //                 UPLINK RESET AND STATISTICS               //
+                    ///////////////////////////////////////////////////////////////
+                    else if (c1 == 'K' && c2 == 'R')    // KR  next frame is sequence 0
+                    {
+                        uplink.expected = 0;
+                        uplink.nacked = -1;
+                        printf_checksum("KR;%d", uart1_rx_free());
+                    }
+                    else if (c1 == 'R' && c2 == 'U')    // RU  frames; retransmissions; nacks; bytes lost
+                    {
+                        printf_checksum("KS;%u;%u;%u;%u", uplink.frames, uplink.duplicates, uplink.nacks, uart1_rx_overruns);
+                    }
                     else if (current_token > 0)  // && \n or \r
                     {
                         buffer[buffer_position++] = '\0';
                         buffer[buffer_position] = '\0';
                         printf_nochecksum_direct("ERROR received data: %s\r\n", buffer);
                     }
+
+                    if (framed && accepted)
+                        uplink_acknowledge(sequence);
                 }
             	buffer_position = 0;
             	current_token = 0;
@@ -887,12 +1220,17 @@ void communication_input_task( void *parameters )
 void print_navigation()
 {
 	int i;
+	struct GluonscriptCode code;
 	uart1_puts("\n\r");
-	for (i = 0; i < MAX_GLUONSCRIPTCODES; i++)
+	for (i = 0; i < gluonscript_data.lines; i++)
 	{
-		printf_checksum("ND;%d;%d;%f;%f;%d;%d", i+1, gluonscript_data.codes[i].opcode,
-			gluonscript_data.codes[i].x, gluonscript_data.codes[i].y,
-			gluonscript_data.codes[i].a, gluonscript_data.codes[i].b);
+		if (! gluonscript_read_code(i, &code))   // not through the cache, see gluonscript_read_code
+		{
+			printf_message("\r\nSPI Flash not available\r\n");
+			return;
+		}
+		printf_checksum("ND;%d;%d;%f;%f;%d;%d", i+1, code.opcode,
+			code.x, code.y, code.a, code.b);
 	}	
 }
 
@@ -1032,6 +1370,7 @@ void print_configuration()
                 (config.osd.show_block_name? 32768 : 0) ;
     printf(";%u;%u;%u;%u", bitmask, (unsigned int)config.osd.rssi, (unsigned int)config.osd.voltage_low, (unsigned int)config.osd.voltage_high);
     printf(";%d;%d", (int)config.sensors.imu_rotated, (int)RAD2DEG(config.sensors.neutral_pitch));
+    printf(";%d;%.1f", config.sensors.magnetometer_enabled, RAD2DEG(config.sensors.magnetic_declination));
     uart1_puts("\r\n");
 }		
 
@@ -1070,15 +1409,73 @@ void print_logline(struct LogLine *l)
 	//printf_nochecksum ("%d;%d;%d;%d;", l->height_m, l->pitch, l->roll, l->yaw);
 	//printf_nochecksum ("%d;%d;%d;%u\r\n", (int)l->temperature_c, (int)l->control_state, l->navigation_code_line+1, l->servo_trigger);
 
-    printf_checksum("DD;%lu;%lu;%.6f;%.6f;%.1f;%d;%d;%d;%d;%d;%d;%d;%d;%d;%u",
+    printf_checksum("DD;%lu;%lu;%.6f;%.6f;%.1f;%d;%d;%d;%d;%d;%d;%d;%d;%d;%u;%.2f;%u",
                             l->date, l->time, RAD2DEG(l->gps_latitude_rad), RAD2DEG(l->gps_longitude_rad),
                             ((float)l->gps_speed_m_s)/3.0, l->gps_heading, l->gps_height_m,
                             l->height_m, l->pitch, l->roll, l->yaw,
-                            (int)l->temperature_c, (int)l->control_state, l->navigation_code_line+1, l->servo_trigger);
+                            (int)l->temperature_c, (int)l->control_state, l->navigation_code_line+1, l->servo_trigger,
+                            ((float)l->acc_vibration_100)/100.0, (unsigned int)l->sensor_health);
 #endif
 }	
 
 
+/*!
+ *     Sends the result of a benchmark: name; calls; us per call; error; heap bytes used
+ */
+void print_benchmark_result(struct BenchmarkResult *r)
+{
+	printf_checksum("BM;%s;%u;%.1f;%.4f;%d", r->name, r->calls, r->us_per_call, r->error, r->heap_used);
+}
+
+
+/*!
+ *     Sends the stack report: name; size; least free over all flights; free now (words),
+ *     then heap free now; least heap free (bytes); stack overflows; last overflowing task
+ */
+void print_stack_report()
+{
+	int r;
+
+	for (r = 0; r < stack_report.tasks; r++)
+	{
+		printf_checksum("TK;%.8s;%u;%u;%u", stack_report.task[r].name, stack_report.task[r].size,
+		                stack_report.task[r].min_free, stack_monitor_free(r));
+	}
+	printf_checksum("TK;heap;%u;%u;%u;%.8s", (unsigned int)xPortGetFreeHeapSize(), stack_report.heap_free,
+	                stack_report.overflows, stack_report.overflow_task);
+}
+
+
+/*!
+ *     Sends the deadline accounting of the jobs (none without ENABLE_COOPERATIVE_JOBS):
+ *     name; period; runs; deadline misses; max start after the release; max run time (ms)
+ */
+void print_jobs()
+{
+	struct Job *job;
+	int i;
+
+	for (i = 0; i < jobs_count(); i++)
+	{
+		job = jobs_get(i);
+		printf_checksum("TJ;%s;%u;%lu;%u;%u;%u", job->name, job->period_ms, job->runs,
+		                job->deadline_misses, job->max_late_ms, job->max_run_ms);
+	}
+}
+
+
+/*!
+ *     Sends a camera trigger event: number; flags; satellites; us since startup; date; UTC ms of the day;
+ *     latitude; longitude (degrees * 10^7); GPS height; barometric height (dm); roll; pitch; yaw (0.01 degree)
+ */
+void print_geotag_event(struct GeotagEvent *e)
+{
+	printf_checksum("GE;%u;%u;%u;%lu;%ld;%lu;%ld;%ld;%d;%d;%d;%d;%u", e->number, (unsigned int)e->flags,
+	                (unsigned int)e->satellites, e->time_us, e->date, e->utc_ms, e->latitude_e7, e->longitude_e7,
+	                e->gps_height_dm, e->height_dm, e->roll_cdeg, e->pitch_cdeg, e->yaw_cdeg);
+}
+
+
 #ifdef RAW_50HZ_LOG
 void print_logline_simulation(struct LogLine *l)
 {
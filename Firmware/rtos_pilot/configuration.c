@@ -9,6 +9,9 @@
  *  @since    0.1
  */
  
+#include <stddef.h>
+#include <string.h>
+
 // Gluonpilot library includes
 #include "microcontroller/microcontroller.h"
 #include "dataflash/dataflash.h"
@@ -25,14 +28,103 @@ struct Configuration config;
 //! Contains the hardware version (defined in configuration.h)
 int HARDWARE_VERSION;
 
+/*!
+ *  Layout of the pages written before CONFIGURATION_MAGIC: no header, and
+ *  the sensor calibration without the magnetometer and the gyro temperature
+ *  model. The structs behind it didn't change.
+ */
+struct SensorConfigV0
+{
+	float acc_x_neutral;
+	float acc_y_neutral;
+	float acc_z_neutral;
+
+	float gyro_x_neutral;
+	float gyro_y_neutral;
+	float gyro_z_neutral;
+
+	enum BoardRotation imu_rotated;
+	float neutral_pitch;
+};
+
+struct ConfigurationV0
+{
+	struct SensorConfigV0 sensors;
+	struct TelemetryConfig telemetry;
+	struct GpsConfig gps;
+	struct ControlConfig control;
+	struct OsdConfig osd;
+};
+
+static void configuration_default_sensors();
+
+
+//! An erased page reads NaN, garbage rarely gives raw neutrals
+static int is_raw_neutral(float f)
+{
+	return f >= 0.0f && f <= 65535.0f;
+}
+
+
+/*!
+ *  Converts the page of the layout before CONFIGURATION_MAGIC, read into
+ *  config, in place: the calibration is taken, the new fields get their
+ *  defaults and the structs behind it move up to their new place.
+ *  @return 0 when it doesn't look like such a page
+ */
+static int configuration_convert_v0()
+{
+	struct SensorConfigV0 sensors;
+	unsigned char *page = (unsigned char*)&config;
+
+	memcpy(&sensors, page, sizeof(sensors));
+	if (!is_raw_neutral(sensors.acc_x_neutral) || !is_raw_neutral(sensors.acc_y_neutral) ||
+	    !is_raw_neutral(sensors.acc_z_neutral) || !is_raw_neutral(sensors.gyro_x_neutral) ||
+	    !is_raw_neutral(sensors.gyro_y_neutral) || !is_raw_neutral(sensors.gyro_z_neutral))
+		return 0;
+
+	// from the back: every struct moves up, over the ones already moved
+	memmove(&config.osd, page + offsetof(struct ConfigurationV0, osd), sizeof(struct OsdConfig));
+	memmove(&config.control, page + offsetof(struct ConfigurationV0, control), sizeof(struct ControlConfig));
+	memmove(&config.gps, page + offsetof(struct ConfigurationV0, gps), sizeof(struct GpsConfig));
+	memmove(&config.telemetry, page + offsetof(struct ConfigurationV0, telemetry), sizeof(struct TelemetryConfig));
+
+	configuration_default_sensors();
+	config.sensors.acc_x_neutral = sensors.acc_x_neutral;
+	config.sensors.acc_y_neutral = sensors.acc_y_neutral;
+	config.sensors.acc_z_neutral = sensors.acc_z_neutral;
+	config.sensors.gyro_x_neutral = sensors.gyro_x_neutral;
+	config.sensors.gyro_y_neutral = sensors.gyro_y_neutral;
+	config.sensors.gyro_z_neutral = sensors.gyro_z_neutral;
+	config.sensors.imu_rotated = sensors.imu_rotated;
+	config.sensors.neutral_pitch = sensors.neutral_pitch;
+
+	config.magic = CONFIGURATION_MAGIC;
+	config.version = CONFIGURATION_VERSION;
+	config.size = sizeof(struct Configuration);
+	return 1;
+}
+
 
 /*!
  *  Loads the configuration struct from the 1st dataflash page.
+ *  A page without the magic is converted from the layout before it, see
+ *  configuration_convert_v0(). The default configuration is loaded for an
+ *  empty page and a page of an unknown version or size.
+ *  @return CONFIGURATION_LOADED, CONFIGURATION_CONVERTED or CONFIGURATION_DEFAULTS
  *  @todo  Add global min and max value for the output.
  */
-void configuration_load()
+int configuration_load()
 {
 	dataflash.read(CONFIGURATION_PAGE, sizeof(struct Configuration), (unsigned char*)&config);
+	if (config.magic == CONFIGURATION_MAGIC && config.version == CONFIGURATION_VERSION &&
+	    config.size == sizeof(struct Configuration))
+		return CONFIGURATION_LOADED;
+	if (config.magic != CONFIGURATION_MAGIC && configuration_convert_v0())
+		return CONFIGURATION_CONVERTED;
+
+	configuration_default();
+	return CONFIGURATION_DEFAULTS;
 }
 
 
@@ -90,16 +182,61 @@ void configuration_determine_hardware_version()
  */
 void configuration_write()
 {
+	config.magic = CONFIGURATION_MAGIC;
+	config.version = CONFIGURATION_VERSION;
+	config.size = sizeof(struct Configuration);
 	dataflash.write(CONFIGURATION_PAGE, sizeof(struct Configuration), (unsigned char*)&config);
 }
 
 
+/*!
+ *  Defaults of the sensor calibration.
+ */
+static void configuration_default_sensors()
+{
+	int i;
+
+    config.sensors.acc_x_neutral = 32000;
+	config.sensors.acc_y_neutral = 32000;
+	config.sensors.acc_z_neutral = 32000;
+	
+	config.sensors.gyro_x_neutral = 27180.0f;
+	config.sensors.gyro_y_neutral = 26304.0f;
+	config.sensors.gyro_z_neutral = 31850.0f;
+	for (i = 0; i < 3; i++)
+	{
+		config.sensors.gyro_temperature[i][0] = 0.0f;
+		config.sensors.gyro_temperature[i][1] = 0.0f;
+	}
+
+    config.sensors.imu_rotated = ROTATION_0;
+    config.sensors.neutral_pitch = 0.0f;
+
+#if (ENABLE_QUADROCOPTER || F1E_STEERING)
+    config.sensors.magnetometer_enabled = 1;
+#else
+    config.sensors.magnetometer_enabled = 0;
+#endif
+    config.sensors.magnetometer_offset_x = 0;
+    config.sensors.magnetometer_offset_y = 0;
+    config.sensors.magnetometer_offset_z = 0;
+    config.sensors.magnetometer_scale_x = 1.0f / 550.0f;   // HMC5883L at 1090 LSB/Ga, ~0.5Ga
+    config.sensors.magnetometer_scale_y = 1.0f / 550.0f;
+    config.sensors.magnetometer_scale_z = 1.0f / 550.0f;
+    config.sensors.magnetic_declination = 0.0f;
+}
+
+
 /*!
  *  Called on user request. Usefull when an upgrade causes the "struct config" to change.
  */
 void configuration_default()
 {
 	int i;
+	config.magic = CONFIGURATION_MAGIC;
+	config.version = CONFIGURATION_VERSION;
+	config.size = sizeof(struct Configuration);
+
 	config.control.channel_ap = 3;
 	config.control.channel_motor = 2;
 	config.control.channel_pitch = 0;
@@ -154,16 +291,7 @@ void configuration_default()
     config.gps.operational_baudrate = 115200l;
     config.gps.initial_baudrate = 38400l;
     config.gps.enable_waas = 0;
-    config.sensors.acc_x_neutral = 32000;
-	config.sensors.acc_y_neutral = 32000;
-	config.sensors.acc_z_neutral = 32000;
-	
-	config.sensors.gyro_x_neutral = 27180.0f;
-	config.sensors.gyro_y_neutral = 26304.0f;
-	config.sensors.gyro_z_neutral = 31850.0f;
-
-    config.sensors.imu_rotated = ROTATION_0;
-    config.sensors.neutral_pitch = 0.0f;
+    configuration_default_sensors();
 
 	config.telemetry.stream_GpsBasic = 5;
 	config.telemetry.stream_GyroAccProc = 40;
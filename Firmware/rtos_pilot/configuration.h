@@ -7,6 +7,7 @@
 
 #define ENABLE_XBEE_RESET 1
 #define ENABLE_OSD_PAL_DEFAULT 1
+//#define ENABLE_COOPERATIVE_JOBS 1   // telemetry, datalogger and OSD as jobs of one task, see jobs.c
  /***************************************/
 
 #include "sensors.h"
@@ -16,8 +17,30 @@
 #include "gps/gps.h"
 
 
+/*!
+ *  The page is only loaded as it is when it starts with the magic, the
+ *  version and the size of this firmware: a new field shifts everything
+ *  behind it. A page without the magic (before version 1) is converted
+ *  when loaded, see configuration.c, other pages get the defaults. Either
+ *  way it has to be burned again (FC).
+ *  Increment CONFIGURATION_VERSION when the struct changes: the size only
+ *  catches the changes that add or remove bytes.
+ *   1: magnetometer calibration
+ *   2: gyro_temperature
+ */
+#define CONFIGURATION_MAGIC 0x47C0
+#define CONFIGURATION_VERSION 2
+
+//! Results of configuration_load()
+#define CONFIGURATION_DEFAULTS 0
+#define CONFIGURATION_LOADED 1
+#define CONFIGURATION_CONVERTED 2
+
 struct Configuration
 {
+	unsigned int magic;             //!< CONFIGURATION_MAGIC
+	unsigned int version;           //!< CONFIGURATION_VERSION
+	unsigned int size;              //!< sizeof(struct Configuration)
 	struct SensorConfig sensors;
 	struct TelemetryConfig telemetry;
 	struct GpsConfig gps;
@@ -36,7 +59,7 @@ extern int HARDWARE_VERSION;
 
 void configuration_default();
 
-void configuration_load();
+int configuration_load();
 
 void configuration_write();
 
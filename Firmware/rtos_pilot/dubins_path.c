@@ -0,0 +1,308 @@
+/*!
+ *  Dubins paths between consecutive waypoints.
+ *
+ *  When a FROM_TO or CIRCLE_TO line becomes active, it gets the shortest
+ *  turn - straight - turn path (LSL, RSR, LSR or RSL) from the previous
+ *  waypoint to its own waypoint. The turn radius is the minimum radius at the
+ *  cruising speed and max_roll (with some margin), and the heading at a
+ *  waypoint is the bisector of the legs in and out of it, so consecutive paths
+ *  join without S-turns.
+ *  The path is planned once per leg; the lateral guidance then follows the
+ *  stored arcs and line.
+ *
+ *  @file     dubins_path.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+#include "fastmath/fastmath.h"
+
+#include "dubins_path.h"
+#include "gluonscript.h"
+#include "handler_navigation.h"
+#include "configuration.h"
+#include "sensors.h"
+#include "common.h"
+
+#define ROLL_MARGIN 0.8f            //!< plan with 80% of max_roll
+#define MIN_RADIUS_M 10.0f
+#define MAX_DISTANCE_M 16000.0f     //!< positions are stored as int
+
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+static struct DubinsPath path;
+static float radius_m;
+
+// the path being followed
+static int active_line = -1;        //!< the line the path was planned for
+static int segment;                 //!< 0 first turn, 1 straight, 2 last turn
+static float progress_rad, last_angle;
+
+static void dubins_plan(int line);
+static int dubins_previous_waypoint(int line);
+static float dubins_waypoint_heading(int line);
+static float wrap_pi(float a);
+
+
+static int is_waypoint(int opcode)
+{
+	return opcode == FROM_TO_ABS || opcode == FLY_TO_ABS || opcode == CIRCLE_TO_ABS;
+}
+
+
+/*!
+ *   Forgets the planned path. Call after the flightplan or the home position
+ *   changed.
+ */
+void dubins_reset()
+{
+	active_line = -1;
+}
+
+
+/*!
+ *   Lateral guidance along the planned path of the current line.
+ *   Returns DUBINS_NOT_PLANNED when there is no path, or when we didn't come
+ *   from the waypoint the path starts at (after a GOTO, a block switch...).
+ */
+int dubins_navigate(struct GluonscriptCode *current_code, int altitude_agl)
+{
+	int line = gluonscript_context.current_codeline;
+	struct DubinsPath *p = &path;
+	float n, e, a;
+
+	n = (sensor_data.gps.latitude_rad - current_code->x) * latitude_meter_per_radian;
+	e = (sensor_data.gps.longitude_rad - current_code->y) * longitude_meter_per_radian;
+
+	if (active_line != line)
+	{
+		dubins_plan(line);
+		active_line = line;
+		segment = 0;
+		progress_rad = 0.0f;
+		last_angle = fast_atan2(e - p->c1_e, n - p->c1_n);
+	}
+
+	if (p->turn1 == 0 ||
+	    p->from_latitude_rad != navigation_data.last_waypoint_latitude_rad ||
+	    p->from_longitude_rad != navigation_data.last_waypoint_longitude_rad)
+		return DUBINS_NOT_PLANNED;
+
+	if (segment == 0)
+	{
+		a = fast_atan2(e - p->c1_e, n - p->c1_n);
+		progress_rad += wrap_pi(a - last_angle) * p->turn1;
+		last_angle = a;
+		if (progress_rad * 1000.0f >= (float)p->sweep1_mrad)
+			segment = 1;
+	}
+
+	if (segment == 1)
+	{
+		float u_n = (float)(p->t2_n - p->t1_n), u_e = (float)(p->t2_e - p->t1_e);
+		float length = fast_sqrt(u_n*u_n + u_e*u_e), along;
+
+		if (length > 1.0f)
+		{
+			u_n /= length;
+			u_e /= length;
+		}
+		along = (n - p->t1_n)*u_n + (e - p->t1_e)*u_e;
+		if (along >= length)
+		{
+			segment = 2;
+			progress_rad = 0.0f;
+			last_angle = fast_atan2(e - p->c2_e, n - p->c2_n);
+		}
+		else
+		{
+			// fly towards a carrot on the line
+			float carrot = MIN(along + 4.0f * sensor_data.gps.speed_ms, length);
+			float heading = fast_atan2(p->t1_e + carrot*u_e - e, p->t1_n + carrot*u_n - n);
+			if (heading < 0.0f)
+				heading += 2.0f*PI;
+			navigation_data.desired_heading_rad = heading;
+			navigation_data.desired_pre_bank = 0.0f;
+			navigation_data.desired_altitude_agl = altitude_agl;
+			return DUBINS_FOLLOWING;
+		}
+	}
+
+	// segment 0 or 2: a turn
+	{
+		struct GluonscriptCode circle;
+		int c_n = segment == 0 ? p->c1_n : p->c2_n;
+		int c_e = segment == 0 ? p->c1_e : p->c2_e;
+
+		if (segment == 2)
+		{
+			a = fast_atan2(e - c_e, n - c_n);
+			progress_rad += wrap_pi(a - last_angle) * p->turn2;
+			last_angle = a;
+			if (progress_rad * 1000.0f >= (float)p->sweep2_mrad)
+				return DUBINS_PASSED;
+		}
+
+		circle.x = current_code->x + (float)c_n / latitude_meter_per_radian;
+		circle.y = current_code->y + (float)c_e / longitude_meter_per_radian;
+		circle.a = (int)radius_m * (segment == 0 ? p->turn1 : p->turn2);
+		circle.b = altitude_agl;
+		navigation_do_circle(&circle);
+	}
+	return DUBINS_FOLLOWING;
+}
+
+
+/*!
+ *   Shortest CSC path from the previous waypoint to the one of this line.
+ *   CCC paths are only shorter when the waypoints are closer than 4 radii,
+ *   then the best CSC path is used anyway.
+ */
+static void dubins_plan(int line)
+{
+	struct DubinsPath *p = &path;
+	struct GluonscriptCode to, from;
+	int from_line, d1, d2;
+	float s_n, s_e, h_s, h_e, best = -1.0f;
+	float r, tan_roll = tanf(config.control.max_roll * ROLL_MARGIN);
+
+	radius_m = (float)config.control.cruising_speed_ms * (float)config.control.cruising_speed_ms / (G * MAX(tan_roll, 0.1f));
+	radius_m = MAX(radius_m, MIN_RADIUS_M);
+	r = radius_m;
+
+	p->turn1 = p->turn2 = 0;
+	gluonscript_get_code(line, &to);
+	if (!is_waypoint(to.opcode) || to.opcode == FLY_TO_ABS)
+		return;
+	from_line = dubins_previous_waypoint(line);
+	if (from_line < 0)
+		return;
+	gluonscript_get_code(from_line, &from);
+
+	// start: the previous waypoint, relative to this one
+	s_n = (from.x - to.x) * latitude_meter_per_radian;
+	s_e = (from.y - to.y) * longitude_meter_per_radian;
+	if (fabs(s_n) > MAX_DISTANCE_M || fabs(s_e) > MAX_DISTANCE_M)
+		return;
+	h_s = dubins_waypoint_heading(from_line);
+	h_e = dubins_waypoint_heading(line);
+
+	for (d1 = -1; d1 <= 1; d1 += 2)
+		for (d2 = -1; d2 <= 1; d2 += 2)
+		{
+			// turn centers are on the right (d = 1) or left (d = -1) side
+			float c1_n = s_n - d1 * r * sinf(h_s), c1_e = s_e + d1 * r * cosf(h_s);
+			float c2_n = -d2 * r * sinf(h_e), c2_e = d2 * r * cosf(h_e);
+			float v_n = c2_n - c1_n, v_e = c2_e - c1_e;
+			float dist2 = v_n*v_n + v_e*v_e;
+			float m = (float)(d2 - d1) * r;   // 0 for LSL and RSR: outer tangent
+			float straight, u_n, u_e, t1_n, t1_e, t2_n, t2_e, sweep1, sweep2, length;
+
+			if (dist2 <= m*m || dist2 < 1.0f)
+				continue;
+			straight = sqrtf(dist2 - m*m);
+			u_n = (straight*v_n + m*v_e) / dist2;
+			u_e = (-m*v_n + straight*v_e) / dist2;
+
+			// tangent points: the center is on the turn side of the straight line
+			t1_n = c1_n + d1 * r * u_e;
+			t1_e = c1_e - d1 * r * u_n;
+			t2_n = c2_n + d2 * r * u_e;
+			t2_e = c2_e - d2 * r * u_n;
+
+			sweep1 = d1 * (atan2f(t1_e - c1_e, t1_n - c1_n) - atan2f(s_e - c1_e, s_n - c1_n));
+			sweep2 = d2 * (atan2f(-c2_e, -c2_n) - atan2f(t2_e - c2_e, t2_n - c2_n));
+			while (sweep1 < 0.0f) sweep1 += 2.0f*PI;
+			while (sweep2 < 0.0f) sweep2 += 2.0f*PI;
+			if (sweep1 > 2.0f*PI - 0.01f) sweep1 = 0.0f;
+			if (sweep2 > 2.0f*PI - 0.01f) sweep2 = 0.0f;
+
+			length = r * (sweep1 + sweep2) + straight;
+			if (best < 0.0f || length < best)
+			{
+				best = length;
+				p->c1_n = (int)c1_n;  p->c1_e = (int)c1_e;
+				p->c2_n = (int)c2_n;  p->c2_e = (int)c2_e;
+				p->t1_n = (int)t1_n;  p->t1_e = (int)t1_e;
+				p->t2_n = (int)t2_n;  p->t2_e = (int)t2_e;
+				p->sweep1_mrad = (int)(sweep1 * 1000.0f);
+				p->sweep2_mrad = (int)(sweep2 * 1000.0f);
+				p->turn1 = d1;
+				p->turn2 = d2;
+				p->from_latitude_rad = from.x;
+				p->from_longitude_rad = from.y;
+			}
+		}
+}
+
+
+/*!
+ *   The waypoint before this line in the flightplan, -1 if there is none
+ *   within a page.
+ */
+static int dubins_previous_waypoint(int line)
+{
+	int i;
+	struct GluonscriptCode code;
+
+	for (i = line - 1; i >= 0 && i >= line - GLUONSCRIPT_PAGE_CODES; i--)
+	{
+		gluonscript_get_code(i, &code);
+		if (is_waypoint(code.opcode))
+			return i;
+		else if (code.opcode == CIRCLE_ABS || code.opcode == FLARE_TO_ABS || code.opcode == GLIDE_TO_ABS)
+			return -1;   // these don't leave from their waypoint
+	}
+	return -1;
+}
+
+
+/*!
+ *   Heading when passing the waypoint: the bisector of the incoming and the
+ *   outgoing leg.
+ */
+static float dubins_waypoint_heading(int line)
+{
+	struct GluonscriptCode wp_code, next_code, previous_code;
+	struct GluonscriptCode *wp = &wp_code, *next = &next_code;
+	int previous = dubins_previous_waypoint(line);
+	float in_n = 0.0f, in_e = 0.0f, out_n = 0.0f, out_e = 0.0f, l;
+
+	gluonscript_get_code(line, wp);
+	gluonscript_next_waypoint_code(line, next);
+	if (previous >= 0)
+	{
+		gluonscript_get_code(previous, &previous_code);
+		in_n = (wp->x - previous_code.x) * latitude_meter_per_radian;
+		in_e = (wp->y - previous_code.y) * longitude_meter_per_radian;
+		l = MAX(sqrtf(in_n*in_n + in_e*in_e), 1.0f);
+		in_n /= l;
+		in_e /= l;
+	}
+	if (is_waypoint(next->opcode))
+	{
+		out_n = (next->x - wp->x) * latitude_meter_per_radian;
+		out_e = (next->y - wp->y) * longitude_meter_per_radian;
+		l = MAX(sqrtf(out_n*out_n + out_e*out_e), 1.0f);
+		out_n /= l;
+		out_e /= l;
+	}
+
+	// a U-turn has no bisector: keep the incoming heading
+	if ((in_n + out_n)*(in_n + out_n) + (in_e + out_e)*(in_e + out_e) < 0.01f)
+		return atan2f(in_e, in_n);
+	return atan2f(in_e + out_e, in_n + out_n);
+}
+
+
+static float wrap_pi(float a)
+{
+	if (a > PI)
+		a -= 2.0f*PI;
+	else if (a < -PI)
+		a += 2.0f*PI;
+	return a;
+}
@@ -0,0 +1,28 @@
+#ifndef DUBINS_PATH_H
+#define DUBINS_PATH_H
+
+#include "gluonscript.h"
+
+#define DUBINS_NOT_PLANNED -1   //!< no path for this line, use the straight leg
+#define DUBINS_FOLLOWING 0
+#define DUBINS_PASSED 1         //!< the end of the path (the waypoint) was passed
+
+/*!
+ *   Turn - straight - turn path from the previous waypoint to a waypoint.
+ *   Positions are in meters north and east of the waypoint the path leads to.
+ */
+struct DubinsPath
+{
+	int c1_n, c1_e;             //!< center of the first turn
+	int c2_n, c2_e;             //!< center of the last turn
+	int t1_n, t1_e;             //!< leaves the first turn
+	int t2_n, t2_e;             //!< enters the last turn
+	int sweep1_mrad, sweep2_mrad;
+	signed char turn1, turn2;   //!< 1 = right, -1 = left, 0 = no path
+	float from_latitude_rad, from_longitude_rad;   //!< the previous waypoint
+};
+
+void dubins_reset();
+int dubins_navigate(struct GluonscriptCode *current_code, int altitude_agl);
+
+#endif // DUBINS_PATH_H
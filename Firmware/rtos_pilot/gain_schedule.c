@@ -0,0 +1,113 @@
+/*!
+ *  Schedules the attitude gains of the wing on the airspeed.
+ *
+ *  The elevator and aileron moments grow with the dynamic pressure, so with
+ *  fixed gains the loops are sluggish when flying slowly and oscillate when
+ *  diving. The configured pitch2elevator and roll2aileron gains are tuned at
+ *  the cruising speed. Once per GPS update, after the wind estimator, they are
+ *  scaled with a factor interpolated from a table over airspeed bins and
+ *  copied into the active pids used by the 50Hz loop, which pays nothing
+ *  extra. The integrator and derivative state stays in the active pids.
+ *
+ *  The configured gains are not touched: the ground station reads and
+ *  changes them as before, a change is picked up by the next update.
+ *
+ *  Until the wind estimate is confident the airspeed is unknown: the GPS
+ *  ground speed is off by the wind, in a tailwind it would cut the gains.
+ *  The factor then goes back to 1, the gains tuned at the cruising speed.
+ *
+ *  @file     gain_schedule.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#include "gain_schedule.h"
+#include "wind_estimator.h"
+#include "configuration.h"
+#include "common.h"
+
+#define FIRST_BIN 0.6f              //!< airspeed / cruising speed of the first bin
+#define BIN_WIDTH 0.2f
+#define MAX_FACTOR_STEP 0.1f        //!< per update, smooths the switch between cruise gains and the schedule
+
+//! Gain factor per bin, (V_cruise / V)^2 bounded to [0.4, 2.0]
+static const float gain_factor[GAIN_SCHEDULE_BINS] = {
+	2.0f,       // 0.6 x cruising speed
+	1.56f,      // 0.8
+	1.0f,       // 1.0
+	0.69f,      // 1.2
+	0.51f,      // 1.4
+	0.4f        // 1.6
+};
+
+struct GainSchedule gain_schedule;
+
+static void gain_schedule_scale(struct pid *active, const struct pid *configured, float factor);
+
+
+/*!
+ *   Starts with the configured gains and an empty integrator.
+ */
+void gain_schedule_init()
+{
+	gain_schedule.pitch2elevator = config.control.pid_pitch2elevator;
+	gain_schedule.roll2aileron = config.control.pid_roll2aileron;
+	gain_schedule.pitch2elevator.i_state = gain_schedule.pitch2elevator.d_state = gain_schedule.pitch2elevator.last_error = 0.0f;
+	gain_schedule.roll2aileron.i_state = gain_schedule.roll2aileron.d_state = gain_schedule.roll2aileron.last_error = 0.0f;
+	gain_schedule.airspeed_ms = (float)config.control.cruising_speed_ms;
+	gain_schedule.factor = 1.0f;
+}
+
+
+/*!
+ *   Interpolates the gain factor for the current airspeed and updates the
+ *   active pids. Called at the GPS rate.
+ */
+void gain_schedule_update()
+{
+	float bin, factor;
+	int b;
+
+	if (wind_estimate.confidence >= WIND_CONFIDENT && config.control.cruising_speed_ms > 0)
+	{
+		gain_schedule.airspeed_ms = wind_airspeed_ms();
+		bin = (gain_schedule.airspeed_ms / (float)config.control.cruising_speed_ms - FIRST_BIN) / BIN_WIDTH;
+		bin = BIND(bin, 0.0f, (float)(GAIN_SCHEDULE_BINS - 1));
+		b = MIN((int)bin, GAIN_SCHEDULE_BINS - 2);
+		factor = gain_factor[b] + (gain_factor[b+1] - gain_factor[b]) * (bin - (float)b);
+	}
+	else
+	{
+		gain_schedule.airspeed_ms = (float)config.control.cruising_speed_ms;
+		factor = 1.0f;
+	}
+
+	gain_schedule.factor += BIND(factor - gain_schedule.factor, -MAX_FACTOR_STEP, MAX_FACTOR_STEP);
+
+	gain_schedule_scale(&gain_schedule.pitch2elevator, &config.control.pid_pitch2elevator, gain_schedule.factor);
+	gain_schedule_scale(&gain_schedule.roll2aileron, &config.control.pid_roll2aileron, gain_schedule.factor);
+}
+
+
+/*!
+ *   Copies the gains and limits, not the state. The control task must not
+ *   see a half written float.
+ */
+static void gain_schedule_scale(struct pid *active, const struct pid *configured, float factor)
+{
+	float p = configured->p_gain * factor,
+	      i = configured->i_gain * factor,
+	      d = configured->d_gain * factor;
+
+	taskENTER_CRITICAL();
+	active->p_gain = p;
+	active->i_gain = i;
+	active->d_gain = d;
+	active->i_min = configured->i_min;
+	active->i_max = configured->i_max;
+	active->d_term_min_var = configured->d_term_min_var;
+	taskEXIT_CRITICAL();
+}
@@ -0,0 +1,22 @@
+#ifndef GAIN_SCHEDULE_H
+#define GAIN_SCHEDULE_H
+
+#include "pid/pid.h"
+
+#define GAIN_SCHEDULE_BINS 6
+
+//! Active attitude pids of the wing control loop
+struct GainSchedule
+{
+	struct pid pitch2elevator;      // config.control.pid_pitch2elevator, scaled
+	struct pid roll2aileron;        // config.control.pid_roll2aileron, scaled
+	float airspeed_ms;              // the gains are scheduled for this airspeed
+	float factor;                   // applied on the configured p, i and d gains
+};
+
+extern struct GainSchedule gain_schedule;
+
+void gain_schedule_init();
+void gain_schedule_update();
+
+#endif // GAIN_SCHEDULE_H
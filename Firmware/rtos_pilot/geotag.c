@@ -0,0 +1,352 @@
+/*!
+ *  Records every camera trigger with its position and attitude, for the
+ *  geotagging of the photos.
+ *
+ *  The log only has trigger.trigger_counter, at 4Hz. Here trigger_servo()
+ *  calls geotag_trigger() when the servo moves: the time (us) and the
+ *  attitude and barometric height of that moment are kept, and the event
+ *  waits for the next GPS fix. The position is then interpolated between
+ *  the fixes before and after the trigger, on the time the GPS task took
+ *  them. The fix right after a trigger isn't used: it waited in the NMEA
+ *  buffer during the pulse, its time is unknown. Without a fix within
+ *  GEOTAG_MAX_GAP_US the position is extrapolated from the last one.
+ *  The UTC time is counted from the fix where the GPS second changed, so it
+ *  lags the real time by the output delay of the receiver.
+ *
+ *  The events go to a ring of GEOTAG_PAGES pages at the end of the log. The
+ *  page being filled is written after every event, by the datalogger, so a
+ *  power loss costs at most the last event. RG sends all events, oldest
+ *  first, tools/geotag_export turns them into a CSV for exiftool.
+ *
+ *  The CHDK mode doesn't fire the trigger per photo, it isn't recorded.
+ *
+ *  @file     geotag.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+#include "FreeRTOS/semphr.h"
+
+#include "dataflash/dataflash.h"
+
+#include "geotag.h"
+#include "sensors.h"
+#include "handler_trigger.h"
+#include "benchmark.h"
+#include "common.h"
+
+#define GEOTAG_MAGIC 0x4754
+
+extern xSemaphoreHandle xSpiSemaphore;
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+struct GeotagStatus geotag;
+
+static struct GeotagPage page;          // being filled
+static int first_page = -1;             // -1: no dataflash
+static int current = 0;                 // of the ring
+static int events_in_page = 0;
+static volatile int dirty = 0;
+static volatile int page_written_full = 0;
+
+static struct GeotagEvent pending[GEOTAG_PENDING];
+static int pending_events = 0;
+static int skip_fix = 0;
+
+//! The last fix taken on time
+static struct
+{
+	int valid;
+	unsigned long time_us;
+	double latitude_rad, longitude_rad;
+	long latitude_e7, longitude_e7;
+	float height_m;
+	float speed_ms;
+	float heading_rad;
+	int satellites;
+	long date;
+} last;
+
+//! The fix where the GPS second changed
+static long second_time = -1;           // hhmmss
+static unsigned long second_us;
+
+
+/*!
+ *   Takes the ring from the end of the log and continues after its newest
+ *   page. Called after dataflash_ftl_open(), before the scheduler starts.
+ */
+void geotag_open()
+{
+	unsigned int header[2];         // magic, sequence
+	unsigned int newest_sequence = 0;
+	int i, newest = -1;
+
+	if (PAGE_SIZE < sizeof(struct GeotagPage))   // also when there is no flash
+		return;
+
+	first_page = MAX_PAGE + 1 - GEOTAG_PAGES;
+	MAX_PAGE = first_page - 1;
+
+	for (i = 0; i < GEOTAG_PAGES; i++)
+	{
+		dataflash.read(first_page + i, sizeof(header), (unsigned char*)header);
+		if (header[0] == GEOTAG_MAGIC && (newest < 0 || (int)(header[1] - newest_sequence) > 0))
+		{
+			newest = i;
+			newest_sequence = header[1];
+		}
+	}
+
+	page.magic = GEOTAG_MAGIC;
+	page.sequence = newest < 0 ? 0 : newest_sequence + 1;
+	current = newest < 0 ? 0 : (newest + 1) % GEOTAG_PAGES;
+	memset(page.event, GEOTAG_FREE, sizeof(page.event));
+}
+
+
+static long to_e7(double rad)
+{
+	return (long)(RAD2DEG(rad) * 10000000.0);
+}
+
+
+/*!
+ *   Called by trigger_servo() in the GPS task, when the servo moves.
+ */
+void geotag_trigger()
+{
+	struct GeotagEvent *e;
+	float yaw;
+	int i;
+
+	if (first_page < 0)
+		return;
+
+	if (pending_events == GEOTAG_PENDING)   // no fix for a while: make room
+		geotag_update(0);
+	if (pending_events == GEOTAG_PENDING)
+	{
+		geotag.lost++;
+		for (i = 1; i < GEOTAG_PENDING; i++)
+			pending[i - 1] = pending[i];
+		pending_events--;
+	}
+
+	e = &pending[pending_events++];
+	e->time_us = benchmark_time_us();
+	e->number = trigger.trigger_counter;
+	e->height_dm = (int)(sensor_data.pressure_height * 10.0f);
+	e->roll_cdeg = (int)(RAD2DEG(sensor_data.roll) * 100.0f);
+	e->pitch_cdeg = (int)(RAD2DEG(sensor_data.pitch) * 100.0f);
+	yaw = RAD2DEG(sensor_data.yaw);
+	while (yaw < 0.0f)
+		yaw += 360.0f;
+	while (yaw >= 360.0f)
+		yaw -= 360.0f;
+	e->yaw_cdeg = (unsigned int)(yaw * 100.0f);
+
+	skip_fix = 1;
+}
+
+
+/*!
+ *   Positions an event from the last fix and, when new_fix, the one the GPS
+ *   task just took at now_us.
+ */
+static void geotag_locate(struct GeotagEvent *e, int new_fix, unsigned long now_us)
+{
+	float f, dt_s;
+
+	if (! last.valid && ! new_fix)
+	{
+		e->flags = GEOTAG_NO_FIX;
+		e->satellites = 0;
+		e->date = 0;
+		e->utc_ms = 0;
+		e->latitude_e7 = e->longitude_e7 = 0;
+		e->gps_height_dm = 0;
+		return;
+	}
+
+	if (! last.valid)   // the first fix, after the trigger
+	{
+		e->flags = 0;
+		e->latitude_e7 = to_e7(sensor_data.gps.latitude_rad);
+		e->longitude_e7 = to_e7(sensor_data.gps.longitude_rad);
+		e->gps_height_dm = sensor_data.gps.height_m * 10;
+		e->satellites = sensor_data.gps.satellites_in_view;
+		e->date = sensor_data.gps.date;
+	}
+	else if (new_fix && now_us - last.time_us <= GEOTAG_MAX_GAP_US)
+	{
+		f = (float)(e->time_us - last.time_us) / (float)(now_us - last.time_us);
+		e->flags = GEOTAG_INTERPOLATED;
+		// the difference keeps the resolution of the fixes
+		e->latitude_e7 = last.latitude_e7 + (long)(RAD2DEG(sensor_data.gps.latitude_rad - last.latitude_rad) * 10000000.0 * f);
+		e->longitude_e7 = last.longitude_e7 + (long)(RAD2DEG(sensor_data.gps.longitude_rad - last.longitude_rad) * 10000000.0 * f);
+		e->gps_height_dm = (int)((last.height_m + ((float)sensor_data.gps.height_m - last.height_m) * f) * 10.0f);
+		e->satellites = sensor_data.gps.satellites_in_view;
+		e->date = sensor_data.gps.date;
+	}
+	else
+	{
+		dt_s = (float)(e->time_us - last.time_us) / 1000000.0f;
+		e->flags = GEOTAG_EXTRAPOLATED;
+		e->latitude_e7 = last.latitude_e7 +
+			(long)(RAD2DEG(last.speed_ms * cosf(last.heading_rad) * dt_s / latitude_meter_per_radian) * 10000000.0);
+		e->longitude_e7 = last.longitude_e7 +
+			(long)(RAD2DEG(last.speed_ms * sinf(last.heading_rad) * dt_s / longitude_meter_per_radian) * 10000000.0);
+		e->gps_height_dm = (int)(last.height_m * 10.0f);
+		e->satellites = last.satellites;
+		e->date = last.date;
+	}
+
+	if (second_time < 0)
+		e->utc_ms = 0;
+	else
+		e->utc_ms = ((second_time / 10000) * 3600UL + ((second_time / 100) % 100) * 60UL + second_time % 100) * 1000UL +
+		            (e->time_us - second_us) / 1000UL;
+	if (e->utc_ms >= 86400000UL)
+		e->utc_ms -= 86400000UL;
+}
+
+
+/*!
+ *   Puts an event in the page, the datalogger writes it.
+ */
+static void geotag_store(struct GeotagEvent *e)
+{
+	if (events_in_page == GEOTAG_EVENTS_PER_PAGE)
+	{
+		if (! page_written_full)
+		{
+			geotag.lost++;
+			return;
+		}
+		current = (current + 1) % GEOTAG_PAGES;
+		page.sequence++;
+		memset(page.event, GEOTAG_FREE, sizeof(page.event));
+		events_in_page = 0;
+		page_written_full = 0;
+	}
+	page.event[events_in_page++] = *e;
+	geotag.events++;
+	dirty = 1;
+}
+
+
+static void geotag_finish_first(int new_fix, unsigned long now_us)
+{
+	int i;
+
+	geotag_locate(&pending[0], new_fix, now_us);
+	geotag_store(&pending[0]);
+	for (i = 1; i < pending_events; i++)
+		pending[i - 1] = pending[i];
+	pending_events--;
+}
+
+
+/*!
+ *   Called by the GPS task every cycle, before gluonscript_do.
+ *   @param new_fix 1 when a new RMC sentence with a fix was read
+ */
+void geotag_update(int new_fix)
+{
+	unsigned long now_us = benchmark_time_us();
+
+	if (first_page < 0)
+		return;
+
+	if (new_fix && skip_fix)
+	{
+		skip_fix = 0;
+		new_fix = 0;
+	}
+
+	if (new_fix)
+	{
+		while (pending_events > 0)
+			geotag_finish_first(1, now_us);
+
+		if (sensor_data.gps.time != second_time)
+		{
+			second_time = sensor_data.gps.time;
+			second_us = now_us;
+		}
+		last.valid = 1;
+		last.time_us = now_us;
+		last.latitude_rad = sensor_data.gps.latitude_rad;
+		last.longitude_rad = sensor_data.gps.longitude_rad;
+		last.latitude_e7 = to_e7(last.latitude_rad);
+		last.longitude_e7 = to_e7(last.longitude_rad);
+		last.height_m = (float)sensor_data.gps.height_m;
+		last.speed_ms = sensor_data.gps.speed_ms;
+		last.heading_rad = sensor_data.gps.heading_rad;
+		last.satellites = sensor_data.gps.satellites_in_view;
+		last.date = sensor_data.gps.date;
+	}
+
+	while (pending_events > 0 && now_us - pending[0].time_us > GEOTAG_MAX_GAP_US)
+		geotag_finish_first(0, now_us);
+}
+
+
+/*!
+ *   Writes the page when it changed, called by the datalogger.
+ *   The GPS task has a higher priority: an event is always stored in one
+ *   piece as seen from here, but it can be stored while the page is being
+ *   sent to the flash. The flags come first in the event, so that event is
+ *   either complete or still GEOTAG_FREE on the flash, and it is written
+ *   again at the next call.
+ */
+void geotag_flush()
+{
+	int n;
+
+	if (! dirty)
+		return;
+	if (xSemaphoreTake(xSpiSemaphore, (portTickType) 0) != pdTRUE)   // try again at the next call
+		return;
+	dirty = 0;
+	n = events_in_page;
+	dataflash.write(first_page + current, sizeof(page), (unsigned char*)&page);
+	xSemaphoreGive(xSpiSemaphore);
+	if (n == GEOTAG_EVENTS_PER_PAGE)
+		page_written_full = 1;
+}
+
+
+/*!
+ *   Sends all events in the flash to printer, oldest first.
+ *   The current page is the oldest one until it is written after startup.
+ */
+void geotag_print(void (*printer)(struct GeotagEvent*))
+{
+	struct GeotagPage p;
+	int i, j;
+
+	if (first_page < 0)
+		return;
+
+	for (i = 0; i <= GEOTAG_PAGES; i++)
+	{
+		if (xSemaphoreTake(xSpiSemaphore, (portTickType) 100 / portTICK_RATE_MS) != pdTRUE)
+			continue;
+		dataflash.read(first_page + (current + i) % GEOTAG_PAGES, sizeof(p), (unsigned char*)&p);
+		xSemaphoreGive(xSpiSemaphore);
+		if (p.magic != GEOTAG_MAGIC)
+			continue;
+		if ((i == 0 && p.sequence == page.sequence) || (i == GEOTAG_PAGES && p.sequence != page.sequence))
+			continue;
+		for (j = 0; j < GEOTAG_EVENTS_PER_PAGE && p.event[j].flags != GEOTAG_FREE; j++)
+			printer(&p.event[j]);
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef GEOTAG_H
+#define GEOTAG_H
+
+#define GEOTAG_PAGES 256             //!< taken from the end of the log, a ring
+#define GEOTAG_EVENTS_PER_PAGE 7     //!< fits the 264 byte pages of the smallest flash
+#define GEOTAG_PENDING 4             //!< triggers waiting for the next fix
+#define GEOTAG_MAX_GAP_US 4000000UL  //!< longer without a fix: extrapolated
+
+#define GEOTAG_INTERPOLATED 0x01     //!< between the fixes before and after the trigger
+#define GEOTAG_EXTRAPOLATED 0x02     //!< no fix after the trigger: from the speed and heading of the one before
+#define GEOTAG_NO_FIX 0x04           //!< no fix yet: no position, date and time
+#define GEOTAG_FREE 0xFF
+
+
+/*!
+ *   One camera trigger. 34 bytes.
+ */
+struct GeotagEvent
+{
+	unsigned char flags;            //!< GEOTAG_*, GEOTAG_FREE for an empty slot. First: see geotag_flush()
+	unsigned char satellites;
+	unsigned int number;            //!< trigger.trigger_counter: 0 for the first photo after startup
+	unsigned long time_us;          //!< since startup, when the servo moved
+	long date;                      //!< ddmmyy
+	unsigned long utc_ms;           //!< since midnight
+	long latitude_e7;               //!< degrees * 10^7
+	long longitude_e7;
+	int gps_height_dm;
+	int height_dm;                  //!< barometric
+	int roll_cdeg;                  //!< 0.01 degree
+	int pitch_cdeg;
+	unsigned int yaw_cdeg;          //!< 0...35999
+};
+
+struct GeotagPage
+{
+	unsigned int magic;
+	unsigned int sequence;          //!< +1 for every page, the highest is the newest
+	struct GeotagEvent event[GEOTAG_EVENTS_PER_PAGE];
+};
+
+struct GeotagStatus
+{
+	unsigned int events;            //!< since startup
+	unsigned int lost;              //!< the page was full and not written yet
+};
+
+extern struct GeotagStatus geotag;
+
+void geotag_open();
+void geotag_trigger();
+void geotag_update(int new_fix);
+void geotag_flush();
+void geotag_print(void (*printer)(struct GeotagEvent*));
+
+#endif // GEOTAG_H
@@ -1,6 +1,7 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 // Include all FreeRTOS header files
 #include "FreeRTOS/FreeRTOS.h"
@@ -19,17 +20,88 @@
 #include "handler_navigation.h"
 #include "handler_flightplan_switch.h"
 #include "handler_maximum_range.h"
+#include "handler_geofence.h"
+#include "handler_watch.h"
+#include "dubins_path.h"
 #include "sensors.h"
 #include "task_control.h"
 #include "configuration.h"
 #include "gluonscript.h"
 
 
-volatile struct GluonscriptData gluonscript_data = {.current_codeline = 0, .last_code = 0, .tick = 0 };
+volatile struct GluonscriptData gluonscript_data = {.last_code = 0, .tick = 0, .lines = 0, .blocks = 0 };
+volatile struct GluonscriptContext gluonscript_context = {.current_codeline = 0, .stack_depth = 0, .time_block_s = 0, .stack_errors = 0 };
+
+#ifdef __XC16__
+	#define PERSISTENT __attribute__((persistent))   // not cleared by the startup code
+#else
+	#define PERSISTENT
+#endif
+
+#define GLUONSCRIPT_CONTEXT_MAGIC 0x4743
+
+/*!
+ *  Copy of the context and the navigation state of the last tick, for a warm
+ *  restart after a reset in flight. Without the home position the next fix
+ *  would become home: the relative waypoints, HOME_DISTANCE, the maximum
+ *  range and return-home would all use the place of the reset.
+ */
+struct GluonscriptSaved
+{
+	double home_latitude_rad;
+	double home_longitude_rad;
+	float home_gps_height;
+	float home_pressure_height;
+	float last_waypoint_latitude_rad;
+	float last_waypoint_longitude_rad;
+	float last_waypoint_altitude_agl;
+	float loiter_waypoint_latitude_rad;
+	float loiter_waypoint_longitude_rad;
+	float loiter_waypoint_altitude_agl;
+	float wind_heading;
+	unsigned int wind_heading_set;
+	unsigned int airborne;
+	unsigned int time_airborne_s;
+	struct GluonscriptContext context;
+};
+
+static PERSISTENT struct GluonscriptSaved saved;
+static PERSISTENT unsigned int saved_check;
+
+extern xSemaphoreHandle xSpiSemaphore;
+
+/*!
+ *  The flightplan lives in the NAVIGATION_PAGES last pages of the dataflash,
+ *  GLUONSCRIPT_PAGE_CODES lines per page. Only GLUONSCRIPT_CACHE_PAGES pages
+ *  are kept in RAM: a line that is not cached faults its page in, and
+ *  gluonscript_prefetch() loads the pages we are about to need from the
+ *  (low priority) datalogger task so this rarely happens in flight.
+ *  Other tasks only get copies of the lines, so a page can be replaced at any
+ *  time. The cached pages are exactly what is in the flash: relative waypoints
+ *  are converted when they're read.
+ */
+#define GLUONSCRIPT_PAGE_MAGIC 0x4750
+#define FAULT_WAIT_TICKS ((portTickType) 100 / portTICK_RATE_MS)
+
+struct GluonscriptPage
+{
+	struct GluonscriptCode code[GLUONSCRIPT_PAGE_CODES];
+	unsigned int magic;       //!< pages without it (never written, old log data) are empty
+};
+
+static struct GluonscriptCode cache[GLUONSCRIPT_CACHE_PAGES][GLUONSCRIPT_PAGE_CODES];
+static int cache_page[GLUONSCRIPT_CACHE_PAGES] = { -1, -1, -1, -1, -1, -1 };
+static unsigned int cache_used[GLUONSCRIPT_CACHE_PAGES];
+static unsigned int cache_clock = 0;
+
+//! Only used while holding xSpiSemaphore.
+static struct GluonscriptPage page_buffer;
+
+static void gluonscript_update_blocks(int line, struct GluonscriptCode *code);
 
 void gluonscript_init()
 {
-	gluonscript_data.current_codeline = 0;
+	gluonscript_restart();
 	gluonscript_data.last_code = 0;
 	gluonscript_data.tick = 0;
 	gluonscript_load();
@@ -37,53 +109,160 @@ void gluonscript_init()
 }	
 
 
-#define STACK_DEPTH 3
-int stack[STACK_DEPTH] = { 0, 0, 0 }; // lets start with a 2-level stack
-int stack_pointer = -1;
+/*!
+ *   Starts the flightplan from the first line, without return addresses.
+ */
+void gluonscript_restart()
+{
+	taskENTER_CRITICAL();
+	gluonscript_context.current_codeline = 0;
+	gluonscript_context.stack_depth = 0;
+	gluonscript_context.time_block_s = 0;
+	gluonscript_context.stack_errors = 0;
+	taskEXIT_CRITICAL();
+}
+
 
-void push_codeline()
+/*!
+ *   Copies the context, consistent even when gluonscript_do is busy.
+ */
+void gluonscript_get_context(struct GluonscriptContext *context)
 {
-	if (stack_pointer < STACK_DEPTH-1)
-	{
-		stack_pointer++;
-		stack[stack_pointer] = gluonscript_data.current_codeline;
-	}
-	else // stack full
-	{
-		stack_pointer = 0;
-		stack[stack_pointer] = gluonscript_data.current_codeline;
-	}
+	taskENTER_CRITICAL();
+	*context = gluonscript_context;
+	taskEXIT_CRITICAL();
 }
 
-void pop_codeline()
+
+static unsigned int gluonscript_saved_check(struct GluonscriptSaved *s)
+{
+	unsigned int check = GLUONSCRIPT_CONTEXT_MAGIC, *word = (unsigned int *)s;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(struct GluonscriptSaved) / sizeof(unsigned int); i++)
+		check = ((check << 1) | (check >> 15)) ^ word[i];
+	return check;
+}
+
+
+/*!
+ *   Continues the flightplan where it was before the reset, when the saved
+ *   context survived it. Call after gluonscript_init. Returns 0 if it didn't.
+ *   In flight, the home position and the take-off state come back with it.
+ */
+int gluonscript_resume()
 {
-	if (stack_pointer > 0)
+	if (saved_check != gluonscript_saved_check(&saved) ||
+	    saved.context.current_codeline < 0 || saved.context.current_codeline >= MAX_GLUONSCRIPTCODES ||
+	    saved.context.stack_depth < 0 || saved.context.stack_depth > GLUONSCRIPT_STACK_DEPTH)
+		return 0;
+
+	taskENTER_CRITICAL();
+	gluonscript_context = saved.context;
+	if (saved.airborne)
 	{
-		gluonscript_data.current_codeline = stack[stack_pointer];
-		stack_pointer--;
+		navigation_data.home_latitude_rad = saved.home_latitude_rad;
+		navigation_data.home_longitude_rad = saved.home_longitude_rad;
+		navigation_data.home_gps_height = saved.home_gps_height;
+		navigation_data.home_pressure_height = saved.home_pressure_height;
+		navigation_data.last_waypoint_latitude_rad = saved.last_waypoint_latitude_rad;
+		navigation_data.last_waypoint_longitude_rad = saved.last_waypoint_longitude_rad;
+		navigation_data.last_waypoint_altitude_agl = saved.last_waypoint_altitude_agl;
+		navigation_data.loiter_waypoint_latitude_rad = saved.loiter_waypoint_latitude_rad;
+		navigation_data.loiter_waypoint_longitude_rad = saved.loiter_waypoint_longitude_rad;
+		navigation_data.loiter_waypoint_altitude_agl = saved.loiter_waypoint_altitude_agl;
+		navigation_data.wind_heading = saved.wind_heading;
+		navigation_data.wind_heading_set = saved.wind_heading_set;
+		navigation_data.time_airborne_s = saved.time_airborne_s;
+		navigation_data.airborne = 1;
+		navigation_resume_home();
 	}
-	else if (stack_pointer == 0)
+	taskEXIT_CRITICAL();
+	return 1;
+}
+
+
+/*!
+ *   Keeps the context and the navigation state of this tick for
+ *   gluonscript_resume(). A reset while it is being written leaves a wrong
+ *   check word: the pilot then starts over, as without a saved context.
+ */
+static void gluonscript_save()
+{
+	saved.home_latitude_rad = navigation_data.home_latitude_rad;
+	saved.home_longitude_rad = navigation_data.home_longitude_rad;
+	saved.home_gps_height = navigation_data.home_gps_height;
+	saved.home_pressure_height = navigation_data.home_pressure_height;
+	saved.last_waypoint_latitude_rad = navigation_data.last_waypoint_latitude_rad;
+	saved.last_waypoint_longitude_rad = navigation_data.last_waypoint_longitude_rad;
+	saved.last_waypoint_altitude_agl = navigation_data.last_waypoint_altitude_agl;
+	saved.loiter_waypoint_latitude_rad = navigation_data.loiter_waypoint_latitude_rad;
+	saved.loiter_waypoint_longitude_rad = navigation_data.loiter_waypoint_longitude_rad;
+	saved.loiter_waypoint_altitude_agl = navigation_data.loiter_waypoint_altitude_agl;
+	saved.wind_heading = navigation_data.wind_heading;
+	saved.wind_heading_set = navigation_data.wind_heading_set;
+	saved.airborne = navigation_data.airborne;
+	saved.time_airborne_s = navigation_data.time_airborne_s;
+	saved.context = gluonscript_context;
+	saved_check = gluonscript_saved_check(&saved);
+}
+
+
+/*!
+ *   CALL: saves the return address. On a full stack the CALL is skipped:
+ *   not running a subroutine is better than returning to the wrong line.
+ *   Returns 0 in that case.
+ */
+static int push_codeline()
+{
+	if (gluonscript_context.stack_depth >= GLUONSCRIPT_STACK_DEPTH)
 	{
-		gluonscript_data.current_codeline = stack[stack_pointer];
-		stack_pointer = STACK_DEPTH-1;
+		gluonscript_context.stack_errors++;
+		printf("\r\nGluonscript stack full: CALL on line %d skipped\r\n", gluonscript_context.current_codeline + 1);
+		return 0;
 	}
+	gluonscript_context.stack[gluonscript_context.stack_depth] = gluonscript_context.current_codeline;
+	gluonscript_context.stack_depth++;
+	return 1;
 }
 
-inline int stack_empty()
+/*!
+ *   RETURN: back to the CALL line. Without return address, nothing changes.
+ */
+static void pop_codeline()
 {
-	return stack_pointer <= -1;
+	if (gluonscript_context.stack_depth > 0)
+	{
+		gluonscript_context.stack_depth--;
+		gluonscript_context.current_codeline = gluonscript_context.stack[gluonscript_context.stack_depth];
+	}
+	else
+		gluonscript_context.stack_errors++;
 }
 
 
 void gluonscript_do()  // executed when a new GPS line has arrived (5Hz)
 {
-	struct GluonscriptCode *current_code = & gluonscript_data.codes[gluonscript_data.current_codeline];
+	struct GluonscriptCode code;
+	struct GluonscriptCode *current_code = &code;
 	ScriptHandlerReturn handlers_result = 0;
-	
+	int watch_jump = watch_take_jump();
+
+	if (watch_jump >= 0)   // the target line is executed in this same tick
+	{
+		printf("\r\nWatch: new block selected\r\n");
+		gluonscript_context.current_codeline = watch_jump;
+	}
+
+	if (! gluonscript_get_code(gluonscript_context.current_codeline, &code))
+		return;  // its page couldn't be loaded from the flash, try again next time
+
 	gluonscript_data.tick++;
 	
 	// call all handlers, returns UNHANDLED 0, HANDLED_FINISHED 1 or HANDLED_UNFINISHED 2
     handlers_result |= maximum_range_handle_gluonscriptcommand(current_code);
+    handlers_result |= geofence_handle_gluonscriptcommand(current_code);
+    handlers_result |= watch_handle_gluonscriptcommand(current_code);
     handlers_result |= flightplan_switch_handle_gluonscriptcommand(current_code);
 	handlers_result |= alarms_handle_gluonscriptcommand(current_code);
  	handlers_result |= trigger_handle_gluonscriptcommand(current_code);
@@ -91,76 +270,77 @@ void gluonscript_do()  // executed when a new GPS line has arrived (5Hz)
  	
  	if (handlers_result & HANDLED_FINISHED)  // one of the handlers already handled it completely
  	{
-		gluonscript_data.current_codeline++;
+		gluonscript_context.current_codeline++;
 	}
 	else
 	{
 		switch(current_code->opcode)
 		{
 			case CALL:
-				push_codeline();
-				if (current_code->a < 0)
-					gluonscript_data.current_codeline = gluonscript_data.current_codeline + current_code->a;
+				if (! push_codeline())
+					gluonscript_context.current_codeline++;
+				else if (current_code->a < 0)
+					gluonscript_context.current_codeline = gluonscript_context.current_codeline + current_code->a;
 				else
-					gluonscript_data.current_codeline = current_code->a;
+					gluonscript_context.current_codeline = current_code->a;
 				break;
 			case RETURN:
 				pop_codeline();
-				gluonscript_data.current_codeline++;
+				gluonscript_context.current_codeline++;
 				break;
 			case GOTO:
 				if (current_code->a < 0)
-					gluonscript_data.current_codeline = gluonscript_data.current_codeline + current_code->a;
+					gluonscript_context.current_codeline = gluonscript_context.current_codeline + current_code->a;
 				else
-					gluonscript_data.current_codeline = current_code->a;
+					gluonscript_context.current_codeline = current_code->a;
 				break;
 			case UNTIL_GR:
 				if (gluonscript_get_variable(current_code->a) > current_code->x)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline--;
+					gluonscript_context.current_codeline--;
 				break;
 			case UNTIL_SM:
 				if (gluonscript_get_variable(current_code->a) < current_code->x)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline--;
+					gluonscript_context.current_codeline--;
 				break;
 			case UNTIL_EQ:
 				if (fabs(gluonscript_get_variable(current_code->a) - current_code->x) < 1e-6f)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline--;
+					gluonscript_context.current_codeline--;
 				break;
 			case UNTIL_NE:
 				if (fabs(gluonscript_get_variable(current_code->a) - current_code->x) > 1e-6f)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline--;
+					gluonscript_context.current_codeline--;
 				break;
 			case IF_GR:
 				if (gluonscript_get_variable(current_code->a) > current_code->x)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline += 2;
+					gluonscript_context.current_codeline += 2;
 				break;
 			case IF_SM:
 				if (gluonscript_get_variable(current_code->a) < current_code->x)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline += 2;
+					gluonscript_context.current_codeline += 2;
 				break;
 			case IF_EQ:
 				if (fabs(gluonscript_get_variable(current_code->a) - current_code->x) < 1e-6f)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline += 2;
+					gluonscript_context.current_codeline += 2;
 				break;
 			case IF_NE:
 				if (fabs(gluonscript_get_variable(current_code->a) - current_code->x) > 1e-6f)
-					gluonscript_data.current_codeline++;
+					gluonscript_context.current_codeline++;
 				else
-					gluonscript_data.current_codeline += 2;
+					gluonscript_context.current_codeline += 2;
 				break;
 			case SERVO_SET:
 
@@ -183,17 +363,18 @@ void gluonscript_do()  // executed when a new GPS line has arrived (5Hz)
                     servo_set_us(current_code->a, current_code->b);  // a = channel(0..7), b = microseconds (1000...2000)
                 }
                 
-                gluonscript_data.current_codeline++;
+                gluonscript_context.current_codeline++;
 				break;
 	        case BLOCK:
-	            navigation_data.time_block_s = 0;
-	            gluonscript_data.current_codeline++;
+	            gluonscript_context.time_block_s = 0;
+	            gluonscript_context.current_codeline++;
 	            break;
 			case EMPTYCMD: // should not happen!!!
 				navigation_data.desired_pre_bank = 0.0f;
 				navigation_data.desired_throttle_pct = -1;
                 //printf("\r\nEmpty navigation command\r\n");
-				gluonscript_data.current_codeline = 0;
+				gluonscript_context.current_codeline = 0;
+				gluonscript_context.stack_depth = 0;
 				// also return home @ 100m height
 				navigation_data.desired_heading_rad = navigation_heading_rad_fromto(sensor_data.gps.longitude_rad,
 		                                                   		         sensor_data.gps.latitude_rad);
@@ -204,7 +385,8 @@ void gluonscript_do()  // executed when a new GPS line has arrived (5Hz)
 				{
 					navigation_data.desired_pre_bank = 0.0f;
                     printf("\r\nUnhandled navigation command: opcode %d\r\n", current_code->opcode);
-					gluonscript_data.current_codeline = 0;
+					gluonscript_context.current_codeline = 0;
+					gluonscript_context.stack_depth = 0;
 					// also return home @ 100m height
 					navigation_data.desired_heading_rad = navigation_heading_rad_fromto(sensor_data.gps.longitude_rad,
 			                                                   		         sensor_data.gps.latitude_rad);
@@ -213,17 +395,77 @@ void gluonscript_do()  // executed when a new GPS line has arrived (5Hz)
 				break;
 		}
 	}	
+
+	gluonscript_save();
 }
 
+/*!
+ *   Jump from the ground station. When the block ends with a RETURN, the
+ *   flightplan continues where it was interrupted: the stack is replaced by
+ *   that one return address, so repeated jumps don't pile up the return
+ *   addresses of subroutines that were left.
+ */
 void gluonscript_goto_from_gcs(int line_number)
 {
-	gluonscript_data.current_codeline--;  // because RETURN does pop+1
-	push_codeline(); // in case this is a function. In case it's not: our circular buffer will handle it.
-	if (line_number >= 0 && line_number < MAX_GLUONSCRIPTCODES)
-		gluonscript_data.current_codeline = line_number;
+	if (line_number < 0 || line_number >= MAX_GLUONSCRIPTCODES)
+		return;
+
+	taskENTER_CRITICAL();
+	gluonscript_context.stack[0] = gluonscript_context.current_codeline - 1;  // because RETURN does pop+1
+	gluonscript_context.stack_depth = 1;
+	gluonscript_context.current_codeline = line_number;
+	taskEXIT_CRITICAL();
 }
 
+/*!
+ *  The variables are computed at most once per gluonscript tick: IF/UNTIL
+ *  lines and the handlers all read the same snapshot. It stands still when
+ *  gluonscript doesn't tick (a page fault), so the OSD and the telemetry
+ *  show live values instead. It is only accessed in critical sections, in
+ *  case another task reads it.
+ */
+static float snapshot_value[ABS_ALT_AND_HEADING_ERR + 1];
+static unsigned long snapshot_valid = 0;   //!< bit i set: snapshot_value[i] is from this tick
+static unsigned int snapshot_tick = 0;
+
 float gluonscript_get_variable(enum gluonscript_variable i)
+{
+	float value;
+	int valid;
+
+	if (i < 0 || i > ABS_ALT_AND_HEADING_ERR)
+		return 0.0;
+
+	taskENTER_CRITICAL();
+	if (snapshot_tick != gluonscript_data.tick)
+	{
+		snapshot_tick = gluonscript_data.tick;
+		snapshot_valid = 0;
+	}
+	valid = (snapshot_valid & (1ul << i)) != 0;
+	value = snapshot_value[i];
+	taskEXIT_CRITICAL();
+
+	if (valid)
+		return value;
+
+	value = gluonscript_live_variable(i);
+
+	taskENTER_CRITICAL();
+	if (snapshot_tick == gluonscript_data.tick)
+	{
+		snapshot_value[i] = value;
+		snapshot_valid |= 1ul << i;
+	}
+	taskEXIT_CRITICAL();
+	return value;
+}
+
+
+/*!
+ *   Computes a variable from the current sensor data, outside the snapshot.
+ */
+float gluonscript_live_variable(enum gluonscript_variable i)
 {
 	switch (i)
 	{
@@ -266,20 +508,22 @@ float gluonscript_get_variable(enum gluonscript_variable i)
 		case BATT_V:
 			return (float)(sensor_data.battery1_voltage_10)/10.0f;
         case BLOCK_TIME:
-            return (float)navigation_data.time_block_s;
+            return (float)gluonscript_context.time_block_s;
         case ABS_ALTITUDE_ERROR:
         	return fabs(control_state.desired_altitude - gluonscript_get_variable(HEIGHT));
         case ABS_HEADING_ERROR:
         {
-	        struct GluonscriptCode *next_code = & gluonscript_data.codes[gluonscript_data.current_codeline+1];
+	        struct GluonscriptCode next;
+	        struct GluonscriptCode *next_code = &next;
+	        gluonscript_get_code(gluonscript_context.current_codeline+1, next_code);
 	        if (next_code->opcode != FROM_TO_ABS && next_code->opcode != FLY_TO_ABS && next_code->opcode != CIRCLE_ABS && 
                 next_code->opcode != FLARE_TO_ABS && next_code->opcode != GLIDE_TO_ABS && next_code->opcode != CIRCLE_TO_ABS)  // was || next_code->opcode != CIRCLE_TO_ABS
             {
-                next_code = & gluonscript_data.codes[gluonscript_data.current_codeline+2];
+                gluonscript_get_code(gluonscript_context.current_codeline+2, next_code);
 	            if (next_code->opcode != FROM_TO_ABS && next_code->opcode != FLY_TO_ABS && next_code->opcode != CIRCLE_ABS && 
 	                next_code->opcode != FLARE_TO_ABS && next_code->opcode != GLIDE_TO_ABS && next_code->opcode != CIRCLE_TO_ABS)
 	            {
-	                next_code = & gluonscript_data.codes[gluonscript_data.current_codeline+3];
+	                gluonscript_get_code(gluonscript_context.current_codeline+3, next_code);
 	            	if (next_code->opcode != FROM_TO_ABS && next_code->opcode != FLY_TO_ABS && next_code->opcode != CIRCLE_ABS && 
 	                	next_code->opcode != FLARE_TO_ABS && next_code->opcode != GLIDE_TO_ABS && next_code->opcode != CIRCLE_TO_ABS)
 	               		printf("\r\nBad ABS_HEADING_ERR position\r\n");
@@ -297,7 +541,7 @@ float gluonscript_get_variable(enum gluonscript_variable i)
 	    } 
         case ABS_ALT_AND_HEADING_ERR:
         {
-            /*struct GluonscriptCode *next = gluonscript_next_waypoint_code(gluonscript_data.current_codeline);
+            /*struct GluonscriptCode *next = gluonscript_next_waypoint_code(gluonscript_context.current_codeline);
 			                
             float heading_error = navigation_heading_rad_fromto((float)(sensor_data.gps.longitude_rad - (double)(next->y)),
 	                                                           (float)(sensor_data.gps.latitude_rad - (double)(next->x)));
@@ -315,9 +559,9 @@ float gluonscript_get_variable(enum gluonscript_variable i)
 }	
 
 
-struct GluonscriptCode * gluonscript_next_waypoint_code(int current_codeline)
+void gluonscript_next_waypoint_code(int current_codeline, struct GluonscriptCode *next)
 {
-	struct GluonscriptCode *next = & (gluonscript_data.codes[current_codeline+1]);
+	gluonscript_get_code(current_codeline+1, next);
 	
 	if (next->opcode != FROM_TO_ABS && next->opcode != FLY_TO_ABS && next->opcode != CIRCLE_ABS && 
         next->opcode != FLARE_TO_ABS && next->opcode != GLIDE_TO_ABS && next->opcode != CIRCLE_TO_ABS)
@@ -330,7 +574,7 @@ struct GluonscriptCode * gluonscript_next_waypoint_code(int current_codeline)
 				current_codeline = (current_codeline + 1) + next->a - 2;
 		}		
 		
-		next = & gluonscript_data.codes[current_codeline+2];
+		gluonscript_get_code(current_codeline+2, next);
 		if (next->opcode != FROM_TO_ABS && next->opcode != FLY_TO_ABS && next->opcode != CIRCLE_ABS && 
             next->opcode != FLARE_TO_ABS && next->opcode != GLIDE_TO_ABS && next->opcode != CIRCLE_TO_ABS)
 		{
@@ -341,23 +585,328 @@ struct GluonscriptCode * gluonscript_next_waypoint_code(int current_codeline)
 				else
 					current_codeline = (current_codeline + 1) + next->a - 3;
 			}
-			next = & gluonscript_data.codes[current_codeline+3];
+			gluonscript_get_code(current_codeline+3, next);
 			if (next->opcode != FROM_TO_ABS && next->opcode != FLY_TO_ABS && next->opcode != CIRCLE_ABS && 
 			    next->opcode != FLARE_TO_ABS && next->opcode != GLIDE_TO_ABS)
 				printf("\r\nNext code not found!!\r\n");
 		}   		
 	}
-	return next;
 }
 
 
-void gluonscript_burn()
+/*!
+ *   Reads a flightplan page in page_buffer. Take xSpiSemaphore first!
+ */
+static void gluonscript_read_page(int page)
+{
+	dataflash.read(NAVIGATION_PAGE + page, sizeof(page_buffer), (unsigned char*) & page_buffer);
+	if (page_buffer.magic != GLUONSCRIPT_PAGE_MAGIC)
+	{
+		memset(& page_buffer, 0, sizeof(page_buffer));
+		page_buffer.magic = GLUONSCRIPT_PAGE_MAGIC;
+	}
+}
+
+
+/*!
+ *   Returns the cache slot holding this page, -1 if it is not cached.
+ *   Call inside a critical section.
+ */
+static int gluonscript_cached(int page)
+{
+	int i;
+	for (i = 0; i < GLUONSCRIPT_CACHE_PAGES; i++)
+		if (cache_page[i] == page)
+			return i;
+	return -1;
+}
+
+
+/*!
+ *   Loads a page in the least recently used slot. The page of the current line
+ *   and the next one are never replaced. Returns 0 when the flash was not
+ *   available within the given time.
+ */
+static int gluonscript_cache_page(int page, portTickType wait)
+{
+	int i, slot = -1;
+	int current = gluonscript_context.current_codeline / GLUONSCRIPT_PAGE_CODES;
+
+	if (xSemaphoreTake( xSpiSemaphore, wait ) != pdTRUE)
+		return 0;
+	gluonscript_read_page(page);
+
+	taskENTER_CRITICAL();
+	if (gluonscript_cached(page) < 0)
+	{
+		for (i = 0; i < GLUONSCRIPT_CACHE_PAGES; i++)
+		{
+			if (cache_page[i] < 0)
+			{
+				slot = i;
+				break;
+			}
+			else if (cache_page[i] != current && cache_page[i] != current + 1 &&
+			         (slot < 0 || cache_clock - cache_used[i] > cache_clock - cache_used[slot]))
+				slot = i;
+		}
+		if (slot >= 0)
+		{
+			memcpy(cache[slot], page_buffer.code, sizeof(cache[slot]));
+			cache_page[slot] = page;
+			cache_used[slot] = ++cache_clock;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	xSemaphoreGive( xSpiSemaphore );
+	return 1;
+}
+
+
+/*!
+ *   Copies a line of the flightplan, loading its page from the flash when
+ *   it is not cached. Returns 0 (and an EMPTYCMD) when that failed because
+ *   the flash was busy. Lines outside the flightplan are EMPTYCMD.
+ */
+int gluonscript_get_code(int line, struct GluonscriptCode *code)
+{
+	int page = line / GLUONSCRIPT_PAGE_CODES, slot, tries;
+
+	memset(code, 0, sizeof(struct GluonscriptCode));
+	if (line < 0 || line >= MAX_GLUONSCRIPTCODES)
+		return 1;
+
+	for (tries = 0; tries < 2; tries++)
+	{
+		taskENTER_CRITICAL();
+		slot = gluonscript_cached(page);
+		if (slot >= 0)
+		{
+			*code = cache[slot][line % GLUONSCRIPT_PAGE_CODES];
+			cache_used[slot] = ++cache_clock;
+		}
+		taskEXIT_CRITICAL();
+
+		if (slot >= 0)
+		{
+			if (navigation_data.relative_positions_calculated)
+				navigation_calculate_relative_position(code);
+			return 1;
+		}
+		if (! gluonscript_cache_page(page, FAULT_WAIT_TICKS))
+			break;
+	}
+	return 0;
+}
+
+
+/*!
+ *   Copies a line straight from the flash, like gluonscript_get_code but
+ *   without the cache: for RN, which would otherwise push the pages
+ *   gluonscript_prefetch() loaded out of it. Returns 0 (and an EMPTYCMD)
+ *   when the flash was busy.
+ */
+int gluonscript_read_code(int line, struct GluonscriptCode *code)
+{
+	memset(code, 0, sizeof(struct GluonscriptCode));
+	if (line < 0 || line >= MAX_GLUONSCRIPTCODES)
+		return 1;
+	if (xSemaphoreTake( xSpiSemaphore, FAULT_WAIT_TICKS ) != pdTRUE)
+		return 0;
+
+	gluonscript_read_page(line / GLUONSCRIPT_PAGE_CODES);
+	*code = page_buffer.code[line % GLUONSCRIPT_PAGE_CODES];
+	xSemaphoreGive( xSpiSemaphore );
+
+	if (navigation_data.relative_positions_calculated)
+		navigation_calculate_relative_position(code);
+	return 1;
+}
+
+
+/*!
+ *   Writes a line of the flightplan to the flash immediately (and in the
+ *   cache when its page is there). Returns 0 when the flash was busy.
+ */
+int gluonscript_set_code(int line, struct GluonscriptCode *code)
+{
+	int page = line / GLUONSCRIPT_PAGE_CODES, slot;
+
+	if (line < 0 || line >= MAX_GLUONSCRIPTCODES)
+		return 0;
+	if (xSemaphoreTake( xSpiSemaphore, FAULT_WAIT_TICKS ) != pdTRUE)
+		return 0;
+
+	gluonscript_read_page(page);
+	page_buffer.code[line % GLUONSCRIPT_PAGE_CODES] = *code;
+	dataflash.write(NAVIGATION_PAGE + page, sizeof(page_buffer), (unsigned char*) & page_buffer);
+
+	taskENTER_CRITICAL();
+	slot = gluonscript_cached(page);
+	if (slot >= 0)
+		cache[slot][line % GLUONSCRIPT_PAGE_CODES] = *code;
+	taskEXIT_CRITICAL();
+
+	xSemaphoreGive( xSpiSemaphore );
+
+	if (code->opcode != EMPTYCMD && line >= gluonscript_data.lines)
+		gluonscript_data.lines = line + 1;
+	gluonscript_update_blocks(line, code);
+	dubins_reset();
+	return 1;
+}
+
+
+/*!
+ *   Makes sure the pages we may need soon are cached: the current and the
+ *   next page, the targets of the jumps on the current page, the return
+ *   address and the lines the alarms jump to. Loads at most one page per call,
+ *   without waiting for the flash. Called from the datalogger task.
+ */
+void gluonscript_prefetch()
+{
+	int pages[GLUONSCRIPT_CACHE_PAGES - 1];
+	int count = 0, line = gluonscript_context.current_codeline, i, j, slot;
+	struct GluonscriptCode code;
+
+	pages[count++] = line / GLUONSCRIPT_PAGE_CODES;
+	if (pages[0] + 1 < MAX_GLUONSCRIPTCODES / GLUONSCRIPT_PAGE_CODES)
+		pages[count++] = pages[0] + 1;
+
+	taskENTER_CRITICAL();
+	slot = gluonscript_cached(pages[0]);
+	taskEXIT_CRITICAL();
+	if (slot < 0)
+	{
+		gluonscript_cache_page(pages[0], 0);
+		return;
+	}
+
+	// collect the lines we may jump to
+	{
+		int targets[GLUONSCRIPT_PAGE_CODES + 4 + MAX_WATCHES], n = 0;
+
+		for (i = pages[0] * GLUONSCRIPT_PAGE_CODES; i < (pages[0] + 1) * GLUONSCRIPT_PAGE_CODES; i++)
+		{
+			gluonscript_get_code(i, &code);
+			if (code.opcode == GOTO || code.opcode == CALL)
+				targets[n++] = code.a < 0 ? i + code.a : code.a;
+		}
+		i = gluonscript_context.stack_depth;
+		if (i > 0)
+			targets[n++] = gluonscript_context.stack[i - 1] + 1;
+		if (maximum_range.active)
+			targets[n++] = maximum_range.target;
+		if (geofence.active)
+			targets[n++] = geofence.target;
+		if (battery_alarm.panic_line >= 0)
+			targets[n++] = battery_alarm.panic_line;
+		n += watch_targets(&targets[n]);
+
+		for (i = 0; i < n && count < GLUONSCRIPT_CACHE_PAGES - 1; i++)
+		{
+			int page = targets[i] / GLUONSCRIPT_PAGE_CODES;
+			if (targets[i] < 0 || targets[i] >= MAX_GLUONSCRIPTCODES)
+				continue;
+			for (j = 0; j < count && pages[j] != page; j++)
+				;
+			if (j == count)
+				pages[count++] = page;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		taskENTER_CRITICAL();
+		slot = gluonscript_cached(pages[i]);
+		if (slot >= 0)
+			cache_used[slot] = ++cache_clock;   // keep it
+		taskEXIT_CRITICAL();
+
+		if (slot < 0)
+		{
+			gluonscript_cache_page(pages[i], 0);
+			return;
+		}
+	}
+}
+
+
+/*!
+ *   Keeps the list of BLOCK lines up to date when a line changed.
+ */
+static void gluonscript_update_blocks(int line, struct GluonscriptCode *code)
 {
-	dataflash.write(NAVIGATION_PAGE, sizeof(gluonscript_data.codes), (unsigned char*) & (gluonscript_data.codes));
+	int i, j;
+
+	// remove the old one
+	for (i = 0; i < gluonscript_data.blocks; i++)
+		if (gluonscript_data.block[i].line == line)
+		{
+			for (j = i; j < gluonscript_data.blocks - 1; j++)
+				gluonscript_data.block[j] = gluonscript_data.block[j+1];
+			gluonscript_data.blocks--;
+			break;
+		}
+
+	if (code->opcode != BLOCK || gluonscript_data.blocks >= GLUONSCRIPT_MAX_BLOCKS)
+		return;
+
+	// insert, sorted by line
+	for (i = gluonscript_data.blocks; i > 0 && gluonscript_data.block[i-1].line > line; i--)
+		gluonscript_data.block[i] = gluonscript_data.block[i-1];
+	gluonscript_data.block[i].line = line;
+	{
+		// the name is stored in a, b, x and y, 2 characters each
+		int x = (int)code->x;
+		int y = (int)code->y;
+		char *name = (char*)gluonscript_data.block[i].name;
+		name[0] = ((char*)(& code->a))[1];
+		name[1] = ((char*)(& code->a))[0];
+		name[2] = ((char*)(& code->b))[1];
+		name[3] = ((char*)(& code->b))[0];
+		name[4] = ((char*)(& x))[1];
+		name[5] = ((char*)(& x))[0];
+		name[6] = ((char*)(& y))[1];
+		name[7] = ((char*)(& y))[0];
+		name[8] = '\0';
+	}
+	gluonscript_data.blocks++;
 }
 
 
+/*!
+ *   (Re)reads the flightplan: empties the cache and scans all pages once for
+ *   the length of the flightplan and its blocks.
+ */
 void gluonscript_load()
 {
-	dataflash.read(NAVIGATION_PAGE, sizeof(gluonscript_data.codes), (unsigned char*) & (gluonscript_data.codes));
+	int page, i;
+
+	taskENTER_CRITICAL();
+	for (i = 0; i < GLUONSCRIPT_CACHE_PAGES; i++)
+		cache_page[i] = -1;
+	taskEXIT_CRITICAL();
+
+	gluonscript_data.lines = 0;
+	gluonscript_data.blocks = 0;
+	for (page = 0; page < MAX_GLUONSCRIPTCODES / GLUONSCRIPT_PAGE_CODES; page++)
+	{
+		if (xSemaphoreTake( xSpiSemaphore, ( portTickType ) 1000 ) != pdTRUE)
+		{
+			printf("\r\nSPI Flash not available\r\n");
+			break;
+		}
+		gluonscript_read_page(page);
+		for (i = 0; i < GLUONSCRIPT_PAGE_CODES; i++)
+		{
+			if (page_buffer.code[i].opcode != EMPTYCMD)
+				gluonscript_data.lines = page * GLUONSCRIPT_PAGE_CODES + i + 1;
+			if (page_buffer.code[i].opcode == BLOCK)
+				gluonscript_update_blocks(page * GLUONSCRIPT_PAGE_CODES + i, & page_buffer.code[i]);
+		}
+		xSemaphoreGive( xSpiSemaphore );
+	}
+	dubins_reset();
 }	
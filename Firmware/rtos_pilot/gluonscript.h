@@ -1,9 +1,16 @@
 #ifndef GLUONSCRIPT_H
 #define GLUONSCRIPT_H
 
+#include "dataflash/dataflash.h"
 
-#define MAX_GLUONSCRIPTCODES 72
+#define GLUONSCRIPT_PAGE_CODES 16      //!< code lines per dataflash page
+#define MAX_GLUONSCRIPTCODES (GLUONSCRIPT_PAGE_CODES * NAVIGATION_PAGES)
+#define GLUONSCRIPT_CACHE_PAGES 6      //!< pages kept in RAM
+#define GLUONSCRIPT_MAX_BLOCKS 8
 #define GLUONSCRIPT_HZ 5
+#ifndef GLUONSCRIPT_STACK_DEPTH
+#define GLUONSCRIPT_STACK_DEPTH 3      //!< nested CALLs, can be changed at build time
+#endif
 
 enum gluonscript_handler_return
 {
@@ -75,7 +82,11 @@ enum gluonscript_command {
     SERVO_STOP_TRIGGER = 32,
     SET_FLIGHTPLAN_SWITCH = 33,
     SET_MAXIMUM_RANGE = 34,
-    SERVO_START_DST_TRIGGER = 35
+    SERVO_START_DST_TRIGGER = 35,
+    GEOFENCE_VERTEX = 36,
+    SET_GEOFENCE = 37,
+    WATCH_GR = 38,     // a > x goto b, checked at 50Hz
+    WATCH_SM = 39
 };
 
 
@@ -89,23 +100,51 @@ struct GluonscriptCode
 	int b;    //
 };
 
-struct GluonscriptData
+struct GluonscriptBlock
+{
+	int line;
+	char name[9];
+};
+
+/*!
+ *  Where the flightplan is: the line being executed, the return addresses
+ *  of the CALLs and the time in the current block. It has no pointers, so
+ *  it can be sent as telemetry or kept over a reset.
+ */
+struct GluonscriptContext
 {
-	//! Stores the list of waypoints.
-	struct GluonscriptCode codes[MAX_GLUONSCRIPTCODES];
 	int current_codeline;       //!< Index in the waypoint array pointing to the current waypoint.
+	int stack[GLUONSCRIPT_STACK_DEPTH];   //!< The lines of the CALLs.
+	int stack_depth;            //!< Return addresses on the stack.
+	unsigned int time_block_s;  //!< Seconds since the last BLOCK line.
+	unsigned int stack_errors;  //!< CALLs on a full stack and RETURNs on an empty one.
+};
+
+struct GluonscriptData
+{
 	int last_code;
 	unsigned int tick;
+	int lines;                  //!< Length of the flightplan, the lines behind it are empty.
+	int blocks;
+	struct GluonscriptBlock block[GLUONSCRIPT_MAX_BLOCKS];   //!< The BLOCK lines, for the OSD menu.
 };	
 
 extern volatile struct GluonscriptData gluonscript_data;
+extern volatile struct GluonscriptContext gluonscript_context;
 
 void gluonscript_do();
 float gluonscript_get_variable(enum gluonscript_variable i);
-struct GluonscriptCode * gluonscript_next_waypoint_code(int current_codeline);
-void gluonscript_burn();	
+float gluonscript_live_variable(enum gluonscript_variable i);
+void gluonscript_next_waypoint_code(int current_codeline, struct GluonscriptCode *next);
+int gluonscript_get_code(int line, struct GluonscriptCode *code);
+int gluonscript_read_code(int line, struct GluonscriptCode *code);
+int gluonscript_set_code(int line, struct GluonscriptCode *code);
+void gluonscript_prefetch();
 void gluonscript_load();
 void gluonscript_init();
+void gluonscript_restart();
+int gluonscript_resume();
+void gluonscript_get_context(struct GluonscriptContext *context);
 
 void gluonscript_goto_from_gcs(int line_number);
 
@@ -0,0 +1,269 @@
+/*!
+ *  Temperature model of the gyroscope neutrals.
+ *
+ *  The neutral (zero rate output, raw units) of each axis is modelled as
+ *     neutral(T) = n + c1*(T-25) + c2*(T-25)^2
+ *  with n = config.sensors.gyro_x/y/z_neutral and c1, c2 in
+ *  config.sensors.gyro_temperature, so the model is stored in the
+ *  configuration and burned to flash with it (FC).
+ *
+ *  The model is evaluated at 10Hz, the scaling of every sample only uses the
+ *  result (sensor_data.gyro_x/y/z_neutral).
+ *
+ *  It is learned while the module is not moving: every 2 seconds with a low
+ *  gyro variance yield one (temperature, mean raw) point per axis. The points
+ *  are kept as the sums of a weighted least squares fit with slow forgetting.
+ *  The order of the fit depends on the temperature range that has been seen:
+ *  only the neutral, the neutral and the slope, or the full polynomial.
+ *
+ *  @file     gyro_temperature.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+#include "gyro_temperature.h"
+#include "sensors.h"
+#include "configuration.h"
+
+#define WINDOW 20                  //!< samples per point (2s at 10Hz)
+#define MAX_VARIANCE 100           //!< raw units^2 per axis, about 0.3 deg/s standard deviation
+#define MAX_DEVIATION 1000         //!< raw units, abort the window (and avoid overflows)
+#define MAX_SPEED_MS 1.0f          //!< don't learn while the GPS says we are moving
+#define FORGET 0.998f              //!< weight of the old points per new point
+#define MIN_WEIGHT 5.0f            //!< points needed before the neutral is updated
+#define LINEAR_RANGE 1.0f          //!< C standard deviation needed to fit the slope
+#define QUADRATIC_RANGE 3.0f       //!< C standard deviation needed to fit the curvature
+#define MAX_SLOPE 20.0f            //!< raw units per C, reject fits beyond this
+#define MAX_CURVATURE 1.0f         //!< raw units per C^2
+
+// current window
+static int window_count = 0;
+static unsigned int first[3];
+static long sum[3], sum_squared[3];
+static float sum_temperature;
+
+// weighted sums of the fit, t = T - 25 and y = mean raw - reference[i]
+static unsigned int reference[3];
+static float s_1, s_t, s_tt, s_ttt, s_tttt;
+static float s_y[3], s_ty[3], s_tty[3];
+
+static float last_temperature = GYRO_TEMPERATURE_REFERENCE;
+
+static void gyro_temperature_add_point(float t, float y[3]);
+static void gyro_temperature_fit();
+static float *neutral(int axis);
+
+
+/*!
+ *   Calculates the gyroscope neutrals at this temperature, and stores them in
+ *   sensor_data for the scaling of the raw readings.
+ */
+void gyro_temperature_apply(float temperature)
+{
+	float t = temperature - GYRO_TEMPERATURE_REFERENCE;
+
+	sensor_data.gyro_x_neutral = config.sensors.gyro_x_neutral + (config.sensors.gyro_temperature[0][0] + config.sensors.gyro_temperature[0][1] * t) * t;
+	sensor_data.gyro_y_neutral = config.sensors.gyro_y_neutral + (config.sensors.gyro_temperature[1][0] + config.sensors.gyro_temperature[1][1] * t) * t;
+	sensor_data.gyro_z_neutral = config.sensors.gyro_z_neutral + (config.sensors.gyro_temperature[2][0] + config.sensors.gyro_temperature[2][1] * t) * t;
+	last_temperature = temperature;
+}
+
+
+/*!
+ *   Call at 10Hz with the raw gyroscope readings and the gyroscope's temperature.
+ *   Updates the model when the module has been still for a while, and applies it.
+ */
+void gyro_temperature_learn(unsigned int x_raw, unsigned int y_raw, unsigned int z_raw, float temperature)
+{
+	unsigned int raw[3];
+	int i, still = 1;
+
+	raw[0] = x_raw;
+	raw[1] = y_raw;
+	raw[2] = z_raw;
+
+	if (window_count == 0)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			first[i] = raw[i];
+			sum[i] = 0;
+			sum_squared[i] = 0;
+		}
+		sum_temperature = 0.0f;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		long d = (long)raw[i] - (long)first[i];
+		if (d > MAX_DEVIATION || d < -MAX_DEVIATION)
+			still = 0;
+		sum[i] += d;
+		sum_squared[i] += d*d;
+	}
+	sum_temperature += temperature;
+	window_count++;
+
+	if (!still || sensor_data.gps.speed_ms > MAX_SPEED_MS)
+		window_count = 0;
+	else if (window_count == WINDOW)
+	{
+		float y[3];
+
+		for (i = 0; i < 3; i++)
+		{
+			// n*sum(d^2) - sum(d)^2 = n^2 * variance
+			if (sum_squared[i] * WINDOW - sum[i] * sum[i] > (long)MAX_VARIANCE * WINDOW * WINDOW)
+				still = 0;
+			if (s_1 == 0.0f)
+				reference[i] = first[i];
+			y[i] = (float)((long)first[i] - (long)reference[i]) + (float)sum[i] / (float)WINDOW;
+		}
+		window_count = 0;
+
+		if (still)
+		{
+			gyro_temperature_add_point(sum_temperature / (float)WINDOW - GYRO_TEMPERATURE_REFERENCE, y);
+			gyro_temperature_fit();
+		}
+	}
+
+	gyro_temperature_apply(temperature);
+}
+
+
+/*!
+ *   Sets the neutrals from readings at the current temperature (gyro
+ *   calibration), keeping the temperature coefficients.
+ */
+void gyro_temperature_set_neutral(float x_raw, float y_raw, float z_raw)
+{
+	float t = last_temperature - GYRO_TEMPERATURE_REFERENCE;
+
+	config.sensors.gyro_x_neutral = x_raw - (config.sensors.gyro_temperature[0][0] + config.sensors.gyro_temperature[0][1] * t) * t;
+	config.sensors.gyro_y_neutral = y_raw - (config.sensors.gyro_temperature[1][0] + config.sensors.gyro_temperature[1][1] * t) * t;
+	config.sensors.gyro_z_neutral = z_raw - (config.sensors.gyro_temperature[2][0] + config.sensors.gyro_temperature[2][1] * t) * t;
+	gyro_temperature_apply(last_temperature);
+}
+
+
+/*!
+ *   Clears the temperature coefficients and the collected points.
+ *   The neutrals are kept at their value at the current temperature.
+ */
+void gyro_temperature_reset()
+{
+	int i;
+
+	config.sensors.gyro_x_neutral = sensor_data.gyro_x_neutral;
+	config.sensors.gyro_y_neutral = sensor_data.gyro_y_neutral;
+	config.sensors.gyro_z_neutral = sensor_data.gyro_z_neutral;
+	for (i = 0; i < 3; i++)
+	{
+		config.sensors.gyro_temperature[i][0] = 0.0f;
+		config.sensors.gyro_temperature[i][1] = 0.0f;
+		s_y[i] = s_ty[i] = s_tty[i] = 0.0f;
+	}
+	s_1 = s_t = s_tt = s_ttt = s_tttt = 0.0f;
+	window_count = 0;
+	gyro_temperature_apply(last_temperature);
+}
+
+
+/*!
+ *   Returns the (weighted) number of points in the fit.
+ */
+int gyro_temperature_samples()
+{
+	return (int)s_1;
+}
+
+
+static void gyro_temperature_add_point(float t, float y[3])
+{
+	int i;
+	float tt = t*t;
+
+	s_1 = s_1 * FORGET + 1.0f;
+	s_t = s_t * FORGET + t;
+	s_tt = s_tt * FORGET + tt;
+	s_ttt = s_ttt * FORGET + tt*t;
+	s_tttt = s_tttt * FORGET + tt*tt;
+	for (i = 0; i < 3; i++)
+	{
+		s_y[i] = s_y[i] * FORGET + y[i];
+		s_ty[i] = s_ty[i] * FORGET + t*y[i];
+		s_tty[i] = s_tty[i] * FORGET + tt*y[i];
+	}
+}
+
+
+/*!
+ *   Least squares fit of y = a + b*t + c*t^2 on the collected points.
+ *   Coefficients that can't be determined from the temperature range seen so
+ *   far are kept.
+ */
+static void gyro_temperature_fit()
+{
+	float mean_t, spread;
+	int i;
+
+	if (s_1 < MIN_WEIGHT)
+		return;
+
+	mean_t = s_t / s_1;
+	spread = s_tt / s_1 - mean_t*mean_t;
+	spread = spread > 0.0f ? sqrtf(spread) : 0.0f;
+
+	for (i = 0; i < 3; i++)
+	{
+		float a, b = config.sensors.gyro_temperature[i][0], c = config.sensors.gyro_temperature[i][1];
+
+		if (spread >= QUADRATIC_RANGE)
+		{
+			// Cramer's rule on the 3x3 normal equations
+			float m00 = s_1, m01 = s_t, m02 = s_tt, m11 = s_tt, m12 = s_ttt, m22 = s_tttt;
+			float c00 = m11*m22 - m12*m12;
+			float c01 = m02*m12 - m01*m22;
+			float c02 = m01*m12 - m02*m11;
+			float det = m00*c00 + m01*c01 + m02*c02;
+			if (fabs(det) < 1e-6f)
+				continue;
+			a = (s_y[i]*c00 + s_ty[i]*c01 + s_tty[i]*c02) / det;
+			b = (s_y[i]*c01 + s_ty[i]*(m00*m22 - m02*m02) + s_tty[i]*(m01*m02 - m00*m12)) / det;
+			c = (s_y[i]*c02 + s_ty[i]*(m01*m02 - m00*m12) + s_tty[i]*(m00*m11 - m01*m01)) / det;
+		}
+		else if (spread >= LINEAR_RANGE)
+		{
+			// keep the curvature
+			float z = s_y[i] - c*s_tt, tz = s_ty[i] - c*s_ttt;
+			float det = s_1*s_tt - s_t*s_t;
+			if (fabs(det) < 1e-6f)
+				continue;
+			a = (s_tt*z - s_t*tz) / det;
+			b = (s_1*tz - s_t*z) / det;
+		}
+		else
+			a = (s_y[i] - b*s_t - c*s_tt) / s_1;   // keep the slope and curvature
+
+		if (fabs(b) > MAX_SLOPE || fabs(c) > MAX_CURVATURE)
+			continue;
+
+		*neutral(i) = (float)reference[i] + a;
+		config.sensors.gyro_temperature[i][0] = b;
+		config.sensors.gyro_temperature[i][1] = c;
+	}
+}
+
+
+static float *neutral(int axis)
+{
+	if (axis == 0)
+		return &config.sensors.gyro_x_neutral;
+	else if (axis == 1)
+		return &config.sensors.gyro_y_neutral;
+	else
+		return &config.sensors.gyro_z_neutral;
+}
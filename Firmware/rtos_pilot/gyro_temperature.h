@@ -0,0 +1,13 @@
+#ifndef GYRO_TEMPERATURE_H
+#define GYRO_TEMPERATURE_H
+
+#define GYRO_TEMPERATURE_REFERENCE 25.0f   //!< C, config.sensors.gyro_x/y/z_neutral are valid at this temperature
+
+void gyro_temperature_apply(float temperature);
+void gyro_temperature_learn(unsigned int x_raw, unsigned int y_raw, unsigned int z_raw, float temperature);
+
+void gyro_temperature_set_neutral(float x_raw, float y_raw, float z_raw);
+void gyro_temperature_reset();
+int gyro_temperature_samples();
+
+#endif // GYRO_TEMPERATURE_H
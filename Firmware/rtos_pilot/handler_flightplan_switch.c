@@ -30,9 +30,9 @@ ScriptHandlerReturn flightplan_switch_handle_gluonscriptcommand (struct Gluonscr
 
         if (this_state != flightplan_switch.current_state && this_state == last_switch_state)
         {
-            //printf("\r\nVal %d -> State %d->%d -> Line %d \r\n", channel_value, flightplan_switch.current_state, this_state, gluonscript_data.current_codeline+2); // not + 1 -> ++ follows after HANDLED_FINISHED
+            //printf("\r\nVal %d -> State %d->%d -> Line %d \r\n", channel_value, flightplan_switch.current_state, this_state, gluonscript_context.current_codeline+2); // not + 1 -> ++ follows after HANDLED_FINISHED
             printf("\r\nFlightplan switch: new block selected\r\n");
-            gluonscript_data.current_codeline = flightplan_switch.target[this_state] - 1;  // is incremented on HANDLED_FINISHED
+            gluonscript_context.current_codeline = flightplan_switch.target[this_state] - 1;  // is incremented on HANDLED_FINISHED
             flightplan_switch.current_state = this_state;
             last_switch_state = this_state;
             return HANDLED_FINISHED;
@@ -0,0 +1,353 @@
+/*!
+ *  Polygon geofence.
+ *
+ *  The fence is a set of inclusion and exclusion polygons, defined in the
+ *  flightplan with GEOFENCE_VERTEX lines (x = latitude, y = longitude,
+ *  a = polygon number, b = GEOFENCE_INCLUSION or GEOFENCE_EXCLUSION) and
+ *  activated with SET_GEOFENCE (a = line to jump to on a breach,
+ *  x = look-ahead in seconds).
+ *
+ *  When the fence is activated (or a vertex is uploaded while it is active)
+ *  the vertices are converted once to an integer edge table in a local frame,
+ *  in meters from the first vertex, with a bounding box per polygon. The
+ *  table is built by the GPS task into the spare one of two tables, and
+ *  swapped in at once: geofence_check() never sees a half built table.
+ *  geofence_check() runs the crossing number test at the control rate, a few
+ *  edges per call, for the current position and the position predicted from
+ *  the GPS velocity. The breach is acted upon by the gluonscript handler,
+ *  like the maximum range.
+ *
+ *  @file     handler_geofence.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#include "fastmath/fastmath.h"
+
+#include "gluonscript.h"
+#include "handler_geofence.h"
+#include "handler_navigation.h"
+#include "sensors.h"
+#include "common.h"
+
+#define EDGES_PER_CHECK 8     //!< edges tested per geofence_check() call
+
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+static struct GeofenceTable tables[2];
+
+struct Geofence geofence = { .active = 0, .table = &tables[0], .rebuild = 0, .breach = 0 };
+
+// incremental crossing number test: the pass in progress
+static int pass_polygon = 0;
+static int pass_edge = 0;
+static int point_x[2], point_y[2];         //!< current and predicted position
+static unsigned char candidate[2];         //!< bit per polygon: point inside its bounding box
+static unsigned char inside[2];            //!< bit per polygon: crossing parity so far
+
+static int holdoff = 0;
+
+static void geofence_to_local(struct GeofenceTable *t, float latitude_rad, float longitude_rad, int *x, int *y);
+static int geofence_in_box(struct GeofencePolygon *p, int x, int y);
+static int geofence_crosses(struct GeofenceEdge *e, int x, int y);
+static unsigned char geofence_evaluate(struct GeofenceTable *t, unsigned char inside_bits);
+static int geofence_fill(struct GeofenceTable *t);
+
+
+/*!
+ *   Builds the edge table from the GEOFENCE_VERTEX lines of the flightplan
+ *   and makes it the active one. Only called by the GPS task.
+ *   Returns the number of polygons, 0 when the fence is empty or invalid.
+ */
+int geofence_build()
+{
+    struct GeofenceTable *spare = geofence.table == &tables[0] ? &tables[1] : &tables[0];
+    int polygons = geofence_fill(spare);
+
+    taskENTER_CRITICAL();
+    geofence.table = spare;
+    geofence.breach = 0;
+    pass_polygon = 0;     // a pass over the old table is dropped
+    pass_edge = 0;
+    taskEXIT_CRITICAL();
+
+    return polygons;
+}
+
+
+static int geofence_fill(struct GeofenceTable *t)
+{
+    int i, n = 0, edges = 0, first_vertex = -1;
+    struct GluonscriptCode code, first, a, b;
+
+    t->polygons = 0;
+
+    for (i = 0; i <= gluonscript_data.lines; i++)
+    {
+        gluonscript_get_code(i, &code);   // EMPTYCMD behind the flightplan
+
+        // close the polygon that was being built
+        if (first_vertex >= 0 &&
+            (i == gluonscript_data.lines || code.opcode != GEOFENCE_VERTEX || code.a != first.a))
+        {
+            struct GeofencePolygon *p = &t->polygon[t->polygons];
+            int v, count = i - first_vertex;
+
+            if (count >= 3 && edges + count <= GEOFENCE_MAX_EDGES && t->polygons < GEOFENCE_MAX_POLYGONS)
+            {
+                p->first_edge = edges;
+                p->edges = count;
+                p->type = first.b == GEOFENCE_EXCLUSION ? GEOFENCE_EXCLUSION : GEOFENCE_INCLUSION;
+                p->min_x = p->min_y = GEOFENCE_MAX_M;
+                p->max_x = p->max_y = -GEOFENCE_MAX_M;
+
+                for (v = 0; v < count; v++)
+                {
+                    struct GeofenceEdge *e = &t->edge[edges + v];
+                    int ax, ay, bx, by;
+
+                    gluonscript_get_code(first_vertex + v, &a);
+                    gluonscript_get_code(first_vertex + (v + 1) % count, &b);
+                    geofence_to_local(t, a.x, a.y, &ax, &ay);
+                    geofence_to_local(t, b.x, b.y, &bx, &by);
+                    if (ax <= -GEOFENCE_MAX_M || ax >= GEOFENCE_MAX_M || ay <= -GEOFENCE_MAX_M || ay >= GEOFENCE_MAX_M)
+                    {
+                        printf("\r\nGeofence: vertex %d too far away\r\n", first_vertex + v + 1);
+                        t->polygons = 0;
+                        return 0;
+                    }
+
+                    // store with y1 <= y2, the crossing test doesn't care about the direction
+                    if (ay <= by)
+                    {
+                        e->x1 = ax;
+                        e->y1 = ay;
+                        e->dx = bx - ax;
+                        e->dy = by - ay;
+                    }
+                    else
+                    {
+                        e->x1 = bx;
+                        e->y1 = by;
+                        e->dx = ax - bx;
+                        e->dy = ay - by;
+                    }
+
+                    p->min_x = MIN(p->min_x, ax);
+                    p->max_x = MAX(p->max_x, ax);
+                    p->min_y = MIN(p->min_y, ay);
+                    p->max_y = MAX(p->max_y, ay);
+                }
+                edges += count;
+                t->polygons++;
+            }
+            else
+                printf("\r\nGeofence: polygon %d ignored\r\n", first.a);
+            first_vertex = -1;
+        }
+
+        if (i < gluonscript_data.lines && code.opcode == GEOFENCE_VERTEX && first_vertex < 0)
+        {
+            if (n++ == 0)
+            {
+                t->origin_latitude_rad = code.x;
+                t->origin_longitude_rad = code.y;
+            }
+            first_vertex = i;
+            first = code;
+        }
+    }
+
+    return t->polygons;
+}
+
+
+/*!
+ *   Tests up to EDGES_PER_CHECK edges. Call at the control rate (50Hz).
+ *   geofence.breach is updated at the end of every pass over all polygons.
+ */
+void geofence_check()
+{
+    struct GeofenceTable *t = geofence.table;
+    int budget = EDGES_PER_CHECK;
+
+    if (!geofence.active || t->polygons == 0 || sensor_data.gps.status != ACTIVE)
+        return;
+
+    if (pass_polygon == 0 && pass_edge == 0)
+    {
+        // start a new pass: take the current and the predicted position
+        float ahead = sensor_data.gps.speed_ms * geofence.lookahead_s;
+        int p;
+
+        geofence_to_local(t, sensor_data.gps.latitude_rad, sensor_data.gps.longitude_rad, &point_x[0], &point_y[0]);
+        point_x[1] = BIND(point_x[0] + (int)(ahead * fast_sin(sensor_data.gps.heading_rad)), -GEOFENCE_MAX_M, GEOFENCE_MAX_M);
+        point_y[1] = BIND(point_y[0] + (int)(ahead * fast_cos(sensor_data.gps.heading_rad)), -GEOFENCE_MAX_M, GEOFENCE_MAX_M);
+
+        candidate[0] = candidate[1] = 0;
+        inside[0] = inside[1] = 0;
+        for (p = 0; p < t->polygons; p++)
+        {
+            if (geofence_in_box(&t->polygon[p], point_x[0], point_y[0]))
+                candidate[0] |= 1 << p;
+            if (geofence_in_box(&t->polygon[p], point_x[1], point_y[1]))
+                candidate[1] |= 1 << p;
+        }
+    }
+
+    while (budget > 0 && pass_polygon < t->polygons)
+    {
+        struct GeofencePolygon *p = &t->polygon[pass_polygon];
+        unsigned char bit = 1 << pass_polygon;
+
+        if (((candidate[0] | candidate[1]) & bit) == 0 || pass_edge >= p->edges)
+        {
+            // outside the bounding box: no need to look at the edges
+            pass_polygon++;
+            pass_edge = 0;
+            continue;
+        }
+
+        {
+            struct GeofenceEdge *e = &t->edge[p->first_edge + pass_edge];
+            if ((candidate[0] & bit) && geofence_crosses(e, point_x[0], point_y[0]))
+                inside[0] ^= bit;
+            if ((candidate[1] & bit) && geofence_crosses(e, point_x[1], point_y[1]))
+                inside[1] ^= bit;
+        }
+        pass_edge++;
+        budget--;
+    }
+
+    if (pass_polygon >= t->polygons)
+    {
+        geofence.breach = (geofence_evaluate(t, inside[0]) ? GEOFENCE_BREACH : 0) |
+                          (geofence_evaluate(t, inside[1]) ? GEOFENCE_BREACH_PREDICTED : 0);
+        pass_polygon = 0;
+        pass_edge = 0;
+    }
+}
+
+
+/*!
+ *   Complete (non-incremental) test of one position.
+ *   Returns 1 when it is outside the fence.
+ */
+int geofence_violated(float latitude_rad, float longitude_rad)
+{
+    struct GeofenceTable *t = geofence.table;
+    unsigned char in = 0;
+    int x, y, p, e;
+
+    if (t->polygons == 0)
+        return 0;
+
+    geofence_to_local(t, latitude_rad, longitude_rad, &x, &y);
+    for (p = 0; p < t->polygons; p++)
+    {
+        if (!geofence_in_box(&t->polygon[p], x, y))
+            continue;
+        for (e = 0; e < t->polygon[p].edges; e++)
+            if (geofence_crosses(&t->edge[t->polygon[p].first_edge + e], x, y))
+                in ^= 1 << p;
+    }
+    return geofence_evaluate(t, in);
+}
+
+
+ScriptHandlerReturn geofence_handle_gluonscriptcommand (struct GluonscriptCode *code)
+{
+    if (holdoff > 0)
+        holdoff--;
+
+    if (geofence.rebuild)   // a vertex was uploaded
+    {
+        geofence.rebuild = 0;
+        if (geofence.active)
+            geofence.active = geofence_build() > 0;
+    }
+
+    if (geofence.active && geofence.breach && holdoff == 0)
+    {
+        printf("\r\nGeofence: new block selected\r\n");
+        gluonscript_context.current_codeline = geofence.target - 1;  // is incremented on HANDLED_FINISHED
+        holdoff = GLUONSCRIPT_HZ*10;    // disable this for 10 seconds
+        return HANDLED_FINISHED;
+    }
+
+    if (code->opcode == SET_GEOFENCE)
+    {
+        geofence.target = code->a - 1;
+        geofence.lookahead_s = code->x;
+        geofence.active = geofence_build() > 0;
+        holdoff = GLUONSCRIPT_HZ;   // give the first pass some time
+        return HANDLED_FINISHED;
+    }
+    else if (code->opcode == GEOFENCE_VERTEX)
+        return HANDLED_FINISHED;    // only data
+
+    return NOT_HANDLED;
+}
+
+
+static void geofence_to_local(struct GeofenceTable *t, float latitude_rad, float longitude_rad, int *x, int *y)
+{
+    float east = (longitude_rad - t->origin_longitude_rad) * longitude_meter_per_radian;
+    float north = (latitude_rad - t->origin_latitude_rad) * latitude_meter_per_radian;
+
+    // round to the nearest meter
+    *x = (int)BIND(east + (east > 0.0f ? 0.5f : -0.5f), (float)-GEOFENCE_MAX_M, (float)GEOFENCE_MAX_M);
+    *y = (int)BIND(north + (north > 0.0f ? 0.5f : -0.5f), (float)-GEOFENCE_MAX_M, (float)GEOFENCE_MAX_M);
+}
+
+
+static int geofence_in_box(struct GeofencePolygon *p, int x, int y)
+{
+    return x >= p->min_x && x <= p->max_x && y >= p->min_y && y <= p->max_y;
+}
+
+
+/*!
+ *   1 when a ray from (x, y) towards +x crosses the edge.
+ *   Half open in y, so a vertex on the ray is counted once.
+ */
+static int geofence_crosses(struct GeofenceEdge *e, int x, int y)
+{
+    if (y < e->y1 || y >= e->y1 + e->dy)
+        return 0;
+    // (x, y) is left of the edge
+    return (long)(x - e->x1) * (long)e->dy < (long)(y - e->y1) * (long)e->dx;
+}
+
+
+/*!
+ *   Returns 1 when the point is outside all inclusion polygons (if there are
+ *   any) or inside an exclusion polygon.
+ */
+static unsigned char geofence_evaluate(struct GeofenceTable *t, unsigned char inside_bits)
+{
+    int p, has_inclusion = 0, included = 0;
+
+    for (p = 0; p < t->polygons; p++)
+    {
+        int in = (inside_bits >> p) & 1;
+        if (t->polygon[p].type == GEOFENCE_EXCLUSION)
+        {
+            if (in)
+                return 1;
+        }
+        else
+        {
+            has_inclusion = 1;
+            included |= in;
+        }
+    }
+    return has_inclusion && !included;
+}
@@ -0,0 +1,59 @@
+#ifndef HANDLER_GEOFENCE_H
+#define HANDLER_GEOFENCE_H
+
+#include "gluonscript.h"
+
+#define GEOFENCE_MAX_POLYGONS 4
+#define GEOFENCE_MAX_EDGES 32
+#define GEOFENCE_MAX_M 16000          // vertices further from the first one are rejected
+
+#define GEOFENCE_INCLUSION 1
+#define GEOFENCE_EXCLUSION 2
+
+#define GEOFENCE_BREACH 1             // the current position is outside the fence
+#define GEOFENCE_BREACH_PREDICTED 2   // the position after lookahead_s is outside the fence
+
+//! Edge in the local frame (m, east and north of the first vertex), y1 <= y2
+struct GeofenceEdge
+{
+    int x1, y1;
+    int dx, dy;
+};
+
+struct GeofencePolygon
+{
+    unsigned char first_edge;
+    unsigned char edges;
+    unsigned char type;               // GEOFENCE_INCLUSION or GEOFENCE_EXCLUSION
+    int min_x, max_x, min_y, max_y;   // bounding box
+};
+
+//! The polygons in the local frame, built by geofence_build()
+struct GeofenceTable
+{
+    float origin_latitude_rad;
+    float origin_longitude_rad;
+    int polygons;
+    struct GeofencePolygon polygon[GEOFENCE_MAX_POLYGONS];
+    struct GeofenceEdge edge[GEOFENCE_MAX_EDGES];
+};
+
+struct Geofence
+{
+    int active;
+    int target;                       // gluonscript line on breach
+    float lookahead_s;
+    struct GeofenceTable * volatile table;   // the one geofence_check() walks, never the one being built
+    volatile unsigned char rebuild;   // a vertex changed while active: the GPS task rebuilds the table
+    volatile unsigned char breach;    // GEOFENCE_BREACH* bits, updated by geofence_check()
+};
+
+extern struct Geofence geofence;
+
+int geofence_build();
+void geofence_check();
+int geofence_violated(float latitude_rad, float longitude_rad);
+
+ScriptHandlerReturn geofence_handle_gluonscriptcommand (struct GluonscriptCode *code);
+
+#endif // HANDLER_GEOFENCE_H
@@ -19,11 +19,10 @@ ScriptHandlerReturn maximum_range_handle_gluonscriptcommand (struct GluonscriptC
 
         if (i % GLUONSCRIPT_HZ == 1)   // save some uC cycles; i++ % 2 == 1 to make sure it has a startup delay (and has a good PWM/PPM reception))
         {
-            if (navigation_distance_between_meter(sensor_data.gps.longitude_rad, navigation_data.home_longitude_rad,
-                                                  sensor_data.gps.latitude_rad, navigation_data.home_latitude_rad) > maximum_range.maximum_range)
+            if (gluonscript_get_variable(HOME_DISTANCE) > maximum_range.maximum_range)
             {
                 printf("\r\nMax range: new block selected\r\n");
-                gluonscript_data.current_codeline = maximum_range.target - 1;  // is incremented on HANDLED_FINISHED
+                gluonscript_context.current_codeline = maximum_range.target - 1;  // is incremented on HANDLED_FINISHED
                 i = -GLUONSCRIPT_HZ*10;    // disable this for 10 seconds
                 return HANDLED_FINISHED;
             }
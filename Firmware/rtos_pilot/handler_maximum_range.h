@@ -10,6 +10,8 @@ struct maximum_range
     int target;
 };
 
+extern struct maximum_range maximum_range;
+
 ScriptHandlerReturn maximum_range_handle_gluonscriptcommand (struct GluonscriptCode *code);
 
 #endif // HANDLER_MAXIMUM_RANGE_H
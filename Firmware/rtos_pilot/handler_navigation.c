@@ -20,6 +20,7 @@
 
 // Gluonpilot libraries
 #include "ppm_in/ppm_in.h"
+#include "fastmath/fastmath.h"
 
 #include "configuration.h"
 #include "sensors.h"
@@ -27,6 +28,9 @@
 #include "handler_navigation.h"
 #include "handler_trigger.h"
 #include "handler_alarms.h"
+#include "gain_schedule.h"
+#include "wind_estimator.h"
+#include "dubins_path.h"
 #include "gluonscript.h"
 
 
@@ -45,7 +49,7 @@ float heading_rad_fromto (float diff_long, float diff_lat);
 float distance_between_meter(float long1, float long2, float lat1, float lat2);
 void navigation_do_circle(struct GluonscriptCode *current_code);
 int waypoint_reached(struct GluonscriptCode *current_code);
-void convert_parameters_to_abs(int i);
+void convert_parameters_to_abs(struct GluonscriptCode *code);
 
 
 /*!
@@ -64,40 +68,40 @@ void navigation_init ()
 	navigation_data.airborne = 0;
 	
 	navigation_data.time_airborne_s = 0;
-	navigation_data.time_block_s = 0;
 	navigation_data.wind_heading_set = 0;
+	wind_estimator_init();
 	navigation_data.relative_positions_calculated = 0;
 	navigation_data.desired_throttle_pct = -1;
 }
 
 
-void navigation_calculate_relative_position(int i)
+void navigation_calculate_relative_position(struct GluonscriptCode *code)
 {
-	switch (gluonscript_data.codes[i].opcode)
+	switch (code->opcode)
 	{
 		case FROM_TO_REL:
-                           gluonscript_data.codes[i].opcode = FROM_TO_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = FROM_TO_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		case FLY_TO_REL:
-                           gluonscript_data.codes[i].opcode = FLY_TO_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = FLY_TO_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		case CIRCLE_REL:
-                           gluonscript_data.codes[i].opcode = CIRCLE_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = CIRCLE_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		case CIRCLE_TO_REL:
-                           gluonscript_data.codes[i].opcode = CIRCLE_TO_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = CIRCLE_TO_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		case FLARE_TO_REL:
-                           gluonscript_data.codes[i].opcode = FLARE_TO_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = FLARE_TO_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		case GLIDE_TO_REL:
-                           gluonscript_data.codes[i].opcode = GLIDE_TO_ABS;
-                           convert_parameters_to_abs(i);
+                           code->opcode = GLIDE_TO_ABS;
+                           convert_parameters_to_abs(code);
                            break;
 		default:
                            break;
@@ -105,25 +109,22 @@ void navigation_calculate_relative_position(int i)
 }	
 
 /*!
- *    Calculate absolute lat/lon positions for relative waypoints.
+ *    From now on, relative waypoints are converted to absolute lat/lon
+ *    positions when they are read from the flightplan.
  */
 void navigation_calculate_relative_positions()
 {
-	int i;
-	for (i = 0; i < MAX_GLUONSCRIPTCODES; i++)
-	{
-		navigation_calculate_relative_position(i);
-	}
 	navigation_data.relative_positions_calculated = 1;
+	dubins_reset();
 }
 
 
-void convert_parameters_to_abs(int i)
+void convert_parameters_to_abs(struct GluonscriptCode *code)
 {
-    gluonscript_data.codes[i].x /= latitude_meter_per_radian;
-    gluonscript_data.codes[i].x += navigation_data.home_latitude_rad;
-    gluonscript_data.codes[i].y /= longitude_meter_per_radian;
-    gluonscript_data.codes[i].y += navigation_data.home_longitude_rad;
+    code->x /= latitude_meter_per_radian;
+    code->x += navigation_data.home_latitude_rad;
+    code->y /= longitude_meter_per_radian;
+    code->y += navigation_data.home_longitude_rad;
 }
 
 
@@ -135,7 +136,7 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
 	if (gluonscript_data.tick % GLUONSCRIPT_HZ == 0)
 	{
 		navigation_data.time_airborne_s++;
-        navigation_data.time_block_s++;
+        gluonscript_context.time_block_s++;
 	}
 	
 	
@@ -179,6 +180,12 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
 		// lock yaw
 		sensor_data.yaw = sensor_data.gps.heading_rad;
 	}
+
+	wind_estimator_update();
+	gain_schedule_update();
+	// once the wind is known, climb into the real wind instead of the take-off direction
+	if (navigation_data.wind_heading_set && wind_estimate.confidence >= WIND_CONFIDENT && wind_estimate.speed_ms > 2.0f)
+		navigation_data.wind_heading = wind_estimate.from_rad;
 	
 		
 	switch(current_code->opcode)
@@ -202,13 +209,26 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
 		{
 			navigation_data.desired_pre_bank = 0.0f;
 			navigation_data.desired_throttle_pct = -1;
+
+			int dubins = dubins_navigate(current_code, current_code->a);
+			if (dubins != DUBINS_NOT_PLANNED)
+			{
+				if (dubins == DUBINS_PASSED || waypoint_reached(current_code))
+				{
+					navigation_data.last_waypoint_latitude_rad = current_code->x;
+					navigation_data.last_waypoint_longitude_rad = current_code->y;
+					navigation_data.last_waypoint_altitude_agl = navigation_data.desired_altitude_agl;
+					return HANDLED_FINISHED;
+				}
+				return HANDLED_UNFINISHED;
+			}
 			
 			float leg_x = (current_code->x - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian;  // lat
   			float leg_y = (current_code->y - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian;  // lon
   			float leg2 = MAX(leg_x * leg_x + leg_y * leg_y, 1.f);
   			float nav_leg_progress = ((sensor_data.gps.latitude_rad - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian * leg_x + 
   			                          (sensor_data.gps.longitude_rad - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian * leg_y) / leg2;
-  			float nav_leg_length = sqrtf(leg2);
+  			float nav_leg_length = fast_sqrt(leg2);
 
 			  /** distance of carrot (in meter) */
 			float carrot = 4.0f * sensor_data.gps.speed_ms;
@@ -272,13 +292,29 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
 		case CIRCLE_TO_ABS:
 		{
 			struct GluonscriptCode code;
-			// circle center = in between previous and current waypoint
+
+			navigation_data.desired_throttle_pct = -1;
+			int dubins = dubins_navigate(current_code, current_code->b);
+			if (dubins != DUBINS_NOT_PLANNED)
+			{
+				if (dubins == DUBINS_PASSED)
+				{
+					navigation_data.last_waypoint_latitude_rad = current_code->x;
+					navigation_data.last_waypoint_longitude_rad = current_code->y;
+					navigation_data.last_waypoint_altitude_agl = navigation_data.desired_altitude_agl;
+					return HANDLED_FINISHED;
+				}
+				return HANDLED_UNFINISHED;
+			}
+
+			// not planned: circle center = in between previous and current waypoint
 			code.x = (navigation_data.last_waypoint_latitude_rad + current_code->x) / 2.0;
 			code.y = (navigation_data.last_waypoint_longitude_rad + current_code->y) / 2.0;
 			code.a = (int)(navigation_distance_between_meter(navigation_data.last_waypoint_longitude_rad, current_code->y, navigation_data.last_waypoint_latitude_rad, current_code->x))/2;
 			
 			// decide to turn right or left
-			struct GluonscriptCode *next = gluonscript_next_waypoint_code(gluonscript_data.current_codeline);
+			struct GluonscriptCode next_code, *next = &next_code;
+			gluonscript_next_waypoint_code(gluonscript_context.current_codeline, next);
 			float dir1 = navigation_heading_rad_fromto(navigation_data.last_waypoint_longitude_rad - current_code->y,
 	                                                   navigation_data.last_waypoint_latitude_rad - current_code->x);
 			float dir2 = navigation_heading_rad_fromto(current_code->y - next->y,
@@ -320,7 +356,7 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
   			float leg2 = MAX(leg_x * leg_x + leg_y * leg_y, 1.f);
   			float nav_leg_progress = ((sensor_data.gps.latitude_rad - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian * leg_x + 
   			                          (sensor_data.gps.longitude_rad - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian * leg_y) / leg2;
-  			float nav_leg_length = sqrtf(leg2);
+  			float nav_leg_length = fast_sqrt(leg2);
 
 			  /** distance of carrot (in meter) */
 			float carrot = 4.0f * sensor_data.gps.speed_ms;
@@ -352,7 +388,7 @@ ScriptHandlerReturn navigation_handle_gluonscriptcommand (struct GluonscriptCode
   			float leg2 = MAX(leg_x * leg_x + leg_y * leg_y, 1.f);
   			float nav_leg_progress = ((sensor_data.gps.latitude_rad - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian * leg_x + 
   			                          (sensor_data.gps.longitude_rad - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian * leg_y) / leg2;
-  			float nav_leg_length = sqrtf(leg2);
+  			float nav_leg_length = fast_sqrt(leg2);
 
 			  /** distance of carrot (in meter) */
 			float carrot = 4.0f * sensor_data.gps.speed_ms;
@@ -496,9 +532,10 @@ void navigation_do_circle(struct GluonscriptCode *current_code)
 	//}	
 
 	
+	// bank for a turn rate of ground speed / r at the current airspeed
 	navigation_data.desired_pre_bank = (distance_center > abs_r + distance_ahead*2.0 || 
 	                                   distance_center < abs_r - distance_ahead) ? 0 :
-  				                          atan(sensor_data.gps.speed_ms*sensor_data.gps.speed_ms / (G*r));
+  				                          atan(wind_airspeed_ms()*sensor_data.gps.speed_ms / (G*r));
 
 	float next_r = abs_r / cosf(rad_ahead); // CHANGE sqrt(r*r + distance_ahe^ ad*distance_ahead);
 			
@@ -543,6 +580,18 @@ void navigation_set_home()
 
 
 
+/*!
+ *  Takes the home position restored by gluonscript_resume() after a reset
+ *  in flight, instead of the current position.
+ */
+void navigation_resume_home()
+{
+	cos_latitude = cos(navigation_data.home_latitude_rad);
+	longitude_meter_per_radian = latitude_meter_per_radian * cos_latitude;  // approx
+	navigation_calculate_relative_positions();
+}
+
+
 /*!
  *  Calculates the heading from waypoint a to waypoint b.
  *  @param diff_long Origin longitude - destination longitude.
@@ -553,10 +602,10 @@ float navigation_heading_rad_fromto (float diff_long, float diff_lat)
 	//diff_lat *= cos_latitude;   // Local, flat earth approximation!
 	diff_long *= cos_latitude;   // Local, flat earth approximation!
 	
-	float waypointHeading = atan2(diff_long, -diff_lat);
+	float waypointHeading = fast_atan2(diff_long, -diff_lat);
 
 	// make clockwise direction positive (CCW is +ve as is)
-	if(sin(diff_long) > 0.0)
+	if(diff_long > 0.0)
 		waypointHeading = (2.0*PI) - waypointHeading;
 	else
 		waypointHeading = -waypointHeading;
@@ -583,5 +632,5 @@ float navigation_distance_between_meter(float long1, float long2, float lat1, fl
 	float difflong = (long1 - long2) * longitude_meter_per_radian;
 	float difflat = (lat1 - lat2) * latitude_meter_per_radian;
 
-	return sqrt(difflong*difflong + difflat*difflat);
+	return fast_sqrt(difflong*difflong + difflat*difflat);
 }
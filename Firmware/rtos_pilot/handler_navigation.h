@@ -7,8 +7,10 @@ void navigation_init();
 //void navigation_update();
 float navigation_heading_rad_fromto (float diff_long, float diff_lat); // used in OSD-code
 float navigation_distance_between_meter(float long1, float long2, float lat1, float lat2);
-void navigation_calculate_relative_position(int i);
+void navigation_calculate_relative_position(struct GluonscriptCode *code);
 void navigation_calculate_relative_positions();
+void navigation_resume_home();
+void navigation_do_circle(struct GluonscriptCode *current_code);
 
 
 /*!
@@ -59,7 +61,6 @@ struct NavigationData
 	//float distance_next_waypoint; //!< Distance to next waypoint in meter.
 	
 	unsigned int time_airborne_s;
-    unsigned int time_block_s;
 };
 
 
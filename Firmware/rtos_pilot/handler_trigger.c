@@ -13,6 +13,7 @@
 #include "handler_navigation.h"
 #include "gluonscript.h"
 #include "sensors.h"
+#include "geotag.h"
 
 
 struct trigger_state trigger = { .mode = TRIGGER_PWM_INTERVAL_MODE, .is_triggering = 0, .servo_channel = 5,
@@ -95,6 +96,7 @@ void trigger_servo(int servo, int usec_pulse, float delay_s)
 {
 	unsigned int us = servo_read_us(servo);
 
+	geotag_trigger();
     if (usec_pulse > 2499)
     {
         servo_set_logical_1(servo);
@@ -0,0 +1,192 @@
+/*!
+ *  Condition watchers: "on condition goto" lines.
+ *
+ *  WATCH_GR and WATCH_SM register a watcher (a = variable, x = threshold,
+ *  y = hysteresis, b = line to jump to, b = 0 removes the watchers on this
+ *  variable). Unlike IF_ and UNTIL_ lines, which are only evaluated when the
+ *  program gets there, a watcher is checked at the control rate whatever
+ *  line is being executed, so reactions like an RC switch, a low battery or
+ *  a maximum distance don't need a dedicated handler.
+ *
+ *  The check is an integer compare: the threshold is converted once when the
+ *  line is executed. RC channels, the link status and the battery voltage
+ *  are read directly; the other variables only change at the GPS rate and
+ *  are sampled every gluonscript tick. When a watcher fires, the GPS task
+ *  is woken right away and gluonscript_do() starts at the target line,
+ *  without waiting for the next GPS sentence. A watcher that fires while an
+ *  earlier jump is still pending stays armed and fires at the next check.
+ *
+ *  @file     handler_watch.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+#include "FreeRTOS/semphr.h"
+
+#include "ppm_in/ppm_in.h"
+
+#include "gluonscript.h"
+#include "handler_watch.h"
+#include "sensors.h"
+
+static struct Watch watch[MAX_WATCHES];
+static volatile int fired = -1;      // line to jump to, -1 if none. Set by the control task, taken by the GPS task
+
+extern xSemaphoreHandle xGpsSemaphore;
+
+
+/*!
+ *   Integer form: voltages and speeds in 0.1 units, the rest in whole units.
+ */
+static int watch_scale(int variable)
+{
+    return (variable == BATT_V || variable == SPEED_MS) ? 10 : 1;
+}
+
+
+static int watch_is_fast(int variable)
+{
+    return (variable >= CHANNEL_1 && variable <= CHANNEL_8) || variable == PPM_LINK_ALIVE || variable == BATT_V;
+}
+
+
+static int watch_sample(struct Watch *w)
+{
+    if (w->variable >= CHANNEL_1 && w->variable <= CHANNEL_8)
+        return ppm.channel[w->variable - CHANNEL_1];
+    else if (w->variable == PPM_LINK_ALIVE)
+        return ppm.connection_alive ? 1 : 0;
+    else if (w->variable == BATT_V)
+        return (int)sensor_data.battery1_voltage_10;
+    else
+        return w->slow_value;
+}
+
+
+/*!
+ *   Evaluates all watchers. Call at the control rate (50Hz).
+ */
+void watch_check()
+{
+    int i;
+
+    for (i = 0; i < MAX_WATCHES; i++)
+    {
+        struct Watch *w = &watch[i];
+        int value;
+
+        if (!w->active)
+            continue;
+
+        value = watch_sample(w) * w->comparator;   // "smaller than" becomes "greater than"
+        if (w->armed && value > w->threshold && fired < 0)
+        {
+            w->armed = 0;
+            fired = w->target;
+            if (xGpsSemaphore != NULL)
+                xSemaphoreGive(xGpsSemaphore);   // jump now, not at the next GPS sentence
+        }
+        else if (!w->armed && value < w->threshold - w->hysteresis)
+            w->armed = 1;
+    }
+}
+
+
+/*!
+ *   The line of a watcher that fired and whose jump wasn't taken yet, -1
+ *   if none.
+ */
+int watch_pending()
+{
+    return fired;
+}
+
+
+/*!
+ *   The line a watcher wants to jump to, -1 if none. Called by
+ *   gluonscript_do(): reading and clearing it is one step, so a watcher that
+ *   fires meanwhile isn't lost.
+ */
+int watch_take_jump()
+{
+    int line;
+
+    taskENTER_CRITICAL();
+    line = fired;
+    fired = -1;
+    taskEXIT_CRITICAL();
+    return line;
+}
+
+
+/*!
+ *   The lines the active watchers jump to, for gluonscript_prefetch().
+ *   target holds MAX_WATCHES lines, returns how many there are.
+ */
+int watch_targets(int *target)
+{
+    int i, n = 0;
+
+    for (i = 0; i < MAX_WATCHES; i++)
+        if (watch[i].active)
+            target[n++] = watch[i].target;
+    return n;
+}
+
+
+static void watch_remove(int variable, int comparator)
+{
+    int i;
+    for (i = 0; i < MAX_WATCHES; i++)
+        if (watch[i].active && watch[i].variable == variable && watch[i].comparator == comparator)
+            watch[i].active = 0;
+}
+
+
+static void watch_add(struct GluonscriptCode *code, int comparator)
+{
+    int i, scale = watch_scale(code->a);
+
+    watch_remove(code->a, comparator);   // a watcher is replaced by a new one on the same condition
+    for (i = 0; i < MAX_WATCHES && watch[i].active; i++)
+        ;
+    if (i == MAX_WATCHES)
+    {
+        printf("\r\nWatch: too many watchers\r\n");
+        return;
+    }
+
+    watch[i].variable = code->a;
+    watch[i].comparator = comparator;
+    watch[i].threshold = (int)(code->x * scale) * comparator;
+    watch[i].hysteresis = (int)(code->y * scale);
+    watch[i].target = code->b - 1;
+    watch[i].slow_value = (int)(gluonscript_get_variable(code->a) * scale);
+    watch[i].armed = 1;                  // fires right away when the condition is already true
+    watch[i].active = 1;
+}
+
+
+ScriptHandlerReturn watch_handle_gluonscriptcommand (struct GluonscriptCode *code)
+{
+    int i;
+
+    for (i = 0; i < MAX_WATCHES; i++)
+        if (watch[i].active && !watch_is_fast(watch[i].variable))
+            watch[i].slow_value = (int)(gluonscript_get_variable(watch[i].variable) * watch_scale(watch[i].variable));
+
+    if (code->opcode == WATCH_GR || code->opcode == WATCH_SM)
+    {
+        int comparator = code->opcode == WATCH_GR ? 1 : -1;
+        if (code->b == 0)
+            watch_remove(code->a, comparator);
+        else
+            watch_add(code, comparator);
+        return HANDLED_FINISHED;
+    }
+    return NOT_HANDLED;
+}
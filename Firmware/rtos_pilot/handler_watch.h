@@ -0,0 +1,28 @@
+#ifndef HANDLER_WATCH_H
+#define HANDLER_WATCH_H
+
+#include "gluonscript.h"
+
+#define MAX_WATCHES 4
+
+//! A condition that is watched at the control rate, whatever line is being executed.
+struct Watch
+{
+    volatile unsigned char active;
+    unsigned char variable;           // enum gluonscript_variable
+    signed char comparator;           // 1: fires above the threshold, -1: below
+    unsigned char armed;              // fires again after it went back past the hysteresis
+    int threshold;                    // in the integer form of the variable
+    int hysteresis;
+    int target;                       // gluonscript line
+    volatile int slow_value;          // the variables that change at the GPS rate, updated every tick
+};
+
+void watch_check();
+int watch_pending();
+int watch_take_jump();
+int watch_targets(int *target);
+
+ScriptHandlerReturn watch_handle_gluonscriptcommand (struct GluonscriptCode *code);
+
+#endif // HANDLER_WATCH_H
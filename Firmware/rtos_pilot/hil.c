@@ -0,0 +1,250 @@
+/*!
+ *  Binary hardware-in-the-loop interface.
+ *
+ *  An external simulator injects raw IMU, barometer, GPS and RC samples at the
+ *  full sensor rate. They replace the readings of the sensor drivers, so the AHRS,
+ *  control and navigation code run unmodified. The servo outputs are returned
+ *  every control cycle.
+ *
+ *  At 57600 baud, IMU samples at 50Hz and servo frames at 50Hz take about a third
+ *  of the link. At 250Hz (quadrocopter) the uart needs to be switched to 115200.
+ *
+ *  Enabled with the HI command, see hil.h for the frame format.
+ *
+ *  @file     hil.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <string.h>
+
+// Include all FreeRTOS header files
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+#include "FreeRTOS/queue.h"
+#include "FreeRTOS/croutine.h"
+#include "FreeRTOS/semphr.h"
+
+#include "uart1_queue/uart1_queue.h"
+#include "ppm_in/ppm_in.h"
+#include "servo/servo.h"
+#include "scp1000/scp1000.h"
+
+#include "hil.h"
+#include "sensors.h"
+
+//! Control ticks (50Hz) without RC frame before the link is considered lost
+#define HIL_RC_TIMEOUT_TICKS 25
+
+extern xSemaphoreHandle xUart1Semaphore;
+extern xSemaphoreHandle xGpsSemaphore;
+
+volatile struct HilData hil = { .active = 0 };
+
+enum HilParserState { WAIT_SYNC1, WAIT_SYNC2, WAIT_TYPE, WAIT_LENGTH, PAYLOAD, WAIT_CK_A, WAIT_CK_B };
+
+static enum HilParserState state = WAIT_SYNC1;
+static unsigned char type, length, position, ck_a, ck_b;
+static unsigned char payload[HIL_MAX_PAYLOAD];
+
+
+static void checksum_add(unsigned char c)
+{
+	ck_a += c;
+	ck_b += ck_a;
+}
+
+
+/*!
+ *   Copies a received frame into the hil struct.
+ */
+static void hil_handle_frame()
+{
+	switch (type)
+	{
+		case HIL_IMU:
+			if (length == 12)
+				memcpy((void *)hil.imu_raw, payload, 12);
+			break;
+		case HIL_BARO:
+			if (length == 6)
+			{
+				memcpy((void *)&hil.pressure, payload, 4);
+				memcpy((void *)&hil.temperature_10, payload + 4, 2);
+				hil.baro_updated = 1;
+			}
+			break;
+		case HIL_GPS:
+			if (length == 19)
+			{
+				memcpy((void *)&hil.latitude_rad, payload, 4);
+				memcpy((void *)&hil.longitude_rad, payload + 4, 4);
+				memcpy((void *)&hil.speed_ms, payload + 8, 4);
+				memcpy((void *)&hil.heading_rad, payload + 12, 4);
+				memcpy((void *)&hil.height_m, payload + 16, 2);
+				hil.satellites_in_view = payload[18];
+				hil.gps_updated = 1;
+				if (hil.active)
+					xSemaphoreGive(xGpsSemaphore);  // as if a complete NMEA sentence came in
+			}
+			break;
+		case HIL_RC:
+			if (length == 16 && hil.active)
+			{
+				memcpy((void *)ppm.channel, payload, 16);
+				hil.rc_ticks_no_frame = 0;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+
+/*!
+ *   Feeds one byte received on uart1 to the frame parser.
+ *   @return 1 when the byte belongs to a binary frame, 0 when it should go to the CSV parser.
+ */
+int hil_parse_byte(unsigned char c)
+{
+	switch (state)
+	{
+		case WAIT_SYNC1:
+			if (c != HIL_SYNC1)
+				return 0;
+			state = WAIT_SYNC2;
+			break;
+		case WAIT_SYNC2:
+			state = (c == HIL_SYNC2) ? WAIT_TYPE : WAIT_SYNC1;
+			break;
+		case WAIT_TYPE:
+			type = c;
+			ck_a = ck_b = 0;
+			checksum_add(c);
+			state = WAIT_LENGTH;
+			break;
+		case WAIT_LENGTH:
+			length = c;
+			position = 0;
+			checksum_add(c);
+			if (length > HIL_MAX_PAYLOAD)
+				state = WAIT_SYNC1;
+			else
+				state = length > 0 ? PAYLOAD : WAIT_CK_A;
+			break;
+		case PAYLOAD:
+			payload[position++] = c;
+			checksum_add(c);
+			if (position >= length)
+				state = WAIT_CK_A;
+			break;
+		case WAIT_CK_A:
+			state = (c == ck_a) ? WAIT_CK_B : WAIT_SYNC1;
+			break;
+		case WAIT_CK_B:
+			if (c == ck_b)
+				hil_handle_frame();
+			state = WAIT_SYNC1;
+			break;
+	}
+	return 1;
+}
+
+
+/*!
+ *   Replaces the IMU driver: raw words as they would be read from the ADC or MPU-6000.
+ */
+void hil_read_raw_imu()
+{
+	sensor_data.acc_x_raw = hil.imu_raw[0];
+	sensor_data.acc_y_raw = hil.imu_raw[1];
+	sensor_data.acc_z_raw = hil.imu_raw[2];
+	sensor_data.gyro_x_raw = hil.imu_raw[3];
+	sensor_data.gyro_y_raw = hil.imu_raw[4];
+	sensor_data.gyro_z_raw = hil.imu_raw[5];
+}
+
+
+/*!
+ *   Replaces the barometer driver.
+ */
+void hil_read_baro()
+{
+	if (!hil.baro_updated)
+		return;
+	hil.baro_updated = 0;
+
+	sensor_data.pressure = (float)hil.pressure;
+	sensor_data.temperature_10 = hil.temperature_10;
+	sensor_data.temperature = (float)hil.temperature_10 / 10.0f;
+	sensor_data.pressure_height = scp1000_pressure_to_height(sensor_data.pressure, sensor_data.temperature);
+}
+
+
+/*!
+ *   Replaces gps_update_info().
+ *   @return 1 when a new position was taken
+ */
+char hil_update_gps(struct gps_info *gpsinfo)
+{
+	if (!hil.gps_updated)
+		return 0;
+	hil.gps_updated = 0;
+
+	gpsinfo->latitude_rad = hil.latitude_rad;
+	gpsinfo->longitude_rad = hil.longitude_rad;
+	gpsinfo->speed_ms = hil.speed_ms;
+	gpsinfo->heading_rad = hil.heading_rad;
+	gpsinfo->height_m = hil.height_m;
+	gpsinfo->satellites_in_view = hil.satellites_in_view;
+	gpsinfo->status = hil.satellites_in_view >= 4 ? ACTIVE : VOID;
+	return 1;
+}
+
+
+/*!
+ *   Replaces ppm_in_update_status_ticks_50hz().
+ */
+void hil_update_rc_status_50hz()
+{
+	if (hil.rc_ticks_no_frame < HIL_RC_TIMEOUT_TICKS)
+		hil.rc_ticks_no_frame++;
+	ppm.connection_alive = (hil.rc_ticks_no_frame < HIL_RC_TIMEOUT_TICKS);
+}
+
+
+/*!
+ *   Sends the current servo pulses to the simulator. Skipped when another task
+ *   is writing to uart1.
+ */
+void hil_send_servos()
+{
+	unsigned char frame[6 + 12];
+	unsigned char a = 0, b = 0;
+	unsigned int us;
+	int i;
+
+	frame[0] = HIL_SYNC1;
+	frame[1] = HIL_SYNC2;
+	frame[2] = HIL_SERVOS;
+	frame[3] = 12;
+	for (i = 0; i < 6; i++)
+	{
+		us = servo_read_us(i);
+		frame[4 + 2*i] = (unsigned char)(us & 0xFF);
+		frame[5 + 2*i] = (unsigned char)(us >> 8);
+	}
+	for (i = 2; i < 16; i++)
+	{
+		a += frame[i];
+		b += a;
+	}
+	frame[16] = a;
+	frame[17] = b;
+
+	if (xSemaphoreTake( xUart1Semaphore, 0 ) == pdTRUE)
+	{
+		uart1_put((char *)frame, sizeof(frame));
+		xSemaphoreGive( xUart1Semaphore );
+	}
+}
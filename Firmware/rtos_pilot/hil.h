@@ -0,0 +1,55 @@
+#ifndef HIL_H
+#define HIL_H
+
+#include "gps/gps.h"
+
+/*!
+ *   Binary hardware-in-the-loop frames on uart1:
+ *   0xA5 0x5A type length payload[length] ck_a ck_b
+ *   The checksum is an 8-bit Fletcher over type, length and payload (as in UBX).
+ *   All values are little endian.
+ */
+#define HIL_SYNC1 0xA5
+#define HIL_SYNC2 0x5A
+#define HIL_MAX_PAYLOAD 24
+
+enum HilMessage
+{
+	HIL_IMU = 1,      //!< 6 x unsigned int: acc x/y/z, gyro x/y/z raw words, as in the TR telemetry
+	HIL_BARO = 2,     //!< long pressure (Pa), int temperature (0.1 degC)
+	HIL_GPS = 3,      //!< float lat (rad), float lon (rad), float speed (m/s), float heading (rad), int height (m), unsigned char satellites
+	HIL_RC = 4,       //!< 8 x unsigned int, ppm channels in us
+	HIL_SERVOS = 0x81 //!< Autopilot -> simulator, 6 x unsigned int, servo pulses in us
+};
+
+/*!
+ *   Latest samples received from the simulator.
+ */
+struct HilData
+{
+	unsigned int active : 1;
+	unsigned int baro_updated : 1;
+	unsigned int gps_updated : 1;
+
+	unsigned int imu_raw[6];
+	long pressure;
+	int temperature_10;
+
+	float latitude_rad, longitude_rad;
+	float speed_ms, heading_rad;
+	int height_m;
+	unsigned char satellites_in_view;
+
+	unsigned int rc_ticks_no_frame;  //!< Control ticks since the last RC frame
+};
+
+extern volatile struct HilData hil;
+
+int hil_parse_byte(unsigned char c);
+void hil_read_raw_imu();
+void hil_read_baro();
+char hil_update_gps(struct gps_info *gpsinfo);
+void hil_update_rc_status_50hz();
+void hil_send_servos();
+
+#endif // HIL_H
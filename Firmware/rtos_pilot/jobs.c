@@ -0,0 +1,143 @@
+/*!
+ *  Runs the low rate periodic jobs cooperatively on one task.
+ *
+ *  Telemetry (10Hz), the datalogger (4Hz) and the OSD (5Hz) each had their
+ *  own task: a stack carved from the FreeRTOS heap and a context switch per
+ *  period. With ENABLE_COOPERATIVE_JOBS they become jobs of this worker task,
+ *  which only needs the stack of the deepest job. The jobs are kept in a
+ *  timing wheel of JOBS_WHEEL_SLOTS slots of JOBS_TICK_MS: every tick the
+ *  worker wakes up once and runs the jobs in the current slot, in the order
+ *  they were added, and puts each one back a period further.
+ *
+ *  The init functions of the jobs run first, one after the other, when the
+ *  worker starts: they may block (the OSD has to wait for the MAX7456).
+ *  A run must return quickly and not block for long, it delays the others.
+ *  Every run is accounted against its deadline (the next release); RJ sends
+ *  the counters. When the worker falls behind, vTaskDelayUntil doesn't wait
+ *  and the missed slots are run right away, so no release is skipped.
+ *
+ *  The control and sensor tasks stay preemptive, as do the GPS/navigation and
+ *  console tasks: those wait for their input, not for a period.
+ *
+ *  @file     jobs.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#include "jobs.h"
+#include "common.h"
+
+static struct Job *wheel[JOBS_WHEEL_SLOTS];
+static struct Job *jobs[JOBS_MAX];
+static int n_jobs = 0;
+
+static void jobs_insert(struct Job *job, int slot);
+
+
+/*!
+ *   Adds a job, before the worker task starts. The first run is one period
+ *   after the init functions of all jobs.
+ *   @return 0 when the period doesn't fit the wheel or there are too many jobs
+ */
+int jobs_add(struct Job *job)
+{
+	unsigned int ticks = job->period_ms / JOBS_TICK_MS;
+
+	if (n_jobs >= JOBS_MAX || ticks == 0 || ticks > JOBS_WHEEL_SLOTS || job->period_ms % JOBS_TICK_MS != 0)
+	{
+		printf("Job %s: invalid period\r\n", job->name);
+		return 0;
+	}
+	job->runs = 0;
+	job->deadline_misses = 0;
+	job->max_late_ms = 0;
+	job->max_run_ms = 0;
+	job->next = NULL;
+	jobs[n_jobs++] = job;
+	return 1;
+}
+
+
+int jobs_count()
+{
+	return n_jobs;
+}
+
+
+struct Job *jobs_get(int i)
+{
+	return jobs[i];
+}
+
+
+/*!
+ *   FreeRTOS task running the jobs.
+ */
+void jobs_task(void *parameters)
+{
+	portTickType xLastExecutionTime, start, end;
+	struct Job *due, *job;
+	int i, slot = 0;
+
+	vTaskSetApplicationTaskTag( NULL, ( void * ) 5 );
+	for (i = 0; i < n_jobs; i++)
+		if (jobs[i]->init == NULL || jobs[i]->init())
+			jobs_insert(jobs[i], (jobs[i]->period_ms / JOBS_TICK_MS) % JOBS_WHEEL_SLOTS);
+	xLastExecutionTime = xTaskGetTickCount();
+
+	for ( ;; )
+	{
+		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) JOBS_TICK_MS / portTICK_RATE_MS ) );
+		slot = (slot + 1) % JOBS_WHEEL_SLOTS;
+
+		due = wheel[slot];
+		wheel[slot] = NULL;
+		while (due)
+		{
+			job = due;
+			due = due->next;
+
+			start = xTaskGetTickCount();
+			if (! job->run())
+				continue;   // leaves the wheel
+			end = xTaskGetTickCount();
+
+			// xLastExecutionTime is the release of this slot
+			job->runs++;
+			job->max_late_ms = MAX(job->max_late_ms, (unsigned int)(start - xLastExecutionTime) * portTICK_RATE_MS);
+			job->max_run_ms = MAX(job->max_run_ms, (unsigned int)(end - start) * portTICK_RATE_MS);
+			if ((unsigned int)(end - xLastExecutionTime) * portTICK_RATE_MS > job->period_ms)
+				job->deadline_misses++;
+
+			jobs_insert(job, (slot + job->period_ms / JOBS_TICK_MS) % JOBS_WHEEL_SLOTS);
+		}
+	}
+}
+
+
+/*!
+ *   Puts a job in a slot, in the order the jobs were added.
+ */
+static void jobs_insert(struct Job *job, int slot)
+{
+	struct Job **p = &wheel[slot];
+	int i, j;
+
+	for (i = 0; jobs[i] != job; i++)
+		;
+	while (*p)
+	{
+		for (j = 0; jobs[j] != *p; j++)
+			;
+		if (j > i)
+			break;
+		p = &((*p)->next);
+	}
+	job->next = *p;
+	*p = job;
+}
@@ -0,0 +1,32 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#define JOBS_TICK_MS 50            //!< resolution of the timing wheel, periods are a multiple of it
+#define JOBS_WHEEL_SLOTS 20        //!< one second, the longest period
+#define JOBS_MAX 6
+
+/*!
+ *   A periodic job of the worker task. The deadline of a run is the next
+ *   release, one period after its own.
+ */
+struct Job
+{
+	const char *name;
+	int (*init)();                 //!< may block, NULL when none; returns 0 when the job isn't needed
+	int (*run)();                  //!< returns 0 when the job is done for good
+	unsigned int period_ms;
+
+	unsigned long runs;
+	unsigned int deadline_misses;  //!< runs that finished after their deadline
+	unsigned int max_late_ms;      //!< worst start after the release
+	unsigned int max_run_ms;
+
+	struct Job *next;              //!< in its slot of the wheel
+};
+
+int jobs_add(struct Job *job);
+int jobs_count();
+struct Job *jobs_get(int i);
+void jobs_task(void *parameters);
+
+#endif // JOBS_H
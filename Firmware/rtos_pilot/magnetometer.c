@@ -0,0 +1,274 @@
+/*!
+ *  Calibrated magnetometer and tilt compensated heading.
+ *
+ *  The HMC5843/5883L is read with an interrupt driven I2C transaction
+ *  (hmc5843_read_async), so the sensor task is never blocked. Every new
+ *  vector is corrected for hard iron (offset) and soft iron (per-axis scale)
+ *  and stored in sensor_data.mag_x/y/z, with 1.0 being the local field strength.
+ *
+ *  The calibration is an ellipsoid fit on samples collected while the plane is
+ *  rotated in all directions (CM;1 ... CM;0):
+ *     A x^2 + B y^2 + C z^2 + D x + E y + F z = 1
+ *  solved in the least squares sense. Only the sums of the normal equations are
+ *  kept, so the number of samples is unlimited and costs no extra RAM.
+ *
+ *  @file     magnetometer.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+// Include all FreeRTOS header files
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#include "hmc5843/hmc5843.h"
+#include "fastmath/fastmath.h"
+
+#include "magnetometer.h"
+#include "sensors.h"
+#include "configuration.h"
+#include "common.h"
+
+#define FIT_SCALE 512.0f              //!< raw units are divided by this to keep the sums well conditioned
+#define SAMPLE_MIN_DISTANCE 20        //!< raw units, skip samples too close to the previous one
+#define MAX_RADIUS_RATIO 2.0f         //!< reject fits that are too far from a sphere
+#define FIELD_TOLERANCE 0.3f          //!< reject headings when the field strength is off by more than 30%
+
+static int calibrating = 0;
+static int samples = 0;
+static int last_x, last_y, last_z;
+static int min[3], max[3];   //!< raw range per axis, to check the coverage
+static float ata[6][6];    //!< sum of phi*phi'
+static float atb[6];       //!< sum of phi
+
+static int solve6(float a[6][6], float b[6]);
+
+
+/*!
+ *   Initializes the magnetometer and reads the first vector (blocking).
+ *   Call from the sensor task, after i2c_init().
+ */
+void magnetometer_init()
+{
+	hmc5843_init();
+	vTaskDelay(( portTickType ) 100 / portTICK_RATE_MS );  // the first measurement takes 100ms
+	hmc5843_read(&sensor_data.magnetometer_raw);
+	magnetometer_update();
+}
+
+
+/*!
+ *   Updates the calibrated vector with the result of the previous read, and
+ *   queues the next one. Call at the magnetometer's rate (15Hz).
+ */
+void magnetometer_read()
+{
+	if (hmc5843_read_async(&sensor_data.magnetometer_raw))
+		magnetometer_update();
+}
+
+
+/*!
+ *   Applies the calibration to the raw vector, and adds it to the calibration
+ *   sums when a calibration is running.
+ */
+void magnetometer_update()
+{
+	int x = sensor_data.magnetometer_raw.x.i16;
+	int y = sensor_data.magnetometer_raw.y.i16;
+	int z = sensor_data.magnetometer_raw.z.i16;
+
+	sensor_data.mag_x = (float)(x - config.sensors.magnetometer_offset_x) * config.sensors.magnetometer_scale_x;
+	sensor_data.mag_y = (float)(y - config.sensors.magnetometer_offset_y) * config.sensors.magnetometer_scale_y;
+	sensor_data.mag_z = (float)(z - config.sensors.magnetometer_offset_z) * config.sensors.magnetometer_scale_z;
+
+	if (calibrating &&
+	    (abs(x - last_x) > SAMPLE_MIN_DISTANCE || abs(y - last_y) > SAMPLE_MIN_DISTANCE || abs(z - last_z) > SAMPLE_MIN_DISTANCE))
+	{
+		float phi[6];
+		int i, j;
+
+		phi[3] = (float)x / FIT_SCALE;
+		phi[4] = (float)y / FIT_SCALE;
+		phi[5] = (float)z / FIT_SCALE;
+		phi[0] = phi[3] * phi[3];
+		phi[1] = phi[4] * phi[4];
+		phi[2] = phi[5] * phi[5];
+
+		for (i = 0; i < 6; i++)
+		{
+			for (j = i; j < 6; j++)
+				ata[i][j] += phi[i] * phi[j];
+			atb[i] += phi[i];
+		}
+		min[0] = MIN(min[0], x);  max[0] = MAX(max[0], x);
+		min[1] = MIN(min[1], y);  max[1] = MAX(max[1], y);
+		min[2] = MIN(min[2], z);  max[2] = MAX(max[2], z);
+		samples++;
+		last_x = x;
+		last_y = y;
+		last_z = z;
+	}
+}
+
+
+/*!
+ *   Tilt compensated magnetic heading, corrected for the declination.
+ *   @param heading Heading in [0, 2*PI), only written when valid.
+ *   @return 1 when valid, 0 when the field strength is off (magnetic disturbance or not calibrated)
+ */
+int magnetometer_heading(float sin_roll, float cos_roll, float sin_pitch, float cos_pitch, float *heading)
+{
+	float mx = sensor_data.mag_x, my = sensor_data.mag_y, mz = sensor_data.mag_z;
+	float norm2 = mx*mx + my*my + mz*mz;
+	float YH, XH, h;
+
+	if (norm2 < (1.0f - FIELD_TOLERANCE)*(1.0f - FIELD_TOLERANCE) || norm2 > (1.0f + FIELD_TOLERANCE)*(1.0f + FIELD_TOLERANCE))
+		return 0;
+
+	YH =                my*cos_roll           - mz*sin_roll;
+	XH = mx*cos_pitch + my*sin_roll*sin_pitch + mz*cos_roll*sin_pitch;
+
+	h = fast_atan2(-YH, XH) + config.sensors.magnetic_declination;
+	if (h >= 2.0f*PI)
+		h -= 2.0f*PI;
+	else if (h < 0.0f)
+		h += 2.0f*PI;
+	*heading = h;
+	return 1;
+}
+
+
+/*!
+ *   Starts collecting samples. Rotate the plane around all axes, away from
+ *   metal and cables carrying a current, then call magnetometer_calibration_finish().
+ */
+void magnetometer_calibration_start()
+{
+	int i, j;
+
+	calibrating = 0;
+	for (i = 0; i < 6; i++)
+	{
+		for (j = 0; j < 6; j++)
+			ata[i][j] = 0.0f;
+		atb[i] = 0.0f;
+	}
+	for (i = 0; i < 3; i++)
+	{
+		min[i] = 32767;
+		max[i] = -32768;
+	}
+	samples = 0;
+	last_x = last_y = last_z = 0;
+	calibrating = 1;
+}
+
+
+int magnetometer_calibration_samples()
+{
+	return samples;
+}
+
+
+/*!
+ *   Fits the ellipsoid through the collected samples and stores the offsets and
+ *   scales in the configuration (not written to flash).
+ *   @return 1 on success, 0 when there are too few samples or the fit is degenerate.
+ */
+int magnetometer_calibration_finish()
+{
+	float a[6][6], b[6];
+	float center[3], radius[3], g;
+	int i, j;
+
+	portENTER_CRITICAL();
+	calibrating = 0;
+	for (i = 0; i < 6; i++)
+	{
+		for (j = 0; j < 6; j++)
+			a[i][j] = (j >= i) ? ata[i][j] : ata[j][i];
+		b[i] = atb[i];
+	}
+	portEXIT_CRITICAL();
+
+	if (samples < MAGNETOMETER_CALIBRATION_MIN_SAMPLES || !solve6(a, b))
+		return 0;
+
+	g = 1.0f;
+	for (i = 0; i < 3; i++)
+	{
+		if (b[i] <= 0.0f)   // not an ellipsoid: the samples don't cover all directions
+			return 0;
+		center[i] = -b[i+3] / (2.0f * b[i]);
+		g += b[i] * center[i] * center[i];
+	}
+	for (i = 0; i < 3; i++)
+	{
+		radius[i] = sqrtf(g / b[i]);
+		if ((float)(max[i] - min[i]) < radius[i] * FIT_SCALE)   // less than half of the ellipsoid seen
+			return 0;
+	}
+
+	if (MAX(radius[0], MAX(radius[1], radius[2])) > MAX_RADIUS_RATIO * MIN(radius[0], MIN(radius[1], radius[2])))
+		return 0;
+
+	config.sensors.magnetometer_offset_x = (int)(center[0] * FIT_SCALE);
+	config.sensors.magnetometer_offset_y = (int)(center[1] * FIT_SCALE);
+	config.sensors.magnetometer_offset_z = (int)(center[2] * FIT_SCALE);
+	config.sensors.magnetometer_scale_x = 1.0f / (radius[0] * FIT_SCALE);
+	config.sensors.magnetometer_scale_y = 1.0f / (radius[1] * FIT_SCALE);
+	config.sensors.magnetometer_scale_z = 1.0f / (radius[2] * FIT_SCALE);
+	return 1;
+}
+
+
+/*!
+ *   Solves a x = b with Gaussian elimination and partial pivoting.
+ *   The solution is returned in b, a is destroyed.
+ *   @return 0 when a is singular
+ */
+static int solve6(float a[6][6], float b[6])
+{
+	int i, j, k, pivot;
+	float f;
+
+	for (k = 0; k < 6; k++)
+	{
+		pivot = k;
+		for (i = k + 1; i < 6; i++)
+			if (fabs(a[i][k]) > fabs(a[pivot][k]))
+				pivot = i;
+		if (fabs(a[pivot][k]) < 1.0e-6f)
+			return 0;
+		if (pivot != k)
+		{
+			for (j = 0; j < 6; j++)
+			{
+				f = a[k][j];
+				a[k][j] = a[pivot][j];
+				a[pivot][j] = f;
+			}
+			f = b[k];
+			b[k] = b[pivot];
+			b[pivot] = f;
+		}
+		for (i = k + 1; i < 6; i++)
+		{
+			f = a[i][k] / a[k][k];
+			for (j = k; j < 6; j++)
+				a[i][j] -= f * a[k][j];
+			b[i] -= f * b[k];
+		}
+	}
+	for (k = 5; k >= 0; k--)
+	{
+		for (j = k + 1; j < 6; j++)
+			b[k] -= a[k][j] * b[j];
+		b[k] /= a[k][k];
+	}
+	return 1;
+}
@@ -0,0 +1,16 @@
+#ifndef MAGNETOMETER_H
+#define MAGNETOMETER_H
+
+#define MAGNETOMETER_CALIBRATION_MIN_SAMPLES 100
+
+void magnetometer_init();
+void magnetometer_read();
+void magnetometer_update();
+
+int magnetometer_heading(float sin_roll, float cos_roll, float sin_pitch, float cos_pitch, float *heading);
+
+void magnetometer_calibration_start();
+int magnetometer_calibration_finish();
+int magnetometer_calibration_samples();
+
+#endif // MAGNETOMETER_H
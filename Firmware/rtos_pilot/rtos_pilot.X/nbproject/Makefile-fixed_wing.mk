@@ -41,11 +41,11 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1970174492/croutine.o ${OBJECTDIR}/_ext/1970174492/heap_1.o ${OBJECTDIR}/_ext/1970174492/list.o ${OBJECTDIR}/_ext/1970174492/port.o ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o ${OBJECTDIR}/_ext/1970174492/queue.o ${OBJECTDIR}/_ext/1970174492/tasks.o ${OBJECTDIR}/_ext/1970174492/timers.o ${OBJECTDIR}/_ext/957539446/adc.o ${OBJECTDIR}/_ext/1077768206/bmp085.o ${OBJECTDIR}/_ext/1070193764/button.o ${OBJECTDIR}/_ext/968823332/dataflash.o ${OBJECTDIR}/_ext/957545600/gps.o ${OBJECTDIR}/_ext/1967121974/hmc5843.o ${OBJECTDIR}/_ext/957545584/i2c.o ${OBJECTDIR}/_ext/957550049/led.o ${OBJECTDIR}/_ext/773745621/matrix.o ${OBJECTDIR}/_ext/1785572984/max7456.o ${OBJECTDIR}/_ext/1843177418/microcontroller.o ${OBJECTDIR}/_ext/957554017/pid.o ${OBJECTDIR}/_ext/674232159/ppm_in.o ${OBJECTDIR}/_ext/667767512/pwm_in.o ${OBJECTDIR}/_ext/888521352/quaternion.o ${OBJECTDIR}/_ext/1429652139/scp1000.o ${OBJECTDIR}/_ext/1089077615/servo.o ${OBJECTDIR}/_ext/1591518261/uart1_queue.o ${OBJECTDIR}/_ext/1090805370/uart2.o ${OBJECTDIR}/_ext/2082761406/mpu6000.o ${OBJECTDIR}/_ext/1843177418/getErrLoc.o ${OBJECTDIR}/_ext/1472/communication_csv.o ${OBJECTDIR}/_ext/1472/configuration.o ${OBJECTDIR}/_ext/1472/gluonscript.o ${OBJECTDIR}/_ext/1472/rtos_pilot.o ${OBJECTDIR}/_ext/1472/handler_alarms.o ${OBJECTDIR}/_ext/1472/handler_trigger.o ${OBJECTDIR}/_ext/1472/handler_navigation.o ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o ${OBJECTDIR}/_ext/1472/task_gps.o ${OBJECTDIR}/_ext/1472/task_datalogger.o ${OBJECTDIR}/_ext/1472/task_control.o ${OBJECTDIR}/_ext/1472/task_sensors_analog.o ${OBJECTDIR}/_ext/1472/sensors.o ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o ${OBJECTDIR}/_ext/1472/handler_maximum_range.o ${OBJECTDIR}/_ext/1472/task_osd.o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1970174492/croutine.o.d ${OBJECTDIR}/_ext/1970174492/heap_1.o.d ${OBJECTDIR}/_ext/1970174492/list.o.d ${OBJECTDIR}/_ext/1970174492/port.o.d ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o.d ${OBJECTDIR}/_ext/1970174492/queue.o.d ${OBJECTDIR}/_ext/1970174492/tasks.o.d ${OBJECTDIR}/_ext/1970174492/timers.o.d ${OBJECTDIR}/_ext/957539446/adc.o.d ${OBJECTDIR}/_ext/1077768206/bmp085.o.d ${OBJECTDIR}/_ext/1070193764/button.o.d ${OBJECTDIR}/_ext/968823332/dataflash.o.d ${OBJECTDIR}/_ext/957545600/gps.o.d ${OBJECTDIR}/_ext/1967121974/hmc5843.o.d ${OBJECTDIR}/_ext/957545584/i2c.o.d ${OBJECTDIR}/_ext/957550049/led.o.d ${OBJECTDIR}/_ext/773745621/matrix.o.d ${OBJECTDIR}/_ext/1785572984/max7456.o.d ${OBJECTDIR}/_ext/1843177418/microcontroller.o.d ${OBJECTDIR}/_ext/957554017/pid.o.d ${OBJECTDIR}/_ext/674232159/ppm_in.o.d ${OBJECTDIR}/_ext/667767512/pwm_in.o.d ${OBJECTDIR}/_ext/888521352/quaternion.o.d ${OBJECTDIR}/_ext/1429652139/scp1000.o.d ${OBJECTDIR}/_ext/1089077615/servo.o.d ${OBJECTDIR}/_ext/1591518261/uart1_queue.o.d ${OBJECTDIR}/_ext/1090805370/uart2.o.d ${OBJECTDIR}/_ext/2082761406/mpu6000.o.d ${OBJECTDIR}/_ext/1843177418/getErrLoc.o.d ${OBJECTDIR}/_ext/1472/communication_csv.o.d ${OBJECTDIR}/_ext/1472/configuration.o.d ${OBJECTDIR}/_ext/1472/gluonscript.o.d ${OBJECTDIR}/_ext/1472/rtos_pilot.o.d ${OBJECTDIR}/_ext/1472/handler_alarms.o.d ${OBJECTDIR}/_ext/1472/handler_trigger.o.d ${OBJECTDIR}/_ext/1472/handler_navigation.o.d ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o.d ${OBJECTDIR}/_ext/1472/task_gps.o.d ${OBJECTDIR}/_ext/1472/task_datalogger.o.d ${OBJECTDIR}/_ext/1472/task_control.o.d ${OBJECTDIR}/_ext/1472/task_sensors_analog.o.d ${OBJECTDIR}/_ext/1472/sensors.o.d ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o.d ${OBJECTDIR}/_ext/1472/handler_maximum_range.o.d ${OBJECTDIR}/_ext/1472/task_osd.o.d ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1970174492/croutine.o ${OBJECTDIR}/_ext/1970174492/heap_1.o ${OBJECTDIR}/_ext/1970174492/list.o ${OBJECTDIR}/_ext/1970174492/port.o ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o ${OBJECTDIR}/_ext/1970174492/queue.o ${OBJECTDIR}/_ext/1970174492/tasks.o ${OBJECTDIR}/_ext/1970174492/timers.o ${OBJECTDIR}/_ext/957539446/adc.o ${OBJECTDIR}/_ext/1077768206/bmp085.o ${OBJECTDIR}/_ext/1070193764/button.o ${OBJECTDIR}/_ext/968823332/dataflash.o ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o ${OBJECTDIR}/_ext/957545600/gps.o ${OBJECTDIR}/_ext/1967121974/hmc5843.o ${OBJECTDIR}/_ext/957545584/i2c.o ${OBJECTDIR}/_ext/957550049/led.o ${OBJECTDIR}/_ext/773745621/matrix.o ${OBJECTDIR}/_ext/1785572984/max7456.o ${OBJECTDIR}/_ext/1843177418/microcontroller.o ${OBJECTDIR}/_ext/957554017/pid.o ${OBJECTDIR}/_ext/674232159/ppm_in.o ${OBJECTDIR}/_ext/667767512/pwm_in.o ${OBJECTDIR}/_ext/888521352/quaternion.o ${OBJECTDIR}/_ext/118348622/fastmath.o ${OBJECTDIR}/_ext/1429652139/scp1000.o ${OBJECTDIR}/_ext/1089077615/servo.o ${OBJECTDIR}/_ext/1591518261/uart1_queue.o ${OBJECTDIR}/_ext/1090805370/uart2.o ${OBJECTDIR}/_ext/2082761406/mpu6000.o ${OBJECTDIR}/_ext/1843177418/getErrLoc.o ${OBJECTDIR}/_ext/1472/communication_csv.o ${OBJECTDIR}/_ext/1472/configuration.o ${OBJECTDIR}/_ext/1472/gluonscript.o ${OBJECTDIR}/_ext/1472/rtos_pilot.o ${OBJECTDIR}/_ext/1472/handler_alarms.o ${OBJECTDIR}/_ext/1472/handler_trigger.o ${OBJECTDIR}/_ext/1472/handler_navigation.o ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o ${OBJECTDIR}/_ext/1472/task_gps.o ${OBJECTDIR}/_ext/1472/task_datalogger.o ${OBJECTDIR}/_ext/1472/task_control.o ${OBJECTDIR}/_ext/1472/task_sensors_analog.o ${OBJECTDIR}/_ext/1472/sensors.o ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o ${OBJECTDIR}/_ext/1472/handler_maximum_range.o ${OBJECTDIR}/_ext/1472/task_osd.o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o ${OBJECTDIR}/_ext/1472/hil.o ${OBJECTDIR}/_ext/1472/benchmark.o ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o ${OBJECTDIR}/_ext/1472/magnetometer.o ${OBJECTDIR}/_ext/1472/gyro_temperature.o ${OBJECTDIR}/_ext/1472/sensor_health.o ${OBJECTDIR}/_ext/1472/handler_geofence.o ${OBJECTDIR}/_ext/1472/wind_estimator.o ${OBJECTDIR}/_ext/1472/dubins_path.o ${OBJECTDIR}/_ext/1472/handler_watch.o ${OBJECTDIR}/_ext/1472/gain_schedule.o ${OBJECTDIR}/_ext/1472/autotune.o ${OBJECTDIR}/_ext/1472/stack_monitor.o ${OBJECTDIR}/_ext/1472/jobs.o ${OBJECTDIR}/_ext/1472/geotag.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1970174492/croutine.o.d ${OBJECTDIR}/_ext/1970174492/heap_1.o.d ${OBJECTDIR}/_ext/1970174492/list.o.d ${OBJECTDIR}/_ext/1970174492/port.o.d ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o.d ${OBJECTDIR}/_ext/1970174492/queue.o.d ${OBJECTDIR}/_ext/1970174492/tasks.o.d ${OBJECTDIR}/_ext/1970174492/timers.o.d ${OBJECTDIR}/_ext/957539446/adc.o.d ${OBJECTDIR}/_ext/1077768206/bmp085.o.d ${OBJECTDIR}/_ext/1070193764/button.o.d ${OBJECTDIR}/_ext/968823332/dataflash.o.d ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d ${OBJECTDIR}/_ext/957545600/gps.o.d ${OBJECTDIR}/_ext/1967121974/hmc5843.o.d ${OBJECTDIR}/_ext/957545584/i2c.o.d ${OBJECTDIR}/_ext/957550049/led.o.d ${OBJECTDIR}/_ext/773745621/matrix.o.d ${OBJECTDIR}/_ext/1785572984/max7456.o.d ${OBJECTDIR}/_ext/1843177418/microcontroller.o.d ${OBJECTDIR}/_ext/957554017/pid.o.d ${OBJECTDIR}/_ext/674232159/ppm_in.o.d ${OBJECTDIR}/_ext/667767512/pwm_in.o.d ${OBJECTDIR}/_ext/888521352/quaternion.o.d ${OBJECTDIR}/_ext/118348622/fastmath.o.d ${OBJECTDIR}/_ext/1429652139/scp1000.o.d ${OBJECTDIR}/_ext/1089077615/servo.o.d ${OBJECTDIR}/_ext/1591518261/uart1_queue.o.d ${OBJECTDIR}/_ext/1090805370/uart2.o.d ${OBJECTDIR}/_ext/2082761406/mpu6000.o.d ${OBJECTDIR}/_ext/1843177418/getErrLoc.o.d ${OBJECTDIR}/_ext/1472/communication_csv.o.d ${OBJECTDIR}/_ext/1472/configuration.o.d ${OBJECTDIR}/_ext/1472/gluonscript.o.d ${OBJECTDIR}/_ext/1472/rtos_pilot.o.d ${OBJECTDIR}/_ext/1472/handler_alarms.o.d ${OBJECTDIR}/_ext/1472/handler_trigger.o.d ${OBJECTDIR}/_ext/1472/handler_navigation.o.d ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o.d ${OBJECTDIR}/_ext/1472/task_gps.o.d ${OBJECTDIR}/_ext/1472/task_datalogger.o.d ${OBJECTDIR}/_ext/1472/task_control.o.d ${OBJECTDIR}/_ext/1472/task_sensors_analog.o.d ${OBJECTDIR}/_ext/1472/sensors.o.d ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o.d ${OBJECTDIR}/_ext/1472/handler_maximum_range.o.d ${OBJECTDIR}/_ext/1472/task_osd.o.d ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d ${OBJECTDIR}/_ext/1472/hil.o.d ${OBJECTDIR}/_ext/1472/benchmark.o.d ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d ${OBJECTDIR}/_ext/1472/magnetometer.o.d ${OBJECTDIR}/_ext/1472/gyro_temperature.o.d ${OBJECTDIR}/_ext/1472/sensor_health.o.d ${OBJECTDIR}/_ext/1472/handler_geofence.o.d ${OBJECTDIR}/_ext/1472/wind_estimator.o.d ${OBJECTDIR}/_ext/1472/dubins_path.o.d ${OBJECTDIR}/_ext/1472/handler_watch.o.d ${OBJECTDIR}/_ext/1472/gain_schedule.o.d ${OBJECTDIR}/_ext/1472/autotune.o.d ${OBJECTDIR}/_ext/1472/stack_monitor.o.d ${OBJECTDIR}/_ext/1472/jobs.o.d ${OBJECTDIR}/_ext/1472/geotag.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/_ext/1970174492/croutine.o ${OBJECTDIR}/_ext/1970174492/heap_1.o ${OBJECTDIR}/_ext/1970174492/list.o ${OBJECTDIR}/_ext/1970174492/port.o ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o ${OBJECTDIR}/_ext/1970174492/queue.o ${OBJECTDIR}/_ext/1970174492/tasks.o ${OBJECTDIR}/_ext/1970174492/timers.o ${OBJECTDIR}/_ext/957539446/adc.o ${OBJECTDIR}/_ext/1077768206/bmp085.o ${OBJECTDIR}/_ext/1070193764/button.o ${OBJECTDIR}/_ext/968823332/dataflash.o ${OBJECTDIR}/_ext/957545600/gps.o ${OBJECTDIR}/_ext/1967121974/hmc5843.o ${OBJECTDIR}/_ext/957545584/i2c.o ${OBJECTDIR}/_ext/957550049/led.o ${OBJECTDIR}/_ext/773745621/matrix.o ${OBJECTDIR}/_ext/1785572984/max7456.o ${OBJECTDIR}/_ext/1843177418/microcontroller.o ${OBJECTDIR}/_ext/957554017/pid.o ${OBJECTDIR}/_ext/674232159/ppm_in.o ${OBJECTDIR}/_ext/667767512/pwm_in.o ${OBJECTDIR}/_ext/888521352/quaternion.o ${OBJECTDIR}/_ext/1429652139/scp1000.o ${OBJECTDIR}/_ext/1089077615/servo.o ${OBJECTDIR}/_ext/1591518261/uart1_queue.o ${OBJECTDIR}/_ext/1090805370/uart2.o ${OBJECTDIR}/_ext/2082761406/mpu6000.o ${OBJECTDIR}/_ext/1843177418/getErrLoc.o ${OBJECTDIR}/_ext/1472/communication_csv.o ${OBJECTDIR}/_ext/1472/configuration.o ${OBJECTDIR}/_ext/1472/gluonscript.o ${OBJECTDIR}/_ext/1472/rtos_pilot.o ${OBJECTDIR}/_ext/1472/handler_alarms.o ${OBJECTDIR}/_ext/1472/handler_trigger.o ${OBJECTDIR}/_ext/1472/handler_navigation.o ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o ${OBJECTDIR}/_ext/1472/task_gps.o ${OBJECTDIR}/_ext/1472/task_datalogger.o ${OBJECTDIR}/_ext/1472/task_control.o ${OBJECTDIR}/_ext/1472/task_sensors_analog.o ${OBJECTDIR}/_ext/1472/sensors.o ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o ${OBJECTDIR}/_ext/1472/handler_maximum_range.o ${OBJECTDIR}/_ext/1472/task_osd.o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o
+OBJECTFILES=${OBJECTDIR}/_ext/1970174492/croutine.o ${OBJECTDIR}/_ext/1970174492/heap_1.o ${OBJECTDIR}/_ext/1970174492/list.o ${OBJECTDIR}/_ext/1970174492/port.o ${OBJECTDIR}/_ext/1970174492/portasm_dsPIC.o ${OBJECTDIR}/_ext/1970174492/queue.o ${OBJECTDIR}/_ext/1970174492/tasks.o ${OBJECTDIR}/_ext/1970174492/timers.o ${OBJECTDIR}/_ext/957539446/adc.o ${OBJECTDIR}/_ext/1077768206/bmp085.o ${OBJECTDIR}/_ext/1070193764/button.o ${OBJECTDIR}/_ext/968823332/dataflash.o ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o ${OBJECTDIR}/_ext/957545600/gps.o ${OBJECTDIR}/_ext/1967121974/hmc5843.o ${OBJECTDIR}/_ext/957545584/i2c.o ${OBJECTDIR}/_ext/957550049/led.o ${OBJECTDIR}/_ext/773745621/matrix.o ${OBJECTDIR}/_ext/1785572984/max7456.o ${OBJECTDIR}/_ext/1843177418/microcontroller.o ${OBJECTDIR}/_ext/957554017/pid.o ${OBJECTDIR}/_ext/674232159/ppm_in.o ${OBJECTDIR}/_ext/667767512/pwm_in.o ${OBJECTDIR}/_ext/888521352/quaternion.o ${OBJECTDIR}/_ext/118348622/fastmath.o ${OBJECTDIR}/_ext/1429652139/scp1000.o ${OBJECTDIR}/_ext/1089077615/servo.o ${OBJECTDIR}/_ext/1591518261/uart1_queue.o ${OBJECTDIR}/_ext/1090805370/uart2.o ${OBJECTDIR}/_ext/2082761406/mpu6000.o ${OBJECTDIR}/_ext/1843177418/getErrLoc.o ${OBJECTDIR}/_ext/1472/communication_csv.o ${OBJECTDIR}/_ext/1472/configuration.o ${OBJECTDIR}/_ext/1472/gluonscript.o ${OBJECTDIR}/_ext/1472/rtos_pilot.o ${OBJECTDIR}/_ext/1472/handler_alarms.o ${OBJECTDIR}/_ext/1472/handler_trigger.o ${OBJECTDIR}/_ext/1472/handler_navigation.o ${OBJECTDIR}/_ext/1472/handler_flightplan_switch.o ${OBJECTDIR}/_ext/1472/task_gps.o ${OBJECTDIR}/_ext/1472/task_datalogger.o ${OBJECTDIR}/_ext/1472/task_control.o ${OBJECTDIR}/_ext/1472/task_sensors_analog.o ${OBJECTDIR}/_ext/1472/sensors.o ${OBJECTDIR}/_ext/1472/task_sensors_mpu6000.o ${OBJECTDIR}/_ext/1472/handler_maximum_range.o ${OBJECTDIR}/_ext/1472/task_osd.o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o ${OBJECTDIR}/_ext/1472/hil.o ${OBJECTDIR}/_ext/1472/benchmark.o ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o ${OBJECTDIR}/_ext/1472/magnetometer.o ${OBJECTDIR}/_ext/1472/gyro_temperature.o ${OBJECTDIR}/_ext/1472/sensor_health.o ${OBJECTDIR}/_ext/1472/handler_geofence.o ${OBJECTDIR}/_ext/1472/wind_estimator.o ${OBJECTDIR}/_ext/1472/dubins_path.o ${OBJECTDIR}/_ext/1472/handler_watch.o ${OBJECTDIR}/_ext/1472/gain_schedule.o ${OBJECTDIR}/_ext/1472/autotune.o ${OBJECTDIR}/_ext/1472/stack_monitor.o ${OBJECTDIR}/_ext/1472/jobs.o ${OBJECTDIR}/_ext/1472/geotag.o
 
 
 CFLAGS=
@@ -135,6 +135,12 @@ ${OBJECTDIR}/_ext/968823332/dataflash.o: ../../lib/dataflash/dataflash.c  nbproj
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/dataflash/dataflash.c  -o ${OBJECTDIR}/_ext/968823332/dataflash.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/968823332/dataflash.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/968823332/dataflash.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/968823332/dataflash_ftl.o: ../../lib/dataflash/dataflash_ftl.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/968823332 
+	@${RM} ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/dataflash/dataflash_ftl.c  -o ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 ${OBJECTDIR}/_ext/957545600/gps.o: ../../lib/gps/gps.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/957545600 
 	@${RM} ${OBJECTDIR}/_ext/957545600/gps.o.d 
@@ -201,6 +207,12 @@ ${OBJECTDIR}/_ext/888521352/quaternion.o: ../../lib/quaternion/quaternion.c  nbp
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/quaternion/quaternion.c  -o ${OBJECTDIR}/_ext/888521352/quaternion.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/888521352/quaternion.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/888521352/quaternion.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/118348622/fastmath.o: ../../lib/fastmath/fastmath.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/118348622 
+	@${RM} ${OBJECTDIR}/_ext/118348622/fastmath.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/fastmath/fastmath.c  -o ${OBJECTDIR}/_ext/118348622/fastmath.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/118348622/fastmath.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/118348622/fastmath.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 ${OBJECTDIR}/_ext/1429652139/scp1000.o: ../../lib/scp1000/scp1000.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/1429652139 
 	@${RM} ${OBJECTDIR}/_ext/1429652139/scp1000.o.d 
@@ -333,6 +345,96 @@ ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o: ../ahrs_kalman_2x3.c  nbproject/Makefi
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../ahrs_kalman_2x3.c  -o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/1472/geotag.o: ../geotag.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/geotag.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../geotag.c  -o ${OBJECTDIR}/_ext/1472/geotag.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/geotag.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/geotag.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/jobs.o: ../jobs.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/jobs.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../jobs.c  -o ${OBJECTDIR}/_ext/1472/jobs.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/jobs.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/jobs.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/stack_monitor.o: ../stack_monitor.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/stack_monitor.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../stack_monitor.c  -o ${OBJECTDIR}/_ext/1472/stack_monitor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/stack_monitor.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/stack_monitor.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/autotune.o: ../autotune.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/autotune.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../autotune.c  -o ${OBJECTDIR}/_ext/1472/autotune.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/autotune.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/autotune.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/gain_schedule.o: ../gain_schedule.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/gain_schedule.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../gain_schedule.c  -o ${OBJECTDIR}/_ext/1472/gain_schedule.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/gain_schedule.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/gain_schedule.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/handler_watch.o: ../handler_watch.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/handler_watch.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../handler_watch.c  -o ${OBJECTDIR}/_ext/1472/handler_watch.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/handler_watch.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/handler_watch.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/dubins_path.o: ../dubins_path.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/dubins_path.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../dubins_path.c  -o ${OBJECTDIR}/_ext/1472/dubins_path.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/dubins_path.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/dubins_path.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/wind_estimator.o: ../wind_estimator.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/wind_estimator.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../wind_estimator.c  -o ${OBJECTDIR}/_ext/1472/wind_estimator.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/wind_estimator.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/wind_estimator.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/handler_geofence.o: ../handler_geofence.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/handler_geofence.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../handler_geofence.c  -o ${OBJECTDIR}/_ext/1472/handler_geofence.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/handler_geofence.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/handler_geofence.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/sensor_health.o: ../sensor_health.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/sensor_health.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../sensor_health.c  -o ${OBJECTDIR}/_ext/1472/sensor_health.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/sensor_health.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/sensor_health.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/gyro_temperature.o: ../gyro_temperature.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/gyro_temperature.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../gyro_temperature.c  -o ${OBJECTDIR}/_ext/1472/gyro_temperature.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/gyro_temperature.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/gyro_temperature.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/magnetometer.o: ../magnetometer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/magnetometer.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../magnetometer.c  -o ${OBJECTDIR}/_ext/1472/magnetometer.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/magnetometer.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/magnetometer.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/ahrs_quaternion.o: ../ahrs_quaternion.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../ahrs_quaternion.c  -o ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/benchmark.o: ../benchmark.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/benchmark.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../benchmark.c  -o ${OBJECTDIR}/_ext/1472/benchmark.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/benchmark.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/benchmark.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/hil.o: ../hil.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/hil.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../hil.c  -o ${OBJECTDIR}/_ext/1472/hil.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/hil.o.d"        -g -D__DEBUG   -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/hil.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 else
 ${OBJECTDIR}/_ext/1970174492/croutine.o: ../../lib/FreeRTOS/croutine.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/1970174492 
@@ -400,6 +502,12 @@ ${OBJECTDIR}/_ext/968823332/dataflash.o: ../../lib/dataflash/dataflash.c  nbproj
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/dataflash/dataflash.c  -o ${OBJECTDIR}/_ext/968823332/dataflash.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/968823332/dataflash.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/968823332/dataflash.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/968823332/dataflash_ftl.o: ../../lib/dataflash/dataflash_ftl.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/968823332 
+	@${RM} ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/dataflash/dataflash_ftl.c  -o ${OBJECTDIR}/_ext/968823332/dataflash_ftl.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/968823332/dataflash_ftl.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 ${OBJECTDIR}/_ext/957545600/gps.o: ../../lib/gps/gps.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/957545600 
 	@${RM} ${OBJECTDIR}/_ext/957545600/gps.o.d 
@@ -466,6 +574,12 @@ ${OBJECTDIR}/_ext/888521352/quaternion.o: ../../lib/quaternion/quaternion.c  nbp
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/quaternion/quaternion.c  -o ${OBJECTDIR}/_ext/888521352/quaternion.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/888521352/quaternion.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/888521352/quaternion.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/118348622/fastmath.o: ../../lib/fastmath/fastmath.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/118348622 
+	@${RM} ${OBJECTDIR}/_ext/118348622/fastmath.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../../lib/fastmath/fastmath.c  -o ${OBJECTDIR}/_ext/118348622/fastmath.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/118348622/fastmath.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/118348622/fastmath.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 ${OBJECTDIR}/_ext/1429652139/scp1000.o: ../../lib/scp1000/scp1000.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR}/_ext/1429652139 
 	@${RM} ${OBJECTDIR}/_ext/1429652139/scp1000.o.d 
@@ -598,6 +712,96 @@ ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o: ../ahrs_kalman_2x3.c  nbproject/Makefi
 	${MP_CC} $(MP_EXTRA_CC_PRE)  ../ahrs_kalman_2x3.c  -o ${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
 	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/ahrs_kalman_2x3.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/1472/geotag.o: ../geotag.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/geotag.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../geotag.c  -o ${OBJECTDIR}/_ext/1472/geotag.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/geotag.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/geotag.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/jobs.o: ../jobs.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/jobs.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../jobs.c  -o ${OBJECTDIR}/_ext/1472/jobs.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/jobs.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/jobs.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/stack_monitor.o: ../stack_monitor.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/stack_monitor.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../stack_monitor.c  -o ${OBJECTDIR}/_ext/1472/stack_monitor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/stack_monitor.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/stack_monitor.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/autotune.o: ../autotune.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/autotune.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../autotune.c  -o ${OBJECTDIR}/_ext/1472/autotune.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/autotune.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/autotune.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/gain_schedule.o: ../gain_schedule.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/gain_schedule.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../gain_schedule.c  -o ${OBJECTDIR}/_ext/1472/gain_schedule.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/gain_schedule.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/gain_schedule.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/handler_watch.o: ../handler_watch.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/handler_watch.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../handler_watch.c  -o ${OBJECTDIR}/_ext/1472/handler_watch.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/handler_watch.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/handler_watch.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/dubins_path.o: ../dubins_path.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/dubins_path.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../dubins_path.c  -o ${OBJECTDIR}/_ext/1472/dubins_path.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/dubins_path.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/dubins_path.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/wind_estimator.o: ../wind_estimator.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/wind_estimator.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../wind_estimator.c  -o ${OBJECTDIR}/_ext/1472/wind_estimator.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/wind_estimator.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/wind_estimator.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/handler_geofence.o: ../handler_geofence.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/handler_geofence.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../handler_geofence.c  -o ${OBJECTDIR}/_ext/1472/handler_geofence.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/handler_geofence.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/handler_geofence.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/sensor_health.o: ../sensor_health.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/sensor_health.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../sensor_health.c  -o ${OBJECTDIR}/_ext/1472/sensor_health.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/sensor_health.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/sensor_health.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/gyro_temperature.o: ../gyro_temperature.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/gyro_temperature.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../gyro_temperature.c  -o ${OBJECTDIR}/_ext/1472/gyro_temperature.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/gyro_temperature.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/gyro_temperature.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/magnetometer.o: ../magnetometer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/magnetometer.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../magnetometer.c  -o ${OBJECTDIR}/_ext/1472/magnetometer.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/magnetometer.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/magnetometer.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/ahrs_quaternion.o: ../ahrs_quaternion.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../ahrs_quaternion.c  -o ${OBJECTDIR}/_ext/1472/ahrs_quaternion.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/ahrs_quaternion.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/benchmark.o: ../benchmark.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/benchmark.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../benchmark.c  -o ${OBJECTDIR}/_ext/1472/benchmark.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/benchmark.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/benchmark.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
+${OBJECTDIR}/_ext/1472/hil.o: ../hil.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR}/_ext/1472 
+	@${RM} ${OBJECTDIR}/_ext/1472/hil.o.d 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  ../hil.c  -o ${OBJECTDIR}/_ext/1472/hil.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/hil.o.d"        -g -omf=elf -mlarge-code -mlarge-data -O1 -I"..\..\lib\FreeRTOS" -I"..\..\lib" -I"..\..\lib\button" -I"..\..\lib\adc" -I".." -I"..\..\lib\i2c" -I"..\..\lib\bmp085" -I"..\..\lib\hmc5843" -I"..\..\lib\max7456" -I"..\..\lib\matrix" -I"..\..\lib\quaternion" -I"..\..\lib\pid" -I"..\..\lib\pwm_in" -I"..\..\lib\led" -I"..\..\lib\ppm_in" -I"..\..\lib\uart2" -I"..\..\lib\uart1_queue" -I"..\..\lib\servo" -I"..\..\lib\scp1000" -I"..\..\lib\microcontroller" -I"..\..\lib\gps" -I"..\..\lib\dataflash" -DMPLAB_DSPIC_PORT -msmart-io=1 -Wall -msfr-warn=off
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/hil.o.d" $(SILENT)  -rsi ${MP_CC_DIR}../ 
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 #include "microcontroller/microcontroller.h"
 #include "uart1_queue/uart1_queue.h"
 #include "dataflash/dataflash.h"
+#include "dataflash/dataflash_ftl.h"
 #include "pwm_in/pwm_in.h"
 #include "ppm_in/ppm_in.h"
 #include "led/led.h"
@@ -42,6 +43,9 @@
 #include "gluonscript.h"
 #include "task_osd.h"
 #include "task_gps.h"
+#include "stack_monitor.h"
+#include "geotag.h"
+#include "jobs.h"
 
 #include "common.h"
 
@@ -52,7 +56,17 @@ static char version[] = "0.9 Beta 2";
 
 unsigned long idle_counter = 0;
 
+#ifdef ENABLE_COOPERATIVE_JOBS
+#ifdef RAW_50HZ_LOG
+#error "RAW_50HZ_LOG needs the datalogger task, the jobs run at most every JOBS_TICK_MS"
+#endif
+static struct Job telemetry_job = { "Telemetry", communication_telemetry_init, communication_telemetry_step, 100 };
+static struct Job datalogger_job = { "Dataflash", datalogger_job_init, datalogger_step, 250 };
+static struct Job osd_job = { "OSD", osd_init, osd_step, 200 };
+#endif
+
 void setup_trace_pins();
+static void start_task(pdTASK_CODE code, const char *name, unsigned int stack_size, unsigned portBASE_TYPE priority);
 
 int main()
 {
@@ -66,8 +80,8 @@ int main()
 	printf("Limited version");
 #endif
 	
-	printf(" [%s %s, config: %dB, logline: %dB, navigation: %dB, double: %dB]\r\n\r\n",
-                __DATE__, __TIME__, sizeof(struct Configuration), sizeof(struct LogLine), sizeof(gluonscript_data.codes), sizeof(double));
+	printf(" [%s %s, config: %dB, logline: %dB, navigation: %d lines, double: %dB]\r\n\r\n",
+                __DATE__, __TIME__, sizeof(struct Configuration), sizeof(struct LogLine), MAX_GLUONSCRIPTCODES, sizeof(double));
 	
 	microcontroller_reset_type();  // printf out reason of reset; for debugging
 	led_init();
@@ -90,9 +104,22 @@ int main()
 	// Open flash & load configuration
 	dataflash_open();
 	printf("%d MB flash found \r\n", (int)PAGE_SIZE/264);
+	dataflash_ftl_open();
+	if (dataflash_ftl_remapped_pages() > 0)
+		printf("%d bad flash pages remapped\r\n", dataflash_ftl_remapped_pages());
+	geotag_open();
 	//printf("Loading configuration...");
-	configuration_load();
+	switch (configuration_load())
+	{
+		case CONFIGURATION_DEFAULTS:
+			printf("Unknown configuration: defaults loaded, burn it again\r\n");
+			break;
+		case CONFIGURATION_CONVERTED:
+			printf("Configuration of an older firmware converted, burn it again\r\n");
+			break;
+	}
 	//printf("done\r\n");
+	stack_monitor_load();
 
 	
 	// Open RC receiver input: pwm_in/ppm_in task: in ppm_in/pwm_in.c
@@ -115,22 +142,30 @@ int main()
 	}	
 	
 
-	// Create our tasks. 
+	// Create our tasks. tools/memory_budget reads the stack sizes from here.
 	if (config.control.servo_mix == QUADROCOPTER)
-		xTaskCreate( control_copter_task,            ( signed portCHAR * ) "CControl",      ( configMINIMAL_STACK_SIZE * 3 ), NULL, tskIDLE_PRIORITY + 7, NULL );
+		start_task( control_copter_task,          "CControl",      ( configMINIMAL_STACK_SIZE * 3 ), tskIDLE_PRIORITY + 7 );
 	else
-		xTaskCreate( control_wing_task,            ( signed portCHAR * ) "WControl",      ( configMINIMAL_STACK_SIZE * 3 ), NULL, tskIDLE_PRIORITY + 7, NULL );
+		start_task( control_wing_task,            "WControl",      ( configMINIMAL_STACK_SIZE * 3 ), tskIDLE_PRIORITY + 7 );
 
     if (HARDWARE_VERSION == V01Q)
-    	xTaskCreate( sensors_mpu6000_task,                 ( signed portCHAR * ) "Sensors",      ( configMINIMAL_STACK_SIZE * 5 ), NULL, tskIDLE_PRIORITY + 6, NULL );
+    	start_task( sensors_mpu6000_task,         "Sensors",       ( configMINIMAL_STACK_SIZE * 5 ), tskIDLE_PRIORITY + 6 );
     else
-        xTaskCreate( sensors_analog_task,                 ( signed portCHAR * ) "Sensors",      ( configMINIMAL_STACK_SIZE * 5 ), NULL, tskIDLE_PRIORITY + 6, NULL );
-
-    xTaskCreate( sensors_gps_task,             ( signed portCHAR * ) "GpsNavi",      ( configMINIMAL_STACK_SIZE * 4 ), NULL, tskIDLE_PRIORITY + 5, NULL );
-	xTaskCreate( communication_input_task,     ( signed portCHAR * ) "ConsoleInput", ( configMINIMAL_STACK_SIZE * 5 ), NULL, tskIDLE_PRIORITY + 4, NULL );
-	xTaskCreate( datalogger_task,              ( signed portCHAR * ) "Dataflash",    ( configMINIMAL_STACK_SIZE * 3 ), NULL, tskIDLE_PRIORITY + 3, NULL );
-	xTaskCreate( communication_telemetry_task, ( signed portCHAR * ) "Telemetry",    ( configMINIMAL_STACK_SIZE * 2 ), NULL, tskIDLE_PRIORITY + 2, NULL );
-    xTaskCreate( osd_task,                     ( signed portCHAR * ) "OSD",          ( configMINIMAL_STACK_SIZE * 1 ), NULL, tskIDLE_PRIORITY + 1, NULL );
+        start_task( sensors_analog_task,          "Sensors",       ( configMINIMAL_STACK_SIZE * 5 ), tskIDLE_PRIORITY + 6 );
+
+    start_task( sensors_gps_task,             "GpsNavi",       ( configMINIMAL_STACK_SIZE * 4 ), tskIDLE_PRIORITY + 5 );
+	start_task( communication_input_task,     "ConsoleInput",  ( configMINIMAL_STACK_SIZE * 5 ), tskIDLE_PRIORITY + 4 );
+#ifdef ENABLE_COOPERATIVE_JOBS
+	// one stack instead of three: the jobs run in this order when due together
+	jobs_add(&telemetry_job);
+	jobs_add(&datalogger_job);
+	jobs_add(&osd_job);
+	start_task( jobs_task,                    "Jobs",          ( configMINIMAL_STACK_SIZE * 3 ), tskIDLE_PRIORITY + 3 );
+#else
+	start_task( datalogger_task,              "Dataflash",     ( configMINIMAL_STACK_SIZE * 3 ), tskIDLE_PRIORITY + 3 );
+	start_task( communication_telemetry_task, "Telemetry",     ( configMINIMAL_STACK_SIZE * 2 ), tskIDLE_PRIORITY + 2 );
+    start_task( osd_task,                     "OSD",           ( configMINIMAL_STACK_SIZE * 1 ), tskIDLE_PRIORITY + 1 );
+#endif
 
 #ifdef USE_TRACING
     printf("\r\nENABLING TRACING\r\n");
@@ -147,11 +182,24 @@ int main()
 }
 
 
+/*!
+ *   Creates a task and lets the stack monitor follow it.
+ */
+static void start_task(pdTASK_CODE code, const char *name, unsigned int stack_size, unsigned portBASE_TYPE priority)
+{
+	xTaskHandle task;
+
+	if (xTaskCreate( code, ( signed portCHAR * ) name, stack_size, NULL, priority, &task ) == pdPASS)
+		stack_monitor_register(task, name, stack_size);
+}
+
+
 void vApplicationStackOverflowHook( xTaskHandle *pxTask, signed portCHAR *pcTaskName )
 {
 	uart1_puts("\n\rStack overflow! ");
 	uart1_puts((char*)pcTaskName);
 	uart1_puts("\n\r");
+	stack_monitor_overflow((char*)pcTaskName);   // resets
 	while(1) ; 
 }
 
@@ -0,0 +1,168 @@
+/*!
+ *  Vibration, clipping and stuck sensor detection.
+ *
+ *  sensor_health_sample() runs at the sensor rate on the raw words, in integer
+ *  math only: every axis is high-pass filtered (raw minus a first order
+ *  low-pass) and the mean square of the result is tracked, and samples at the
+ *  end of the range are counted.
+ *  sensor_health_update() runs at 10Hz: it converts the mean squares to RMS
+ *  values, detects axes that stopped changing, and decides whether the
+ *  accelerometers can still be used to correct the attitude.
+ *
+ *  @file     sensor_health.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+#include "sensor_health.h"
+#include "sensors.h"
+
+#define LP_SHIFT 3                  //!< low-pass: 1/8 per sample
+#define MS_SHIFT 5                  //!< mean square: 1/32 per sample
+#define MAX_HP 4000                 //!< raw units, limits the square to a long
+#define CLIP_MARGIN 64              //!< raw units from 0 or 65535
+#define STUCK_UPDATES 20            //!< 2 seconds without a change
+#define ACC_VIBRATION_DISTRUST 400  //!< milli-g RMS
+#define ACC_VIBRATION_TRUST 300     //!< milli-g RMS, hysteresis
+
+struct SensorHealth sensor_health = { {0, 0, 0}, {0, 0, 0}, 0, 0, 0, 0, 1 };
+
+static long low_pass[6];            //!< Q4
+static long mean_square[6];
+static unsigned char clipped = 0;   //!< since the last update
+static unsigned char initialized = 0;
+
+static unsigned int last_raw[6];
+static unsigned char unchanged[6];
+
+static float acc_mg_per_raw, gyro_ddps_per_raw;
+
+
+/*!
+ *   Sets the scale of the raw words, for the RMS values in milli-g and 0.1 deg/s.
+ */
+void sensor_health_init(float acc_raw_per_g, float gyro_raw_per_dps)
+{
+	acc_mg_per_raw = 1000.0f / acc_raw_per_g;
+	gyro_ddps_per_raw = 10.0f / gyro_raw_per_dps;
+	initialized = 0;
+}
+
+
+/*!
+ *   Call after every read of the raw sensors.
+ */
+void sensor_health_sample()
+{
+	unsigned int raw[6];
+	int i;
+
+	raw[0] = sensor_data.acc_x_raw;
+	raw[1] = sensor_data.acc_y_raw;
+	raw[2] = sensor_data.acc_z_raw;
+	raw[3] = sensor_data.gyro_x_raw;
+	raw[4] = sensor_data.gyro_y_raw;
+	raw[5] = sensor_data.gyro_z_raw;
+
+	if (!initialized)
+	{
+		for (i = 0; i < 6; i++)
+		{
+			low_pass[i] = (long)raw[i] << 4;
+			mean_square[i] = 0;
+			last_raw[i] = raw[i];
+			unchanged[i] = 0;
+		}
+		initialized = 1;
+	}
+
+	for (i = 0; i < 6; i++)
+	{
+		long hp;
+
+		low_pass[i] += (((long)raw[i] << 4) - low_pass[i]) >> LP_SHIFT;
+		hp = (long)raw[i] - (low_pass[i] >> 4);
+		if (hp > MAX_HP)
+			hp = MAX_HP;
+		else if (hp < -MAX_HP)
+			hp = -MAX_HP;
+		mean_square[i] += (hp*hp - mean_square[i]) >> MS_SHIFT;
+
+		if (raw[i] < CLIP_MARGIN || raw[i] > 65535u - CLIP_MARGIN)
+		{
+			clipped |= 1 << i;
+			if (i < 3)
+			{
+				if (sensor_health.acc_clipped < 65535u)
+					sensor_health.acc_clipped++;
+			}
+			else if (sensor_health.gyro_clipped < 65535u)
+				sensor_health.gyro_clipped++;
+		}
+	}
+}
+
+
+/*!
+ *   Call at 10Hz.
+ */
+void sensor_health_update()
+{
+	unsigned int raw[6];
+	unsigned int acc_max = 0;
+	int i;
+
+	raw[0] = sensor_data.acc_x_raw;
+	raw[1] = sensor_data.acc_y_raw;
+	raw[2] = sensor_data.acc_z_raw;
+	raw[3] = sensor_data.gyro_x_raw;
+	raw[4] = sensor_data.gyro_y_raw;
+	raw[5] = sensor_data.gyro_z_raw;
+
+	for (i = 0; i < 3; i++)
+	{
+		sensor_health.acc_vibration[i] = (unsigned int)(sqrtf((float)mean_square[i]) * acc_mg_per_raw);
+		sensor_health.gyro_vibration[i] = (unsigned int)(sqrtf((float)mean_square[i+3]) * gyro_ddps_per_raw);
+		if (sensor_health.acc_vibration[i] > acc_max)
+			acc_max = sensor_health.acc_vibration[i];
+	}
+
+	for (i = 0; i < 6; i++)
+	{
+		if (raw[i] == last_raw[i])
+		{
+			if (unchanged[i] < STUCK_UPDATES)
+				unchanged[i]++;
+		}
+		else
+			unchanged[i] = 0;
+		last_raw[i] = raw[i];
+
+		if (unchanged[i] >= STUCK_UPDATES)
+			sensor_health.stuck |= 1 << i;
+		else
+			sensor_health.stuck &= ~(1 << i);
+	}
+
+	sensor_health.clipping = clipped != 0;
+
+	if (acc_max > ACC_VIBRATION_DISTRUST || (clipped & 0x07) || (sensor_health.stuck & 0x07))
+		sensor_health.acc_trusted = 0;
+	else if (acc_max < ACC_VIBRATION_TRUST)
+		sensor_health.acc_trusted = 1;
+
+	clipped = 0;
+}
+
+
+/*!
+ *   Returns the stuck axes, clipping and accelerometer distrust as SENSOR_HEALTH_* bits.
+ */
+unsigned char sensor_health_flags()
+{
+	return sensor_health.stuck |
+	       (sensor_health.clipping ? SENSOR_HEALTH_CLIPPING : 0) |
+	       (sensor_health.acc_trusted ? 0 : SENSOR_HEALTH_ACC_DISTRUST);
+}
@@ -0,0 +1,31 @@
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+#define SENSOR_HEALTH_STUCK_ACC_X  0x01
+#define SENSOR_HEALTH_STUCK_ACC_Y  0x02
+#define SENSOR_HEALTH_STUCK_ACC_Z  0x04
+#define SENSOR_HEALTH_STUCK_GYRO_X 0x08
+#define SENSOR_HEALTH_STUCK_GYRO_Y 0x10
+#define SENSOR_HEALTH_STUCK_GYRO_Z 0x20
+#define SENSOR_HEALTH_CLIPPING     0x40
+#define SENSOR_HEALTH_ACC_DISTRUST 0x80
+
+struct SensorHealth
+{
+	unsigned int acc_vibration[3];    // RMS of the high-pass filtered accelerometers, milli-g
+	unsigned int gyro_vibration[3];   // RMS of the high-pass filtered gyroscopes, 0.1 deg/s
+	unsigned int acc_clipped;         // samples at the end of the range since boot
+	unsigned int gyro_clipped;
+	unsigned char clipping;           // 1 when a sample clipped during the last 0.1s
+	unsigned char stuck;              // SENSOR_HEALTH_STUCK_* bits
+	unsigned char acc_trusted;        // 0 when vibration or clipping makes the accelerometers useless for the attitude
+};
+
+extern struct SensorHealth sensor_health;
+
+void sensor_health_init(float acc_raw_per_g, float gyro_raw_per_dps);
+void sensor_health_sample();
+void sensor_health_update();
+unsigned char sensor_health_flags();
+
+#endif // SENSOR_HEALTH_H
@@ -15,10 +15,14 @@ struct SensorData
 	unsigned int idg500_vref;
 	float acc_x, acc_y, acc_z;
 	float p, q, r;
+	float mag_x, mag_y, mag_z;  // calibrated magnetometer, 1.0 = local field strength
 	float roll, pitch, yaw;
 	float roll_acc, pitch_acc;
 	float vertical_speed; // estimated speed along z axis
 	float p_bias, q_bias;  // used in kalman filter
+	float r_bias;          // used in the quaternion filter
+	float gyro_x_neutral, gyro_y_neutral, gyro_z_neutral;  // at the current temperature, see gyro_temperature.c
+	float imu_temperature;
 
 	float pressure;
 	float temperature;
@@ -41,9 +45,19 @@ struct SensorConfig
 	float gyro_x_neutral;
 	float gyro_y_neutral;
 	float gyro_z_neutral;
+	float gyro_temperature[3][2];   // per axis: raw units per C and per C^2, relative to 25C
 
     enum BoardRotation imu_rotated;
     float neutral_pitch;
+
+    int magnetometer_enabled;
+    int magnetometer_offset_x;      // hard iron, raw units
+    int magnetometer_offset_y;
+    int magnetometer_offset_z;
+    float magnetometer_scale_x;     // soft iron, raw units to local field strength
+    float magnetometer_scale_y;
+    float magnetometer_scale_z;
+    float magnetic_declination;     // rad, added to the magnetic heading
 };
 
 extern struct SensorData sensor_data;
@@ -0,0 +1,203 @@
+/*!
+ *  Records the stack high-water mark of every task in the dataflash.
+ *
+ *  The stack sizes in rtos_pilot.c were picked from a measurement once.
+ *  Here the telemetry task samples uxTaskGetStackHighWaterMark every 10s and
+ *  keeps the least free stack of each task, and the least free heap, over all
+ *  flights in STACK_REPORT_PAGE. The page is only written when a new low is
+ *  found, at most once a minute. RK prints the report next to the current
+ *  values, RK;1 starts over.
+ *
+ *  A stack overflow (configCHECK_FOR_STACK_OVERFLOW) used to stop the pilot.
+ *  Now the name of the task is kept in RAM that survives a reset, the pilot
+ *  resets and counts the overflow in the report when it starts again.
+ *  tools/memory_budget gives the static side of the picture.
+ *
+ *  @file     stack_monitor.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+#include "FreeRTOS/semphr.h"
+
+#include "dataflash/dataflash.h"
+
+#include "stack_monitor.h"
+#include "common.h"
+
+#ifdef __XC16__
+	#define PERSISTENT __attribute__((persistent))   // not cleared by the startup code
+#else
+	#define PERSISTENT
+#endif
+
+#define STACK_REPORT_MAGIC 0x534B
+#define OVERFLOW_MAGIC 0x4F56
+#define WRITE_INTERVAL 6            //!< updates, once a minute
+
+struct StackReport stack_report;
+
+static xTaskHandle task_handle[STACK_MONITOR_TASKS];
+static int task_report[STACK_MONITOR_TASKS];   //!< index in stack_report.task
+static int tasks = 0;
+static int updates_since_write = WRITE_INTERVAL;
+static int dirty = 0;
+
+static PERSISTENT char overflow_name[configMAX_TASK_NAME_LEN];
+static PERSISTENT unsigned int overflow_check;
+
+extern xSemaphoreHandle xSpiSemaphore;
+
+static int stack_monitor_write();
+
+
+/*!
+ *   Reads the report from the dataflash, and adds the stack overflow that
+ *   caused the last reset. Called before the scheduler starts.
+ */
+void stack_monitor_load()
+{
+	dataflash.read(STACK_REPORT_PAGE, sizeof(stack_report), (unsigned char*)&stack_report);
+	if (stack_report.magic != STACK_REPORT_MAGIC || stack_report.tasks < 0 || stack_report.tasks > STACK_MONITOR_TASKS)
+	{
+		memset(&stack_report, 0, sizeof(stack_report));
+		stack_report.magic = STACK_REPORT_MAGIC;
+		stack_report.heap_free = 0xFFFF;
+	}
+
+	if (overflow_check == OVERFLOW_MAGIC)
+	{
+		overflow_check = 0;
+		stack_report.overflows++;
+		memcpy(stack_report.overflow_task, overflow_name, configMAX_TASK_NAME_LEN);
+		dataflash.write(STACK_REPORT_PAGE, sizeof(stack_report), (unsigned char*)&stack_report);
+		printf("Reset after a stack overflow in %.8s\r\n", overflow_name);
+	}
+}
+
+
+/*!
+ *   Adds a task, called right after xTaskCreate.
+ *   @param size The stack size given to xTaskCreate, in words
+ */
+void stack_monitor_register(xTaskHandle task, const char *name, unsigned int size)
+{
+	int r;
+
+	if (tasks >= STACK_MONITOR_TASKS)
+		return;
+
+	for (r = 0; r < stack_report.tasks; r++)
+		if (strncmp(stack_report.task[r].name, name, configMAX_TASK_NAME_LEN) == 0)
+			break;
+	if (r == STACK_MONITOR_TASKS)
+		return;
+	if (r == stack_report.tasks)
+	{
+		stack_report.tasks++;
+		strncpy(stack_report.task[r].name, name, configMAX_TASK_NAME_LEN);
+		stack_report.task[r].min_free = size;
+	}
+	if (stack_report.task[r].size != size)   // changed since the last build: start over
+		stack_report.task[r].min_free = size;
+	stack_report.task[r].size = size;
+
+	task_handle[tasks] = task;
+	task_report[tasks] = r;
+	tasks++;
+}
+
+
+/*!
+ *   Samples the high-water marks. Called every 10s by the telemetry task.
+ */
+void stack_monitor_update()
+{
+	unsigned int left;
+	int i;
+
+	for (i = 0; i < tasks; i++)
+	{
+		left = (unsigned int)uxTaskGetStackHighWaterMark(task_handle[i]);
+		if (left < stack_report.task[task_report[i]].min_free)
+		{
+			stack_report.task[task_report[i]].min_free = left;
+			dirty = 1;
+		}
+	}
+	left = (unsigned int)xPortGetFreeHeapSize();
+	if (left < stack_report.heap_free)
+	{
+		stack_report.heap_free = left;
+		dirty = 1;
+	}
+
+	if (updates_since_write < WRITE_INTERVAL)
+		updates_since_write++;
+	else if (dirty && stack_monitor_write())
+	{
+		dirty = 0;
+		updates_since_write = 0;
+	}
+}
+
+
+/*!
+ *   Forgets the worst cases recorded so far.
+ */
+void stack_monitor_clear()
+{
+	int r;
+
+	for (r = 0; r < stack_report.tasks; r++)
+		stack_report.task[r].min_free = stack_report.task[r].size;
+	stack_report.heap_free = 0xFFFF;
+	stack_report.overflows = 0;
+	memset(stack_report.overflow_task, 0, configMAX_TASK_NAME_LEN);
+	dirty = 1;
+	updates_since_write = WRITE_INTERVAL;
+}
+
+
+/*!
+ *   The current high-water mark of stack_report.task[r], in words. 0xFFFF
+ *   when the task doesn't run in this build (e.g. the copter control).
+ */
+unsigned int stack_monitor_free(int r)
+{
+	int i;
+
+	for (i = 0; i < tasks; i++)
+		if (task_report[i] == r)
+			return (unsigned int)uxTaskGetStackHighWaterMark(task_handle[i]);
+	return 0xFFFF;
+}
+
+
+/*!
+ *   Called by vApplicationStackOverflowHook: the stack of the task is
+ *   corrupt, keep its name and reset.
+ */
+void stack_monitor_overflow(const char *name)
+{
+	strncpy(overflow_name, name, configMAX_TASK_NAME_LEN);
+	overflow_check = OVERFLOW_MAGIC;
+#ifdef __XC16__
+	asm("reset");
+#endif
+}
+
+
+static int stack_monitor_write()
+{
+	if (xSemaphoreTake(xSpiSemaphore, (portTickType) 0) != pdTRUE)   // shared with the datalogger, try again later
+		return 0;
+	dataflash.write(STACK_REPORT_PAGE, sizeof(stack_report), (unsigned char*)&stack_report);
+	xSemaphoreGive(xSpiSemaphore);
+	return 1;
+}
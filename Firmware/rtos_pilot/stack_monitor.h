@@ -0,0 +1,40 @@
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include "FreeRTOS/FreeRTOS.h"
+#include "FreeRTOS/task.h"
+
+#define STACK_MONITOR_TASKS 8
+#define STACK_REPORT_PAGE 3        //!< between the configuration (0-2) and the log index (4)
+
+//! Stack of one task, in words
+struct StackUsage
+{
+	char name[configMAX_TASK_NAME_LEN];
+	unsigned int size;
+	unsigned int min_free;          //!< high-water mark: the least free stack ever seen
+};
+
+/*!
+ *   Worst case over all flights, kept in the dataflash.
+ */
+struct StackReport
+{
+	unsigned int magic;
+	int tasks;
+	struct StackUsage task[STACK_MONITOR_TASKS];
+	unsigned int heap_free;         //!< bytes of configTOTAL_HEAP_SIZE left after creating the tasks, least seen
+	unsigned int overflows;
+	char overflow_task[configMAX_TASK_NAME_LEN];   //!< last task that overflowed its stack
+};
+
+extern struct StackReport stack_report;
+
+void stack_monitor_load();
+void stack_monitor_register(xTaskHandle task, const char *name, unsigned int size);
+void stack_monitor_update();
+void stack_monitor_clear();
+unsigned int stack_monitor_free(int r);
+void stack_monitor_overflow(const char *name);
+
+#endif // STACK_MONITOR_H
@@ -37,6 +37,11 @@
 #include "configuration.h"
 #include "sensors.h"
 #include "handler_navigation.h"
+#include "handler_geofence.h"
+#include "handler_watch.h"
+#include "gain_schedule.h"
+#include "autotune.h"
+#include "hil.h"
 #include "common.h"
 
 void control_wing_manual();
@@ -110,6 +115,8 @@ void control_init()
 	
 	if (config.control.cruising_speed_ms < 0.5)  // not valid? change to 18 to avoid /0
 		config.control.cruising_speed_ms = 18.0;  
+
+	gain_schedule_init();
 }
 
 
@@ -148,8 +155,13 @@ void control_wing_task(void *parameters)
 	{
 		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 20 / portTICK_RATE_MS ) );   //!> 50Hz
 		
+		geofence_check();   // a few edges per call, the gluonscript handler acts on a breach
+		watch_check();
+
 		// Update RC link status
-		if (config.control.use_pwm)
+		if (hil.active)
+			hil_update_rc_status_50hz();
+		else if (config.control.use_pwm)
 		{
 			if (ppm.channel[config.control.channel_motor] < 900)  // We assume failsafe kicked in when motor channel < 930ms
 			{
@@ -218,6 +230,10 @@ void control_wing_task(void *parameters)
 			control_wing_manual(); // manual mode	
 		}
 		lastMode = control_state.flight_mode;
+		autotune_flight_mode(control_state.flight_mode);
+
+		if (hil.active)
+			hil_send_servos();
 	}
 }
 
@@ -386,15 +402,23 @@ void control_wing_desired_to_servos(float dt)
 	// compensate the loss in lift
 	//control_state.desired_pitch += (1.0/cosf(sensor_data.roll) - 1.0)*0.25; // (0.5: 12� up at 45� roll)
 	
-	elevator_out_radians = pid_update(&config.control.pid_pitch2elevator, 
+	// the gains are scheduled on the airspeed by the GPS task, see gain_schedule.c
+	elevator_out_radians = pid_update(&gain_schedule.pitch2elevator, 
 	                                         control_state.desired_pitch - sensor_data.pitch, dt);
-	aileron_out_radians = pid_update(&config.control.pid_roll2aileron, 
+	aileron_out_radians = pid_update(&gain_schedule.roll2aileron, 
 	                                        control_state.desired_roll - sensor_data.roll, dt);
 	yaw_out = ppm.channel[config.control.channel_yaw] - config.control.channel_neutral[config.control.channel_yaw];
 
+	// a relay replaces the pid of the axis being tuned
+	if (autotune.state == AUTOTUNE_RUNNING && control_state.flight_mode == STABILIZED)
+	{
+		if (autotune.axis == AUTOTUNE_ROLL)
+			aileron_out_radians = autotune_relay(control_state.desired_roll - sensor_data.roll, dt);
+		else
+			elevator_out_radians = autotune_relay(control_state.desired_pitch - sensor_data.pitch, dt);
+	}
 	
 	// Experimental: when flying with the wind, the elevons become less effective. Avoid have a too large roll angle!
-	// Fixme: gain scheduling depending on V_air
 	/*if (sensor_data.roll > config.control.max_roll)
 		aileron_out_radians *= 1.2;
 	if (sensor_data.roll < -config.control.max_roll)
@@ -447,9 +471,17 @@ void control_copter_task( void *parameters )
 	{
 		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 4 / portTICK_RATE_MS ) );    //!> 250Hz
 	
-		if (i++ == 5)
+		if (hil.active)
+		{
+			if (i++ % 5 == 0)
+				hil_update_rc_status_50hz();
+		}
+		else if (i++ == 5)
 			ppm_in_update_status_ticks_50hz();
 
+		if (i % 5 == 0)
+			watch_check();   // 50Hz
+
 		if (!ppm.connection_alive || ppm.channel[config.control.channel_ap] < 1300)
 		{
 			control_state.flight_mode = AUTOPILOT;
@@ -472,6 +504,9 @@ void control_copter_task( void *parameters )
 			
 		}
 		lastMode = control_state.flight_mode;
+
+		if (hil.active)
+			hil_send_servos();
 	}
 }
 
@@ -25,10 +25,12 @@
 
 #include "task_datalogger.h"
 #include "sensors.h"
+#include "sensor_health.h"
 #include "task_control.h"
 #include "gluonscript.h"
 #include "handler_navigation.h"
 #include "handler_trigger.h"
+#include "geotag.h"
 #include "common.h"
 
 
@@ -348,28 +350,15 @@ void datalogger_enable()
  */
 void datalogger_task( void *parameters )
 {
-	static struct LogLine l;
-	
 	/* Used to wake the task at the correct frequency. */
 	portTickType xLastExecutionTime; 
 
-	uart1_puts("Datalogger task initializing...");
-
     vTaskSetApplicationTaskTag( NULL, ( void * ) 5 );
-	datalogger_init();
-	
-	uart1_puts("done\r\n");
+	datalogger_job_init();
 	
 	/* Initialise xLastExecutionTime so the first call to vTaskDelayUntil()	works correctly. */
 	xLastExecutionTime = xTaskGetTickCount();
 	
-	// wait for GPS	(date & time!)
-	while(sensor_data.gps.status != ACTIVE)
-		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 1000 / portTICK_RATE_MS ) );   // 1Hz
-	
-	// ok, now we've got the current date and time, we can find an available page and write the index	
-	datalogger_start_session();
-	
 	for( ;; )
 	{	
 #ifndef RAW_50HZ_LOG
@@ -377,88 +366,132 @@ void datalogger_task( void *parameters )
 #else
 		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 20 / portTICK_RATE_MS ) );   // 50Hz
 #endif		
+		if (! datalogger_step())
+			vTaskDelete(NULL);
+	}
+}
 
-		if (! disable_logging)   // logging is disabled when the config tool reads out logging.
-		{
+
+/*!
+ *    Reads the logging index.
+ */
+int datalogger_job_init()
+{
+	uart1_puts("Datalogger task initializing...");
+	datalogger_init();
+	uart1_puts("done\r\n");
+	return 1;
+}
+
+
+/*!
+ *    Logs one line, by the datalogger task or as a job (see jobs.c).
+ *    Nothing is logged until the GPS gives the date and time: they are
+ *    needed for the index. The camera events are written first.
+ *    @return 0 when logging was disabled: the logging stops for good
+ */
+int datalogger_step()
+{
+	static struct LogLine l;
+	static int session_started = 0;
+
+	geotag_flush();
+
+	if (! session_started)
+	{
+		// wait for GPS	(date & time!)
+		if (sensor_data.gps.status != ACTIVE)
+			return 1;
+		// ok, now we've got the current date and time, we can find an available page and write the index	
+		datalogger_start_session();
+		session_started = 1;
+	}
+
+	gluonscript_prefetch();   // load the flightplan pages we'll need soon
+
+	if (! disable_logging)   // logging is disabled when the config tool reads out logging.
+	{
 #ifdef DETAILED_LOG
-			// Normal logging
-			l.temperature_c = (char)sensor_data.temperature; // -128C...+128C
-			l.height_m = (int)sensor_data.pressure_height;
-			l.gps_latitude_rad = sensor_data.gps.latitude_rad;
-			l.gps_longitude_rad = sensor_data.gps.longitude_rad;
-			l.gps_height_m = sensor_data.gps.height_m;
-			l.gps_heading = (int)(sensor_data.gps.heading_rad * (180.0/3.14159));
-			l.gps_speed_m_s = (int)(sensor_data.gps.speed_ms*100.0);
-			l.gps_satellites = (char)sensor_data.gps.satellites_in_view;
-			//l.acc_x = sensor_data.acc_x_raw;
-			//l.acc_y = sensor_data.acc_y_raw;
-			//l.acc_z = sensor_data.acc_z_raw;
-			l.acc_x_g = sensor_data.acc_x;
-			l.acc_y_g = sensor_data.acc_y;
-			l.acc_z_g = sensor_data.acc_z;
-
-			//l.gyro_x = sensor_data.gyro_x_raw;
-			//l.gyro_y = sensor_data.gyro_y_raw;
-			//l.gyro_z = sensor_data.gyro_z_raw;
-			l.p = (int)(sensor_data.p * (180.0/3.14159));
-			l.q = (int)(sensor_data.q * (180.0/3.14159));
-			l.r = (int)(sensor_data.r * (180.0/3.14159));
-			l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
-			l.roll = (int)(sensor_data.roll * (180.0/3.14159));
-			l.desired_pitch = (int)(control_state.desired_pitch * (180.0/3.14159));
-			l.desired_roll = (int)(control_state.desired_roll * (180.0/3.14159));
-			//l.pitch_acc = (int)(sensor_data.pitch_acc * (180.0/3.14159));
-			//l.roll_acc = (int)(sensor_data.roll_acc * (180.0/3.14159));
-			l.control_state = control_state.flight_mode;
-			l.desired_heading = ((int)(navigation_data.desired_heading_rad * 180.0/3.14159));
-			l.navigation_code_line = gluonscript_data.current_codeline;
-			l.desired_height = control_state.desired_altitude;
+		// Normal logging
+		l.temperature_c = (char)sensor_data.temperature; // -128C...+128C
+		l.height_m = (int)sensor_data.pressure_height;
+		l.gps_latitude_rad = sensor_data.gps.latitude_rad;
+		l.gps_longitude_rad = sensor_data.gps.longitude_rad;
+		l.gps_height_m = sensor_data.gps.height_m;
+		l.gps_heading = (int)(sensor_data.gps.heading_rad * (180.0/3.14159));
+		l.gps_speed_m_s = (int)(sensor_data.gps.speed_ms*100.0);
+		l.gps_satellites = (char)sensor_data.gps.satellites_in_view;
+		//l.acc_x = sensor_data.acc_x_raw;
+		//l.acc_y = sensor_data.acc_y_raw;
+		//l.acc_z = sensor_data.acc_z_raw;
+		l.acc_x_g = sensor_data.acc_x;
+		l.acc_y_g = sensor_data.acc_y;
+		l.acc_z_g = sensor_data.acc_z;
+
+		//l.gyro_x = sensor_data.gyro_x_raw;
+		//l.gyro_y = sensor_data.gyro_y_raw;
+		//l.gyro_z = sensor_data.gyro_z_raw;
+		l.p = (int)(sensor_data.p * (180.0/3.14159));
+		l.q = (int)(sensor_data.q * (180.0/3.14159));
+		l.r = (int)(sensor_data.r * (180.0/3.14159));
+		l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
+		l.roll = (int)(sensor_data.roll * (180.0/3.14159));
+		l.desired_pitch = (int)(control_state.desired_pitch * (180.0/3.14159));
+		l.desired_roll = (int)(control_state.desired_roll * (180.0/3.14159));
+		//l.pitch_acc = (int)(sensor_data.pitch_acc * (180.0/3.14159));
+		//l.roll_acc = (int)(sensor_data.roll_acc * (180.0/3.14159));
+		l.control_state = control_state.flight_mode;
+		l.desired_heading = ((int)(navigation_data.desired_heading_rad * 180.0/3.14159));
+		l.navigation_code_line = gluonscript_context.current_codeline;
+		l.desired_height = control_state.desired_altitude;
 #elif RAW_50HZ_LOG
-			// Raw sensor logging at 50Hz
-			l.height_m_5 = (int)(sensor_data.pressure_height*5);
-			l.gps_latitude_rad = sensor_data.gps.latitude_rad;
-			l.gps_longitude_rad = sensor_data.gps.longitude_rad;
-			l.gps_heading_2 = (unsigned char)(sensor_data.gps.heading_rad * (180.0/3.14159) / 2.0);
-			l.gps_speed_m_s_10 = (unsigned char)(sensor_data.gps.speed_ms * 10.0);
-			l.gps_time = sensor_data.gps.time;
-			l.acc_x = sensor_data.acc_x_raw;
-			l.acc_y = sensor_data.acc_y_raw;
-			l.acc_z = sensor_data.acc_z_raw;
-			l.gyro_x = sensor_data.gyro_x_raw;
-			l.gyro_y = sensor_data.gyro_y_raw;
-			l.gyro_z = sensor_data.gyro_z_raw;
-			//l.idg500_vref = sensor_data.idg500_vref;
-			l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
-			l.pitch_acc = (int)(sensor_data.pitch_acc * (180.0/3.14159));
-			l.roll = (int)(sensor_data.roll * (180.0/3.14159));
-			//l.control_state = control_state.flight_mode;
+		// Raw sensor logging at 50Hz
+		l.height_m_5 = (int)(sensor_data.pressure_height*5);
+		l.gps_latitude_rad = sensor_data.gps.latitude_rad;
+		l.gps_longitude_rad = sensor_data.gps.longitude_rad;
+		l.gps_heading_2 = (unsigned char)(sensor_data.gps.heading_rad * (180.0/3.14159) / 2.0);
+		l.gps_speed_m_s_10 = (unsigned char)(sensor_data.gps.speed_ms * 10.0);
+		l.gps_time = sensor_data.gps.time;
+		l.acc_x = sensor_data.acc_x_raw;
+		l.acc_y = sensor_data.acc_y_raw;
+		l.acc_z = sensor_data.acc_z_raw;
+		l.gyro_x = sensor_data.gyro_x_raw;
+		l.gyro_y = sensor_data.gyro_y_raw;
+		l.gyro_z = sensor_data.gyro_z_raw;
+		//l.idg500_vref = sensor_data.idg500_vref;
+		l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
+		l.pitch_acc = (int)(sensor_data.pitch_acc * (180.0/3.14159));
+		l.roll = (int)(sensor_data.roll * (180.0/3.14159));
+		//l.control_state = control_state.flight_mode;
 
 #else
-            // Simple logging
-			l.temperature_c = (char)sensor_data.temperature; // -128C...+128C
-			l.height_m = (int)sensor_data.pressure_height;
-			l.gps_latitude_rad = sensor_data.gps.latitude_rad;
-			l.gps_longitude_rad = sensor_data.gps.longitude_rad;
-			l.gps_height_m = sensor_data.gps.height_m;
-			l.gps_heading = (int)(sensor_data.gps.heading_rad * (180.0/3.14159));
-			l.gps_speed_m_s = (unsigned char)(sensor_data.gps.speed_ms*3.0);
-
-			l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
-			l.roll = (int)(sensor_data.roll * (180.0/3.14159));
-            l.yaw = (int)(sensor_data.yaw * (180.0/3.14159));
-			l.control_state = control_state.flight_mode;
-			l.navigation_code_line = gluonscript_data.current_codeline;
-            l.date = sensor_data.gps.date;
-            l.time = sensor_data.gps.time;
-            l.servo_trigger = trigger.trigger_counter;
+        // Simple logging
+		l.temperature_c = (char)sensor_data.temperature; // -128C...+128C
+		l.height_m = (int)sensor_data.pressure_height;
+		l.gps_latitude_rad = sensor_data.gps.latitude_rad;
+		l.gps_longitude_rad = sensor_data.gps.longitude_rad;
+		l.gps_height_m = sensor_data.gps.height_m;
+		l.gps_heading = (int)(sensor_data.gps.heading_rad * (180.0/3.14159));
+		l.gps_speed_m_s = (unsigned char)(sensor_data.gps.speed_ms*3.0);
+
+		l.pitch = (int)(sensor_data.pitch * (180.0/3.14159));
+		l.roll = (int)(sensor_data.roll * (180.0/3.14159));
+        l.yaw = (int)(sensor_data.yaw * (180.0/3.14159));
+		l.control_state = control_state.flight_mode;
+		l.navigation_code_line = gluonscript_context.current_codeline;
+        l.date = sensor_data.gps.date;
+        l.time = sensor_data.gps.time;
+        l.servo_trigger = trigger.trigger_counter;
+        l.acc_vibration_100 = (unsigned char)MIN(255, MAX(MAX(sensor_health.acc_vibration[0], sensor_health.acc_vibration[1]), sensor_health.acc_vibration[2]) / 10);
+        l.sensor_health = sensor_health_flags();
 #endif
-			datalogger_writeline(&l);
+		datalogger_writeline(&l);
 
-		}
-        else // logging disabled:
-        {
-            printf("\r\nLogging task stopped\r\n");
-            vTaskDelete(NULL);
-        }
 	}
+    else // logging disabled:
+    {
+        printf("\r\nLogging task stopped\r\n");
+        return 0;
+    }
+	return 1;
 }
@@ -99,7 +99,9 @@ struct LogLine
 	char temperature_c;         // 1
 	int  height_m;              // 2
 	int  navigation_code_line;  // 2 
-    unsigned int servo_trigger; // 2 = 44
+    unsigned int servo_trigger; // 2
+    unsigned char acc_vibration_100;  // 1: highest accelerometer vibration RMS, 0.01g
+    unsigned char sensor_health;      // 1 = 46: SENSOR_HEALTH_* flags
 };
 
 #endif
@@ -109,6 +111,8 @@ struct LogLine
 void datalogger_init();
 void datalogger_writeline(struct LogLine *line);
 void datalogger_task( void *parameters );
+int datalogger_job_init();
+int datalogger_step();
 void datalogger_format();
 int datalogger_print_next_page(int index, void(*printer)(struct LogLine*));
 int datalogger_print_next_page_of_all(int index, void(*printer)(struct LogLine*));
@@ -10,11 +10,15 @@
 #include "uart1_queue/uart1_queue.h"
 #include "task_gps.h"
 #include "led/led.h"
+#include "microcontroller/microcontroller.h"
 
 #include "configuration.h"
 #include "common.h"
 #include "gluonscript.h"
 #include "handler_navigation.h"
+#include "hil.h"
+#include "geotag.h"
+#include "handler_watch.h"
 
 
 /*!
@@ -35,6 +39,7 @@ xSemaphoreHandle xGpsSemaphore = NULL;
 void sensors_gps_task( void *parameters )
 {
 	int i = 0;
+	int new_fix;
 
 #ifdef F1E_STEERING
 	/*while(1)
@@ -52,6 +57,8 @@ void sensors_gps_task( void *parameters )
 	sensor_data.gps.longitude_rad = 0.0;
 
 	gluonscript_init();
+	if (microcontroller_after_reboot() && gluonscript_resume())
+		uart1_puts("Flightplan resumed after a reset\r\n");
 
 	gps_open_port(&(config.gps));
 
@@ -77,6 +84,7 @@ void sensors_gps_task( void *parameters )
 	//portTickType xLastExecutionTime = xTaskGetTickCount();
 	for( ;; )
 	{
+		new_fix = 0;
 		/* Wait until it is time for the next cycle. */
 		if (control_state.simulation_mode)
 		{
@@ -84,10 +92,22 @@ void sensors_gps_task( void *parameters )
 			vTaskDelay(( ( portTickType ) 100 / portTICK_RATE_MS ) );
 			sensor_data.gps.satellites_in_view = 9;
 			sensor_data.gps.status = ACTIVE;
+			new_fix = 1;
 		}
 		else if( xSemaphoreTake( xGpsSemaphore, ( portTickType ) 205 / portTICK_RATE_MS ) == pdTRUE )
 		{
-			gps_update_info(&(sensor_data.gps)); // 5Hz (needed?)
+			if (watch_pending() >= 0)
+			{
+				// woken by a watcher: its target line runs now. A sentence that came in
+				// at the same time is read at the next one, i keeps the RMC/GGA phase
+				gluonscript_do();
+				continue;
+			}
+			if (hil.active)
+				new_fix = hil_update_gps(&(sensor_data.gps));
+			else
+				new_fix = gps_update_info(&(sensor_data.gps)); // 5Hz (needed?)
+			new_fix = new_fix && sensor_data.gps.status == ACTIVE;
 			i++;
 		}
 		else
@@ -105,6 +125,8 @@ void sensors_gps_task( void *parameters )
 		if (sensor_data.gps.satellites_in_view < 4 && navigation_data.airborne)
 				sensor_data.gps.speed_ms = config.control.cruising_speed_ms;
 
+		geotag_update(new_fix);   // before the triggers of gluonscript
+
 		if (i % 2 == 0) // this is used for both RMC and GGA, so only update every other tick
 			gluonscript_do();
 
@@ -14,12 +14,15 @@
 #include "adc/adc.h"
 #include "uart1_queue/uart1_queue.h"
 #include "ppm_in/ppm_in.h"
+#include "fastmath/fastmath.h"
 
 #include "common.h"
 #include "task_osd.h"
 #include "configuration.h"
 #include "sensors.h"
+#include "sensor_health.h"
 #include "handler_navigation.h"
+#include "wind_estimator.h"
 
 extern xSemaphoreHandle xSpiSemaphore;
 
@@ -63,12 +66,41 @@ void print_meters(int row, int col, int m, int small);
 
 void osd_print_home_info();
 void osd_print_satellites_in_view(int small);
+/*!
+ *   Posts a warning when a sensor is stuck, clipping or vibrating too much.
+ *   Repeated every 10 seconds while the problem lasts.
+ */
+void osd_print_sensor_health()
+{
+    static unsigned char last_flags = 0;
+    static int repeat = 0;
+    unsigned char flags = sensor_health_flags();
+
+    if (repeat > 0)
+        repeat--;
+
+    if (flags != 0 && (flags != last_flags || repeat == 0))
+    {
+        if (flags & (SENSOR_HEALTH_STUCK_ACC_X | SENSOR_HEALTH_STUCK_ACC_Y | SENSOR_HEALTH_STUCK_ACC_Z |
+                     SENSOR_HEALTH_STUCK_GYRO_X | SENSOR_HEALTH_STUCK_GYRO_Y | SENSOR_HEALTH_STUCK_GYRO_Z))
+            osd_post_message("Sensor stuck", 1);
+        else if (flags & SENSOR_HEALTH_CLIPPING)
+            osd_post_message("Sensor clipping", 1);
+        else
+            osd_post_message("Vibration", 1);
+        repeat = 50;   // 10s at 5Hz
+    }
+    last_flags = flags;
+}
+
 void osd_print_vario(int small);
+void osd_print_sensor_health();
 void osd_print_posted_message(int small);
 void osd_print_centered(int row, char *str, int small);
 void osd_print_altitude(int small);
 void osd_print_rcinfo(int small);
 void osd_print_speed(int small);
+void osd_print_wind(int small);
 void osd_print_fly_time(int small);
 void osd_print_voltage1(int small);
 void osd_print_current1(int small);
@@ -103,14 +135,36 @@ void osd_task( void *parameters )
 {
 	/* Used to wake the task at the correct frequency. */
 	portTickType xLastExecutionTime; 
-	int i;
 	
+	vTaskSetApplicationTaskTag( NULL, ( void * ) 7 );
+	if (osd_init() == 0)
+		vTaskDelete(xTaskGetCurrentTaskHandle());
+	
+	/* Initialise xLastExecutionTime so the first call to vTaskDelayUntil()	works correctly. */
+	xLastExecutionTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 200 / portTICK_RATE_MS ) );   // 5Hz
+		osd_step();
+	}
+}
+
+
+/*!
+ *   Finds the MAX7456 and shows the splash screen.
+ *   @return 0 when there is no OSD
+ */
+int osd_init()
+{
+	portTickType xLastExecutionTime; 
+	int i;
 	
 	uart1_puts("OSD task initializing...\r\n");
-	vTaskSetApplicationTaskTag( NULL, ( void * ) 7 );
+	xLastExecutionTime = xTaskGetTickCount();
 #ifndef USE_TRACING
 	if (osd_initialize(& xLastExecutionTime) == 0)
-		vTaskDelete(xTaskGetCurrentTaskHandle());
+		return 0;
 #endif
 	uart1_puts("OSD initialized\r\n");
 	
@@ -123,9 +177,7 @@ void osd_task( void *parameters )
 	}
 	
 	
-	/* Initialise xLastExecutionTime so the first call to vTaskDelayUntil()	works correctly. */
-	xLastExecutionTime = xTaskGetTickCount();
-	vTaskDelay( ( ( portTickType )100 / portTICK_RATE_MS ) );   // 5Hz
+	vTaskDelay( ( ( portTickType )100 / portTICK_RATE_MS ) );
 	
     spiWriteReg(0x04, 0x04); // clear
 
@@ -149,45 +201,51 @@ void osd_task( void *parameters )
 
     spiWriteReg(0x04, 0x04); // clear
     //osd_print_static_data();
+	return 1;
+}
 
-	for( ;; )
-	{
-		vTaskDelayUntil( &xLastExecutionTime, ( ( portTickType ) 200 / portTICK_RATE_MS ) );   // 5Hz
 
-        if (xSemaphoreTake( xSpiSemaphore, ( portTickType ) 0 ) == pdTRUE )  // only execute this when SPI port is available
+/*!
+ *   Redraws the screen, at 5Hz: by the OSD task or as a job (see jobs.c).
+ */
+int osd_step()
+{
+	int i;
+
+    if (xSemaphoreTake( xSpiSemaphore, ( portTickType ) 0 ) == pdTRUE )  // only execute this when SPI port is available
+    {
+        //vTaskDelay( ( ( portTickType ) 1 / portTICK_RATE_MS ) );   // 5Hz
+        
+        if (do_clear_screen)
         {
-            //vTaskDelay( ( ( portTickType ) 1 / portTICK_RATE_MS ) );   // 5Hz
-            
-            if (do_clear_screen)
-            {
-                spiWriteReg(0x04, 0x04);
-                do_clear_screen = 0;
-            }
+            spiWriteReg(0x04, 0x04);
+            do_clear_screen = 0;
+        }
 
-            osd_set_position(1, 10);
-            osd_write_ascii_char(' ', 0);
+        osd_set_position(1, 10);
+        osd_write_ascii_char(' ', 0);
 
-            osd_print_posted_message(1);
+        osd_print_posted_message(1);
 
-            for (i = 0; i < 30; i++)
-            {
-                osd_set_position(2, i);
-                osd_write_char(0x70);
-                osd_set_position(13, i);
-                osd_write_char(0x9C);
-            }
+        for (i = 0; i < 30; i++)
+        {
+            osd_set_position(2, i);
+            osd_write_char(0x70);
+            osd_set_position(13, i);
+            osd_write_char(0x9C);
+        }
 
-            if (active_menu == BLOCKS)
-                osd_menu_blocks();
-            else
-                osd_menu_osd();
+        if (active_menu == BLOCKS)
+            osd_menu_blocks();
+        else
+            osd_menu_osd();
 
-            last_roll_ppm = ppm.channel[config.control.channel_roll];
-            
-            xSemaphoreGive( xSpiSemaphore );
-        } else
-            printf("\r\nSPI OSD not available\r\n");
-	}
+        last_roll_ppm = ppm.channel[config.control.channel_roll];
+        
+        xSemaphoreGive( xSpiSemaphore );
+    } else
+        printf("\r\nSPI OSD not available\r\n");
+	return 1;
 }
 
 void osd_menu_osd()
@@ -218,7 +276,10 @@ void osd_menu_osd()
     if (config.osd.show_rc_link)
         osd_print_rcinfo(0);
     if (config.osd.show_speed)
+    {
         osd_print_speed(0);
+        osd_print_wind(0);
+    }
     if (config.osd.show_flight_time)
         osd_print_fly_time(0);
     if (config.osd.show_voltage1)
@@ -234,13 +295,14 @@ void osd_menu_osd()
         osd_print_active_block(1);
     if (config.osd.show_vario)
         osd_print_vario(0);
+
+    osd_print_sensor_health();
 }
 
 void osd_menu_blocks()
 {
     static int selected_blocknum = 0, max_block = 0, last_ppm;
     int blocknum = 0, i;
-    char ptr[9];
 
     if (ppm.channel[config.control.channel_roll] > 1750 && last_roll_ppm < 1700)  // select mode
     {
@@ -253,21 +315,13 @@ void osd_menu_blocks()
         }
         else
             {
-            for (i = 0; i < MAX_GLUONSCRIPTCODES; i++)
+            if (selected_blocknum <= gluonscript_data.blocks)
             {
-                if (gluonscript_data.codes[i].opcode == BLOCK)
-                {
-                    selected_blocknum--;
-                    if (selected_blocknum == 0)
-                    {
-                        printf("\r\nOSD: new block selected\r\n");
-                        gluonscript_data.current_codeline = i;
-                        active_menu = OSD;
-                        do_clear_screen = 1;
-                        selected_blocknum = 0;
-                        break;//return;
-                    }
-                }
+                printf("\r\nOSD: new block selected\r\n");
+                gluonscript_context.current_codeline = gluonscript_data.block[selected_blocknum - 1].line;
+                active_menu = OSD;
+                do_clear_screen = 1;
+                selected_blocknum = 0;
             }
         }
     }
@@ -301,31 +355,16 @@ void osd_menu_blocks()
         osd_write_ascii_char('>', 0);
     }
     
-    for (i = 0; i < MAX_GLUONSCRIPTCODES; i++)
+    for (i = 0; i < gluonscript_data.blocks; i++)
     {
-        if (gluonscript_data.codes[i].opcode == BLOCK)
+        blocknum++;
+        osd_print_centered(blocknum + 5, (char*)gluonscript_data.block[i].name, 0);
+        if (blocknum == selected_blocknum)
         {
-            blocknum++;
-            struct GluonscriptCode *current_code = &(gluonscript_data.codes[i]);
-            int x = (int)current_code->x;
-            int y = (int)current_code->y;
-            ptr[0] = ((char*)(& current_code->a))[1];
-            ptr[1] = ((char*)(& current_code->a))[0];
-            ptr[2] = ((char*)(& current_code->b))[1];
-            ptr[3] = ((char*)(& current_code->b))[0];
-            ptr[4] = ((char*)(& x))[1];
-            ptr[5] = ((char*)(& x))[0];
-            ptr[6] = ((char*)(& y))[1];
-            ptr[7] = ((char*)(& y))[0];
-            ptr[8] = '\0';
-            osd_print_centered(blocknum + 5, ptr, 0);
-            if (blocknum == selected_blocknum)
-            {
-                osd_set_position(blocknum + 5, 8);
-                osd_write_ascii_char('>', 0);
-            }
-            max_block = blocknum;
+            osd_set_position(blocknum + 5, 8);
+            osd_write_ascii_char('>', 0);
         }
+        max_block = blocknum;
     }
 
 }
@@ -418,28 +457,17 @@ void osd_print_active_block(int small)
 {
     if (show_block_timer == 0)
     {
-        int i;
+        int i, b;
 
-        for (i = gluonscript_data.current_codeline; i > 0; i--)
+        // the last block before the current line
+        for (b = gluonscript_data.blocks - 1; b >= 0; b--)
         {
-            if (gluonscript_data.codes[i].opcode == BLOCK)
+            if (gluonscript_data.block[b].line <= gluonscript_context.current_codeline)
             {
-                struct GluonscriptCode *current_code = & gluonscript_data.codes[i];
-                if (active_block != i)
+                if (active_block != gluonscript_data.block[b].line)
                 {
-                    active_block = i;
-                    char ptr[9];
-                    int x = (int)current_code->x;
-                    int y = (int)current_code->y;
-                    ptr[0] = ((char*)(& current_code->a))[1];
-                    ptr[1] = ((char*)(& current_code->a))[0];
-                    ptr[2] = ((char*)(& current_code->b))[1];
-                    ptr[3] = ((char*)(& current_code->b))[0];
-                    ptr[4] = ((char*)(& x))[1];
-                    ptr[5] = ((char*)(& x))[0];
-                    ptr[6] = ((char*)(& y))[1];
-                    ptr[7] = ((char*)(& y))[0];
-                    ptr[8] = '\0';
+                    volatile char *ptr = gluonscript_data.block[b].name;
+                    active_block = gluonscript_data.block[b].line;
 
                     for (i = 0; i < 8 && ptr[i] != 0 && ptr[i] != ' '; i++)
                         enteringblock[i+9] = ptr[i];
@@ -688,6 +716,54 @@ void osd_print_speed(int small)
     }
 }
 
+/*!
+ *   Arrow in the direction the wind blows, relative to the nose, and the wind speed.
+ *   Empty as long as the wind estimate isn't reliable.
+ */
+void osd_print_wind(int small)
+{
+    static int symbol_mapping[] = {0xA8, 0xA6, 0xA4, 0xA2, 0xA0, 0xAE, 0xAC, 0xAA };
+    int i, wind_deg, speed;
+
+    if (wind_estimate.confidence < WIND_CONFIDENT)
+    {
+        for (i = 2; i < 8; i++)
+        {
+            osd_set_position(8, i);
+            osd_write_char(0x00);
+        }
+        return;
+    }
+
+    wind_deg = (int) RAD2DEG(wind_estimate.from_rad + PI - wind_nose_heading_rad());
+    while (wind_deg < 0)
+        wind_deg += 360;
+    while (wind_deg >= 360)
+        wind_deg -= 360;
+    i = (wind_deg + 22) / 45;
+    osd_set_position(8, 2);
+    osd_write_char(symbol_mapping[i % 8]);
+    osd_set_position(8, 3);
+    osd_write_char(symbol_mapping[i % 8] + 1);
+
+    if (use_metric)  // to kph
+        speed = (int) (wind_estimate.speed_ms * 3.6);
+    else  // to mph
+        speed = (int) (wind_estimate.speed_ms * (3.6 * 0.62));
+    osd_print_integer(speed, 8, 4, small);
+    osd_write_char(use_metric ? 0x65 : 0x66);
+    if (speed < 10)
+    {
+        osd_set_position (8, 6);
+        osd_write_char(0x00);
+    }
+    if (speed < 100)
+    {
+        osd_set_position (8, 7);
+        osd_write_char(0x00);
+    }
+}
+
 void osd_print_fly_time(int small)
 {
     const unsigned char* number;
@@ -756,7 +832,7 @@ void osd_print_home_heading()
     // Pre-calculate some data used for OSD
 	int home_heading_deg = (int) RAD2DEG(navigation_heading_rad_fromto(sensor_data.gps.longitude_rad - navigation_data.home_longitude_rad,
 	                                                         sensor_data.gps.latitude_rad - navigation_data.home_latitude_rad)
-	                           - sensor_data.gps.heading_rad);
+	                           - wind_nose_heading_rad());   // relative to the nose (camera), not the course
 	if (home_heading_deg < 0)
 		home_heading_deg += 360;
 	else if (home_heading_deg > 360)
@@ -887,6 +963,22 @@ float gravity_to_pitch2(float a_x, float a_z)
 }
 
 #define AH_LINE_START 4
+#define AH_MIN_COS_ROLL 0.01f        //!< tan(roll) stays below 100, the lines are off the screen long before
+
+/*!
+ *   tan(roll) for the horizon lines, cos(roll) is kept away from 0 at +-90 degrees.
+ */
+static float horizon_tan_roll()
+{
+	float c = fast_cos(sensor_data.roll);
+
+	if (c >= 0.0f && c < AH_MIN_COS_ROLL)
+		c = AH_MIN_COS_ROLL;
+	else if (c < 0.0f && c > -AH_MIN_COS_ROLL)
+		c = -AH_MIN_COS_ROLL;
+	return fast_sin(sensor_data.roll) / c;
+}
+
 void osd_print_artificial_horizon2()
 {
     static int previous_positions[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
@@ -902,7 +994,7 @@ void osd_print_artificial_horizon2()
     int pitch_increment = (int)(sensor_data.pitch*(180.0/3.14/FOV_V*18.0)) + 3;
 
     //double FOV_H =
-    float tanroll = tanf(sensor_data.roll);
+    float tanroll = horizon_tan_roll();
     for (i = -7; i < 8; i++) // -0.7..0.7 -> -18..18
     {
         if (i == 0)
@@ -935,22 +1027,22 @@ void osd_print_artificial_horizon()
 
 	int pitch_increment = (int)(sensor_data.pitch*(180.0/3.14/22.0*7.0));   // > 22 = out of screen
 	// hor: 7..14..21    ver: 3.3 .. 7.1 (15 stappen) -> 1..8..15
-	//// optimize me: precalculated tanf
-	int y7 = 8 - (int)(tanf(sensor_data.roll)*-10.8) + pitch_increment;
-	int y8 = 8 - (int)(tanf(sensor_data.roll)*-9.26) + pitch_increment;
-	int y9 = 8 - (int)(tanf(sensor_data.roll)*-7.71) + pitch_increment;
-	int y10 = 8 - (int)(tanf(sensor_data.roll)*-6.17) + pitch_increment;
-	int y11 = 8 - (int)(tanf(sensor_data.roll)*-4.63) + pitch_increment;
-	int y12 = 8 - (int)(tanf(sensor_data.roll)*-3.09) + pitch_increment;
-	int y13 = 8 - (int)(tanf(sensor_data.roll)*-1.54) + pitch_increment;
+	float tanroll = horizon_tan_roll();
+	int y7 = 8 - (int)(tanroll*-10.8) + pitch_increment;
+	int y8 = 8 - (int)(tanroll*-9.26) + pitch_increment;
+	int y9 = 8 - (int)(tanroll*-7.71) + pitch_increment;
+	int y10 = 8 - (int)(tanroll*-6.17) + pitch_increment;
+	int y11 = 8 - (int)(tanroll*-4.63) + pitch_increment;
+	int y12 = 8 - (int)(tanroll*-3.09) + pitch_increment;
+	int y13 = 8 - (int)(tanroll*-1.54) + pitch_increment;
 	int y14 = 8 + pitch_increment;
-	int y15 = 8 - (int)(tanf(sensor_data.roll)*1.54) + pitch_increment;
-	int y16 = 8 - (int)(tanf(sensor_data.roll)*3.09) + pitch_increment;
-	int y17 = 8 - (int)(tanf(sensor_data.roll)*4.63) + pitch_increment;
-	int y18 = 8 - (int)(tanf(sensor_data.roll)*6.17) + pitch_increment;
-	int y19 = 8 - (int)(tanf(sensor_data.roll)*7.71) + pitch_increment;
-	int y20 = 8 - (int)(tanf(sensor_data.roll)*9.26) + pitch_increment;
-	int y21 = 8 - (int)(tanf(sensor_data.roll)*10.8) + pitch_increment;
+	int y15 = 8 - (int)(tanroll*1.54) + pitch_increment;
+	int y16 = 8 - (int)(tanroll*3.09) + pitch_increment;
+	int y17 = 8 - (int)(tanroll*4.63) + pitch_increment;
+	int y18 = 8 - (int)(tanroll*6.17) + pitch_increment;
+	int y19 = 8 - (int)(tanroll*7.71) + pitch_increment;
+	int y20 = 8 - (int)(tanroll*9.26) + pitch_increment;
+	int y21 = 8 - (int)(tanroll*10.8) + pitch_increment;
 	
 	if ((y7) < 16 && y7 >= 0) {
         previous_positions[0] = y7/3;
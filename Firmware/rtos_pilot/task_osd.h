@@ -27,6 +27,8 @@ struct OsdConfig
 };
 
 void osd_task( void *parameters );
+int osd_init();
+int osd_step();
 void osd_post_message (char *str, int blink);
 void osd_clear();
 
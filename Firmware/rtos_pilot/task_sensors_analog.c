@@ -43,6 +43,10 @@
 #include "ahrs.h"
 #include "common.h"
 #include "gluonscript.h"
+#include "hil.h"
+#include "magnetometer.h"
+#include "gyro_temperature.h"
+#include "sensor_health.h"
 
 #define INVERT_X -1.0   // set to -1 if front becomes back
 
@@ -54,7 +58,6 @@ extern xSemaphoreHandle xSpiSemaphore;
 void read_raw_sensor_data();
 void scale_raw_sensor_data();
 void bmp085_do_10Hz();
-unsigned int squared(unsigned int a, unsigned int b, unsigned int c);
 
 float scale_z_gyro = 0.0f;
 
@@ -72,9 +75,6 @@ void sensors_analog_task( void *parameters )
 	float last_height = 0.0f;
 	float dt_since_last_height = 0.0f;
 	unsigned int low_update_counter = 0;
-
-    unsigned int mean_gyro_x, mean_gyro_y, mean_gyro_z;
-    unsigned long var_gyros, var_gyros_temp = 0;
 		
 	/* Used to wake the task at the correct frequency. */
 	portTickType xLastExecutionTime; 
@@ -82,11 +82,12 @@ void sensors_analog_task( void *parameters )
     vTaskSetApplicationTaskTag( NULL, ( void * ) 2 );
 
 	uart1_puts("Sensors task initializing...");
-#if ENABLE_QUADROCOPTER || F1E_STEERING
-	i2c_init();
-	vTaskDelay(( portTickType ) 20 / portTICK_RATE_MS );
-	hmc5843_init();
-#endif
+	if (config.sensors.magnetometer_enabled)
+	{
+		i2c_init();
+		vTaskDelay(( portTickType ) 20 / portTICK_RATE_MS );
+		magnetometer_init();
+	}
 	adc_open();	
 
 	if (HARDWARE_VERSION >= V01O)
@@ -97,17 +98,15 @@ void sensors_analog_task( void *parameters )
 	else
 		scp1000_init();
 
+	gyro_temperature_apply(GYRO_TEMPERATURE_REFERENCE);
 	read_raw_sensor_data();
 	scale_raw_sensor_data();
 	vTaskDelay( ( ( portTickType ) 20 / portTICK_RATE_MS ) );
 	read_raw_sensor_data();
 	scale_raw_sensor_data();
 	ahrs_init();
+	sensor_health_init(acc_value_g, 1.0f / 0.02518315f);
 
-     mean_gyro_x = sensor_data.gyro_x_raw;
-     mean_gyro_y = sensor_data.gyro_y_raw;
-     mean_gyro_z = sensor_data.gyro_z_raw;
-	
 	if (HARDWARE_VERSION >= V01N) // IDZ-500 gyroscope
 		scale_z_gyro = (-0.02538315f*3.14159f/180.0f)*2.0f;
 	else // ADXRS-613 gyroscope
@@ -133,7 +132,13 @@ void sensors_analog_task( void *parameters )
 #endif
 		if (low_update_counter > 65000)
 			low_update_counter = 0;
-		read_raw_sensor_data();
+		if (hil.active)
+			hil_read_raw_imu();
+		else
+		{
+			read_raw_sensor_data();
+			sensor_health_sample();
+		}
 				
 		adc_start();  // restart ADC sampling to make sure we have our samples on the next loop iteration.
 
@@ -141,20 +146,6 @@ void sensors_analog_task( void *parameters )
 		
 		if (low_update_counter % 25 == 0) // 10Hz
 		{
-            // detects when the module is not moving.
-            mean_gyro_x = (mean_gyro_x >> 1) + (sensor_data.gyro_x_raw >> 1);
-            mean_gyro_y = (mean_gyro_y >> 1) + (sensor_data.gyro_y_raw >> 1);
-            mean_gyro_z = (mean_gyro_z >> 1) + (sensor_data.gyro_z_raw >> 1);
-            var_gyros_temp = var_gyros_temp - (var_gyros_temp >> 2) +
-                        squared((unsigned int)(mean_gyro_x - sensor_data.gyro_x_raw),
-                                (unsigned int)(mean_gyro_y - sensor_data.gyro_y_raw),
-                                (unsigned int)(mean_gyro_z - sensor_data.gyro_z_raw) );
-            var_gyros = var_gyros_temp >> 2;
-            //if (var_gyros <= 10)
-            //    printf("\r\n still \r\n");
-            //else if (low_update_counter % 300 == 0)
-            //    printf("\r\n%lu [%u %u] [%u %u] [%u %u]\r\n", var_gyros, (unsigned int)(mean_gyro_x - sensor_data.gyro_x_raw), sensor_data.gyro_x_raw,mean_gyro_y, sensor_data.gyro_y_raw,mean_gyro_z, sensor_data.gyro_z_raw);
-
 			if (control_state.simulation_mode)
             {
                 uart1_puts("\r\nSimulation mode: disabling sensors task!\r\n");
@@ -162,14 +153,25 @@ void sensors_analog_task( void *parameters )
             }
 				
 			sensor_data.battery1_voltage_10 = ((float)adc_get_channel(8) * (3.3f * 5.1f / 6550.0f));
-			if (HARDWARE_VERSION >= V01O)
+			if (hil.active)
+			{
+				hil_read_baro();
+			}
+			else if (HARDWARE_VERSION >= V01O)
 			{
 				bmp085_do_10Hz();
 			}
+
+			// the IDG500 has no temperature sensor, the barometer is close enough (0 until its first reading)
+			sensor_data.imu_temperature = sensor_data.temperature;
+			if (!hil.active && sensor_data.imu_temperature != 0.0f)
+				gyro_temperature_learn(sensor_data.gyro_x_raw, sensor_data.gyro_y_raw, sensor_data.gyro_z_raw, sensor_data.imu_temperature);
+			if (!hil.active)
+				sensor_health_update();
 		}	
 		else
 		{
-			if (HARDWARE_VERSION < V01O && scp1000_dataready())   // New reading from the pressure sensor -> calculate vertical speed
+			if (HARDWARE_VERSION < V01O && !hil.active && scp1000_dataready())   // New reading from the pressure sensor -> calculate vertical speed
 			{
 				// this should be at 9Hz ->0.11s
 				if (xSemaphoreTake( xSpiSemaphore, ( portTickType ) 0 ))  // Spi1 is shared with SCP1000 and Dataflash
@@ -195,12 +197,9 @@ void sensors_analog_task( void *parameters )
 
 
 		// x = (Pitch; Roll)'
-#if (ENABLE_QUADROCOPTER || F1E_STEERING)
-		if (low_update_counter % 25 == 0)
-		{
-			hmc5843_read(&sensor_data.magnetometer_raw); 
-		}
-#endif
+		if (config.sensors.magnetometer_enabled && low_update_counter % 15 == 0)  // ~16Hz, finishes during ahrs_filter
+			magnetometer_read();
+		i2c_watchdog();
 
 #ifdef ENABLE_QUADROCOPTER
 		ahrs_filter(0.005f);	
@@ -210,64 +209,19 @@ void sensors_analog_task( void *parameters )
 	}
 }
 
-unsigned int squared(unsigned int a, unsigned int b, unsigned int c)
-{
-    unsigned long i;
-    if (a > 60000)
-        a = !a;
-    if (b > 60000)
-        b = !b;
-    if (c > 60000)
-        c = !c;
-
-    if (a > 200)
-        return 60000;
-    if (b > 200)
-        return 60000;
-    if (c > 200)
-        return 60000;
-
-    i = (unsigned long)(a*a) + (unsigned long)(b*b) + (unsigned long)(c*c);
-    if (i > 65000)
-        return 65000;
-    else
-        return (unsigned int)i;
-}
-
-
+/*!
+ *   Non-blocking: the BMP085 registers are read by the I2C interrupt while
+ *   the AHRS runs, the results are converted on the next call.
+ */
 void bmp085_do_10Hz()
 {
-	static int state = 0;
-	long tmp;
+	long pressure;
 
-	switch (state)
+	if (bmp085_update(&sensor_data.temperature_10, &pressure))
 	{
-		case 0:
-			bmp085_start_convert_temp();
-			state = 1;
-			break;
-		case 1:
-		{
-			tmp = bmp085_read_temp();
-			bmp085_convert_temp(tmp, &sensor_data.temperature_10);
-			sensor_data.temperature = (float)sensor_data.temperature_10 / 10.0f;
-		}
-			bmp085_start_convert_pressure();
-			state = 2;
-			break;
-		case 2:
-            {
-                long pressure;
-                tmp = bmp085_read_pressure();
-                bmp085_convert_pressure(tmp, &pressure);
-
-                sensor_data.pressure = (float)pressure;
-            }
-            sensor_data.pressure_height = scp1000_pressure_to_height(sensor_data.pressure, sensor_data.temperature);
-
-            bmp085_start_convert_temp();
-            state = 1;
-            break;
+		sensor_data.temperature = (float)sensor_data.temperature_10 / 10.0f;
+		sensor_data.pressure = (float)pressure;
+		sensor_data.pressure_height = scp1000_pressure_to_height(sensor_data.pressure, sensor_data.temperature);
 	}
 }
 
@@ -293,9 +247,9 @@ void scale_raw_sensor_data()
 	sensor_data.acc_z = ((float)(sensor_data.acc_z_raw) - (float)config.sensors.acc_z_neutral) / (-acc_value_g);
 			
 	// scale to rad/sec
-	sensor_data.p = ((float)(sensor_data.gyro_x_raw)-config.sensors.gyro_x_neutral) * (-0.02518315f*3.14159f/180.0f * INVERT_X);  // 0.02518315f
-	sensor_data.q = ((float)(sensor_data.gyro_y_raw)-config.sensors.gyro_y_neutral) * (-0.02538315f*3.14159f/180.0f * INVERT_X);
-	sensor_data.r = ((float)(sensor_data.gyro_z_raw)-config.sensors.gyro_z_neutral) * scale_z_gyro;
+	sensor_data.p = ((float)(sensor_data.gyro_x_raw)-sensor_data.gyro_x_neutral) * (-0.02518315f*3.14159f/180.0f * INVERT_X);  // 0.02518315f
+	sensor_data.q = ((float)(sensor_data.gyro_y_raw)-sensor_data.gyro_y_neutral) * (-0.02538315f*3.14159f/180.0f * INVERT_X);
+	sensor_data.r = ((float)(sensor_data.gyro_z_raw)-sensor_data.gyro_z_neutral) * scale_z_gyro;
 }	
 
 
@@ -33,11 +33,16 @@
 #include "ahrs.h"
 #include "common.h"
 #include "gluonscript.h"
+#include "hil.h"
+#include "magnetometer.h"
+#include "gyro_temperature.h"
+#include "sensor_health.h"
 
 #define INVERT_X -1.0   // set to -1 if front becomes back
 
 
 void read_mpu6000_sensor_data();
+void read_mpu6000_raw_sensor_data();
 void bmp085_do_10Hz_2();
 
 
@@ -60,15 +65,14 @@ void sensors_mpu6000_task( void *parameters )
     vTaskSetApplicationTaskTag( NULL, ( void * ) 2 );
 
 	uart1_puts("Sensors task initializing...");
-#if ENABLE_QUADROCOPTER || F1E_STEERING
 	i2c_init();
-	vTaskDelay(( portTickType ) 20 / portTICK_RATE_MS );
-	hmc5843_init();
-    uart1_puts("magnetometer...");
-    test_HMC5843();
-#else
-    i2c_init();
-#endif
+	if (config.sensors.magnetometer_enabled)
+	{
+		vTaskDelay(( portTickType ) 20 / portTICK_RATE_MS );
+		magnetometer_init();
+		uart1_puts("magnetometer...");
+		test_HMC5843();
+	}
     
 	adc_open();
 
@@ -81,15 +85,19 @@ void sensors_mpu6000_task( void *parameters )
 
     bmp085_init();
 
+	gyro_temperature_apply(GYRO_TEMPERATURE_REFERENCE);
 	read_mpu6000_sensor_data();
 
     vTaskDelay( ( ( portTickType ) 100 / portTICK_RATE_MS ) );   // 1ms
 
     mpu6000_init();
 
+    read_mpu6000_sensor_data();
+    gyro_temperature_apply(sensor_data.imu_temperature);
     read_mpu6000_sensor_data();
 
 	ahrs_init();
+	sensor_health_init(4096.0f, 32.8f);
 
 	uart1_puts("done\r\n");
 
@@ -112,6 +120,8 @@ void sensors_mpu6000_task( void *parameters )
 		adc_start();  // restart ADC sampling to make sure we have our samples on the next loop iteration.
 
 		read_mpu6000_sensor_data();
+		if (!hil.active)
+			sensor_health_sample();
 
 		if (low_update_counter % 25 == 0) // 2Hz
 		{
@@ -129,17 +139,21 @@ void sensors_mpu6000_task( void *parameters )
             //printf("\r\n%u %u %u %u %u\r\n",
             //        adc_get_channel(7), adc_get_channel(8), adc_get_channel(9),
             //        adc_get_channel(10), adc_get_channel(11));
-			bmp085_do_10Hz_2();
+			if (hil.active)
+				hil_read_baro();
+			else
+			{
+				bmp085_do_10Hz_2();
+				gyro_temperature_learn(sensor_data.gyro_x_raw, sensor_data.gyro_y_raw, sensor_data.gyro_z_raw, sensor_data.imu_temperature);
+				sensor_health_update();
+			}
             sensor_data.vertical_speed = sensor_data.vertical_speed * 0.9f + (sensor_data.pressure_height - last_height)/0.5 * 0.1f; // too much noise otherwise
             last_height = sensor_data.pressure_height;
 		}
 
-#if (ENABLE_QUADROCOPTER || F1E_STEERING)
-		if (low_update_counter % 25 == 0)
-		{
-			hmc5843_read(&sensor_data.magnetometer_raw);
-		}
-#endif
+		if (config.sensors.magnetometer_enabled && low_update_counter % 15 == 0)  // ~16Hz, finishes during ahrs_filter
+			magnetometer_read();
+		i2c_watchdog();
 
 #ifdef ENABLE_QUADROCOPTER
 		ahrs_filter(0.004f);
@@ -150,76 +164,28 @@ void sensors_mpu6000_task( void *parameters )
 }
 
 
+/*!
+ *   Non-blocking: the BMP085 registers are read by the I2C interrupt while
+ *   the AHRS runs, the results are converted on the next call.
+ */
 void bmp085_do_10Hz_2()
 {
-	static int state = 0;
-	long tmp;
+	long pressure;
 
-	switch (state)
+	if (bmp085_update(&sensor_data.temperature_10, &pressure))
 	{
-		case 0:
-			bmp085_start_convert_temp();
-			state = 1;
-			break;
-		case 1:
-		{
-			tmp = bmp085_read_temp();
-			bmp085_convert_temp(tmp, &sensor_data.temperature_10);
-			sensor_data.temperature = (float)sensor_data.temperature_10 / 10.0f;
-		}
-			bmp085_start_convert_pressure();
-			state = 2;
-			break;
-		case 2:
-            {
-                long pressure;
-                tmp = bmp085_read_pressure();
-                bmp085_convert_pressure(tmp, &pressure);
-
-                sensor_data.pressure = (float)pressure;
-            }
-            sensor_data.pressure_height = scp1000_pressure_to_height(sensor_data.pressure, sensor_data.temperature);
-
-            bmp085_start_convert_temp();
-            state = 1;
-            break;
+		sensor_data.temperature = (float)sensor_data.temperature_10 / 10.0f;
+		sensor_data.pressure = (float)pressure;
+		sensor_data.pressure_height = scp1000_pressure_to_height(sensor_data.pressure, sensor_data.temperature);
 	}
 }
 
 void read_mpu6000_sensor_data()
 {
-    mpu6000_update_sensor_readings();
-
-    if (mpu6000_raw_sensor_readings.acc_x < 0)
-        sensor_data.acc_x_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_x;
-    else
-        sensor_data.acc_x_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_x;
-
-    if (mpu6000_raw_sensor_readings.acc_y < 0)
-        sensor_data.acc_y_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_y;
-    else
-        sensor_data.acc_y_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_y;
-
-    if (mpu6000_raw_sensor_readings.acc_z < 0)
-        sensor_data.acc_z_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_z;
-    else
-        sensor_data.acc_z_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_z;
-
-    if (mpu6000_raw_sensor_readings.gyro_x < 0)
-        sensor_data.gyro_x_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_x;
-    else
-        sensor_data.gyro_x_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_x;
-
-    if (mpu6000_raw_sensor_readings.gyro_y < 0)
-        sensor_data.gyro_y_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_y;
-    else
-        sensor_data.gyro_y_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_y;
-
-    if (mpu6000_raw_sensor_readings.gyro_z < 0)
-        sensor_data.gyro_z_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_z;
+    if (hil.active)
+        hil_read_raw_imu();   // the simulator sends the same raw words
     else
-        sensor_data.gyro_z_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_z;
-
+        read_mpu6000_raw_sensor_data();
     
     if (config.sensors.imu_rotated == 1)  // 90 CCW
     {
@@ -227,9 +193,9 @@ void read_mpu6000_sensor_data()
         sensor_data.acc_x = ((float)sensor_data.acc_y_raw - (float)config.sensors.acc_y_neutral) / 4096.0;
         sensor_data.acc_z = ((float)config.sensors.acc_z_neutral - (float)sensor_data.acc_z_raw) / 4096.0;
 
-        sensor_data.q = -((float)config.sensors.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
-        sensor_data.p = ((float)sensor_data.gyro_y_raw - (float)config.sensors.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.r = ((float)config.sensors.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.q = -((float)sensor_data.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.p = ((float)sensor_data.gyro_y_raw - (float)sensor_data.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.r = ((float)sensor_data.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
     }
     else if (config.sensors.imu_rotated == 3)  // 270 CCW
     {
@@ -237,9 +203,9 @@ void read_mpu6000_sensor_data()
         sensor_data.acc_x = -((float)sensor_data.acc_y_raw - (float)config.sensors.acc_y_neutral) / 4096.0;
         sensor_data.acc_z = ((float)config.sensors.acc_z_neutral - (float)sensor_data.acc_z_raw) / 4096.0;
 
-        sensor_data.q = ((float)config.sensors.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
-        sensor_data.p = -((float)sensor_data.gyro_y_raw - (float)config.sensors.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.r = ((float)config.sensors.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.q = ((float)sensor_data.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.p = -((float)sensor_data.gyro_y_raw - (float)sensor_data.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.r = ((float)sensor_data.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
     }
     else if (config.sensors.imu_rotated == 2)  // 180
     {
@@ -247,9 +213,9 @@ void read_mpu6000_sensor_data()
         sensor_data.acc_y = ((float)config.sensors.acc_y_neutral - (float)sensor_data.acc_y_raw) / 4096.0;
         sensor_data.acc_z = ((float)config.sensors.acc_z_neutral - (float)sensor_data.acc_z_raw) / 4096.0;
 
-        sensor_data.p = ((float)sensor_data.gyro_x_raw - (float)config.sensors.gyro_x_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.q = ((float)config.sensors.gyro_y_neutral - (float)sensor_data.gyro_y_raw) * (3.14159 / 180.0 / 32.8);
-        sensor_data.r = ((float)config.sensors.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.p = ((float)sensor_data.gyro_x_raw - (float)sensor_data.gyro_x_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.q = ((float)sensor_data.gyro_y_neutral - (float)sensor_data.gyro_y_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.r = ((float)sensor_data.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
     }
     else if (config.sensors.imu_rotated == 0)
     {
@@ -257,9 +223,9 @@ void read_mpu6000_sensor_data()
         sensor_data.acc_y = ((float)sensor_data.acc_y_raw - (float)config.sensors.acc_y_neutral) / 4096.0;
         sensor_data.acc_z = ((float)config.sensors.acc_z_neutral - (float)sensor_data.acc_z_raw) / 4096.0;
 
-        sensor_data.p = ((float)config.sensors.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
-        sensor_data.q = ((float)sensor_data.gyro_y_raw - (float)config.sensors.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.r = ((float)config.sensors.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.p = ((float)sensor_data.gyro_x_neutral - (float)sensor_data.gyro_x_raw) * (3.14159 / 180.0 / 32.8);
+        sensor_data.q = ((float)sensor_data.gyro_y_raw - (float)sensor_data.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.r = ((float)sensor_data.gyro_z_neutral - (float)sensor_data.gyro_z_raw) * (3.14159 / 180.0 / 32.8);
     }
     else if (config.sensors.imu_rotated == 4)  // sideways with top on the left
     {
@@ -267,9 +233,49 @@ void read_mpu6000_sensor_data()
         sensor_data.acc_z = ((float)sensor_data.acc_y_raw - (float)config.sensors.acc_y_neutral) / 4096.0;
         sensor_data.acc_y = ((float)config.sensors.acc_z_neutral - (float)sensor_data.acc_z_raw) / 4096.0;
 
-        sensor_data.p = ((float)sensor_data.gyro_x_raw - (float)config.sensors.gyro_x_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.r = ((float)sensor_data.gyro_y_raw - (float)config.sensors.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
-        sensor_data.q = ((float)sensor_data.gyro_z_raw - (float)config.sensors.gyro_z_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.p = ((float)sensor_data.gyro_x_raw - (float)sensor_data.gyro_x_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.r = ((float)sensor_data.gyro_y_raw - (float)sensor_data.gyro_y_neutral) * (3.14159 / 180.0 / 32.8);
+        sensor_data.q = ((float)sensor_data.gyro_z_raw - (float)sensor_data.gyro_z_neutral) * (3.14159 / 180.0 / 32.8);
     }
 }
 
+
+/*!
+ *   Reads the MPU-6000 and stores the readings as unsigned raw words in sensor_data.
+ */
+void read_mpu6000_raw_sensor_data()
+{
+    mpu6000_update_sensor_readings();
+
+    if (mpu6000_raw_sensor_readings.acc_x < 0)
+        sensor_data.acc_x_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_x;
+    else
+        sensor_data.acc_x_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_x;
+
+    if (mpu6000_raw_sensor_readings.acc_y < 0)
+        sensor_data.acc_y_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_y;
+    else
+        sensor_data.acc_y_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_y;
+
+    if (mpu6000_raw_sensor_readings.acc_z < 0)
+        sensor_data.acc_z_raw = 32768 + (long)mpu6000_raw_sensor_readings.acc_z;
+    else
+        sensor_data.acc_z_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.acc_z;
+
+    if (mpu6000_raw_sensor_readings.gyro_x < 0)
+        sensor_data.gyro_x_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_x;
+    else
+        sensor_data.gyro_x_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_x;
+
+    if (mpu6000_raw_sensor_readings.gyro_y < 0)
+        sensor_data.gyro_y_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_y;
+    else
+        sensor_data.gyro_y_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_y;
+
+    if (mpu6000_raw_sensor_readings.gyro_z < 0)
+        sensor_data.gyro_z_raw = 32768 + (long)mpu6000_raw_sensor_readings.gyro_z;
+    else
+        sensor_data.gyro_z_raw = 32768 + (unsigned int)mpu6000_raw_sensor_readings.gyro_z;
+
+    sensor_data.imu_temperature = (float)mpu6000_raw_sensor_readings.temp * (1.0f / 340.0f) + 36.53f;
+}
@@ -0,0 +1,178 @@
+/*!
+ *  Estimates the wind from the GPS velocity, at the GPS rate.
+ *
+ *  There is no airspeed sensor, and without a magnetometer the AHRS yaw is
+ *  pulled towards the GPS course, so the estimator uses neither. It assumes
+ *  the airspeed stays the same between two GPS velocities v1 and v2 taken on
+ *  different courses: |v1 - w| = |v2 - w| gives
+ *      2 (v2 - v1) . w = |v2|^2 - |v1|^2
+ *  which is linear in the wind w. Each pair is a measurement for a recursive
+ *  least squares filter with a forgetting factor, so the wind is found after
+ *  a couple of turns and slowly follows changes. The airspeed follows as
+ *  |v - w|.
+ *
+ *  @file     wind_estimator.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+
+#include "fastmath/fastmath.h"
+
+#include "wind_estimator.h"
+#include "sensors.h"
+#include "common.h"
+
+#define MIN_SPEED_MS 5.0f           //!< ignore the GPS velocity below this speed (take-off, landing)
+#define MIN_COURSE_CHANGE 0.342f    //!< sin(20 deg) between the two velocities of a pair
+#define MAX_PAIR_AGE 50             //!< 10 seconds at 5Hz, the airspeed may have changed since
+#define LAMBDA 0.95f                //!< forgetting factor per measurement
+#define P_INITIAL 100.0f            //!< (m/s)^2, prior on the wind
+#define AIRSPEED_FILTER 0.1f
+#define RESIDUAL_FILTER 0.05f
+#define MIN_UPDATES 10              //!< before the confidence can rise
+
+struct WindEstimate wind_estimate;
+
+static float p00, p01, p11;         //!< RLS covariance (symmetric)
+static float residual_var;          //!< (m/s)^2
+static float ref_north, ref_east;   //!< first velocity of the pair
+static int ref_age = -1;            //!< -1 when there is no first velocity
+
+static void wind_estimator_publish();
+
+
+void wind_estimator_init()
+{
+	wind_estimate.north_ms = 0.0f;
+	wind_estimate.east_ms = 0.0f;
+	wind_estimate.airspeed_ms = 0.0f;
+	wind_estimate.updates = 0;
+	p00 = p11 = P_INITIAL;
+	p01 = 0.0f;
+	residual_var = 1.0f;
+	ref_age = -1;
+	wind_estimator_publish();
+}
+
+
+/*!
+ *   Call for every new GPS position (5Hz).
+ */
+void wind_estimator_update()
+{
+	float v_north, v_east, d_north, d_east, cross, inv_d;
+	float h0, h1, z, e, ph0, ph1, s, k0, k1;
+
+	if (sensor_data.gps.status != ACTIVE || sensor_data.gps.speed_ms < MIN_SPEED_MS)
+	{
+		ref_age = -1;
+		return;
+	}
+
+	v_north = sensor_data.gps.speed_ms * fast_cos(sensor_data.gps.heading_rad);
+	v_east = sensor_data.gps.speed_ms * fast_sin(sensor_data.gps.heading_rad);
+
+	if (wind_estimate.updates > 0)
+	{
+		float a_north = v_north - wind_estimate.north_ms, a_east = v_east - wind_estimate.east_ms;
+		wind_estimate.airspeed_ms += (fast_sqrt(a_north*a_north + a_east*a_east) - wind_estimate.airspeed_ms) * AIRSPEED_FILTER;
+	}
+	else
+		wind_estimate.airspeed_ms = sensor_data.gps.speed_ms;
+
+	if (ref_age < 0 || ref_age >= MAX_PAIR_AGE)
+	{
+		ref_north = v_north;
+		ref_east = v_east;
+		ref_age = 0;
+		return;
+	}
+	ref_age++;
+
+	// only a course change makes the wind observable, a speed change is a throttle change
+	cross = v_north*ref_east - v_east*ref_north;
+	if (cross*cross < MIN_COURSE_CHANGE*MIN_COURSE_CHANGE * (v_north*v_north + v_east*v_east) * (ref_north*ref_north + ref_east*ref_east))
+		return;
+
+	// measurement normalized to m/s: h . w = z
+	d_north = v_north - ref_north;
+	d_east = v_east - ref_east;
+	inv_d = fast_inv_sqrt(d_north*d_north + d_east*d_east);
+	h0 = 2.0f * d_north * inv_d;
+	h1 = 2.0f * d_east * inv_d;
+	z = (v_north*v_north + v_east*v_east - ref_north*ref_north - ref_east*ref_east) * inv_d;
+
+	// recursive least squares
+	ph0 = p00*h0 + p01*h1;
+	ph1 = p01*h0 + p11*h1;
+	s = LAMBDA + h0*ph0 + h1*ph1;
+	k0 = ph0 / s;
+	k1 = ph1 / s;
+	e = z - (h0*wind_estimate.north_ms + h1*wind_estimate.east_ms);
+
+	wind_estimate.north_ms += k0 * e;
+	wind_estimate.east_ms += k1 * e;
+	p00 = MIN((p00 - k0*ph0) / LAMBDA, P_INITIAL);
+	p01 = (p01 - k0*ph1) / LAMBDA;
+	p11 = MIN((p11 - k1*ph1) / LAMBDA, P_INITIAL);
+
+	residual_var += (e*e - residual_var) * RESIDUAL_FILTER;
+	wind_estimate.updates++;
+
+	ref_north = v_north;
+	ref_east = v_east;
+	ref_age = 0;
+
+	wind_estimator_publish();
+}
+
+
+/*!
+ *   The estimated airspeed when the wind is known, otherwise the GPS speed.
+ */
+float wind_airspeed_ms()
+{
+	if (wind_estimate.confidence >= WIND_CONFIDENT)
+		return wind_estimate.airspeed_ms;
+	else
+		return sensor_data.gps.speed_ms;
+}
+
+
+/*!
+ *   The direction the nose points to: the GPS course corrected for the crab
+ *   angle when the wind is known. In [0, 2*PI).
+ */
+float wind_nose_heading_rad()
+{
+	float heading;
+
+	if (wind_estimate.confidence < WIND_CONFIDENT || sensor_data.gps.speed_ms < MIN_SPEED_MS)
+		return sensor_data.gps.heading_rad;
+
+	heading = fast_atan2(sensor_data.gps.speed_ms * fast_sin(sensor_data.gps.heading_rad) - wind_estimate.east_ms,
+	                     sensor_data.gps.speed_ms * fast_cos(sensor_data.gps.heading_rad) - wind_estimate.north_ms);
+	if (heading < 0.0f)
+		heading += 2.0f*PI;
+	return heading;
+}
+
+
+static void wind_estimator_publish()
+{
+	float from;
+
+	wind_estimate.speed_ms = fast_sqrt(wind_estimate.north_ms*wind_estimate.north_ms + wind_estimate.east_ms*wind_estimate.east_ms);
+	from = fast_atan2(-wind_estimate.east_ms, -wind_estimate.north_ms);
+	if (from < 0.0f)
+		from += 2.0f*PI;
+	wind_estimate.from_rad = from;
+
+	wind_estimate.uncertainty_ms = fast_sqrt((p00 + p11) * residual_var);
+	if (wind_estimate.updates < MIN_UPDATES)
+		wind_estimate.confidence = 0;
+	else
+		wind_estimate.confidence = (unsigned char)BIND(100.0f - 50.0f * wind_estimate.uncertainty_ms, 0.0f, 100.0f);
+}
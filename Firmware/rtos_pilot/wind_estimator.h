@@ -0,0 +1,24 @@
+#ifndef WIND_ESTIMATOR_H
+#define WIND_ESTIMATOR_H
+
+#define WIND_CONFIDENT 50           //!< % confidence above which the estimate is used
+
+struct WindEstimate
+{
+	float north_ms, east_ms;        // wind vector, the direction it blows to
+	float speed_ms;
+	float from_rad;                 // the wind comes from..., 0 = north, like navigation_data.wind_heading
+	float airspeed_ms;              // |ground velocity - wind|
+	float uncertainty_ms;           // standard deviation of the wind vector
+	unsigned char confidence;       // 0-100%
+	unsigned int updates;           // number of accepted measurements
+};
+
+extern struct WindEstimate wind_estimate;
+
+void wind_estimator_init();
+void wind_estimator_update();
+float wind_airspeed_ms();
+float wind_nose_heading_rad();
+
+#endif // WIND_ESTIMATOR_H
@@ -0,0 +1,225 @@
+/*!
+ *  autotune_sim: runs the pid auto-tune of the pilot on the host.
+ *
+ *  autotune_sim [-axis roll|pitch] [-speed m/s] [-relay degrees] [-p gain]
+ *
+ *  One attitude axis of the aircraft is simulated at 1kHz: servo lag, the
+ *  surface moment growing with the dynamic pressure, the aerodynamic damping
+ *  and the lag of the attitude filter. The real autotune.c, gain_schedule.c
+ *  and pid code run at 50Hz on it, like in control_wing_desired_to_servos:
+ *   - a 10 degree step with the configured gains (-p, else the default of
+ *     configuration.c)
+ *   - the relay experiment in stabilized mode, with the measured cycles
+ *   - the same step with the proposed gains, after UA
+ *  The cruising speed is 12m/s, -speed flies the experiment and the steps at
+ *  another airspeed. Exits with 1 when the experiment didn't finish.
+ *
+ *  Build from Firmware/:
+ *    gcc -std=gnu99 -O2 -Wall -Wextra -o autotune_sim -Itools/gluonscript_check -Ilib -Irtos_pilot \
+ *        tools/autotune_sim/autotune_sim.c rtos_pilot/autotune.c rtos_pilot/gain_schedule.c \
+ *        lib/pid/pid.c -lm
+ *
+ *  @file     autotune_sim.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pid/pid.h"
+
+#include "common.h"
+#include "configuration.h"
+#include "gain_schedule.h"
+#include "wind_estimator.h"
+#include "autotune.h"
+
+#define CRUISING_SPEED_MS 12
+#define PHYSICS_HZ 1000
+#define CONTROL_HZ 50
+#define STEP_RAD 0.1745f            //!< 10 degrees
+#define STEP_S 4.0f
+#define MAX_EXPERIMENT_S 40.0f
+
+#define T_SERVO 0.05f               //!< s, servo lag
+#define T_AHRS 0.04f                //!< s, attitude filter lag
+
+struct Configuration config;
+struct SensorData sensor_data;
+struct ControlState control_state;
+struct WindEstimate wind_estimate = { .confidence = 100 };   // the airspeed is known
+
+//! One axis at the cruising speed
+struct AxisModel
+{
+	const char *name;
+	float rate_per_surface;         //!< steady angular rate per rad of surface, 1/s
+	float tau_s;                    //!< rate time constant
+};
+
+static const struct AxisModel roll_model = { "roll", 5.0f, 0.30f };
+static const struct AxisModel pitch_model = { "pitch", 3.0f, 0.20f };
+
+static const struct AxisModel *model;
+static float airspeed_ms;
+static float surface, rate, angle, sensed;
+
+
+float wind_airspeed_ms()
+{
+	return airspeed_ms;
+}
+
+
+/*!
+ *   Levels the aircraft and schedules the gains for the airspeed.
+ */
+static void model_reset()
+{
+	int i;
+
+	surface = rate = angle = sensed = 0.0f;
+	gain_schedule_init();
+	for (i = 0; i < 20; i++)
+		gain_schedule_update();
+}
+
+
+/*!
+ *   Integrates the axis over one control period with the given surface
+ *   command. The moment grows with V^2, the damping with V.
+ */
+static void model_step(float command)
+{
+	float q = (airspeed_ms / (float)CRUISING_SPEED_MS) * (airspeed_ms / (float)CRUISING_SPEED_MS);
+	float tau = model->tau_s * (float)CRUISING_SPEED_MS / airspeed_ms;
+	float dt = 1.0f / (float)PHYSICS_HZ;
+	int i;
+
+	for (i = 0; i < PHYSICS_HZ / CONTROL_HZ; i++)
+	{
+		surface += (command - surface) * dt / T_SERVO;
+		rate += (model->rate_per_surface * q * tau / model->tau_s * surface - rate) * dt / tau;
+		angle += rate * dt;
+		sensed += (angle - sensed) * dt / T_AHRS;
+	}
+}
+
+
+/*!
+ *   One tick of control_wing_desired_to_servos for the axis.
+ */
+static float control(float desired, float dt)
+{
+	struct pid *pid = model == &roll_model ? &gain_schedule.roll2aileron : &gain_schedule.pitch2elevator;
+	float out = pid_update(pid, desired - sensed, dt);
+
+	if (autotune.state == AUTOTUNE_RUNNING && control_state.flight_mode == STABILIZED)
+		out = autotune_relay(desired - sensed, dt);
+	autotune_flight_mode(control_state.flight_mode);
+	return BIND(out, -0.8f, 0.8f);
+}
+
+
+static void step_response(const char *title)
+{
+	const struct pid *pid = model == &roll_model ? &gain_schedule.roll2aileron : &gain_schedule.pitch2elevator;
+	float dt = 1.0f / (float)CONTROL_HZ;
+	float peak = 0.0f, rise_s = -1.0f, settle_s = 0.0f, t;
+
+	model_reset();
+	for (t = 0.0f; t < STEP_S; t += dt)
+	{
+		model_step(control(STEP_RAD, dt));
+		peak = MAX(peak, angle);
+		if (rise_s < 0.0f && angle >= 0.9f * STEP_RAD)
+			rise_s = t;
+		if (fabs(angle - STEP_RAD) > 0.05f * STEP_RAD)
+			settle_s = t;
+	}
+	printf("%s: p %.3f i %.3f d %.3f (x%.2f scheduled)\n", title, pid->p_gain, pid->i_gain, pid->d_gain, gain_schedule.factor);
+	if (rise_s < 0.0f)
+		printf("  10 deg step: doesn't reach 90%% in %.0fs, %.1f deg at the end\n", STEP_S, RAD2DEG(angle));
+	else
+		printf("  10 deg step: rise %.2fs, overshoot %.0f%%, settled (5%%) after %.2fs\n", rise_s,
+		       (peak - STEP_RAD) / STEP_RAD * 100.0f, settle_s);
+}
+
+
+static void experiment(float relay_deg)
+{
+	static const char *state_name[] = { "idle", "armed", "running", "done", "aborted" };
+	float dt = 1.0f / (float)CONTROL_HZ;
+	float t;
+	int cycles = 0;
+
+	model_reset();
+	control_state.flight_mode = MANUAL;
+	autotune_start(model == &roll_model ? AUTOTUNE_ROLL : AUTOTUNE_PITCH, relay_deg);
+	control_state.flight_mode = STABILIZED;
+	for (t = 0.0f; t < MAX_EXPERIMENT_S && autotune.state != AUTOTUNE_DONE && autotune.state != AUTOTUNE_ABORTED; t += dt)
+	{
+		model_step(control(0.0f, dt));
+		if (autotune.cycles != cycles)
+		{
+			cycles = autotune.cycles;
+			printf("  %5.2fs: cycle %d\n", t, cycles);
+		}
+	}
+	printf("relay experiment, %.0f deg: %s after %.1fs", RAD2DEG(autotune.relay_rad), state_name[autotune.state], t);
+	if (autotune.state == AUTOTUNE_DONE)
+		printf(", Ku %.3f, Tu %.3fs\n  proposed for %dm/s: p %.3f i %.3f d %.3f\n", autotune.ku, autotune.tu_s,
+		       CRUISING_SPEED_MS, autotune.proposed.p_gain, autotune.proposed.i_gain, autotune.proposed.d_gain);
+	else
+		printf("\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	float relay_deg = 8.0f, p_gain = -1.0f;
+	int i;
+
+	model = &roll_model;
+	airspeed_ms = (float)CRUISING_SPEED_MS;
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-axis") == 0 && i + 1 < argc)
+			model = strcmp(argv[++i], "pitch") == 0 ? &pitch_model : &roll_model;
+		else if (strcmp(argv[i], "-speed") == 0 && i + 1 < argc)
+			airspeed_ms = atof(argv[++i]);
+		else if (strcmp(argv[i], "-relay") == 0 && i + 1 < argc)
+			relay_deg = atof(argv[++i]);
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+			p_gain = atof(argv[++i]);
+		else
+		{
+			fprintf(stderr, "usage: autotune_sim [-axis roll|pitch] [-speed m/s] [-relay degrees] [-p gain]\n");
+			return 2;
+		}
+	}
+
+	// configuration.c
+	memset(&config, 0, sizeof(config));
+	config.control.cruising_speed_ms = CRUISING_SPEED_MS;
+	config.control.max_pitch = 20.0/180.0*3.14;
+	config.control.min_pitch = -10.0/180.0*3.14;
+	config.control.max_roll = 40.0/180.0*3.14;
+	pid_init(&config.control.pid_pitch2elevator , 0.0, 0.7, 0.0, -1.0, 1.0, 0.0);
+	pid_init(&config.control.pid_roll2aileron, 0.0, 0.5, 0.0, -1.0, 1.0, 0.0);
+	if (p_gain >= 0.0f)
+		(model == &roll_model ? &config.control.pid_roll2aileron : &config.control.pid_pitch2elevator)->p_gain = p_gain;
+
+	printf("%s axis at %.1fm/s\n", model->name, airspeed_ms);
+	control_state.flight_mode = STABILIZED;
+	step_response("configured");
+	experiment(relay_deg);
+	if (!autotune_apply())
+		return 1;
+	control_state.flight_mode = STABILIZED;
+	step_response("tuned");
+	return 0;
+}
@@ -0,0 +1,170 @@
+/*!
+ *  fastmath_bench: accuracy and speed of lib/fastmath against libm.
+ *
+ *  fastmath_bench [-n calls]
+ *
+ *  Every function is swept over its input range and compared with the
+ *  double precision libm function: the maximum error has to stay within the
+ *  bound documented in fastmath.h. Then both are timed on the same inputs,
+ *  fastmath against the float libm function. On the host the libm functions
+ *  are often as fast, the table lookups pay off on the dsPIC, which has no
+ *  FPU; the timing catches a change that makes fastmath much slower.
+ *  Exits with 1 when an error bound is exceeded.
+ *
+ *  Build from Firmware/:
+ *    gcc -std=gnu99 -O2 -Wall -Wextra -o fastmath_bench -Ilib tools/fastmath_bench/fastmath_bench.c \
+ *        lib/fastmath/fastmath.c -lm
+ *
+ *  @file     fastmath_bench.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fastmath/fastmath.h"
+
+#define SWEEP 200000
+#define INPUTS 1024
+
+enum error_kind { ABSOLUTE, RELATIVE };
+
+struct Function
+{
+	const char *name;
+	float min, max;                 //!< swept input range
+	float bound;                    //!< of fastmath.h
+	enum error_kind kind;
+	float (*fast)(float x);
+	float (*libm)(float x);
+	double (*exact)(double x);
+};
+
+//! The functions of two arguments and the fixed point ones get a float wrapper.
+static float atan2_of_angle(float x)  { return fast_atan2(sinf(x), cosf(x)); }
+static float atan2f_of_angle(float x) { return atan2f(sinf(x), cosf(x)); }
+static double atan2_exact(double x)   { return atan2((double)sinf((float)x), (double)cosf((float)x)); }
+static float inv_sqrtf(float x)       { return 1.0f / sqrtf(x); }
+static double inv_sqrt(double x)      { return 1.0 / sqrt(x); }
+static float sin_q15(float x)         { return (float)fast_sin_q15((unsigned int)(long)(x * FASTMATH_BRAD_PER_RAD)) / 32767.0f; }
+static double sin_of_brad(double x)   { return sin((double)((unsigned int)(long)((float)x * FASTMATH_BRAD_PER_RAD) & 0xFFFF) * (M_PI / 32768.0)); }
+
+//! The Q15 functions are compared with libm on the same quantized input.
+static int q15(double x)               { return (int)lrint(x * 32767.0); }
+static float rad(int angle)            { return (float)angle / FASTMATH_BRAD_PER_RAD; }
+static float atan2_q15_of_angle(float x) { return rad(fast_atan2_q15(q15(sin(x)), q15(cos(x)))); }
+static double atan2_q15_exact(double x)  { return atan2((double)q15(sin((float)x)), (double)q15(cos((float)x))); }
+static float asin_q15(float x)         { return rad(fast_asin_q15(q15(x))); }
+static double asin_q15_exact(double x) { return asin((double)q15((float)x) / 32767.0); }
+static float sqrt_q15(float x)         { return (float)fast_sqrt_q15(q15(x)) / 32767.0f; }
+static double sqrt_q15_exact(double x) { return sqrt((double)q15((float)x) / 32767.0); }
+static float inv_sqrt_q15(float x)     { return (float)fast_inv_sqrt_q15(q15(x)) / 32767.0f; }
+static double inv_sqrt_q15_exact(double x) { return 1.0 / sqrt((double)q15((float)x) / 32767.0); }
+
+static const struct Function functions[] = {
+	{ "fast_sin",      -100.0f, 100.0f,  7.6e-5f, ABSOLUTE, fast_sin,      sinf,            sin },
+	{ "fast_cos",      -100.0f, 100.0f,  7.6e-5f, ABSOLUTE, fast_cos,      cosf,            cos },
+	{ "fast_atan2",    -3.14159f, 3.14159f, 2.1e-5f, ABSOLUTE, atan2_of_angle, atan2f_of_angle, atan2_exact },
+	{ "fast_asin",     -1.0f, 1.0f,      2.2e-5f, ABSOLUTE, fast_asin,     asinf,           asin },
+	{ "fast_sqrt",     1e-4f, 1e4f,      4.8e-6f, RELATIVE, fast_sqrt,     sqrtf,           sqrt },
+	{ "fast_inv_sqrt", 1e-4f, 1e4f,      4.8e-6f, RELATIVE, fast_inv_sqrt, inv_sqrtf,       inv_sqrt },
+	{ "fast_sin_q15",  0.0f, 6.28318f,   1.2e-4f, ABSOLUTE, sin_q15,       sinf,            sin_of_brad },
+	{ "fast_atan2_q15", -3.1415f, 3.1415f, 1.3e-4f, ABSOLUTE, atan2_q15_of_angle, atan2f_of_angle, atan2_q15_exact },
+	{ "fast_asin_q15", -1.0f, 1.0f,      1.4e-4f, ABSOLUTE, asin_q15,      asinf,           asin_q15_exact },
+	{ "fast_sqrt_q15", 0.0f, 1.0f,       1.6e-5f, ABSOLUTE, sqrt_q15,      sqrtf,           sqrt_q15_exact },
+	{ "fast_inv_sqrt_q15", 3.1e-5f, 1.0f, 4.0e-5f, RELATIVE, inv_sqrt_q15, inv_sqrtf,      inv_sqrt_q15_exact },
+};
+
+static volatile float sink;
+
+
+static double now_s()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+
+/*!
+ *   Maximum error over the input range, the worst input in *at.
+ */
+static double sweep(const struct Function *f, float *at)
+{
+	double worst = 0.0;
+	int i;
+
+	for (i = 0; i <= SWEEP; i++)
+	{
+		float x = f->min + (f->max - f->min) * (float)i / (float)SWEEP;
+		double exact = f->exact(x);
+		double error = fabs((double)f->fast(x) - exact);
+
+		if (f->kind == RELATIVE)
+			error /= fabs(exact);
+		if (error > worst)
+		{
+			worst = error;
+			*at = x;
+		}
+	}
+	return worst;
+}
+
+
+/*!
+ *   Nanoseconds per call of fn, over calls calls on INPUTS inputs.
+ */
+static double time_ns(float (*fn)(float), const float *input, long calls)
+{
+	double start = now_s();
+	float sum = 0.0f;
+	long i;
+
+	for (i = 0; i < calls; i++)
+		sum += fn(input[i & (INPUTS - 1)]);
+	sink = sum;
+	return (now_s() - start) * 1e9 / (double)calls;
+}
+
+
+int main(int argc, char *argv[])
+{
+	static float input[INPUTS];
+	long calls = 10000000L;
+	int errors = 0;
+	unsigned int f, i;
+
+	if (argc == 3 && strcmp(argv[1], "-n") == 0)
+		calls = atol(argv[2]);
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: fastmath_bench [-n calls]\n");
+		return 2;
+	}
+
+	printf("%-17s %10s %10s %12s %9s %9s\n", "", "max error", "bound", "at", "ns fast", "ns libm");
+	for (f = 0; f < sizeof(functions) / sizeof(functions[0]); f++)
+	{
+		const struct Function *fn = &functions[f];
+		float at = 0.0f;
+		double error = sweep(fn, &at);
+
+		srand(1);
+		for (i = 0; i < INPUTS; i++)
+			input[i] = fn->min + (fn->max - fn->min) * (float)rand() / (float)RAND_MAX;
+
+		printf("%-17s %10.3e %10.3e %12.5g %9.2f %9.2f%s\n", fn->name, error, fn->bound, at,
+		       time_ns(fn->fast, input, calls), time_ns(fn->libm, input, calls),
+		       error > fn->bound ? "  EXCEEDED" : "");
+		if (error > fn->bound)
+			errors++;
+	}
+	printf("(the atan2 functions are timed with the sin and cos of their wrappers)\n");
+	return errors > 0 ? 1 : 0;
+}
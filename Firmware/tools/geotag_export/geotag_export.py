@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""geotag_export: camera trigger events of the pilot to a geotag CSV.
+
+    geotag_export.py [-s session] [-o geotag.csv] [-p photos [-x exiftool.csv] [--offset n]] capture.txt
+
+capture.txt is what the pilot sent after the RG command (see geotag.c), as
+saved by a terminal: the $GE lines, other lines are skipped. Every startup of
+the pilot is a session, the last one is exported unless -s picks another
+(0 is the oldest, -1 the last). geotag.csv gets one line per photo: its
+number, UTC time, position, heights and attitude.
+
+With -p, the photos in that directory are paired with the events in name
+order (--offset skips the first photos) and exiftool.csv is written for
+    exiftool -csv=exiftool.csv photos
+which sets the time, position, altitude and direction in the EXIF of each
+photo.
+"""
+
+import argparse
+import csv
+import datetime
+import os
+import sys
+
+FLAGS = {0x01: 'interpolated', 0x02: 'extrapolated', 0x04: 'no fix'}
+NO_FIX = 0x04
+PHOTO_EXTENSIONS = ('.jpg', '.jpeg', '.tif', '.tiff', '.dng', '.raw', '.cr2', '.nef', '.arw')
+
+
+class Event:
+    def __init__(self, fields):
+        (self.number, self.flags, self.satellites, self.time_us, self.date, self.utc_ms,
+         latitude_e7, longitude_e7, gps_height_dm, height_dm, roll, pitch, yaw) = [int(f) for f in fields]
+        self.latitude = latitude_e7 / 1e7
+        self.longitude = longitude_e7 / 1e7
+        self.gps_height_m = gps_height_dm / 10.0
+        self.height_m = height_dm / 10.0
+        self.roll = roll / 100.0
+        self.pitch = pitch / 100.0
+        self.yaw = yaw / 100.0
+
+    def utc(self):
+        """datetime of the trigger, None without a fix"""
+        if self.flags & NO_FIX or self.date == 0:
+            return None
+        day = datetime.datetime(2000 + self.date % 100, self.date // 100 % 100, self.date // 10000)
+        return day + datetime.timedelta(milliseconds=self.utc_ms)
+
+    def kind(self):
+        return FLAGS.get(self.flags, 'fix')
+
+
+def checksum_ok(line):
+    """$...*XX: xor of everything between $ and *"""
+    body, _, checksum = line[1:].partition('*')
+    value = 0
+    for c in body:
+        value ^= ord(c)
+    try:
+        return value == int(checksum[:2], 16)
+    except ValueError:
+        return False
+
+
+def read_sessions(path):
+    """Events grouped per startup of the pilot: the time and number start over."""
+    sessions = []
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            start = line.find('$GE;')
+            if start < 0:
+                continue
+            line = line[start:]
+            if not checksum_ok(line):
+                print('checksum error, skipped: ' + line, file=sys.stderr)
+                continue
+            fields = line[1:].partition('*')[0].split(';')[1:]
+            if len(fields) != 13:
+                continue
+            event = Event(fields)
+            last = sessions[-1][-1] if sessions else None
+            if last is None or event.time_us <= last.time_us or event.number < last.number:
+                sessions.append([])
+            sessions[-1].append(event)
+    return sessions
+
+
+def write_geotag(path, events):
+    with open(path, 'w', newline='') as f:
+        out = csv.writer(f)
+        out.writerow(['number', 'utc', 'latitude', 'longitude', 'gps_height_m', 'height_m',
+                      'roll', 'pitch', 'yaw', 'satellites', 'position', 'time_us'])
+        for e in events:
+            utc = e.utc()
+            out.writerow([e.number, utc.isoformat(timespec='milliseconds') if utc else '',
+                          '%.7f' % e.latitude if not e.flags & NO_FIX else '',
+                          '%.7f' % e.longitude if not e.flags & NO_FIX else '',
+                          e.gps_height_m if not e.flags & NO_FIX else '', e.height_m,
+                          e.roll, e.pitch, e.yaw, e.satellites, e.kind(), e.time_us])
+
+
+def write_exiftool(path, photos, events):
+    """Empty values are left alone by exiftool."""
+    with open(path, 'w', newline='') as f:
+        out = csv.writer(f)
+        out.writerow(['SourceFile', 'DateTimeOriginal', 'SubSecTimeOriginal', 'GPSLatitude', 'GPSLatitudeRef',
+                      'GPSLongitude', 'GPSLongitudeRef', 'GPSAltitude', 'GPSAltitudeRef',
+                      'GPSImgDirection', 'GPSImgDirectionRef'])
+        for photo, e in zip(photos, events):
+            utc = e.utc()
+            if e.flags & NO_FIX:
+                out.writerow([photo] + [''] * 10)
+                continue
+            out.writerow([photo, utc.strftime('%Y:%m:%d %H:%M:%S') if utc else '',
+                          '%03d' % (utc.microsecond // 1000) if utc else '',
+                          '%.7f' % abs(e.latitude), 'N' if e.latitude >= 0 else 'S',
+                          '%.7f' % abs(e.longitude), 'E' if e.longitude >= 0 else 'W',
+                          '%.1f' % abs(e.gps_height_m), 0 if e.gps_height_m >= 0 else 1,
+                          '%.2f' % e.yaw, 'T'])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Camera trigger events of the pilot to a geotag CSV.')
+    parser.add_argument('capture', help='output of the RG command')
+    parser.add_argument('-s', dest='session', type=int, default=-1, help='startup to export, 0 is the oldest')
+    parser.add_argument('-o', dest='output', default='geotag.csv')
+    parser.add_argument('-p', dest='photos', help='directory with the photos of the session')
+    parser.add_argument('-x', dest='exiftool', default='exiftool.csv')
+    parser.add_argument('--offset', type=int, default=0, help='photos to skip before the first trigger')
+    options = parser.parse_args()
+
+    sessions = read_sessions(options.capture)
+    if not sessions:
+        print('no $GE lines in ' + options.capture, file=sys.stderr)
+        return 1
+    for i, s in enumerate(sessions):
+        first = s[0].utc()
+        print('session %d: %d photos%s' % (i, len(s), ', from ' + first.isoformat(timespec='seconds') if first else ''))
+    try:
+        events = sessions[options.session]
+    except IndexError:
+        print('no session %d' % options.session, file=sys.stderr)
+        return 1
+
+    write_geotag(options.output, events)
+    counts = {}
+    for e in events:
+        counts[e.kind()] = counts.get(e.kind(), 0) + 1
+    print('%s: %d photos (%s)' % (options.output, len(events), ', '.join('%d %s' % (n, k) for k, n in sorted(counts.items()))))
+
+    if options.photos:
+        photos = sorted(os.path.join(options.photos, name) for name in os.listdir(options.photos)
+                        if name.lower().endswith(PHOTO_EXTENSIONS))[options.offset:]
+        if len(photos) != len(events):
+            print('warning: %d photos for %d triggers, the first %d are paired'
+                  % (len(photos), len(events), min(len(photos), len(events))), file=sys.stderr)
+        write_exiftool(options.exiftool, photos, events)
+        print('%s: run exiftool -csv=%s %s' % (options.exiftool, options.exiftool, options.photos))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,41 @@
+/*!
+ *  Host replacement of the FreeRTOS API used by gluonscript and its handlers,
+ *  and by the drivers of tools/host_test. There is only one task on the
+ *  host: critical sections are empty and the semaphores are always available.
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+typedef unsigned long portTickType;
+typedef long portBASE_TYPE;
+typedef void * xSemaphoreHandle;
+typedef void * xQueueHandle;
+typedef void * xTaskHandle;
+
+#define portTICK_RATE_MS ((portTickType) 1)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define configKERNEL_INTERRUPT_PRIORITY 1
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define vSemaphoreCreateBinary(s) ((s) = (xSemaphoreHandle) 1)
+#define xSemaphoreGive(s) ((void) 0)
+#define xSemaphoreGiveFromISR(s, woken) ((void)(s), (void)(woken))
+#define vTaskDelay(t)
+#define vTaskDelayUntil(last, t) ((void)(last))
+#define xTaskGetTickCount() ((portTickType) 0)
+#define vTaskSetApplicationTaskTag(task, tag)
+#define taskYIELD()
+
+// a function, not a macro: its result is often ignored
+static inline portBASE_TYPE xSemaphoreTake(xSemaphoreHandle s, portTickType t)
+{
+	(void)s;
+	(void)t;
+	return pdTRUE;
+}
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,863 @@
+/*!
+ *  gluonscript_check: flies a flightplan on the host before it is uploaded.
+ *
+ *  gluonscript_check [-t seconds] [-home latitude longitude] [-v] plan [script]
+ *
+ *  The plan holds the WN lines as they are sent to the pilot, or the ND lines
+ *  it sends back: "WN;line;opcode;x;y;a;b", the $ and *checksum are optional.
+ *  The script changes the environment during the flight, one "seconds name
+ *  value" per line: ch1..ch8 (us), link (0/1), batt (V), gps (0 = lost),
+ *  wind_n and wind_e (m/s, the wind blows towards).
+ *  The aircraft starts at the home position (default: the first absolute
+ *  waypoint) and flies for 600s unless -t is given.
+ *
+ *  The plan is analysed first, then the real gluonscript code runs at
+ *  GLUONSCRIPT_HZ and the watchers and the geofence at 50Hz, against the
+ *  aircraft of host.c.
+ *  Reported are:
+ *   - lines that can't be reached, and lines that weren't during the flight
+ *   - loops without a navigation line, the aircraft keeps its last heading
+ *   - CALLs nested deeper than the GLUONSCRIPT_STACK_DEPTH return
+ *     addresses (the pilot skips such a CALL), RETURN without CALL and
+ *     handler jumps that leave return addresses behind
+ *   - the worst case cost of a tick: host time and the flightplan pages
+ *     that had to be read from the flash, which block the GPS task
+ *  Exits with 1 when an error was found.
+ *
+ *  Build from Firmware/:
+ *    gcc -std=gnu99 -O2 -Wall -Wextra -o gluonscript_check -Itools/gluonscript_check -Ilib -Irtos_pilot \
+ *        tools/gluonscript_check/gluonscript_check.c tools/gluonscript_check/host.c \
+ *        rtos_pilot/gluonscript.c rtos_pilot/handler_alarms.c rtos_pilot/handler_flightplan_switch.c \
+ *        rtos_pilot/handler_geofence.c rtos_pilot/handler_maximum_range.c rtos_pilot/handler_navigation.c \
+ *        rtos_pilot/handler_trigger.c rtos_pilot/handler_watch.c rtos_pilot/dubins_path.c \
+ *        rtos_pilot/wind_estimator.c rtos_pilot/gain_schedule.c lib/fastmath/fastmath.c -lm
+ *
+ *  @file     gluonscript_check.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common.h"
+#include "gluonscript.h"
+#include "handler_navigation.h"
+#include "handler_watch.h"
+#include "handler_geofence.h"
+#include "ppm_in/ppm_in.h"
+
+#include "host.h"
+
+#define CONTROL_HZ 50
+#define STALL_TICKS (5*GLUONSCRIPT_HZ)
+#define MAX_EVENTS 256
+
+static const char *opcode_name[] = {
+	"EMPTY", "CLIMB", "FROM_TO_REL", "FROM_TO_ABS", "FLY_TO_REL", "FLY_TO_ABS", "GOTO",
+	"CIRCLE_ABS", "CIRCLE_REL", "IF_EQ", "IF_SM", "IF_GR", "IF_NE", "UNTIL_EQ", "UNTIL_NE",
+	"UNTIL_GR", "UNTIL_SM", "SERVO_SET", "SERVO_TRIGGER", "BLOCK", "FLARE_TO_ABS",
+	"FLARE_TO_REL", "GLIDE_TO_ABS", "GLIDE_TO_REL", "SET_LOITER_POSITION", "LOITER_CIRCLE",
+	"CIRCLE_TO_ABS", "CIRCLE_TO_REL", "SET_BATTERY_ALARM", "CALL", "RETURN",
+	"SERVO_START_TRIGGER", "SERVO_STOP_TRIGGER", "SET_FLIGHTPLAN_SWITCH", "SET_MAXIMUM_RANGE",
+	"SERVO_START_DST_TRIGGER", "GEOFENCE_VERTEX", "SET_GEOFENCE", "WATCH_GR", "WATCH_SM"
+};
+
+//! A change of the environment at a given time.
+struct Event
+{
+	float time_s;
+	char name[8];
+	float value;
+};
+
+/*!
+ *   What is known about a subroutine (CALL target).
+ */
+struct Function
+{
+	unsigned char state;           // 0: not analysed, 1: busy (recursion), 2: done
+	unsigned char navigates;       // it or one of its subroutines has a navigation line
+	int depth;                     // return addresses it pushes at most
+	int deepest_call;              // the CALL line that gets there, -1 if none
+};
+
+static struct GluonscriptCode plan[MAX_GLUONSCRIPTCODES + 1];
+static int lines;                  // node lines is the end of the plan (EMPTYCMD)
+
+static unsigned char reachable[MAX_GLUONSCRIPTCODES + 1];
+static unsigned char reported[MAX_GLUONSCRIPTCODES + 1];
+static unsigned long executed[MAX_GLUONSCRIPTCODES + 1];
+static struct Function function[MAX_GLUONSCRIPTCODES + 1];
+
+static struct Event event[MAX_EVENTS];
+static int events = 0;
+
+static int errors = 0, warnings = 0;
+static int verbose = 0;
+
+#define REPORTED_CALL_DEPTH 1
+#define REPORTED_RETURN 2
+#define REPORTED_LEFT_ON_STACK 4
+#define REPORTED_STALL 8
+
+
+static const char *name_of(int opcode)
+{
+	if (opcode >= 0 && opcode < (int)(sizeof(opcode_name) / sizeof(opcode_name[0])))
+		return opcode_name[opcode];
+	return "?";
+}
+
+
+static int is_navigation(int opcode)
+{
+	switch (opcode)
+	{
+		case CLIMB:
+		case FROM_TO_REL:
+		case FROM_TO_ABS:
+		case FLY_TO_REL:
+		case FLY_TO_ABS:
+		case CIRCLE_ABS:
+		case CIRCLE_REL:
+		case FLARE_TO_ABS:
+		case FLARE_TO_REL:
+		case GLIDE_TO_ABS:
+		case GLIDE_TO_REL:
+		case LOITER_CIRCLE:
+		case CIRCLE_TO_ABS:
+		case CIRCLE_TO_REL:
+		case EMPTYCMD:       // heads home
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+
+/*!
+ *   Lines outside the plan are EMPTYCMD, they are all the end node.
+ */
+static int node(int line)
+{
+	return (line < 0 || line >= lines) ? lines : line;
+}
+
+
+static int jump_target(int line)
+{
+	return plan[line].a < 0 ? line + plan[line].a : plan[line].a;
+}
+
+
+/*!
+ *   Where gluonscript_do can go from this line, without the handler jumps.
+ *   With follow_calls, CALL goes to its subroutine and the line behind it,
+ *   otherwise only to the line behind it. RETURN has none.
+ */
+static int successors(int line, int *next, int follow_calls)
+{
+	if (line == lines)
+	{
+		next[0] = node(0);
+		return 1;
+	}
+
+	switch (plan[line].opcode)
+	{
+		case GOTO:
+			next[0] = node(jump_target(line));
+			return 1;
+		case CALL:
+			next[0] = node(line + 1);
+			next[1] = node(jump_target(line));
+			return follow_calls ? 2 : 1;
+		case RETURN:
+			return 0;
+		case IF_EQ:
+		case IF_SM:
+		case IF_GR:
+		case IF_NE:
+			next[0] = node(line + 1);
+			next[1] = node(line + 2);
+			return 2;
+		case UNTIL_EQ:
+		case UNTIL_NE:
+		case UNTIL_GR:
+		case UNTIL_SM:
+			next[0] = node(line + 1);
+			next[1] = node(line - 1);
+			return 2;
+		case EMPTYCMD:
+			next[0] = node(0);
+			return 1;
+		default:
+			next[0] = node(line + 1);
+			return 1;
+	}
+}
+
+
+/*!
+ *   Lines the handlers can jump to at any time, once this line was executed.
+ */
+static int handler_targets(int line, int *target)
+{
+	struct GluonscriptCode *code = &plan[line];
+
+	switch (code->opcode)
+	{
+		case SET_MAXIMUM_RANGE:
+		case SET_GEOFENCE:
+			target[0] = code->a - 1;
+			return 1;
+		case SET_FLIGHTPLAN_SWITCH:
+			target[0] = code->b - 1;
+			target[1] = (int)code->x - 1;
+			target[2] = (int)code->y - 1;
+			return 3;
+		case WATCH_GR:
+		case WATCH_SM:
+			if (code->b == 0)
+				return 0;
+			target[0] = code->b - 1;
+			return 1;
+		case SET_BATTERY_ALARM:
+			if (code->a < 0)
+				return 0;
+			target[0] = code->a;    // panic_line is not incremented
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+
+static const char *block_name(int line)
+{
+	int i;
+	for (i = 0; i < gluonscript_data.blocks; i++)
+		if (gluonscript_data.block[i].line == line && gluonscript_data.block[i].name[0] != '\0')
+			return (const char *)gluonscript_data.block[i].name;
+	return NULL;
+}
+
+
+static void error(int line, const char *message)
+{
+	errors++;
+	if (line >= 0)
+		printf("error: line %d (%s): %s\n", line + 1, name_of(plan[node(line)].opcode), message);
+	else
+		printf("error: %s\n", message);
+}
+
+
+static void warning(int line, const char *message)
+{
+	warnings++;
+	if (line >= 0)
+		printf("warning: line %d (%s): %s\n", line + 1, name_of(plan[node(line)].opcode), message);
+	else
+		printf("warning: %s\n", message);
+}
+
+
+/*!
+ *   Reads the plan into the (host) flash and into plan[] for the analysis.
+ */
+static int load_plan(const char *filename)
+{
+	char buffer[256], *s, *star;
+	int n = 0, line, opcode;
+	struct GluonscriptCode code;
+	FILE *f = fopen(filename, "r");
+
+	if (f == NULL)
+	{
+		perror(filename);
+		return 0;
+	}
+
+	while (fgets(buffer, sizeof(buffer), f) != NULL)
+	{
+		s = buffer[0] == '$' ? buffer + 1 : buffer;
+		if ((star = strchr(s, '*')) != NULL)
+			*star = '\0';
+		if (strncmp(s, "WN;", 3) != 0 && strncmp(s, "ND;", 3) != 0)
+			continue;
+
+		memset(&code, 0, sizeof(code));
+		if (sscanf(s + 3, "%d;%d;%f;%f;%d;%d", &line, &opcode, &code.x, &code.y, &code.a, &code.b) != 6 ||
+		    line < 1 || line > MAX_GLUONSCRIPTCODES)
+		{
+			fprintf(stderr, "%s: can't read %s", filename, buffer);
+			continue;
+		}
+		code.opcode = (unsigned char)opcode;
+		gluonscript_set_code(line - 1, &code);
+		n++;
+	}
+	fclose(f);
+
+	gluonscript_init();
+	lines = gluonscript_data.lines;
+	for (line = 0; line < lines; line++)
+		gluonscript_get_code(line, &plan[line]);
+	plan[lines].opcode = EMPTYCMD;
+	host_flash_reads = 0;
+
+	printf("%s: %d lines, %d blocks\n", filename, lines, gluonscript_data.blocks);
+	return n > 0;
+}
+
+
+static int compare_events(const void *a, const void *b)
+{
+	float d = ((const struct Event *)a)->time_s - ((const struct Event *)b)->time_s;
+	return d < 0.0f ? -1 : (d > 0.0f ? 1 : 0);
+}
+
+
+static int load_script(const char *filename)
+{
+	char buffer[128];
+	FILE *f = fopen(filename, "r");
+
+	if (f == NULL)
+	{
+		perror(filename);
+		return 0;
+	}
+	while (fgets(buffer, sizeof(buffer), f) != NULL && events < MAX_EVENTS)
+	{
+		struct Event *e = &event[events];
+		if (buffer[0] == '#' || sscanf(buffer, "%f %7s %f", &e->time_s, e->name, &e->value) != 3)
+			continue;
+		events++;
+	}
+	fclose(f);
+	qsort(event, events, sizeof(struct Event), compare_events);
+	return 1;
+}
+
+
+static void apply_event(struct Event *e)
+{
+	if (strncmp(e->name, "ch", 2) == 0 && e->name[2] >= '1' && e->name[2] <= '8' && e->name[3] == '\0')
+		ppm.channel[e->name[2] - '1'] = (unsigned int)e->value;
+	else if (strcmp(e->name, "link") == 0)
+		ppm.connection_alive = e->value != 0.0f;
+	else if (strcmp(e->name, "batt") == 0)
+		host_environment.battery_v = e->value;
+	else if (strcmp(e->name, "gps") == 0)
+		host_environment.gps_lost = e->value == 0.0f;
+	else if (strcmp(e->name, "wind_n") == 0)
+		host_environment.wind_north_ms = e->value;
+	else if (strcmp(e->name, "wind_e") == 0)
+		host_environment.wind_east_ms = e->value;
+	else
+		fprintf(stderr, "unknown script variable %s\n", e->name);
+}
+
+
+/*
+ *   Static analysis
+ */
+
+/*!
+ *   Marks everything that can be executed: from line 1, and from the handler
+ *   targets once the line that sets them can be reached.
+ */
+static void analyse_reachability()
+{
+	static int queue[MAX_GLUONSCRIPTCODES + 1];
+	int head = 0, tail = 0, next[3], target[3], n, i, line;
+	char message[80];
+
+	reachable[0] = 1;
+	queue[tail++] = 0;
+	while (head < tail)
+	{
+		line = queue[head++];
+		n = successors(line, next, 1);
+		if (line < lines)
+		{
+			int t = handler_targets(line, target);
+			for (i = 0; i < t; i++)
+			{
+				if (node(target[i]) == lines)
+				{
+					sprintf(message, "jumps to line %d, outside the flightplan", target[i] + 1);
+					error(line, message);
+				}
+				next[n++] = node(target[i]);
+			}
+			if ((plan[line].opcode == GOTO || plan[line].opcode == CALL) && next[n-1] == lines &&
+			    jump_target(line) != lines)
+			{
+				sprintf(message, "jumps to line %d, outside the flightplan", jump_target(line) + 1);
+				error(line, message);
+			}
+		}
+		for (i = 0; i < n; i++)
+			if (!reachable[next[i]])
+			{
+				reachable[next[i]] = 1;
+				queue[tail++] = next[i];
+			}
+	}
+
+	if (reachable[lines] && lines < MAX_GLUONSCRIPTCODES)
+		warning(-1, "the plan can run past its last line: EMPTYCMD heads home and restarts at line 1");
+
+	for (line = 0; line < lines; line++)
+	{
+		int last = line, block = -1;
+		if (reachable[line] || plan[line].opcode == GEOFENCE_VERTEX)
+			continue;
+		while (last + 1 < lines && !reachable[last + 1])
+			last++;
+		for (i = line; i <= last; i++)
+			if (plan[i].opcode == BLOCK && block < 0)
+				block = i;
+
+		if (block >= 0)
+			printf("info: lines %d-%d: the block %s%sis only reachable from the OSD or the ground station\n",
+			       line + 1, last + 1, block_name(block) ? block_name(block) : "", block_name(block) ? " " : "");
+		else
+		{
+			sprintf(message, "lines %d-%d can't be reached", line + 1, last + 1);
+			warning(-1, message);
+		}
+		line = last;
+	}
+}
+
+
+/*!
+ *   Depth of the return address stack in a subroutine, whether it navigates,
+ *   and recursion. Walks the lines from entry up to the RETURNs, without
+ *   entering the subroutines it calls (they're analysed on their own).
+ *   Returns the depth of the deepest CALL it makes, main_program reports
+ *   the RETURNs it finds.
+ */
+static void analyse_function(int entry, struct Function *f, int main_program)
+{
+	unsigned char *seen = calloc(lines + 1, 1);
+	int *stack = malloc(sizeof(int) * (lines + 1));
+	int sp = 0, line, next[2], n, i;
+	char message[80];
+
+	f->state = 1;
+	f->depth = 0;
+	f->deepest_call = -1;
+	stack[sp++] = entry;
+	seen[entry] = 1;
+	while (sp > 0)
+	{
+		line = stack[--sp];
+		if (line < lines && is_navigation(plan[line].opcode))
+			f->navigates = 1;
+		if (line < lines && plan[line].opcode == RETURN && main_program && !(reported[line] & REPORTED_RETURN))
+		{
+			reported[line] |= REPORTED_RETURN;
+			warning(line, "RETURN outside a subroutine, continues at the next line");
+		}
+		if (line < lines && plan[line].opcode == CALL && node(jump_target(line)) < lines)
+		{
+			int callee = node(jump_target(line));
+			struct Function *c = &function[callee];
+			if (c->state == 0)
+				analyse_function(callee, c, 0);
+			if (c->state == 1)
+			{
+				if (!(reported[line] & REPORTED_CALL_DEPTH))
+				{
+					reported[line] |= REPORTED_CALL_DEPTH;
+					sprintf(message, "recursive CALL of line %d, fills the stack", callee + 1);
+					error(line, message);
+				}
+			}
+			else
+			{
+				f->navigates |= c->navigates;
+				if (1 + c->depth > f->depth)
+				{
+					f->depth = 1 + c->depth;
+					f->deepest_call = line;
+				}
+			}
+		}
+		if (line == lines && !main_program)
+			continue;     // runs off the end: restarts the main program
+
+		n = successors(line, next, 0);
+		for (i = 0; i < n; i++)
+			if (!seen[next[i]])
+			{
+				seen[next[i]] = 1;
+				stack[sp++] = next[i];
+			}
+	}
+	f->state = 2;
+	free(seen);
+	free(stack);
+}
+
+
+static void analyse_calls()
+{
+	static struct Function main_program;
+	int line, target[3], n, i;
+	char message[160];
+
+	// the handler targets are entry points of the main program too
+	analyse_function(0, &main_program, 1);
+	for (line = 0; line < lines; line++)
+	{
+		if (!reachable[line])
+			continue;
+		n = handler_targets(line, target);
+		for (i = 0; i < n; i++)
+		{
+			struct Function f = { 0, 0, 0, -1 };
+			if (node(target[i]) == lines)
+				continue;
+			analyse_function(node(target[i]), &f, 1);
+			if (f.depth > main_program.depth)
+				main_program = f;
+		}
+	}
+
+	printf("info: CALLs nest %d deep, the stack holds %d return addresses\n", main_program.depth, GLUONSCRIPT_STACK_DEPTH);
+	if (main_program.depth > GLUONSCRIPT_STACK_DEPTH)
+	{
+		int len = 0;
+		line = main_program.deepest_call;
+		while (line >= 0 && len < (int)sizeof(message) - 12)
+		{
+			len += sprintf(message + len, "%s%d", len ? " > " : "lines ", line + 1);
+			line = function[node(jump_target(line))].deepest_call;
+		}
+		strcat(message, ": the deepest CALL is skipped");
+		error(-1, message);
+	}
+}
+
+
+/*!
+ *   Tarjan's strongly connected components of the lines that don't navigate
+ *   (navigation lines and CALLs of subroutines with one are left out): the
+ *   loops that leave the aircraft on its last heading. When no line in the
+ *   loop can leave it, it never ends.
+ */
+static int scc_index[MAX_GLUONSCRIPTCODES + 1], scc_low[MAX_GLUONSCRIPTCODES + 1];
+static unsigned char scc_on_stack[MAX_GLUONSCRIPTCODES + 1];
+static int scc_stack[MAX_GLUONSCRIPTCODES + 1], scc_sp = 0, scc_counter = 0;
+
+static int navigates(int line)
+{
+	if (line == lines)
+		return 1;
+	if (plan[line].opcode == CALL && node(jump_target(line)) < lines)
+		return function[node(jump_target(line))].navigates;
+	return is_navigation(plan[line].opcode);
+}
+
+static void report_loop(int *member, int n)
+{
+	static unsigned char in_loop[MAX_GLUONSCRIPTCODES + 1];
+	int i, j, k, next[2], leaves = 0, first = lines, last = 0;
+	char message[80];
+
+	for (i = 0; i < n; i++)
+		if (!reachable[member[i]])
+			return;
+
+	for (i = 0; i < n; i++)
+		in_loop[member[i]] = 1;
+	for (i = 0; i < n; i++)
+	{
+		first = MIN(first, member[i]);
+		last = MAX(last, member[i]);
+		k = successors(member[i], next, 0);
+		for (j = 0; j < k; j++)
+			leaves |= !in_loop[next[j]];
+	}
+	for (i = 0; i < n; i++)
+		in_loop[member[i]] = 0;
+
+	if (leaves)
+	{
+		sprintf(message, "lines %d-%d can loop without a navigation line", first + 1, last + 1);
+		warning(-1, message);
+	}
+	else
+	{
+		sprintf(message, "lines %d-%d loop forever without a navigation line", first + 1, last + 1);
+		error(-1, message);
+	}
+}
+
+static void strongconnect(int line)
+{
+	int next[2], n, i;
+
+	scc_index[line] = scc_low[line] = ++scc_counter;
+	scc_stack[scc_sp++] = line;
+	scc_on_stack[line] = 1;
+
+	n = successors(line, next, 0);
+	for (i = 0; i < n; i++)
+	{
+		if (navigates(next[i]))
+			continue;
+		if (scc_index[next[i]] == 0)
+		{
+			strongconnect(next[i]);
+			scc_low[line] = MIN(scc_low[line], scc_low[next[i]]);
+		}
+		else if (scc_on_stack[next[i]])
+			scc_low[line] = MIN(scc_low[line], scc_index[next[i]]);
+	}
+
+	if (scc_low[line] == scc_index[line])
+	{
+		int start = scc_sp, self_loop = 0;
+		do
+			start--;
+		while (scc_stack[start] != line);
+
+		for (i = 0; i < n; i++)
+			self_loop |= next[i] == line;
+		if (scc_sp - start > 1 || self_loop)
+			report_loop(&scc_stack[start], scc_sp - start);
+
+		for (i = start; i < scc_sp; i++)
+			scc_on_stack[scc_stack[i]] = 0;
+		scc_sp = start;
+	}
+}
+
+static void analyse_loops()
+{
+	int line;
+	for (line = 0; line <= lines; line++)
+		if (scc_index[line] == 0 && !navigates(line))
+			strongconnect(line);
+}
+
+
+/*
+ *   The flight
+ */
+
+static double elapsed_us(struct timespec *start, struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e6 + (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+
+static void fly(float seconds)
+{
+	unsigned long ticks = (unsigned long)(seconds * GLUONSCRIPT_HZ), tick, reads;
+	unsigned long worst_reads = 0, fault_reads = 0, prefetch_reads = 0;
+	int worst_reads_line = 0, worst_time_line = 0, stall = 0, stall_line = 0;
+	int next_event = 0, i, line, next[5], n, expected, watch_line;
+	unsigned int stack_errors;
+	double us, worst_us = 0.0, total_us = 0.0;
+	struct timespec start, end;
+	char message[120];
+
+	for (tick = 0; tick < ticks; tick++)
+	{
+		float t = (float)tick / GLUONSCRIPT_HZ;
+		struct GluonscriptCode *code;
+
+		while (next_event < events && event[next_event].time_s <= t)
+			apply_event(&event[next_event++]);
+
+		for (i = 0; i < CONTROL_HZ / GLUONSCRIPT_HZ; i++)
+		{
+			host_step(1.0f / CONTROL_HZ);
+			watch_check();
+			geofence_check();
+		}
+
+		// a watcher that fired jumps before the line is fetched
+		watch_line = watch_pending();
+		if (watch_line >= 0 && gluonscript_context.stack_depth > 0 &&
+		    !(reported[node(gluonscript_context.current_codeline)] & REPORTED_LEFT_ON_STACK))
+		{
+			reported[node(gluonscript_context.current_codeline)] |= REPORTED_LEFT_ON_STACK;
+			sprintf(message, "at %.1fs: watcher jump to line %d leaves %d return address(es) on the stack",
+			        t, watch_line + 1, gluonscript_context.stack_depth);
+			warning(node(gluonscript_context.current_codeline), message);
+		}
+		line = node(watch_line >= 0 ? watch_line : gluonscript_context.current_codeline);
+		code = &plan[line];
+		executed[line]++;
+
+		reads = host_flash_reads;
+		stack_errors = gluonscript_context.stack_errors;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		gluonscript_do();
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		reads = host_flash_reads - reads;
+		fault_reads += reads;
+
+		us = elapsed_us(&start, &end);
+		total_us += us;
+		if (us > worst_us)
+		{
+			worst_us = us;
+			worst_time_line = line;
+		}
+		if (reads > worst_reads)
+		{
+			worst_reads = reads;
+			worst_reads_line = line;
+		}
+
+		reads = host_flash_reads;
+		gluonscript_prefetch();
+		prefetch_reads += host_flash_reads - reads;
+
+		// follow the return addresses
+		n = successors(line, next, 1);
+		expected = gluonscript_context.current_codeline == line || code->opcode == RETURN;
+		for (i = 0; i < n; i++)
+			expected |= node(gluonscript_context.current_codeline) == next[i];
+
+		if (gluonscript_context.stack_errors != stack_errors && code->opcode == CALL &&
+		    !(reported[line] & REPORTED_CALL_DEPTH))
+		{
+			reported[line] |= REPORTED_CALL_DEPTH;
+			sprintf(message, "at %.1fs: %d CALLs deep, the stack is full and the CALL is skipped", t,
+			        gluonscript_context.stack_depth + 1);
+			error(line, message);
+		}
+		else if (gluonscript_context.stack_errors != stack_errors && code->opcode == RETURN &&
+		         !(reported[line] & REPORTED_RETURN))
+		{
+			reported[line] |= REPORTED_RETURN;
+			sprintf(message, "at %.1fs: RETURN without CALL, continues at the next line", t);
+			warning(line, message);
+		}
+		else if (!expected && gluonscript_context.stack_depth > 0 && !(reported[line] & REPORTED_LEFT_ON_STACK))
+		{
+			reported[line] |= REPORTED_LEFT_ON_STACK;
+			sprintf(message, "at %.1fs: handler jump to line %d leaves %d return address(es) on the stack",
+			        t, gluonscript_context.current_codeline + 1, gluonscript_context.stack_depth);
+			warning(line, message);
+		}
+
+		// navigation is only updated by the navigation lines
+		if (is_navigation(code->opcode))
+			stall = 0;
+		else if (stall++ == 0)
+			stall_line = line;
+		if (stall == STALL_TICKS && !(reported[stall_line] & REPORTED_STALL))
+		{
+			reported[stall_line] |= REPORTED_STALL;
+			sprintf(message, "at %.1fs: no navigation line for %ds", t, STALL_TICKS / GLUONSCRIPT_HZ);
+			error(stall_line, message);
+		}
+
+		if (verbose && gluonscript_context.current_codeline != line)
+			printf("%7.1fs line %d -> %d\n", t, line + 1, gluonscript_context.current_codeline + 1);
+	}
+
+	printf("info: %lu ticks, %.1f us per tick on this host, worst %.1f us at line %d\n",
+	       ticks, total_us / MAX(ticks, 1), worst_us, worst_time_line + 1);
+	printf("info: %lu flightplan pages read in the GPS task, worst %lu in one tick at line %d; %lu prefetched\n",
+	       fault_reads, worst_reads, worst_reads_line + 1, prefetch_reads);
+}
+
+
+static void report_coverage()
+{
+	int line, covered = 0, counted = 0;
+
+	for (line = 0; line < lines; line++)
+	{
+		if (plan[line].opcode == GEOFENCE_VERTEX)
+			continue;
+		counted++;
+		if (executed[line])
+			covered++;
+		if (verbose)
+			printf("%5d %-24s %8lu ticks\n", line + 1, name_of(plan[line].opcode), executed[line]);
+	}
+	printf("info: %d of %d lines executed", covered, counted);
+	for (line = 0; line < lines; line++)
+	{
+		int last = line;
+		if (executed[line] || !reachable[line] || plan[line].opcode == GEOFENCE_VERTEX)
+			continue;
+		while (last + 1 < lines && !executed[last + 1] && reachable[last + 1])
+			last++;
+		printf(line == last ? ", not %d" : ", not %d-%d", line + 1, last + 1);
+		line = last;
+	}
+	printf("\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	float seconds = 600.0f;
+	double latitude_rad = 0.0, longitude_rad = 0.0;
+	int home_given = 0, i, line;
+	const char *plan_file = NULL, *script_file = NULL;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			seconds = atof(argv[++i]);
+		else if (strcmp(argv[i], "-home") == 0 && i + 2 < argc)
+		{
+			latitude_rad = DEG2RAD(atof(argv[++i]));
+			longitude_rad = DEG2RAD(atof(argv[++i]));
+			home_given = 1;
+		}
+		else if (strcmp(argv[i], "-v") == 0)
+			verbose = 1;
+		else if (plan_file == NULL)
+			plan_file = argv[i];
+		else
+			script_file = argv[i];
+	}
+	if (plan_file == NULL)
+	{
+		fprintf(stderr, "usage: gluonscript_check [-t seconds] [-home latitude longitude] [-v] plan [script]\n");
+		return 2;
+	}
+
+	host_init(latitude_rad, longitude_rad);
+	if (!load_plan(plan_file) || (script_file != NULL && !load_script(script_file)))
+		return 2;
+
+	for (line = 0; line < lines && !home_given; line++)
+		if (plan[line].opcode == FROM_TO_ABS || plan[line].opcode == FLY_TO_ABS || plan[line].opcode == CIRCLE_ABS ||
+		    plan[line].opcode == CIRCLE_TO_ABS || plan[line].opcode == FLARE_TO_ABS || plan[line].opcode == GLIDE_TO_ABS)
+		{
+			host_init(plan[line].x, plan[line].y);
+			break;
+		}
+
+	analyse_reachability();
+	analyse_calls();
+	analyse_loops();
+
+	fly(seconds);
+	report_coverage();
+
+	printf("%d error(s), %d warning(s)\n", errors, warnings);
+	return errors > 0;
+}
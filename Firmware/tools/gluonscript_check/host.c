@@ -0,0 +1,246 @@
+/*!
+ *  Host side of gluonscript_check.
+ *
+ *  Everything the gluonscript code links against outside of gluonscript.c and
+ *  its handlers: the flightplan pages of the dataflash (in memory), the
+ *  servos, the RC receiver, the OSD messages and the sensors, fed by a simple
+ *  fixed-wing model that flies what navigation asks for: a coordinated turn
+ *  with a first order roll and pitch controller in front of it instead of
+ *  task_control. mission_campaign links the real task_control.c
+ *  (-DHOST_TASK_CONTROL) and flies the 6-DOF model of its aircraft.c
+ *  instead of host_step.
+ *
+ *  @file     host.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+
+#include "servo/servo.h"
+#include "ppm_in/ppm_in.h"
+#include "dataflash/dataflash.h"
+
+#include "common.h"
+#include "sensors.h"
+#include "configuration.h"
+#include "task_control.h"
+#include "handler_navigation.h"
+
+#include "host.h"
+
+#define FLASH_PAGE_SIZE 528
+
+struct HostEnvironment host_environment = { .wind_north_ms = 0.0f, .wind_east_ms = 0.0f, .battery_v = 12.6f, .gps_lost = 0,
+                                            .gps_error_north_m = 0.0f, .gps_error_east_m = 0.0f };
+unsigned long host_flash_reads = 0;
+
+struct Configuration config;
+struct SensorData sensor_data;
+#ifndef HOST_TASK_CONTROL
+struct ControlState control_state;
+#endif
+volatile struct ppm_info ppm;
+xSemaphoreHandle xSpiSemaphore;
+xSemaphoreHandle xGpsSemaphore = NULL;   // watch_check() wakes the GPS task with it
+
+extern float latitude_meter_per_radian;
+
+
+/*!
+ *   Aircraft state
+ */
+static struct
+{
+	double latitude_rad;
+	double longitude_rad;
+	float altitude_m;
+	float heading_rad;
+	float roll, pitch;
+} model;
+
+
+/*
+ *   Dataflash: only the flightplan pages, NAVIGATION_PAGE is 0.
+ */
+int NAVIGATION_PAGE = 0;
+
+static unsigned char flash[NAVIGATION_PAGES][FLASH_PAGE_SIZE];
+
+static void host_flash_open()
+{
+}
+
+static void host_flash_read(int page, int size, unsigned char *buffer)
+{
+	host_flash_reads++;
+	memcpy(buffer, flash[page - NAVIGATION_PAGE], MIN(size, FLASH_PAGE_SIZE));
+}
+
+static void host_flash_write(int page, int size, unsigned char *buffer)
+{
+	memcpy(flash[page - NAVIGATION_PAGE], buffer, MIN(size, FLASH_PAGE_SIZE));
+}
+
+static int host_flash_read_Mbit()
+{
+	return 4;
+}
+
+// the raw chip operations are only used by the FTL, which isn't part of the check
+struct Dataflash dataflash = {
+	.open = host_flash_open,
+	.read = host_flash_read,
+	.write = host_flash_write,
+	.read_Mbit = host_flash_read_Mbit
+};
+
+
+/*
+ *   Servos, only remembered for servo_read_us.
+ */
+static unsigned int servo_us[8] = { 1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500 };
+
+void servo_set_us(int servo, unsigned int us)
+{
+	if (servo >= 0 && servo < 8)
+		servo_us[servo] = us;
+}
+
+unsigned int servo_read_us(int channel)
+{
+	return (channel >= 0 && channel < 8) ? servo_us[channel] : 1500;
+}
+
+void servo_set_logical_0(int servo)
+{
+	servo_set_us(servo, 0);
+}
+
+void servo_set_logical_1(int servo)
+{
+	servo_set_us(servo, 2500);
+}
+
+
+/*
+ *   Camera events, geotag.c isn't part of the check.
+ */
+void geotag_trigger()
+{
+}
+
+
+void osd_post_message(char *str, int blink)
+{
+	(void)blink;
+	printf("OSD message: %s\n", str);
+}
+
+
+/*!
+ *   Defaults of configuration.c, the aircraft sits at the given position with
+ *   its engine running.
+ */
+void host_init(double latitude_rad, double longitude_rad)
+{
+	int i;
+
+	memset(&config, 0, sizeof(config));
+	config.control.cruising_speed_ms = 12;
+	config.control.max_pitch = 20.0/180.0*3.14;
+	config.control.min_pitch = -10.0/180.0*3.14;
+	config.control.max_roll = 40.0/180.0*3.14;
+	config.control.waypoint_radius_m = 30;
+	config.control.altitude_mode = PRESSURE;
+
+	ppm.connection_alive = 1;
+	ppm.valid_frame = 1;
+	for (i = 0; i < 8; i++)
+		ppm.channel[i] = 1500;
+
+	memset(&model, 0, sizeof(model));
+	model.latitude_rad = latitude_rad;
+	model.longitude_rad = longitude_rad;
+	host_step(0.0f);
+}
+
+
+/*!
+ *   Integrates the aircraft model over dt seconds and updates the sensors.
+ */
+void host_step(float dt)
+{
+	float airspeed = (float)config.control.cruising_speed_ms;
+	float heading_error = navigation_data.desired_heading_rad - model.heading_rad;
+	float east_meter_per_radian = latitude_meter_per_radian * cosf((float)model.latitude_rad);
+	float v_north, v_east;
+
+	if (heading_error > PI)
+		heading_error -= 2.0f * PI;
+	else if (heading_error < -PI)
+		heading_error += 2.0f * PI;
+
+	// what the control loop would ask
+	control_state.desired_altitude = navigation_data.desired_altitude_agl;
+	control_state.desired_roll = heading_error + navigation_data.desired_pre_bank;
+	control_state.desired_pitch = (control_state.desired_altitude - model.altitude_m) * 0.05f;
+
+	// attitude follows the desired attitude (first order)
+	model.roll += (BIND(control_state.desired_roll, -config.control.max_roll, config.control.max_roll) - model.roll) * dt / 0.5f;
+	model.pitch += (BIND(control_state.desired_pitch, config.control.min_pitch, config.control.max_pitch) - model.pitch) * dt / 0.7f;
+
+	// coordinated turn
+	model.heading_rad += G / airspeed * tanf(model.roll) * dt;
+	if (model.heading_rad < 0.0f)
+		model.heading_rad += 2.0f * PI;
+	else if (model.heading_rad >= 2.0f * PI)
+		model.heading_rad -= 2.0f * PI;
+
+	v_north = airspeed * cosf(model.pitch) * cosf(model.heading_rad) + host_environment.wind_north_ms;
+	v_east = airspeed * cosf(model.pitch) * sinf(model.heading_rad) + host_environment.wind_east_ms;
+
+	model.latitude_rad += v_north * dt / latitude_meter_per_radian;
+	model.longitude_rad += v_east * dt / east_meter_per_radian;
+	model.altitude_m += airspeed * sinf(model.pitch) * dt;
+	if (model.altitude_m < 0.0f)
+		model.altitude_m = 0.0f;
+
+	sensor_data.roll = model.roll;
+	sensor_data.pitch = model.pitch;
+	sensor_data.yaw = model.heading_rad;
+	sensor_data.pressure_height = model.altitude_m;
+	sensor_data.vertical_speed = airspeed * sinf(model.pitch);
+	sensor_data.battery1_voltage_10 = (unsigned int)MAX(host_environment.battery_v * 10.0f + 0.5f, 0.0f);
+	if (host_environment.gps_lost)
+	{
+		sensor_data.gps.satellites_in_view = 0;
+		sensor_data.gps.status = VOID;
+	}
+	else
+	{
+		sensor_data.gps.satellites_in_view = 9;
+		sensor_data.gps.status = ACTIVE;
+		sensor_data.gps.latitude_rad = model.latitude_rad + host_environment.gps_error_north_m / latitude_meter_per_radian;
+		sensor_data.gps.longitude_rad = model.longitude_rad + host_environment.gps_error_east_m / east_meter_per_radian;
+		sensor_data.gps.speed_ms = sqrtf(v_north*v_north + v_east*v_east);
+		sensor_data.gps.heading_rad = atan2f(v_east, v_north);
+		if (sensor_data.gps.heading_rad < 0.0f)
+			sensor_data.gps.heading_rad += 2.0f * PI;
+		sensor_data.gps.height_m = (int)model.altitude_m;
+	}
+}
+
+
+/*!
+ *   The true position of the aircraft, the GPS can be off or lost.
+ */
+void host_position(double *latitude_rad, double *longitude_rad)
+{
+	*latitude_rad = model.latitude_rad;
+	*longitude_rad = model.longitude_rad;
+}
@@ -0,0 +1,29 @@
+/*!
+ *  Host side of gluonscript_check: replaces the hardware, the other tasks
+ *  and the aircraft around the gluonscript code.
+ *
+ *  @file     host.h
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+//! Environment, changed by the script file.
+struct HostEnvironment
+{
+	float wind_north_ms, wind_east_ms;
+	float battery_v;
+	int gps_lost;
+	float gps_error_north_m, gps_error_east_m;   //!< added to the GPS position
+};
+
+extern struct HostEnvironment host_environment;
+extern unsigned long host_flash_reads;     //!< flightplan pages read from the (fake) flash
+
+void host_init(double latitude_rad, double longitude_rad);
+void host_step(float dt);
+void host_position(double *latitude_rad, double *longitude_rad);
+
+#endif // HOST_H
@@ -0,0 +1,233 @@
+/*!
+ *  Model of the AT45DB161D dataflash: 4096 pages of 528 bytes and the two
+ *  SRAM buffers, with the commands of dataflash.c and dataflash_ftl.c.
+ *
+ *  A command starts when the chip select falls: the opcode, three address
+ *  bytes (page << 10 | byte), the don't care bytes of the reads and then
+ *  the data. The page operations run when the chip select rises. After a
+ *  program the chip is busy for at45db_program_polls status reads and
+ *  ignores every other command, like the real one. A page marked bad loses
+ *  a bit on every program, which the compare of the FTL has to catch.
+ *
+ *  @file     at45db.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_test.h"
+
+#define STATUS_READY 0x80
+#define STATUS_COMPARE 0x40
+#define STATUS_DENSITY 0x2C         //!< 16Mbit, 528 byte pages
+
+struct At45dbStatistics at45db_statistics;
+int at45db_program_polls = 0;
+
+static unsigned char *memory;
+static unsigned char buffer[2][AT45DB_PAGE_SIZE];
+static unsigned char bad[AT45DB_PAGES];
+static const unsigned char id[] = { 0x1F, 0x26, 0x00, 0x01, 0x00 };   // Atmel, DataFlash 16Mbit
+
+static int received;                //!< bytes of the current command
+static unsigned char opcode;
+static unsigned long address;
+static int page, offset;            //!< position of the data
+static int busy;
+static int compare_differs;
+
+
+void at45db_init()
+{
+	if (memory == NULL)
+		memory = malloc((size_t)AT45DB_PAGES * AT45DB_PAGE_SIZE);
+	memset(memory, 0xFF, (size_t)AT45DB_PAGES * AT45DB_PAGE_SIZE);
+	memset(buffer, 0xFF, sizeof(buffer));
+	memset(bad, 0, sizeof(bad));
+	memset(&at45db_statistics, 0, sizeof(at45db_statistics));
+	at45db_program_polls = 0;
+	busy = 0;
+	compare_differs = 0;
+	received = 0;
+}
+
+
+static unsigned char *page_memory(int p)
+{
+	return &memory[(size_t)p * AT45DB_PAGE_SIZE];
+}
+
+
+/*!
+ *   The contents of a page, after the command in progress ran: the driver
+ *   released the chip select with its last write.
+ */
+unsigned char *at45db_page(int p)
+{
+	host_sfr_sync();
+	return page_memory(p);
+}
+
+
+void at45db_set_bad(int p, int is_bad)
+{
+	bad[p] = (unsigned char)is_bad;
+}
+
+
+static unsigned char status()
+{
+	unsigned char s = STATUS_DENSITY | (compare_differs ? STATUS_COMPARE : 0);
+
+	if (busy > 0)
+	{
+		busy--;
+		at45db_statistics.busy_polls++;
+		return s;
+	}
+	return s | STATUS_READY;
+}
+
+
+//! Bytes between the opcode and the data, 0 for the commands without data.
+static int header(unsigned char op)
+{
+	switch (op)
+	{
+		case 0xE8: case 0xD2:               // legacy continuous read, page read
+			return 7;
+		case 0x0B: case 0xD4: case 0xD6:    // continuous read, buffer reads
+			return 4;
+		case 0x03: case 0xD1: case 0xD3:    // the low frequency reads
+		case 0x84: case 0x87:               // buffer writes
+			return 3;
+		default:
+			return 0;
+	}
+}
+
+
+static unsigned char read_data()
+{
+	unsigned char c;
+
+	switch (opcode)
+	{
+		case 0xD4: case 0xD1:
+			c = buffer[0][offset];
+			offset = (offset + 1) % AT45DB_PAGE_SIZE;
+			return c;
+		case 0xD6: case 0xD3:
+			c = buffer[1][offset];
+			offset = (offset + 1) % AT45DB_PAGE_SIZE;
+			return c;
+		case 0xD2:                          // wraps within the page
+			c = page_memory(page)[offset];
+			offset = (offset + 1) % AT45DB_PAGE_SIZE;
+			return c;
+		default:                            // continuous: on to the next page
+			c = page_memory(page)[offset];
+			if (++offset == AT45DB_PAGE_SIZE)
+			{
+				offset = 0;
+				page = (page + 1) % AT45DB_PAGES;
+			}
+			return c;
+	}
+}
+
+
+static void at45db_select()
+{
+	received = 0;
+}
+
+
+static unsigned char at45db_byte(unsigned char in)
+{
+	int n = received++;
+
+	if (n == 0)
+	{
+		opcode = in;
+		address = 0;
+		if (busy > 0 && opcode != 0xD7)
+			at45db_statistics.ignored++;
+	}
+	if (busy > 0 && opcode != 0xD7)
+		return 0xFF;
+	if (opcode == 0xD7)
+		return status();
+	if (opcode == 0x9F)
+		return n < (int)sizeof(id) ? id[n] : 0x00;
+
+	if (n >= 1 && n <= 3)
+	{
+		address = (address << 8) | in;
+		page = (int)(address >> 10) & (AT45DB_PAGES - 1);
+		offset = (int)(address & 0x3FF) % AT45DB_PAGE_SIZE;
+	}
+	if (n >= 4 && (opcode == 0x84 || opcode == 0x87))
+	{
+		buffer[opcode == 0x87][offset] = in;
+		offset = (offset + 1) % AT45DB_PAGE_SIZE;
+	}
+	else if (header(opcode) > 0 && opcode != 0x84 && opcode != 0x87 && n >= header(opcode))
+		return read_data();
+	return 0xFF;
+}
+
+
+static void program(int b)
+{
+	memcpy(page_memory(page), buffer[b], AT45DB_PAGE_SIZE);
+	if (bad[page])
+		page_memory(page)[17] ^= 0x01;
+	at45db_statistics.programs++;
+	busy = at45db_program_polls;
+}
+
+
+/*!
+ *   Runs the page operations.
+ */
+static void at45db_deselect()
+{
+	int i;
+
+	if (received < 4 || (busy > 0 && opcode != 0xD7))
+		return;
+	switch (opcode)
+	{
+		case 0x83: case 0x86:               // buffer to page with erase
+			program(opcode == 0x86);
+			break;
+		case 0x88: case 0x89:               // without erase: bits only go from 1 to 0
+			for (i = 0; i < AT45DB_PAGE_SIZE; i++)
+				buffer[opcode == 0x89][i] &= page_memory(page)[i];
+			program(opcode == 0x89);
+			break;
+		case 0x53: case 0x55:               // page to buffer
+			memcpy(buffer[opcode == 0x55], page_memory(page), AT45DB_PAGE_SIZE);
+			break;
+		case 0x60: case 0x61:               // compare page to buffer
+			compare_differs = memcmp(buffer[opcode == 0x61], page_memory(page), AT45DB_PAGE_SIZE) != 0;
+			at45db_statistics.compares++;
+			break;
+		case 0x58: case 0x59:               // auto page rewrite
+			memcpy(buffer[opcode == 0x59], page_memory(page), AT45DB_PAGE_SIZE);
+			program(opcode == 0x59);
+			at45db_statistics.programs--;
+			at45db_statistics.rewrites++;
+			break;
+		case 0x81:                          // page erase
+			memset(page_memory(page), 0xFF, AT45DB_PAGE_SIZE);
+			busy = at45db_program_polls;
+			break;
+	}
+}
+
+
+const struct HostSpiSlave at45db_spi = { at45db_select, at45db_deselect, at45db_byte };
@@ -0,0 +1,147 @@
+/*!
+ *  Model of the BMP085 on I2C1: the calibration words of the datasheet
+ *  example, the control register 0xF4 that starts a conversion and the
+ *  result registers 0xF6..0xF8. A conversion takes the time of the
+ *  datasheet; the result registers keep the previous result until then.
+ *
+ *  @file     bmp085_model.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <string.h>
+
+#include "host_test.h"
+
+#define CONTROL 0xF4
+#define RESULT 0xF6
+#define TEMPERATURE 0x2E
+#define PRESSURE 0x34
+
+//! AC1..AC6, B1, B2, MB, MC, MD
+static const long calibration[11] = { 408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868 };
+
+int bmp085_model_early_reads;
+
+static unsigned char registers[256];
+static unsigned int ut;
+static long up;                         //!< at oversampling 3
+static int command;                     //!< of the conversion in progress, 0: none
+static unsigned long done_us;
+
+static int first_write;
+static int pointer;
+
+
+void bmp085_model_init()
+{
+	int i;
+
+	memset(registers, 0, sizeof(registers));
+	for (i = 0; i < 11; i++)
+	{
+		registers[0xAA + 2*i] = (unsigned char)((calibration[i] >> 8) & 0xFF);
+		registers[0xAB + 2*i] = (unsigned char)(calibration[i] & 0xFF);
+	}
+	registers[0xD0] = 0x55;             // chip id
+	ut = 0;
+	up = 0;
+	command = 0;
+	bmp085_model_early_reads = 0;
+}
+
+
+/*!
+ *   The raw values the next conversions give: ut and up of the datasheet,
+ *   up with the 19 bits of oversampling 3.
+ */
+void bmp085_model_set(unsigned int t, long p)
+{
+	ut = t;
+	up = p;
+}
+
+
+static void convert()
+{
+	long value;
+	int oss;
+
+	if (command == 0 || host_time_us < done_us)
+		return;
+	if (command == TEMPERATURE)
+		value = (long)ut << 8;
+	else
+	{
+		oss = command >> 6;
+		value = (up >> (3 - oss)) << (8 - oss);
+	}
+	registers[RESULT] = (unsigned char)(value >> 16);
+	registers[RESULT + 1] = (unsigned char)(value >> 8);
+	registers[RESULT + 2] = (unsigned char)value;
+	registers[CONTROL] &= ~0x20;        // SCO: conversion complete
+	command = 0;
+}
+
+
+static void start_conversion(unsigned char c)
+{
+	static const unsigned long pressure_us[4] = { 4500, 7500, 13500, 25500 };
+
+	if (c == TEMPERATURE)
+		done_us = host_time_us + 4500;
+	else if ((c & 0x3F) == PRESSURE)
+		done_us = host_time_us + pressure_us[c >> 6];
+	else
+		return;
+	command = c;
+	registers[CONTROL] = c | 0x20;
+}
+
+
+static void bmp085_model_start()
+{
+	first_write = 1;
+}
+
+
+static int bmp085_model_write(unsigned char byte)
+{
+	if (first_write)
+	{
+		first_write = 0;
+		pointer = byte;
+	}
+	else
+	{
+		if (pointer == CONTROL)
+			start_conversion(byte);
+		else
+			registers[pointer] = byte;
+		pointer = (pointer + 1) & 0xFF;
+	}
+	return 1;
+}
+
+
+static unsigned char bmp085_model_read()
+{
+	unsigned char value;
+
+	convert();
+	if (pointer >= RESULT && pointer <= RESULT + 2 && command != 0)
+		bmp085_model_early_reads++;
+	value = registers[pointer];
+	pointer = (pointer + 1) & 0xFF;
+	return value;
+}
+
+
+static void bmp085_model_stop()
+{
+}
+
+
+const struct HostI2cSlave bmp085_model_i2c = {
+	0xEE, bmp085_model_start, bmp085_model_write, bmp085_model_read, bmp085_model_stop
+};
@@ -0,0 +1,942 @@
+/*!
+ *  host_test: unit tests of the lib drivers on the host, on fake registers.
+ *
+ *  host_test [-bench [-n iterations]]
+ *
+ *  The drivers are compiled unchanged against p33FJ256MC710.h of this
+ *  directory: the registers they poll are backed by models of the dataflash
+ *  (at45db.c), the MPU6000 (mpu6000_model.c), the SCP1000 (scp1000_model.c),
+ *  the BMP085 (bmp085_model.c), the uarts (uart_source.c) and the RC
+ *  receiver in PPM (ppm_source.c) and PWM mode (pwm_source.c); sfr.c has
+ *  the SPI2, I2C1 and output compare modules. The FreeRTOS calls come from
+ *  the stubs of tools/gluonscript_check. Every test prints a line, a failed
+ *  check prints the expression and its line. With -bench the hot functions
+ *  are timed afterwards. Exits with 1 when a check failed.
+ *
+ *  Build from Firmware/ (or make -C tools test):
+ *    gcc -std=gnu99 -fgnu89-inline -O2 -Wall -Wextra -o host_test -Itools/host_test \
+ *        -Itools/gluonscript_check -Ilib -Irtos_pilot tools/host_test/host_test.c \
+ *        tools/host_test/sfr.c tools/host_test/at45db.c tools/host_test/mpu6000_model.c \
+ *        tools/host_test/scp1000_model.c tools/host_test/bmp085_model.c \
+ *        tools/host_test/uart_source.c tools/host_test/ppm_source.c tools/host_test/pwm_source.c \
+ *        lib/gps/gps.c lib/ppm_in/ppm_in.c lib/pwm_in/pwm_in.c lib/servo/servo.c \
+ *        lib/matrix/matrix.c lib/i2c/i2c.c lib/bmp085/bmp085.c lib/scp1000/scp1000.c \
+ *        lib/dataflash/dataflash.c lib/dataflash/dataflash_ftl.c \
+ *        lib/mpu6000/mpu6000.c lib/pid/pid.c lib/quaternion/quaternion.c \
+ *        lib/uart1_queue/uart1_queue.c lib/fastmath/fastmath.c -lm
+ *
+ *  @file     host_test.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "microcontroller/microcontroller.h"
+#include "gps/gps.h"
+#include "ppm_in/ppm_in.h"
+#include "pwm_in/pwm_in.h"
+#include "servo/servo.h"
+#include "matrix/matrix.h"
+#include "i2c/i2c.h"
+#include "bmp085/bmp085.h"
+#include "scp1000/scp1000.h"
+#include "dataflash/dataflash.h"
+#include "dataflash/dataflash_ftl.h"
+#include "mpu6000/mpu6000.h"
+#include "pid/pid.h"
+#include "quaternion/quaternion.h"
+#include "uart1_queue/uart1_queue.h"
+#include "configuration.h"
+
+#include "host_test.h"
+
+#define CHECK(condition) check((condition) != 0, __LINE__, #condition)
+#define CHECK_NEAR(a, b, tolerance) check(fabs((double)(a) - (double)(b)) <= (tolerance), __LINE__, #a " == " #b)
+
+//! Defined by the tasks of rtos_pilot in the firmware.
+int HARDWARE_VERSION = V01O;
+xSemaphoreHandle xGpsSemaphore;
+
+static const char *test_name;
+static int test_failures;
+static int failures;
+static volatile float sink;
+
+
+static void check(int ok, int line, const char *what)
+{
+	if (ok)
+		return;
+	printf("  FAIL %s, line %d: %s\n", test_name, line, what);
+	test_failures++;
+}
+
+
+/*!
+ *   Sends what the drivers print to stdout into a file, until
+ *   capture_stop().
+ */
+static FILE *capture_file;
+static int capture_stdout = -1;
+
+static void capture_start()
+{
+	fflush(stdout);
+	capture_file = tmpfile();
+	capture_stdout = dup(fileno(stdout));
+	if (capture_file != NULL && capture_stdout >= 0)
+		dup2(fileno(capture_file), fileno(stdout));
+}
+
+
+/*!
+ *   @return the captured output in buffer, as a string
+ */
+static char *capture_stop(char *buffer, int max)
+{
+	size_t n = 0;
+
+	fflush(stdout);
+	if (capture_stdout >= 0)
+	{
+		dup2(capture_stdout, fileno(stdout));
+		close(capture_stdout);
+		capture_stdout = -1;
+	}
+	if (capture_file != NULL)
+	{
+		rewind(capture_file);
+		n = fread(buffer, 1, max - 1, capture_file);
+		fclose(capture_file);
+		capture_file = NULL;
+	}
+	buffer[n] = '\0';
+	return buffer;
+}
+
+
+static void run(const char *name, void (*test)())
+{
+	test_name = name;
+	test_failures = 0;
+	host_sfr_reset();
+	test();
+	printf("%-24s %s\n", name, test_failures == 0 ? "ok" : "FAILED");
+	failures += test_failures > 0;
+}
+
+
+/*
+ *  gps.c
+ */
+
+//! Sends "$body*checksum\r\n" to the gps uart.
+static void nmea_send(const char *body)
+{
+	unsigned char sentence[128];
+	unsigned char checksum = 0;
+	const char *c;
+	int n;
+
+	for (c = body; *c != '\0'; c++)
+		checksum ^= (unsigned char)*c;
+	n = snprintf((char*)sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+	host_uart_receive(2, sentence, n);
+}
+
+
+static void test_gps()
+{
+	struct GpsConfig config = { 38400L, 115200L, 0 };
+	struct gps_info info;
+	double latitude = (50.0 + 51.0242 / 60.0) * M_PI / 180.0;
+	double longitude = (3.0 + 40.1555 / 60.0) * M_PI / 180.0;
+	unsigned char bad[] = "$GPRMC,110918.000,A,5051.0242,N,00340.1555,E,12.5,271.3,150810,,,A*00\r\n";
+
+	gps_open_port(&config);
+	CHECK(IEC1bits.U2RXIE == 1);
+
+	memset(&info, 0, sizeof(info));
+	nmea_send("GPGGA,110917.000,5051.0242,N,00340.1555,E,1,7,1.16,41.5,M,47.3,M,,");
+	CHECK(gps_update_info(&info) == 0);      // GGA: no fix yet
+	nmea_send("GPRMC,110917.000,A,5051.0242,N,00340.1555,E,12.5,271.3,150810,,,A");
+	CHECK(gps_update_info(&info) == 1);
+	CHECK(info.status == ACTIVE);
+	CHECK(info.time == 110917L);
+	CHECK(info.date == 150810L);
+	CHECK(info.satellites_in_view == 7);
+	CHECK(info.height_m == 41);
+	CHECK_NEAR(info.latitude_rad, latitude, 1e-7);
+	CHECK_NEAR(info.longitude_rad, longitude, 1e-7);
+	CHECK_NEAR(info.speed_ms, 12.5 * 0.514444, 0.01);
+	CHECK_NEAR(info.heading_rad, 271.3 * M_PI / 180.0, 1e-4);
+	CHECK(gps_update_info(&info) == 0);      // nothing new
+
+	// a wrong checksum: the sentence is dropped
+	host_uart_receive(2, bad, (int)strlen((char*)bad));
+	CHECK(gps_update_info(&info) == 0);
+	CHECK(info.time == 110917L);
+
+	// southern and western hemisphere
+	nmea_send("GPRMC,110919.000,A,3352.1280,S,15112.5790,W,0.0,0.0,150810,,,A");
+	CHECK(gps_update_info(&info) == 1);
+	CHECK(info.time == 110919L);
+	CHECK_NEAR(info.latitude_rad, -(33.0 + 52.128 / 60.0) * M_PI / 180.0, 1e-7);
+	CHECK_NEAR(info.longitude_rad, -(151.0 + 12.579 / 60.0) * M_PI / 180.0, 1e-7);
+
+	// no fix
+	nmea_send("GPRMC,110920.000,V,3352.1280,S,15112.5790,W,0.0,0.0,150810,,,N");
+	gps_update_info(&info);
+	CHECK(info.status == VOID);
+}
+
+
+/*
+ *  ppm_in.c
+ */
+
+static const unsigned int ppm_channels[8] = { 1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800 };
+
+static void ppm_ticks(int ticks)
+{
+	while (ticks-- > 0)
+	{
+		microcontroller_delay_ms(20);
+		ppm_in_update_status_ticks_50hz();
+	}
+}
+
+
+static void test_ppm()
+{
+	unsigned int channels[8];
+	char output[64];
+	int i;
+
+	ppm_source_set(ppm_channels, 8, 22500);
+	capture_start();
+	ppm_in_open();
+	// the sync gap is counted as a channel
+	CHECK(strcmp(capture_stop(output, sizeof(output)), "channels: 9") == 0);
+	CHECK(ppm.valid_frame);
+
+	ppm_ticks(30);
+	CHECK(ppm.connection_alive);
+	for (i = 0; i < 8; i++)
+		CHECK_NEAR(ppm.channel[i], ppm_channels[i], 2);
+
+	// a pulse out of range invalidates the frame, the last channels stay
+	memcpy(channels, ppm_channels, sizeof(channels));
+	channels[3] = 2600;
+	ppm_source_set(channels, 8, 22500);
+	microcontroller_delay_ms(100);
+	CHECK(! ppm.valid_frame);
+	CHECK_NEAR(ppm.channel[3], 1400, 2);
+
+	// a frame with a channel less isn't taken either
+	ppm_source_set(ppm_channels, 7, 22500);
+	microcontroller_delay_ms(100);
+	CHECK(! ppm.valid_frame);
+
+	// back, then lost
+	ppm_source_set(ppm_channels, 8, 22500);
+	ppm_ticks(30);
+	CHECK(ppm.valid_frame);
+	CHECK(ppm.connection_alive);
+	ppm_source_set(NULL, 0, 0);
+	ppm_ticks(10);
+	CHECK(ppm.connection_alive);            // not yet: 500ms
+	ppm_ticks(20);
+	CHECK(! ppm.connection_alive);
+}
+
+
+/*
+ *  pwm_in.c
+ */
+
+//! On IC1..IC6, which are the channels 1, 2, 3, 0, 5 and 4.
+static const unsigned int pwm_pulses[6] = { 1100, 1200, 1300, 1400, 1500, 1600 };
+
+
+static void test_pwm_in()
+{
+	unsigned int pulses[6];
+	unsigned long start;
+
+	pwm_source_set(pwm_pulses, 6);
+	pwm_in_open();
+	CHECK(INTCON2bits.ALTIVT == 0);
+	start = host_time_us;
+	pwm_in_wait_for();
+	CHECK(host_time_us - start < 100000UL);
+
+	// the timer runs free: some pulses span its overflow, which costs a tick
+	microcontroller_delay_ms(100);
+	CHECK(ppm.valid_frame);
+	CHECK_NEAR(ppm.channel[1], 1100, 1);
+	CHECK_NEAR(ppm.channel[2], 1200, 1);
+	CHECK_NEAR(ppm.channel[3], 1300, 1);
+	CHECK_NEAR(ppm.channel[0], 1400, 1);
+	CHECK_NEAR(ppm.channel[5], 1500, 1);
+	CHECK_NEAR(ppm.channel[4], 1600, 1);
+
+	// a pulse out of range is dropped
+	memcpy(pulses, pwm_pulses, sizeof(pulses));
+	pulses[5] = 2500;
+	pwm_source_set(pulses, 6);
+	microcontroller_delay_ms(100);
+	CHECK(! ppm.valid_frame);
+	CHECK_NEAR(ppm.channel[4], 1600, 1);
+
+	pwm_source_set(NULL, 0);
+}
+
+
+/*
+ *  servo.c
+ */
+
+static void test_servo()
+{
+	int i;
+
+	servo_init();
+	CHECK(PR2 == FCY/50/64);                // 20ms of 1.6us
+	for (i = 0; i < 8; i++)
+		servo_set_us(i, 1000 + 100 * i);
+	for (i = 0; i < 8; i++)
+	{
+		CHECK_NEAR(host_oc_pulse_us(i + 1), 1000 + 100 * i, 1.6);
+		CHECK_NEAR(servo_read_us(i), 1000 + 100 * i, 2);
+	}
+	servo_set_us(8, 1000);                  // no such servo
+	CHECK(servo_read_us(8) == 0);
+
+	servo_all_neutral();
+	for (i = 0; i < 8; i++)
+		CHECK_NEAR(host_oc_pulse_us(i + 1), 1500, 1.6);
+	servo_set_ms(2, 1.25f);
+	CHECK_NEAR(host_oc_pulse_us(3), 1250, 1.6);
+
+	// a trigger output: the pin instead of the pulses
+	servo_set_logical_1(5);
+	CHECK(host_oc_pulse_us(6) == 0.0f);
+	CHECK((TRISD & (1 << 5)) == 0);
+	CHECK(PORTD & (1 << 5));
+	servo_set_logical_0(5);
+	CHECK((PORTD & (1 << 5)) == 0);
+	CHECK_NEAR(host_oc_pulse_us(5), 1500, 1.6);
+}
+
+
+/*
+ *  matrix.h and matrix.c
+ */
+
+//! r (n x p) = a (n x m) * b (m x p), or * transposed b when b is p x m.
+static void multiply(const float *a, const float *b, float *r, int n, int m, int p, int transposed)
+{
+	int i, j, k;
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < p; j++)
+		{
+			r[i * p + j] = 0.0f;
+			for (k = 0; k < m; k++)
+				r[i * p + j] += a[i * m + k] * (transposed ? b[j * m + k] : b[k * p + j]);
+		}
+}
+
+
+static int matrix_equal(const float *a, const float *b, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (fabs(a[i] - b[i]) > 1e-5 * (1.0 + fabs(b[i])))
+			return 0;
+	return 1;
+}
+
+
+static void test_matrix()
+{
+	float a[9] = { 2.0f, -1.0f, 0.0f, -1.0f, 2.0f, -1.0f, 0.0f, -1.0f, 2.0f };
+	const float inverse[9] = { 0.75f, 0.5f, 0.25f, 0.5f, 1.0f, 0.5f, 0.25f, 0.5f, 0.75f };
+	float b[9] = { 0.5f, 1.5f, -2.0f, 3.0f, 0.25f, -1.0f, 4.0f, 2.0f, 1.0f };
+	float r[9], expected[9], d;
+
+	DETERMINANT_3X3(d, a);
+	CHECK_NEAR(d, 4.0, 1e-6);
+	INVERT_3X3(r, d, a);
+	CHECK(matrix_equal(r, inverse, 9));
+
+	matrix_2x2_mul(a, b, r);
+	multiply(a, b, expected, 2, 2, 2, 0);
+	CHECK(matrix_equal(r, expected, 4));
+	matrix_2x2_mul_transp(a, b, r);
+	multiply(a, b, expected, 2, 2, 2, 1);
+	CHECK(matrix_equal(r, expected, 4));
+	matrix_2x3_times_3x3(a, b, r);
+	multiply(a, b, expected, 2, 3, 3, 0);
+	CHECK(matrix_equal(r, expected, 6));
+	matrix_2x3_times_3x2(a, b, r);
+	multiply(a, b, expected, 2, 3, 2, 0);
+	CHECK(matrix_equal(r, expected, 4));
+	matrix_3x2_times_2x2(a, b, r);
+	multiply(a, b, expected, 3, 2, 2, 0);
+	CHECK(matrix_equal(r, expected, 6));
+	matrix_3x2_times_3x2_transp(a, b, r);
+	multiply(a, b, expected, 3, 2, 3, 1);
+	CHECK(matrix_equal(r, expected, 9));
+	matrix_2x2_times_3x2_transp(a, b, r);
+	multiply(a, b, expected, 2, 2, 3, 1);
+	CHECK(matrix_equal(r, expected, 6));
+
+	CHECK(matrix_3x3_add(a, b, r) == r);
+	CHECK(r[0] == 2.5f && r[4] == 2.25f && r[8] == 3.0f);
+	matrix_2x2_add(a, b, r);
+	CHECK(r[0] == 2.5f && r[3] == 2.0f);
+}
+
+
+/*
+ *  bmp085.c over i2c.c
+ */
+
+#define BMP085_UT 27898                 //!< the datasheet example: 15.0C
+#define BMP085_UP (23843L << 3)         //!< and 69964Pa, at oversampling 3
+#define BMP085_PRESSURE 69963L          //!< of the datasheet algorithm, at oversampling 3
+
+
+static void test_bmp085()
+{
+	int temperature_10 = 0, updates = 0, i;
+	long raw, pressure = 0;
+
+	bmp085_model_init();
+	bmp085_model_set(BMP085_UT, BMP085_UP);
+	i2c_init();
+	i2c_errors = 0;
+	bmp085_init();
+
+	// blocking
+	bmp085_start_convert_temp();
+	microcontroller_delay_ms(5);
+	raw = bmp085_read_temp();
+	CHECK(raw == BMP085_UT);
+	bmp085_convert_temp(raw, &temperature_10);
+	CHECK(temperature_10 == 150);
+	bmp085_start_convert_pressure();
+	microcontroller_delay_ms(26);
+	raw = bmp085_read_pressure();
+	CHECK(raw == BMP085_UP);
+	bmp085_convert_pressure(raw, &pressure);
+	CHECK(pressure == BMP085_PRESSURE);
+
+	// interrupt driven, at 10Hz: every result is read after its conversion
+	temperature_10 = 0;
+	pressure = 0;
+	for (i = 0; i < 10; i++)
+	{
+		updates += bmp085_update(&temperature_10, &pressure);
+		microcontroller_delay_ms(100);
+		i2c_watchdog();
+	}
+	CHECK(updates == 4);
+	CHECK(temperature_10 == 150);
+	CHECK(pressure == BMP085_PRESSURE);
+	CHECK(bmp085_model_early_reads == 0);
+	CHECK(i2c_errors == 0);
+}
+
+
+/*
+ *  scp1000.c
+ */
+
+static void test_scp1000()
+{
+	host_sfr_set_rg9_slave(&scp1000_model_spi);
+	scp1000_model_init();
+	scp1000_init();
+	CHECK(scp1000_model_register(0x03) == 0x09);   // high speed mode
+	CHECK(! scp1000_dataready());
+
+	scp1000_model_set(98765.25f, 21.35f);
+	CHECK(scp1000_dataready());
+	CHECK(scp1000_get_status() & 0x20);
+	CHECK_NEAR(scp1000_get_temperature(), 21.35, 1e-4);
+	CHECK_NEAR(scp1000_get_pressure(), 98765.25, 1e-6);
+	CHECK(! scp1000_dataready());           // cleared by reading DATARD16
+
+	CHECK_NEAR(scp1000_pressure_to_height(101000.0f, 20.0f), 0.0, 1e-3);
+	CHECK_NEAR(scp1000_pressure_to_height(89876.0f, 20.0f), 1000.0, 3.0);
+}
+
+
+/*
+ *  dataflash.c and dataflash_ftl.c
+ */
+
+static void fill(unsigned char *buffer, int size, int seed)
+{
+	int i;
+
+	for (i = 0; i < size; i++)
+		buffer[i] = (unsigned char)(i * 7 + seed * 13 + (i >> 8));
+}
+
+
+static void dataflash_raw(int hardware_version)
+{
+	static unsigned char written[2 * AT45DB_PAGE_SIZE], read[2 * AT45DB_PAGE_SIZE];
+
+	HARDWARE_VERSION = hardware_version;
+	at45db_init();
+	dataflash_open();
+	CHECK(PAGE_SIZE == AT45DB_PAGE_SIZE);
+	CHECK(dataflash.read_Mbit() == 0x06);   // the density code of 16Mbit
+	CHECK(NAVIGATION_PAGE == AT45DB_PAGES - NAVIGATION_PAGES);
+
+	fill(written, sizeof(written), hardware_version);
+	dataflash.write(100, AT45DB_PAGE_SIZE, written);
+	CHECK(memcmp(at45db_page(100), written, AT45DB_PAGE_SIZE) == 0);
+	memset(read, 0, sizeof(read));
+	dataflash.read(100, AT45DB_PAGE_SIZE, read);
+	CHECK(memcmp(read, written, AT45DB_PAGE_SIZE) == 0);
+
+	// two pages in one go
+	dataflash.write(101, sizeof(written), written);
+	CHECK(memcmp(at45db_page(101), written, AT45DB_PAGE_SIZE) == 0);
+	CHECK(memcmp(at45db_page(102), written + AT45DB_PAGE_SIZE, AT45DB_PAGE_SIZE) == 0);
+	memset(read, 0, sizeof(read));
+	dataflash.read(101, sizeof(read), read);
+	CHECK(memcmp(read, written, sizeof(written)) == 0);
+	CHECK(at45db_statistics.ignored == 0);
+}
+
+
+static void test_dataflash_spi2()
+{
+	dataflash_raw(V01O);
+}
+
+
+static void test_dataflash_bitbang()
+{
+	dataflash_raw(V01Q);
+}
+
+
+static void test_dataflash_ftl()
+{
+	static unsigned char written[AT45DB_PAGE_SIZE], read[AT45DB_PAGE_SIZE];
+	int i;
+
+	HARDWARE_VERSION = V01O;
+	at45db_init();
+	dataflash_open();
+	at45db_program_polls = 3;
+	dataflash_ftl_open();
+
+	// the configuration is never programmed in place
+	fill(written, sizeof(written), 1);
+	dataflash.write(CONFIGURATION_PAGE, sizeof(written), written);
+	CHECK(at45db_page(CONFIGURATION_PAGE)[0] == 0xFF);
+	memset(read, 0, sizeof(read));
+	dataflash.read(CONFIGURATION_PAGE, sizeof(read), read);
+	CHECK(memcmp(read, written, sizeof(written)) == 0);
+
+	// a log page that loses a bit is moved into the pool
+	at45db_set_bad(200, 1);
+	fill(written, sizeof(written), 2);
+	dataflash.write(200, sizeof(written), written);
+	memset(read, 0, sizeof(read));
+	dataflash.read(200, sizeof(read), read);
+	CHECK(memcmp(read, written, sizeof(written)) == 0);
+	CHECK(dataflash_ftl.verify_failures == 1);
+	CHECK(dataflash_ftl.lost_writes == 0);
+	CHECK(dataflash_ftl_remapped_pages() == 1);
+
+	// the next pages go where they belong
+	for (i = 201; i < 205; i++)
+	{
+		fill(written, sizeof(written), i);
+		dataflash.write(i, sizeof(written), written);
+	}
+	dataflash.read(204, sizeof(read), read);
+	CHECK(memcmp(read, written, sizeof(written)) == 0);
+	CHECK(memcmp(at45db_page(204), written, sizeof(written)) == 0);
+
+	CHECK(at45db_statistics.busy_polls > 0);
+	CHECK(at45db_statistics.ignored == 0);    // every command waited for the chip
+}
+
+
+/*
+ *  mpu6000.c
+ */
+
+static void test_mpu6000()
+{
+	const int acc[3] = { 100, -200, 4096 };
+	const int gyro[3] = { -1, 32767, -32768 };
+
+	mpu6000_model_init();
+	mpu6000_init();
+	CHECK((mpu6000_model_register(MPUREG_PWR_MGMT_1) & BIT_SLEEP) == 0);
+	CHECK((mpu6000_model_register(MPUREG_PWR_MGMT_1) & BITS_CLKSEL) == MPU_CLK_SEL_PLLGYROZ);
+	CHECK(mpu6000_model_register(MPUREG_USER_CTRL) & BIT_I2C_IF_DIS);
+	CHECK((mpu6000_model_register(MPUREG_GYRO_CONFIG) & BITS_FS_MASK) == BITS_FS_1000DPS);
+	CHECK((mpu6000_model_register(MPUREG_ACCEL_CONFIG) & BITS_FS_MASK) == BITS_FS_8G);
+
+	mpu6000_model_set(acc, -1234, gyro);
+	mpu6000_update_sensor_readings();
+	CHECK(mpu6000_raw_sensor_readings.acc_x == 100);
+	CHECK(mpu6000_raw_sensor_readings.acc_y == -200);
+	CHECK(mpu6000_raw_sensor_readings.acc_z == 4096);
+	CHECK(mpu6000_raw_sensor_readings.temp == -1234);
+	CHECK(mpu6000_raw_sensor_readings.gyro_x == -1);
+	CHECK(mpu6000_raw_sensor_readings.gyro_y == 32767);
+	CHECK(mpu6000_raw_sensor_readings.gyro_z == -32768);
+}
+
+
+/*
+ *  pid.c
+ */
+
+static void test_pid()
+{
+	struct pid pid;
+	float out;
+	int i;
+
+	pid_init(&pid, 0.0f, 2.0f, 0.0f, -1.0f, 1.0f, 0.0f);
+	CHECK_NEAR(pid_update(&pid, 0.5f, 0.02f), 1.0, 1e-6);
+
+	// the integral stops at i_max
+	pid_init(&pid, 0.0f, 0.0f, 3.0f, -0.5f, 0.5f, 0.0f);
+	for (i = 0; i < 100; i++)
+		out = pid_update(&pid, 1.0f, 0.02f);
+	CHECK_NEAR(out, 1.5, 1e-6);
+	for (i = 0; i < 200; i++)
+		out = pid_update(&pid, -1.0f, 0.02f);
+	CHECK_NEAR(out, -1.5, 1e-6);
+
+	// the derivative, and nothing below d_term_min_var
+	pid_init(&pid, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	pid_update(&pid, 0.0f, 0.02f);
+	CHECK_NEAR(pid_update(&pid, 0.01f, 0.02f), 0.0, 1e-6);      // 0.5/s
+	CHECK_NEAR(pid_update(&pid, 0.11f, 0.02f), 0.5, 1e-5);      // 5/s
+
+	// a NaN integral starts over
+	pid_init(&pid, 0.0f, 0.0f, 1.0f, -10.0f, 10.0f, 0.0f);
+	pid.i_state = NAN;
+	CHECK_NEAR(pid_update(&pid, 1.0f, 0.5f), 0.5, 1e-6);
+}
+
+
+/*
+ *  quaternion.c
+ */
+
+static void test_quaternion()
+{
+	float q[4];
+	int i;
+
+	quaternion_from_attitude(0.3f, -0.2f, 1.0f, q);    // roll, pitch, yaw
+	CHECK_NEAR(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3], 1.0, 1e-4);
+	CHECK_NEAR(quaternion_to_roll(q), 0.3, 1e-3);
+	CHECK_NEAR(quaternion_to_pitch(q), -0.2, 1e-3);
+	CHECK_NEAR(quaternion_to_yaw(q), 1.0, 1e-3);
+
+	// 0.5 rad/s around x for a second
+	quaternion_from_attitude(0.0f, 0.0f, 0.0f, q);
+	for (i = 0; i < 100; i++)
+		quaternion_update_with_rates(0.5f, 0.0f, 0.0f, q, 0.01f);
+	CHECK_NEAR(quaternion_to_roll(q), 0.5, 1e-3);
+	CHECK_NEAR(quaternion_to_pitch(q), 0.0, 1e-3);
+	CHECK_NEAR(quaternion_to_yaw(q), 0.0, 1e-3);
+
+	// then yaw in the body frame
+	quaternion_from_attitude(0.0f, 0.0f, 0.0f, q);
+	for (i = 0; i < 200; i++)
+		quaternion_update_with_rates(0.0f, 0.0f, -0.25f, q, 0.01f);
+	CHECK_NEAR(quaternion_to_yaw(q), -0.5, 1e-3);
+}
+
+
+/*
+ *  uart1_queue.c
+ */
+
+static void test_uart1_queue()
+{
+	unsigned char in[300], out[UART1_RX_BUFFER];
+	char sent[16];
+	int i, n;
+
+	uart1_queue_init(115200L);
+	CHECK(IEC0bits.U1RXIE == 1);
+	CHECK(uart1_rx_free() == UART1_RX_BUFFER - 1);
+
+	for (i = 0; i < (int)sizeof(in); i++)
+		in[i] = (unsigned char)i;
+	host_uart_receive(1, in, sizeof(in));
+	CHECK(uart1_rx_free() == UART1_RX_BUFFER - 1 - (int)sizeof(in));
+	n = uart1_read(out, 100, 0);
+	n += uart1_read(out + n, sizeof(out) - n, 0);
+	CHECK(n == (int)sizeof(in));
+	CHECK(memcmp(in, out, sizeof(in)) == 0);
+	CHECK(uart1_rx_overruns == 0);
+
+	// the reader is too slow: the new bytes are dropped
+	host_uart_receive(1, in, sizeof(in));
+	host_uart_receive(1, in, sizeof(in));
+	CHECK(uart1_rx_overruns == 2 * sizeof(in) - (UART1_RX_BUFFER - 1));
+	n = uart1_read(out, sizeof(out), 0);
+	CHECK(n == UART1_RX_BUFFER - 1);
+	CHECK(memcmp(out, in, sizeof(in)) == 0);
+	CHECK(memcmp(out + sizeof(in), in, n - sizeof(in)) == 0);
+
+	// the interrupt is late: the fifo of the uart overflows
+	uart1_rx_overruns = 0;
+	host_uart_latency = HOST_UART_FIFO + 2;
+	host_uart_receive(1, in, HOST_UART_FIFO + 2);
+	CHECK(uart1_rx_overruns == 1);
+	CHECK(uart1_read(out, sizeof(out), 0) == HOST_UART_FIFO);
+	CHECK(U1STAbits.OERR == 0);
+
+	uart1_puts("gluon");
+	uart1_putc('!');
+	n = host_uart_sent(sent, sizeof(sent));
+	CHECK(n == 6 && memcmp(sent, "gluon!", 6) == 0);
+}
+
+
+/*
+ *  Benchmarks
+ */
+
+static double now_s()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+
+//! Uses every element, so that none of them is optimized away.
+static float matrix_sum(const float *a, int n)
+{
+	float sum = 0.0f;
+
+	while (n-- > 0)
+		sum += a[n];
+	return sum;
+}
+
+
+static void bench_result(const char *name, double seconds, long n, const char *unit)
+{
+	printf("%-34s %10.1f ns/%s\n", name, seconds * 1e9 / (double)n, unit);
+}
+
+
+static void benchmark(long iterations)
+{
+	static const char rmc[] = "$GPRMC,110917.000,A,5051.0242,N,00340.1555,E,12.5,271.3,150810,,,A*6C\r\n";
+	static unsigned char page[AT45DB_PAGE_SIZE];
+	unsigned char bytes[64], out[64];
+	struct pid pid;
+	float q[4], m[9], inverse[9], product[9], d;
+	double start;
+	long i, n, pressure;
+	unsigned long spi, i2c;
+	int temperature_10;
+	char output[64];
+	int k;
+
+	printf("\n");
+	start = now_s();
+	n = 0;
+	for (i = 0; i < iterations; i++)
+		for (k = 0; rmc[k] != '\0'; k++, n++)
+			sink = gps_parse_char((unsigned char)rmc[k]);
+	bench_result("gps_parse_char", now_s() - start, n, "byte");
+
+	ppm_source_set(ppm_channels, 8, 22500);
+	capture_start();
+	ppm_in_open();
+	capture_stop(output, sizeof(output));
+	ppm_source_set(NULL, 0, 0);             // the pulses come from the loop
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+		ppm_in_decode_pulse(i % 9 == 8 ? 6000 : 700 + (unsigned int)(i & 255));
+	bench_result("ppm_in_decode_pulse", now_s() - start, iterations, "pulse");
+
+	pid_init(&pid, 0.1f, 1.0f, 0.2f, -1.0f, 1.0f, 0.01f);
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+		sink = pid_update(&pid, (float)(i & 63) * 0.01f, 0.02f);
+	bench_result("pid_update", now_s() - start, iterations, "call");
+
+	quaternion_from_attitude(0.1f, 0.2f, 0.3f, q);
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+		quaternion_update_with_rates(0.01f, -0.02f, 0.03f, q, 0.01f);
+	sink = q[0];
+	bench_result("quaternion_update_with_rates", now_s() - start, iterations, "call");
+
+	host_sfr_reset();
+	uart1_queue_init(115200L);
+	for (k = 0; k < (int)sizeof(bytes); k++)
+		bytes[k] = (unsigned char)k;
+	start = now_s();
+	for (i = 0; i < iterations / 64 + 1; i++)
+	{
+		host_uart_receive(1, bytes, sizeof(bytes));
+		uart1_read(out, sizeof(out), 0);
+	}
+	bench_result("uart1 receive + uart1_read", now_s() - start, (iterations / 64 + 1) * 64, "byte");
+
+	// the SPI models dominate here: the SPI bytes are counted as well
+	for (k = V01O; k <= V01Q; k++)
+	{
+		host_sfr_reset();
+		HARDWARE_VERSION = k;
+		at45db_init();
+		dataflash_open();
+		spi = host_spi_bytes;
+		start = now_s();
+		for (i = 0; i < iterations / 1000 + 1; i++)
+			dataflash.read((int)(i & 1023), AT45DB_PAGE_SIZE, page);
+		bench_result(k == V01O ? "dataflash page read, SPI2" : "dataflash page read, bit banged",
+		             now_s() - start, iterations / 1000 + 1, "page");
+		printf("%-34s %10.1f bytes/page\n", "", (double)(host_spi_bytes - spi) / (double)(iterations / 1000 + 1));
+	}
+
+	// a 20ms frame of pwm_source is 12 edges, each running a capture interrupt
+	host_sfr_reset();
+	pwm_in_open();
+	pwm_source_set(pwm_pulses, 6);
+	start = now_s();
+	for (i = 0; i < iterations / 12 + 1; i++)
+		host_advance_us(20000);
+	bench_result("pwm_in capture interrupt", now_s() - start, (iterations / 12 + 1) * 12, "edge");
+	pwm_source_set(NULL, 0);
+
+	servo_init();
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+		servo_set_us((int)(i & 7), 1000 + (unsigned int)(i & 1023));
+	bench_result("servo_set_us", now_s() - start, iterations, "call");
+
+	for (k = 0; k < 9; k++)
+		m[k] = (float)(k * k % 7) + (k % 4 == 0 ? 5.0f : 0.0f);
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+	{
+		m[0] = 5.0f + (float)(i & 15);
+		INVERT_3X3(inverse, d, m);
+		sink = matrix_sum(inverse, 9);
+	}
+	bench_result("INVERT_3X3", now_s() - start, iterations, "call");
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+	{
+		m[0] = (float)(i & 15);
+		matrix_3x2_times_3x2_transp(m, inverse, product);
+		sink = matrix_sum(product, 9);
+	}
+	bench_result("matrix_3x2_times_3x2_transp", now_s() - start, iterations, "call");
+
+	bmp085_model_init();
+	bmp085_model_set(BMP085_UT, BMP085_UP);
+	i2c_init();
+	bmp085_init();
+	start = now_s();
+	for (i = 0; i < iterations; i++)
+	{
+		bmp085_convert_temp(BMP085_UT + (long)(i & 15), &temperature_10);
+		bmp085_convert_pressure(BMP085_UP + (long)(i & 255), &pressure);
+		sink = (float)pressure;
+	}
+	bench_result("bmp085_convert_temp + _pressure", now_s() - start, iterations, "call");
+
+	// the I2C1 module and the interrupt run in the 100ms delay
+	i2c = host_i2c_bytes;
+	start = now_s();
+	for (i = 0; i < iterations / 1000 + 1; i++)
+	{
+		bmp085_update(&temperature_10, &pressure);
+		microcontroller_delay_ms(100);
+	}
+	bench_result("bmp085_update, I2C1 interrupt", now_s() - start, iterations / 1000 + 1, "call");
+	printf("%-34s %10.1f bytes/call\n", "", (double)(host_i2c_bytes - i2c) / (double)(iterations / 1000 + 1));
+
+	host_sfr_reset();
+	host_sfr_set_rg9_slave(&scp1000_model_spi);
+	scp1000_model_init();
+	scp1000_init();
+	spi = host_spi_bytes;
+	start = now_s();
+	for (i = 0; i < iterations / 1000 + 1; i++)
+		sink = scp1000_get_pressure();
+	bench_result("scp1000_get_pressure, SPI2", now_s() - start, iterations / 1000 + 1, "read");
+	printf("%-34s %10.1f bytes/read\n", "", (double)(host_spi_bytes - spi) / (double)(iterations / 1000 + 1));
+}
+
+
+int main(int argc, char *argv[])
+{
+	long iterations = 1000000L;
+	int bench = 0;
+
+	if (argc >= 2 && strcmp(argv[1], "-bench") == 0)
+	{
+		bench = 1;
+		if (argc == 4 && strcmp(argv[2], "-n") == 0)
+			iterations = atol(argv[3]);
+		else if (argc != 2)
+			bench = -1;
+	}
+	else if (argc != 1)
+		bench = -1;
+	if (bench < 0)
+	{
+		fprintf(stderr, "usage: host_test [-bench [-n iterations]]\n");
+		return 2;
+	}
+
+	run("gps", test_gps);
+	run("ppm_in", test_ppm);
+	run("pwm_in", test_pwm_in);
+	run("servo", test_servo);
+	run("matrix", test_matrix);
+	run("bmp085", test_bmp085);
+	run("scp1000", test_scp1000);
+	run("dataflash SPI2", test_dataflash_spi2);
+	run("dataflash bit banged", test_dataflash_bitbang);
+	run("dataflash_ftl", test_dataflash_ftl);
+	run("mpu6000", test_mpu6000);
+	run("pid", test_pid);
+	run("quaternion", test_quaternion);
+	run("uart1_queue", test_uart1_queue);
+	printf("%s\n", failures == 0 ? "all tests passed" : "FAILED");
+
+	if (bench)
+		benchmark(iterations);
+	return failures > 0 ? 1 : 0;
+}
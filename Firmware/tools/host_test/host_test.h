@@ -0,0 +1,130 @@
+/*!
+ *  The peripheral models of host_test, behind the fake registers of
+ *  p33FJ256MC710.h.
+ *
+ *  @file     host_test.h
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/*
+ *  sfr.c: the registers, the pins and the time
+ */
+
+//! A device on a SPI bus, behind a chip select.
+struct HostSpiSlave
+{
+	void (*select)();                           //!< chip select went low
+	void (*deselect)();                         //!< chip select went high
+	unsigned char (*byte)(unsigned char in);    //!< a byte was received, returns the byte to shift out during the next one
+};
+
+//! A device on the I2C bus.
+struct HostI2cSlave
+{
+	unsigned char address;                      //!< 8 bit write address
+	void (*start)();                            //!< start or restart, the address follows
+	int (*write)(unsigned char byte);           //!< a byte after the address was received, returns the ACK
+	unsigned char (*read)();                    //!< the byte to send
+	void (*stop)();
+};
+
+extern unsigned long host_time_us;              //!< advanced by the delays of microcontroller.c
+extern unsigned long host_spi_bytes;            //!< bytes exchanged with the SPI models
+extern unsigned long host_i2c_bytes;            //!< bytes exchanged on I2C1
+
+void host_sfr_reset();
+void host_sfr_sync();
+void host_sfr_set_rg9_slave(const struct HostSpiSlave *slave);
+void host_i2c_sync();
+float host_oc_pulse_us(int oc);
+void host_advance_us(unsigned long us);
+
+/*
+ *  at45db.c: AT45DB161D dataflash, 4096 pages of 528 bytes, on RF0 (chip
+ *  select) and SPI2 or the bit banged RF6/RF7/RF8
+ */
+
+struct At45dbStatistics
+{
+	unsigned long programs;
+	unsigned long compares;
+	unsigned long rewrites;
+	unsigned long busy_polls;
+	unsigned long ignored;          //!< commands sent while the chip was busy
+};
+
+#define AT45DB_PAGES 4096
+#define AT45DB_PAGE_SIZE 528
+
+extern const struct HostSpiSlave at45db_spi;
+extern struct At45dbStatistics at45db_statistics;
+extern int at45db_program_polls;                //!< status reads that return busy after a program
+
+void at45db_init();
+unsigned char *at45db_page(int page);
+void at45db_set_bad(int page, int bad);
+
+/*
+ *  mpu6000_model.c: MPU6000 on the bit banged RG6..RG9
+ */
+
+extern const struct HostSpiSlave mpu6000_model_spi;
+
+void mpu6000_model_init();
+void mpu6000_model_set(const int acc[3], int temperature, const int gyro[3]);
+unsigned char mpu6000_model_register(int address);
+
+/*
+ *  uart_source.c: bytes arriving on uart 1 and 2, bytes sent on uart 1
+ */
+
+#define HOST_UART_FIFO 4                        //!< receive fifo of the dsPIC uart
+
+extern int host_uart_latency;                   //!< bytes that arrive before the receive interrupt runs
+
+void host_uart_reset();
+void host_uart_receive(int uart, const unsigned char *bytes, int n);
+void host_uart_sync();
+int host_uart_sent(char *buffer, int max);
+
+/*
+ *  scp1000_model.c: SCP1000 barometer on SPI2, chip select RG9, data
+ *  ready on RE8
+ */
+
+extern const struct HostSpiSlave scp1000_model_spi;
+
+void scp1000_model_init();
+void scp1000_model_set(float pressure_pa, float temperature_c);
+unsigned char scp1000_model_register(int address);
+
+/*
+ *  bmp085_model.c: BMP085 barometer on I2C1
+ */
+
+extern const struct HostI2cSlave bmp085_model_i2c;
+extern int bmp085_model_early_reads;            //!< result bytes read before their conversion finished
+
+void bmp085_model_init();
+void bmp085_model_set(unsigned int ut, long up);
+
+/*
+ *  ppm_source.c: the PPM pulse train of the RC receiver on IC4
+ */
+
+void ppm_source_set(const unsigned int *channel_us, int channels, unsigned int frame_us);
+void ppm_source_advance(unsigned long until_us);
+unsigned int ppm_source_ic4buf();
+
+/*
+ *  pwm_source.c: the servo pulses of the RC receiver on IC1..IC6
+ */
+
+void pwm_source_set(const unsigned int *pulse_us, int inputs);
+void pwm_source_advance(unsigned long until_us);
+
+#endif // HOST_TEST_H
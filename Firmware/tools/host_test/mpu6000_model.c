@@ -0,0 +1,111 @@
+/*!
+ *  Model of the MPU6000 on its SPI bus: the register file with the reset
+ *  values, burst reads and writes with an auto incrementing address, the
+ *  device reset of PWR_MGMT_1 and the sleep mode after it. While asleep the
+ *  sensor registers read 0.
+ *
+ *  @file     mpu6000_model.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <string.h>
+
+#include "mpu6000/mpu6000.h"
+
+#include "host_test.h"
+
+static unsigned char registers[128];
+static int acc[3], temperature, gyro[3];
+
+static int received;
+static int address;
+static int reading;
+
+
+static void reset_registers()
+{
+	memset(registers, 0, sizeof(registers));
+	registers[MPUREG_PWR_MGMT_1] = BIT_SLEEP;
+	registers[MPUREG_WHOAMI] = 0x68;
+}
+
+
+void mpu6000_model_init()
+{
+	reset_registers();
+	memset(acc, 0, sizeof(acc));
+	memset(gyro, 0, sizeof(gyro));
+	temperature = 0;
+}
+
+
+void mpu6000_model_set(const int a[3], int t, const int g[3])
+{
+	memcpy(acc, a, sizeof(acc));
+	memcpy(gyro, g, sizeof(gyro));
+	temperature = t;
+}
+
+
+unsigned char mpu6000_model_register(int a)
+{
+	host_sfr_sync();
+	return registers[a & 0x7F];
+}
+
+
+/*!
+ *   The sensor registers hold the values of mpu6000_model_set, big endian.
+ */
+static unsigned char read_register(int a)
+{
+	int i = a - MPUREG_ACCEL_XOUT_H;
+	int value;
+
+	if (i < 0 || i >= 14)
+		return registers[a];
+	if (registers[MPUREG_PWR_MGMT_1] & BIT_SLEEP)
+		return 0;
+	if (i < 6)
+		value = acc[i / 2];
+	else if (i < 8)
+		value = temperature;
+	else
+		value = gyro[(i - 8) / 2];
+	return (unsigned char)((i & 1) ? value : value >> 8);
+}
+
+
+static void mpu6000_model_select()
+{
+	received = 0;
+}
+
+
+static void mpu6000_model_deselect()
+{
+}
+
+
+static unsigned char mpu6000_model_byte(unsigned char in)
+{
+	if (received++ == 0)
+	{
+		address = in & 0x7F;
+		reading = (in & 0x80) != 0;
+		return reading ? read_register(address++) : 0xFF;
+	}
+	if (reading)
+		return read_register(address++ & 0x7F);
+
+	if (address == MPUREG_PWR_MGMT_1 && (in & BIT_H_RESET))
+		reset_registers();
+	else
+		registers[address & 0x7F] = in;
+	address++;
+	return 0xFF;
+}
+
+
+const struct HostSpiSlave mpu6000_model_spi = { mpu6000_model_select, mpu6000_model_deselect, mpu6000_model_byte };
@@ -0,0 +1,178 @@
+/*!
+ *  Host replacement of the dsPIC33FJ256MC710 register definitions, for
+ *  host_test. Only the registers of the tested drivers exist.
+ *
+ *  Most registers are plain variables. The ones a peripheral model has to
+ *  see are macros around a function of sfr.c: PORTF and PORTG (the chip
+ *  selects and the bit banged SPI of the dataflash and the MPU6000),
+ *  SPI2STAT and SPI2BUF, the I2C1 registers, the input capture buffers and
+ *  the uart registers. Every such access first lets the models catch up
+ *  with what was written since the previous one, see host_sfr_sync().
+ *
+ *  @file     p33FJ256MC710.h
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#ifndef HOST_P33FJ256MC710_H
+#define HOST_P33FJ256MC710_H
+
+// the interrupt attributes of XC16 mean nothing to the host compiler
+#define __interrupt__
+#define __shadow__
+#define __auto_psv__
+#define __no_auto_psv__
+#define auto_psv
+
+#define SET_AND_SAVE_CPU_IPL(save, ipl) ((save) = (ipl))
+#define RESTORE_CPU_IPL(save) ((void)(save))
+#define Nop() ((void)0)
+
+//! Written into a data register by the models: no byte of the driver is waiting in it.
+#define HOST_REG_EMPTY 0x100
+
+#define HOST_PORT_BITS(p) struct { \
+	unsigned p##0:1, p##1:1, p##2:1, p##3:1, p##4:1, p##5:1, p##6:1, p##7:1, \
+	         p##8:1, p##9:1, p##10:1, p##11:1, p##12:1, p##13:1, p##14:1, p##15:1; }
+
+typedef HOST_PORT_BITS(RB) PORTBBITS;
+typedef HOST_PORT_BITS(RD) PORTDBITS;
+typedef HOST_PORT_BITS(RE) PORTEBITS;
+typedef HOST_PORT_BITS(RF) PORTFBITS;
+typedef HOST_PORT_BITS(RG) PORTGBITS;
+typedef HOST_PORT_BITS(TRISB) TRISBBITS;
+typedef HOST_PORT_BITS(TRISF) TRISFBITS;
+typedef HOST_PORT_BITS(TRISE) TRISEBITS;
+typedef HOST_PORT_BITS(TRISG) TRISGBITS;
+typedef HOST_PORT_BITS(LATG) LATGBITS;
+
+typedef struct {
+	unsigned SPIRBF:1, SPITBF:1, :4, SPIROV:1, :6, SPISIDL:1, :1, SPIEN:1;
+} SPI2STATBITS;
+
+typedef struct {
+	unsigned :15, ALTIVT:1;
+} INTCON2BITS;
+
+typedef struct {
+	unsigned :1, TCS:1, :1, TGATE:1, TCKPS:2, :7, TSIDL:1, :1, TON:1;
+} T3CONBITS;
+
+typedef T3CONBITS T2CONBITS;
+
+typedef struct {
+	unsigned ICM:3, ICBNE:1, ICOV:1, ICI:2, ICTMR:1, :5, ICSIDL:1;
+} IC1CONBITS;
+
+typedef struct {
+	unsigned OCM:3, OCTSEL:1, OCFLT:1, :8, OCSIDL:1;
+} OC1CONBITS;
+
+typedef struct {
+	unsigned SEN:1, RSEN:1, PEN:1, RCEN:1, ACKEN:1, ACKDT:1, STREN:1, GCEN:1,
+	         SMEN:1, DISSLW:1, A10M:1, IPMIEN:1, SCLREL:1, I2CSIDL:1, :1, I2CEN:1;
+} I2C1CONBITS;
+
+typedef struct {
+	unsigned TBF:1, RBF:1, R_W:1, S:1, P:1, D_A:1, I2COV:1, IWCOL:1,
+	         ADD10:1, GCSTAT:1, BCL:1, :3, TRSTAT:1, ACKSTAT:1;
+} I2C1STATBITS;
+
+typedef struct {
+	unsigned STSEL:1, PDSEL:2, BRGH:1, URXINV:1, ABAUD:1, LPBACK:1, WAKE:1,
+	         UEN:2, :1, RTSMD:1, IREN:1, USIDL:1, :1, UARTEN:1;
+} UxMODEBITS;
+
+typedef struct {
+	unsigned URXDA:1, OERR:1, FERR:1, PERR:1, RIDLE:1, ADDEN:1, URXISEL:2,
+	         TRMT:1, UTXBF:1, UTXEN:1, UTXBRK:1, :1, UTXISEL0:1, UTXINV:1, UTXISEL1:1;
+} UxSTABITS;
+
+typedef struct {
+	unsigned :11, U1RXIE:1, U1TXIE:1;
+} IEC0BITS;
+
+typedef struct {
+	unsigned :1, MI2C1IE:1, :10, U1TXIE:1, :1, U2RXIE:1;
+} IEC1BITS;
+
+typedef struct {
+	unsigned :11, U1RXIF:1;
+} IFS0BITS;
+
+typedef struct {
+	unsigned :1, MI2C1IF:1, :10, U1TXIF:1, :1, U2RXIF:1;
+} IFS1BITS;
+
+typedef struct {
+	unsigned :4, MI2C1IP:3;
+} IPC4BITS;
+
+extern volatile PORTBBITS PORTBbits;
+extern volatile PORTEBITS PORTEbits;
+extern volatile TRISBBITS TRISBbits;
+extern volatile TRISEBITS TRISEbits;
+extern volatile TRISFBITS TRISFbits;
+extern volatile TRISGBITS TRISGbits;
+extern volatile LATGBITS LATGbits;
+extern volatile unsigned int TRISD;
+
+//! PORTD is written as a word by servo.c and read bit by bit by pwm_in.c.
+extern volatile union HostPortD { unsigned int word; PORTDBITS bits; } host_portd;
+
+extern volatile INTCON2BITS INTCON2bits;
+extern volatile T2CONBITS T2CONbits;
+extern volatile T3CONBITS T3CONbits;
+extern volatile unsigned int PR2, PR3, TMR3;
+extern volatile unsigned int IC1CON, IC2CON, IC3CON, IC4CON, IC5CON, IC6CON;
+extern volatile IC1CONBITS IC1CONbits, IC2CONbits, IC3CONbits, IC4CONbits, IC5CONbits, IC6CONbits;
+extern volatile unsigned int OC1R, OC2R, OC3R, OC4R, OC5R, OC6R, OC7R, OC8R;
+extern volatile unsigned int OC1RS, OC2RS, OC3RS, OC4RS, OC5RS, OC6RS, OC7RS, OC8RS;
+extern volatile OC1CONBITS OC1CONbits, OC2CONbits, OC3CONbits, OC4CONbits,
+                           OC5CONbits, OC6CONbits, OC7CONbits, OC8CONbits;
+
+extern volatile unsigned int I2C1BRG, I2CTRN;
+extern volatile IPC4BITS IPC4bits;
+
+extern volatile UxMODEBITS U1MODEbits;
+extern volatile unsigned int U1BRG, U1TXREG;
+extern volatile IEC0BITS IEC0bits;
+extern volatile IEC1BITS IEC1bits;
+extern volatile IFS0BITS IFS0bits;
+extern volatile IFS1BITS IFS1bits;
+
+extern volatile unsigned int _IC1IF, _IC1IE, _IC1IP, _IC2IF, _IC2IE, _IC2IP, _IC3IF, _IC3IE, _IC3IP;
+extern volatile unsigned int _IC4IF, _IC4IE, _IC4IP, _IC5IF, _IC5IE, _IC5IP, _IC6IF, _IC6IE, _IC6IP;
+extern volatile unsigned int _U1RXIP, _U2RXIF;
+
+volatile PORTFBITS *host_portf();
+volatile PORTGBITS *host_portg();
+volatile SPI2STATBITS *host_spi2stat();
+volatile unsigned int *host_spi2buf();
+volatile I2C1CONBITS *host_i2c1con();
+volatile I2C1STATBITS *host_i2c1stat();
+unsigned int host_i2crcv();
+volatile UxSTABITS *host_u1sta();
+unsigned int host_icbuf(int module);
+unsigned int host_uart_rxreg(int uart);
+
+#define PORTD host_portd.word
+#define PORTDbits host_portd.bits
+#define PORTFbits (*host_portf())
+#define PORTGbits (*host_portg())
+#define SPI2STATbits (*host_spi2stat())
+#define SPI2BUF (*host_spi2buf())
+#define I2C1CONbits (*host_i2c1con())
+#define I2C1STATbits (*host_i2c1stat())
+#define I2CRCV host_i2crcv()
+#define U1STAbits (*host_u1sta())
+#define IC1BUF host_icbuf(1)
+#define IC2BUF host_icbuf(2)
+#define IC3BUF host_icbuf(3)
+#define IC4BUF host_icbuf(4)
+#define IC5BUF host_icbuf(5)
+#define IC6BUF host_icbuf(6)
+#define U1RXREG host_uart_rxreg(1)
+#define U2RXREG host_uart_rxreg(2)
+
+#endif // HOST_P33FJ256MC710_H
@@ -0,0 +1,107 @@
+/*!
+ *  The PPM pulse train of an RC receiver on input capture 4.
+ *
+ *  A frame is a falling edge per channel, the channel being the time to the
+ *  next edge, and a sync gap up to the frame length. The edges are captured
+ *  with timer 3 (1:64, 1.6us per tick), which the interrupt of ppm_in.c
+ *  clears: the fifo holds the ticks since the previous interrupt, which
+ *  runs on every 4th capture. Time passes in the delays of
+ *  microcontroller.c, see host_advance_us().
+ *
+ *  @file     ppm_source.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include "microcontroller/microcontroller.h"
+
+#include "host_test.h"
+
+#define MAX_CHANNELS 14
+#define CAPTURE_FIFO 4
+
+void _AltIC4Interrupt(void);
+
+static unsigned int interval_us[MAX_CHANNELS + 1];
+static int intervals = 0;           //!< 0: no signal
+static int next_interval;
+static unsigned long next_edge_us;
+static unsigned long last_interrupt_us;
+
+static unsigned int fifo[CAPTURE_FIFO];
+static int fifo_head, fifo_count;
+static int captures;
+
+
+/*!
+ *   Starts a pulse train with the given channels, channels = 0 stops it.
+ */
+void ppm_source_set(const unsigned int *channel_us, int channels, unsigned int frame_us)
+{
+	unsigned int sum = 0;
+	int i;
+
+	for (i = 0; i < channels && i < MAX_CHANNELS; i++)
+	{
+		interval_us[i] = channel_us[i];
+		sum += channel_us[i];
+	}
+	interval_us[i] = frame_us - sum;
+	intervals = channels > 0 ? i + 1 : 0;
+	next_interval = 0;
+	next_edge_us = host_time_us + 1;
+	last_interrupt_us = host_time_us;
+	captures = 0;
+}
+
+
+/*!
+ *   IC4BUF while ppm_in uses the alternate vector table, see host_icbuf().
+ */
+unsigned int ppm_source_ic4buf()
+{
+	unsigned int value = 0;
+
+	if (fifo_count > 0)
+	{
+		value = fifo[fifo_head];
+		fifo_head = (fifo_head + 1) % CAPTURE_FIFO;
+		fifo_count--;
+	}
+	IC4CONbits.ICBNE = fifo_count > 0;
+	return value;
+}
+
+
+static void capture(unsigned long edge_us)
+{
+	if (IC4CONbits.ICM == 0)
+		return;
+	if (fifo_count < CAPTURE_FIFO)
+	{
+		fifo[(fifo_head + fifo_count) % CAPTURE_FIFO] = (unsigned int)(((edge_us - last_interrupt_us) * 5 / 8) & 0xFFFF);
+		fifo_count++;
+	}
+	else
+		IC4CONbits.ICOV = 1;
+	IC4CONbits.ICBNE = 1;
+
+	if (++captures > IC4CONbits.ICI)
+	{
+		captures = 0;
+		last_interrupt_us = edge_us;    // the interrupt clears TMR3
+		if (_IC4IE)
+			_AltIC4Interrupt();
+	}
+}
+
+
+void ppm_source_advance(unsigned long until_us)
+{
+	while (intervals > 0 && next_edge_us <= until_us)
+	{
+		capture(next_edge_us);
+		next_edge_us += interval_us[next_interval];
+		next_interval = (next_interval + 1) % intervals;
+	}
+}
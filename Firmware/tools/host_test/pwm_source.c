@@ -0,0 +1,104 @@
+/*!
+ *  The servo pulses of an RC receiver on input capture 1..6 (RD8..RD13),
+ *  for pwm_in.c.
+ *
+ *  Every 20ms the receiver sends a pulse on each input, one after the other:
+ *  the next input rises when the previous one falls. Every edge is captured
+ *  with the free running timer 3 and runs the interrupt of its module, which
+ *  looks at the pin to tell the edges apart. Time passes in the delays of
+ *  microcontroller.c, see host_advance_us().
+ *
+ *  @file     pwm_source.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include "microcontroller/microcontroller.h"
+
+#include "host_test.h"
+
+#define INPUTS 6
+#define FRAME_US 20000
+
+void _IC1Interrupt(void);
+void _IC2Interrupt(void);
+void _IC3Interrupt(void);
+void _IC4Interrupt(void);
+void _IC5Interrupt(void);
+void _IC6Interrupt(void);
+
+static void (* const interrupt[INPUTS])(void) = {
+	_IC1Interrupt, _IC2Interrupt, _IC3Interrupt, _IC4Interrupt, _IC5Interrupt, _IC6Interrupt
+};
+static volatile IC1CONBITS * const con[INPUTS] = {
+	&IC1CONbits, &IC2CONbits, &IC3CONbits, &IC4CONbits, &IC5CONbits, &IC6CONbits
+};
+static volatile unsigned int * const flag[INPUTS] = { &_IC1IF, &_IC2IF, &_IC3IF, &_IC4IF, &_IC5IF, &_IC6IF };
+static volatile unsigned int * const enable[INPUTS] = { &_IC1IE, &_IC2IE, &_IC3IE, &_IC4IE, &_IC5IE, &_IC6IE };
+
+static unsigned int pulse_us[INPUTS];
+static int inputs = 0;              //!< 0: no signal
+static int next_edge;               //!< rising edge of input next_edge/2 when even
+static unsigned long frame_start_us, next_edge_us;
+static unsigned int capture[INPUTS];
+
+
+/*!
+ *   Starts the pulses of the first inputs, inputs = 0 stops them.
+ */
+void pwm_source_set(const unsigned int *pulse, int n)
+{
+	int i;
+
+	for (i = 0; i < n && i < INPUTS; i++)
+		pulse_us[i] = pulse[i];
+	inputs = n > 0 ? i : 0;
+	next_edge = 0;
+	frame_start_us = next_edge_us = host_time_us + 1;
+}
+
+
+/*!
+ *   The capture buffer of input capture module 1..6. IC4 is shared with
+ *   the PPM pulse train, which ppm_in handles on the alternate vector table.
+ */
+unsigned int host_icbuf(int module)
+{
+	if (module == 4 && INTCON2bits.ALTIVT)
+		return ppm_source_ic4buf();
+	return capture[module - 1];
+}
+
+
+static void edge(int input, int level, unsigned long t_us)
+{
+	static const unsigned int prescaler[4] = { 1, 8, 64, 256 };
+	unsigned int pin = 1u << (8 + input);
+
+	PORTD = level ? PORTD | pin : PORTD & ~pin;
+	if (con[input]->ICM == 0)
+		return;
+	capture[input] = (unsigned int)((t_us * (FCY / 1000000L) / prescaler[T3CONbits.TCKPS]) & 0xFFFF);
+	*flag[input] = 1;
+	if (*enable[input])
+		interrupt[input]();
+}
+
+
+void pwm_source_advance(unsigned long until_us)
+{
+	while (inputs > 0 && next_edge_us <= until_us)
+	{
+		int input = next_edge / 2;
+
+		edge(input, next_edge % 2 == 0, next_edge_us);
+		if (next_edge % 2 == 0)
+			next_edge_us += pulse_us[input];
+		else if (next_edge == 2 * inputs - 1)
+		{
+			frame_start_us += FRAME_US;
+			next_edge_us = frame_start_us;
+		}
+		next_edge = (next_edge + 1) % (2 * inputs);
+	}
+}
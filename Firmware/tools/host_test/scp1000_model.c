@@ -0,0 +1,129 @@
+/*!
+ *  Model of the SCP1000 barometer on SPI2: a command byte with the register
+ *  address and the write bit, then the data; DATARD16 and TEMPOUT are read
+ *  as 16 bits. Once a measurement mode is written into OPERATION, every
+ *  scp1000_model_set() is a measurement: DRDY (RE8 and the status register)
+ *  is set, reading the last byte of DATARD16 clears it.
+ *
+ *  @file     scp1000_model.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "microcontroller/microcontroller.h"
+
+#include "host_test.h"
+
+#define OPERATION 0x03
+#define STATUS 0x07
+#define DATARD8 0x1F
+#define DATARD16 0x20
+#define TEMPOUT 0x21
+
+#define STATUS_DRDY 0x20
+
+static unsigned char registers[64];
+static unsigned int datard16, tempout;
+static int measuring;
+
+static int command;                     //!< the command byte was received
+static int address;
+static int writing;
+static unsigned char out[2];
+static int out_count, out_sent;
+
+
+static void set_drdy(int drdy)
+{
+	if (drdy)
+		registers[STATUS] |= STATUS_DRDY;
+	else
+		registers[STATUS] &= ~STATUS_DRDY;
+	PORTEbits.RE8 = drdy;
+}
+
+
+void scp1000_model_init()
+{
+	memset(registers, 0, sizeof(registers));
+	datard16 = tempout = 0;
+	measuring = 0;
+	set_drdy(0);
+}
+
+
+/*!
+ *   The next measurement: 0.25Pa and 0.05C resolution.
+ */
+void scp1000_model_set(float pressure_pa, float temperature_c)
+{
+	long pressure = lroundf(pressure_pa * 4.0f);
+
+	registers[DATARD8] = (unsigned char)((pressure >> 16) & 0x07);
+	datard16 = (unsigned int)(pressure & 0xFFFF);
+	tempout = (unsigned int)(lroundf(temperature_c * 20.0f) & 0x3FFF);
+	if (measuring)
+		set_drdy(1);
+}
+
+
+unsigned char scp1000_model_register(int a)
+{
+	host_sfr_sync();
+	return registers[a & 0x3F];
+}
+
+
+static void scp1000_model_select()
+{
+	command = 1;
+}
+
+
+static void scp1000_model_deselect()
+{
+}
+
+
+static unsigned char scp1000_model_byte(unsigned char in)
+{
+	if (command)
+	{
+		command = 0;
+		address = in >> 2;
+		writing = (in & 0x02) != 0;
+		out_count = out_sent = 0;
+		if (writing)
+			return 0x00;
+		if (address == DATARD16 || address == TEMPOUT)
+		{
+			unsigned int value = address == DATARD16 ? datard16 : tempout;
+
+			out[0] = (unsigned char)(value >> 8);
+			out[1] = (unsigned char)value;
+			out_count = 2;
+		}
+		else
+		{
+			out[0] = registers[address];
+			out_count = 1;
+		}
+		return out[0];
+	}
+	if (writing)
+	{
+		registers[address] = in;
+		if (address == OPERATION)
+			measuring = in == 0x09 || in == 0x0A || in == 0x0D;   // high speed, high resolution, ultra low power
+		return 0x00;
+	}
+	if (++out_sent >= out_count && address == DATARD16)
+		set_drdy(0);
+	return out_sent < out_count ? out[out_sent] : 0x00;
+}
+
+
+const struct HostSpiSlave scp1000_model_spi = { scp1000_model_select, scp1000_model_deselect, scp1000_model_byte };
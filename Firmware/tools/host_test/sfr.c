@@ -0,0 +1,384 @@
+/*!
+ *  The fake registers of p33FJ256MC710.h and the delays of microcontroller.c.
+ *
+ *  The drivers bit bang their SPI buses on PORTF and PORTG, one pin per
+ *  write. Every access to PORTF, PORTG or SPI2STAT first compares the pins
+ *  with what the models saw last: a falling chip select starts a command,
+ *  a falling clock puts the next bit of the device on its data out pin, a
+ *  rising clock samples the data in pin. SPI2 exchanges a byte when the
+ *  driver polls SPI2STAT after writing SPI2BUF.
+ *
+ *  The I2C1 module carries out what the driver started (a start, a byte,
+ *  a receive...) at the next access to its registers or the next delay,
+ *  and then runs the MI2C1 interrupt, like the hardware would.
+ *
+ *  @file     sfr.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include "microcontroller/microcontroller.h"
+#include "spi.h"
+
+#include "host_test.h"
+
+volatile PORTBBITS PORTBbits;
+volatile PORTEBITS PORTEbits;
+volatile TRISBBITS TRISBbits;
+volatile TRISEBITS TRISEbits;
+volatile TRISFBITS TRISFbits;
+volatile TRISGBITS TRISGbits;
+volatile LATGBITS LATGbits;
+volatile unsigned int TRISD;
+volatile union HostPortD host_portd;
+volatile INTCON2BITS INTCON2bits;
+volatile T2CONBITS T2CONbits;
+volatile T3CONBITS T3CONbits;
+volatile unsigned int PR2, PR3, TMR3;
+volatile unsigned int IC1CON, IC2CON, IC3CON, IC4CON, IC5CON, IC6CON;
+volatile IC1CONBITS IC1CONbits, IC2CONbits, IC3CONbits, IC4CONbits, IC5CONbits, IC6CONbits;
+volatile unsigned int OC1R, OC2R, OC3R, OC4R, OC5R, OC6R, OC7R, OC8R;
+volatile unsigned int OC1RS, OC2RS, OC3RS, OC4RS, OC5RS, OC6RS, OC7RS, OC8RS;
+volatile OC1CONBITS OC1CONbits, OC2CONbits, OC3CONbits, OC4CONbits,
+                    OC5CONbits, OC6CONbits, OC7CONbits, OC8CONbits;
+volatile unsigned int I2C1BRG, I2CTRN;
+volatile IPC4BITS IPC4bits;
+volatile UxMODEBITS U1MODEbits;
+volatile unsigned int U1BRG, U1TXREG;
+volatile IEC0BITS IEC0bits;
+volatile IEC1BITS IEC1bits;
+volatile IFS0BITS IFS0bits;
+volatile IFS1BITS IFS1bits;
+volatile unsigned int _IC1IF, _IC1IE, _IC1IP, _IC2IF, _IC2IE, _IC2IP, _IC3IF, _IC3IE, _IC3IP;
+volatile unsigned int _IC4IF, _IC4IE, _IC4IP, _IC5IF, _IC5IE, _IC5IP, _IC6IF, _IC6IE, _IC6IP;
+volatile unsigned int _U1RXIP, _U2RXIF;
+
+void _MI2C1Interrupt(void);
+
+unsigned long host_time_us = 0;
+unsigned long host_spi_bytes = 0;
+unsigned long host_i2c_bytes = 0;
+
+static volatile PORTFBITS portf;
+static volatile PORTGBITS portg;
+static volatile SPI2STATBITS spi2stat;
+static volatile unsigned int spi2buf;
+static unsigned int spi2buf_received;   //!< what the module put into spi2buf
+static int spi2buf_accesses;            //!< since then
+static volatile I2C1CONBITS i2c1con;
+static volatile I2C1STATBITS i2c1stat;
+static unsigned int i2crcv;
+
+//! A SPI bus as the device sees it.
+struct Bus
+{
+	const struct HostSpiSlave *slave;
+	int cs, sck;                    //!< levels at the previous sync
+	int bit;
+	unsigned char in, out;          //!< out: shifted out during the current byte
+};
+
+static struct Bus flash_bus = { &at45db_spi, 1, 0, 0, 0, 0xFF };
+static struct Bus rg9_bus = { &mpu6000_model_spi, 1, 0, 0, 0, 0xFF };
+
+//! The I2C1 bus, the device on it and its state between a start and a stop.
+static const struct HostI2cSlave *i2c_slave = &bmp085_model_i2c;
+static int i2c_expect_address;
+static int i2c_addressed;
+static int i2c_in_interrupt;
+
+
+/*!
+ *   A byte was received by the device: returns the one it shifted out.
+ */
+static unsigned char bus_exchange(struct Bus *b, unsigned char in)
+{
+	unsigned char sent = b->out;
+
+	b->out = b->slave->byte(in);
+	host_spi_bytes++;
+	return sent;
+}
+
+
+/*!
+ *   The pins changed by at most one write since the last call.
+ *   @return the level of the data out pin of the device
+ */
+static int bus_sync(struct Bus *b, int cs, int sck, int mosi, int miso)
+{
+	if (cs != b->cs)
+	{
+		b->cs = cs;
+		if (cs)
+			b->slave->deselect();
+		else
+		{
+			b->slave->select();
+			b->bit = 0;
+			b->out = 0xFF;
+			miso = 1;
+		}
+	}
+	else if (! cs && sck != b->sck)
+	{
+		if (! sck)
+			miso = (b->out >> (7 - b->bit)) & 1;
+		else
+		{
+			b->in = (unsigned char)((b->in << 1) | mosi);
+			if (++b->bit == 8)
+			{
+				bus_exchange(b, b->in);
+				b->bit = 0;
+			}
+		}
+	}
+	b->sck = sck;
+	return miso;
+}
+
+
+void host_sfr_sync()
+{
+	portf.RF8 = bus_sync(&flash_bus, portf.RF0, portf.RF6, portf.RF7, portf.RF8);
+	portg.RG8 = bus_sync(&rg9_bus, portg.RG9, portg.RG6, portg.RG7, portg.RG8);
+	host_i2c_sync();
+	host_uart_sync();
+}
+
+
+/*!
+ *   The device on chip select RG9: the MPU6000 (bit banged) or the SCP1000
+ *   (SPI2) of the older boards.
+ */
+void host_sfr_set_rg9_slave(const struct HostSpiSlave *slave)
+{
+	rg9_bus.slave = slave;
+}
+
+
+volatile PORTFBITS *host_portf()
+{
+	host_sfr_sync();
+	return &portf;
+}
+
+
+volatile PORTGBITS *host_portg()
+{
+	host_sfr_sync();
+	return &portg;
+}
+
+
+/*!
+ *   The SPI2 module: a byte written into SPI2BUF is exchanged with the
+ *   device whose chip select is low when the driver polls the status.
+ *   SPI2BUF reads like the hardware, so a write of the byte just received
+ *   can't be told from a read by its value. The drivers read the result of
+ *   every transfer before they write the next byte though: a second access
+ *   since the last exchange is a write.
+ */
+volatile SPI2STATBITS *host_spi2stat()
+{
+	host_sfr_sync();
+	if (spi2buf != spi2buf_received || spi2buf_accesses >= 2)
+	{
+		unsigned char in = (unsigned char)spi2buf;
+
+		if (! flash_bus.cs)
+			spi2buf = bus_exchange(&flash_bus, in);
+		else if (! rg9_bus.cs)
+			spi2buf = bus_exchange(&rg9_bus, in);
+		else
+			spi2buf = 0xFF;
+		spi2buf_received = spi2buf;
+		spi2buf_accesses = 0;
+		spi2stat.SPIRBF = 1;
+	}
+	spi2stat.SPITBF = 0;
+	return &spi2stat;
+}
+
+
+volatile unsigned int *host_spi2buf()
+{
+	spi2buf_accesses++;
+	return &spi2buf;
+}
+
+
+void OpenSPI2(unsigned int config1, unsigned int config2, unsigned int config3)
+{
+	(void)config1;
+	(void)config2;
+	spi2stat.SPIEN = (config3 & SPI_ENABLE) != 0;
+}
+
+
+/*!
+ *   The I2C1 module. Carries out the first of the actions the driver
+ *   started, one at a time as the module does.
+ *   @return 0 when there was none
+ */
+static int i2c_action()
+{
+	if (! i2c1con.I2CEN)
+		return 0;
+
+	if (i2c1con.SEN || i2c1con.RSEN)
+	{
+		i2c1con.SEN = i2c1con.RSEN = 0;
+		i2c_expect_address = 1;
+		i2c_slave->start();
+	}
+	else if (i2c1con.PEN)
+	{
+		i2c1con.PEN = 0;
+		if (i2c_addressed)
+			i2c_slave->stop();
+		i2c_addressed = 0;
+	}
+	else if (I2CTRN != HOST_REG_EMPTY)
+	{
+		unsigned char byte = (unsigned char)I2CTRN;
+		int ack;
+
+		I2CTRN = HOST_REG_EMPTY;
+		if (i2c_expect_address)
+		{
+			i2c_expect_address = 0;
+			i2c_addressed = (byte & 0xFE) == i2c_slave->address;
+			ack = i2c_addressed;
+		}
+		else
+			ack = i2c_addressed && i2c_slave->write(byte);
+		i2c1stat.ACKSTAT = ! ack;
+		i2c1stat.TBF = i2c1stat.TRSTAT = 0;
+		host_i2c_bytes++;
+	}
+	else if (i2c1con.RCEN)
+	{
+		i2c1con.RCEN = 0;
+		i2crcv = i2c_addressed ? i2c_slave->read() : 0xFF;
+		i2c1stat.RBF = 1;
+		host_i2c_bytes++;
+	}
+	else if (i2c1con.ACKEN)
+		i2c1con.ACKEN = 0;
+	else
+		return 0;
+	return 1;
+}
+
+
+/*!
+ *   Every finished action raises the MI2C1 interrupt, whose handler starts
+ *   the next one. Not while the handler runs: it is called again when it
+ *   returns with the flag set.
+ */
+void host_i2c_sync()
+{
+	for (;;)
+	{
+		int action = i2c_action();
+
+		if (action)
+			IFS1bits.MI2C1IF = 1;
+		if (IFS1bits.MI2C1IF && IEC1bits.MI2C1IE && ! i2c_in_interrupt)
+		{
+			i2c_in_interrupt = 1;
+			_MI2C1Interrupt();
+			i2c_in_interrupt = 0;
+		}
+		else if (! action)
+			return;
+	}
+}
+
+
+volatile I2C1CONBITS *host_i2c1con()
+{
+	host_sfr_sync();
+	return &i2c1con;
+}
+
+
+volatile I2C1STATBITS *host_i2c1stat()
+{
+	host_sfr_sync();
+	return &i2c1stat;
+}
+
+
+unsigned int host_i2crcv()
+{
+	host_sfr_sync();
+	i2c1stat.RBF = 0;
+	return i2crcv;
+}
+
+
+/*!
+ *   The pulse of output compare module oc (1..8) in PWM mode on timer 2,
+ *   in us. 0 in any other mode.
+ */
+float host_oc_pulse_us(int oc)
+{
+	static volatile OC1CONBITS * const con[8] = { &OC1CONbits, &OC2CONbits, &OC3CONbits, &OC4CONbits,
+	                                              &OC5CONbits, &OC6CONbits, &OC7CONbits, &OC8CONbits };
+	static volatile unsigned int * const rs[8] = { &OC1RS, &OC2RS, &OC3RS, &OC4RS,
+	                                               &OC5RS, &OC6RS, &OC7RS, &OC8RS };
+	static const int prescaler[4] = { 1, 8, 64, 256 };
+	unsigned int ticks;
+
+	if (oc < 1 || oc > 8 || con[oc-1]->OCM != 6 || ! T2CONbits.TON)
+		return 0.0f;
+	ticks = *rs[oc-1] <= PR2 ? *rs[oc-1] : PR2 + 1;     // longer than the period: always high
+	return (float)ticks * (float)prescaler[T2CONbits.TCKPS] / (float)(FCY / 1000000L);
+}
+
+
+/*!
+ *   All pins high (chip selects released, SDA pulled up), SPI2 and I2C1
+ *   idle, the MPU6000 on RG9.
+ */
+void host_sfr_reset()
+{
+	portf.RF0 = 1;
+	portf.RF6 = portf.RF7 = 0;
+	portg.RG9 = 1;
+	portg.RG6 = portg.RG7 = 0;
+	portg.RG3 = 1;
+	flash_bus.cs = rg9_bus.cs = 1;
+	flash_bus.sck = rg9_bus.sck = 0;
+	rg9_bus.slave = &mpu6000_model_spi;
+	spi2buf = spi2buf_received = 0;
+	spi2buf_accesses = 0;
+	I2CTRN = HOST_REG_EMPTY;
+	i2c1con.SEN = i2c1con.RSEN = i2c1con.PEN = i2c1con.RCEN = i2c1con.ACKEN = 0;
+	i2c_expect_address = i2c_addressed = 0;
+	host_uart_reset();
+}
+
+
+void host_advance_us(unsigned long us)
+{
+	host_time_us += us;
+	ppm_source_advance(host_time_us);
+	pwm_source_advance(host_time_us);
+}
+
+
+void microcontroller_delay_us(unsigned long us)
+{
+	host_sfr_sync();
+	host_advance_us(us);
+}
+
+
+void microcontroller_delay_ms(unsigned long ms)
+{
+	microcontroller_delay_us(ms * 1000UL);
+}
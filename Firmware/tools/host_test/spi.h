@@ -0,0 +1,31 @@
+/*!
+ *  Host replacement of the XC16 peripheral library header of the SPI
+ *  modules: OpenSPI2() and the configuration bits dataflash.c and scp1000.c
+ *  pass to it.
+ *
+ *  @file     spi.h
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#define ENABLE_SCK_PIN      0xffff
+#define ENABLE_SDO_PIN      0xffff
+#define SPI_MODE16_OFF      0xffff
+#define SPI_SMP_OFF         0xffff
+#define SPI_CKE_OFF         0xffff
+#define SLAVE_ENABLE_OFF    0xffff
+#define MASTER_ENABLE_ON    0xffff
+#define PRI_PRESCAL_4_1     0xffff
+#define PRI_PRESCAL_64_1    0xffff
+#define SEC_PRESCAL_1_1     0xffff
+#define SEC_PRESCAL_8_1     0xffff
+#define FRAME_ENABLE_OFF    0xffff
+#define SPI_ENABLE          0xffff
+#define SPI_RX_OVFLOW_CLR   0xffbf
+
+void OpenSPI2(unsigned int config1, unsigned int config2, unsigned int config3);
+
+#endif // HOST_SPI_H
@@ -0,0 +1,157 @@
+/*!
+ *  Bytes arriving on the uarts and the bytes sent on uart 1.
+ *
+ *  Received bytes go into the 4 byte receive fifo of the uart. The receive
+ *  interrupt of the driver runs when host_uart_latency bytes arrived, and
+ *  takes them from U1RXREG or U2RXREG. A byte arriving on a full fifo is
+ *  lost and sets OERR. A byte written into U1TXREG is taken at the next
+ *  access of a modelled register: the transmitter is never full.
+ *  uart2.c is not tested, its functions only count what the gps driver sends.
+ *
+ *  @file     uart_source.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include "microcontroller/microcontroller.h"
+
+#include "host_test.h"
+
+#define SENT_MAX 4096
+
+void _U1RXInterrupt(void);
+void _U2RXInterrupt(void);
+
+int host_uart_latency = 1;
+
+struct Fifo
+{
+	unsigned char byte[HOST_UART_FIFO];
+	int head, count;
+};
+
+static struct Fifo rx[2];
+static volatile UxSTABITS u1sta;
+static char sent[SENT_MAX];
+static int sent_count;
+
+long uart2_baud = 0;
+unsigned long uart2_sent = 0;
+
+
+void host_uart_reset()
+{
+	rx[0].count = rx[1].count = 0;
+	u1sta.OERR = 0;
+	U1TXREG = HOST_REG_EMPTY;
+	sent_count = 0;
+	host_uart_latency = 1;
+}
+
+
+void host_uart_sync()
+{
+	if (U1TXREG != HOST_REG_EMPTY)
+	{
+		if (sent_count < SENT_MAX)
+			sent[sent_count++] = (char)U1TXREG;
+		U1TXREG = HOST_REG_EMPTY;
+	}
+}
+
+
+volatile UxSTABITS *host_u1sta()
+{
+	host_sfr_sync();
+	u1sta.URXDA = rx[0].count > 0;
+	u1sta.UTXBF = 0;
+	u1sta.TRMT = 1;
+	return &u1sta;
+}
+
+
+unsigned int host_uart_rxreg(int uart)
+{
+	struct Fifo *f = &rx[uart - 1];
+	unsigned char c;
+
+	if (f->count == 0)
+		return 0;
+	c = f->byte[f->head];
+	f->head = (f->head + 1) % HOST_UART_FIFO;
+	f->count--;
+	return c;
+}
+
+
+static void interrupt(int uart)
+{
+	if (uart == 1 && IEC0bits.U1RXIE)
+		_U1RXInterrupt();
+	else if (uart == 2 && IEC1bits.U2RXIE)
+		_U2RXInterrupt();
+}
+
+
+void host_uart_receive(int uart, const unsigned char *bytes, int n)
+{
+	struct Fifo *f = &rx[uart - 1];
+	int i, arrived = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		if (f->count == HOST_UART_FIFO)
+		{
+			if (uart == 1)
+				u1sta.OERR = 1;
+		}
+		else
+		{
+			f->byte[(f->head + f->count) % HOST_UART_FIFO] = bytes[i];
+			f->count++;
+		}
+		if (++arrived >= host_uart_latency)
+		{
+			interrupt(uart);
+			arrived = 0;
+		}
+	}
+	if (arrived > 0)
+		interrupt(uart);
+}
+
+
+/*!
+ *   Takes the bytes sent on uart 1 since the last call.
+ *   @return the number of bytes, at most max
+ */
+int host_uart_sent(char *buffer, int max)
+{
+	int i;
+
+	host_uart_sync();
+	for (i = 0; i < sent_count && i < max; i++)
+		buffer[i] = sent[i];
+	sent_count = 0;
+	return i;
+}
+
+
+void uart2_open(long baud)
+{
+	uart2_baud = baud;
+}
+
+
+void uart2_putc(char c)
+{
+	(void)c;
+	uart2_sent++;
+}
+
+
+void uart2_puts(char *str)
+{
+	while (*str++ != '\0')
+		uart2_sent++;
+}
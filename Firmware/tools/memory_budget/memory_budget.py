@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+"""memory_budget: static RAM and stack budget of the rtos_pilot firmware.
+
+    memory_budget.py [-n 3] [-d disassembly] rtos_pilot.map
+
+Reads the map file of the linker and reports the RAM used by every module
+(object file), with its largest variables, and how much of the 30KB of the
+dsPIC33FJ256MC710 is left.
+
+With -d, also the worst case stack of every task. The disassembly comes from
+    xc16-objdump -d rtos_pilot.elf > rtos_pilot.dis
+Every function's frame is read from its LNK and the registers it pushes, the
+call graph from its CALL and RCALL instructions. The worst path from each
+task function is compared with the stack size given to it in rtos_pilot.c,
+plus a FreeRTOS context switch and the deepest interrupt, which run on the
+stack of the interrupted task. Calls through a pointer (w registers) are not
+followed: the functions doing them are listed, their stack is a lower bound.
+The runtime high-water marks (RK command, see stack_monitor.c) complete this.
+
+Let MPLAB X write the map file with
+    Project properties > xc16-ld > Generate map file: rtos_pilot.map
+"""
+
+import argparse
+import os
+import re
+import sys
+
+RAM_BYTES = 30 * 1024
+STACK_WORD = 2                 # portSTACK_TYPE is an unsigned short
+CONTEXT_BYTES = 66             # portSAVE_CONTEXT: 31 words, plus the return address of the yield
+CALL_BYTES = 4                 # return address of a CALL/RCALL (PC is 23 bits)
+INTERRUPT_BYTES = 4            # PC and SR saved by the hardware
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PILOT = os.path.join(HERE, '..', '..', 'rtos_pilot')
+FREERTOS_CONFIG = os.path.join(HERE, '..', '..', 'lib', 'FreeRTOS', 'FreeRTOSConfig.h')
+
+
+# ---------------------------------------------------------------- map file
+
+def is_ram_section(name):
+    """.bss, .nbss, .data, .ndata, .pbss... but not .dinit (program memory)"""
+    return ('bss' in name or 'data' in name) and 'dinit' not in name and 'debug' not in name
+
+
+def parse_map(path):
+    """Returns {module: [bytes, [(bytes, symbol), ...]]} and the .heap/.stack sizes."""
+    modules = {}
+    special = {}
+    section = None
+    pending = None                 # input section split over two lines
+    last = None                    # (module, address, end) of the input section being read
+    symbols = []                   # (address, name, module, end)
+
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.rstrip()
+            m = re.match(r'^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*$', line)
+            if m:
+                section = m.group(1)
+                if section in ('.heap', '.stack'):
+                    special[section] = int(m.group(3), 16)
+                continue
+            m = re.match(r'^ (\.\S+)\s*$', line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = re.match(r'^ (\.\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+\.o\S*)$', line)
+            if m:
+                name = m.group(1) or pending
+                pending = None
+                if name is None or not is_ram_section(name):
+                    last = None
+                    continue
+                address, size = int(m.group(2), 16), int(m.group(3), 16)
+                module = os.path.basename(m.group(4)).split('(')[-1].rstrip(')')
+                module = re.sub(r'\.o$', '', module)
+                modules.setdefault(module, [0, []])[0] += size
+                last = (module, address, address + size)
+                continue
+            pending = None
+            m = re.match(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$', line)
+            if m and last:
+                address = int(m.group(1), 16)
+                if last[1] <= address < last[2]:
+                    symbols.append((address, m.group(2), last[0], last[2]))
+
+    # a variable goes up to the next one, or the end of its input section
+    symbols.sort()
+    for i, (address, name, module, end) in enumerate(symbols):
+        following = symbols[i + 1][0] if i + 1 < len(symbols) else end
+        size = min(following, end) - address
+        if size > 0:
+            modules[module][1].append((size, name.lstrip('_')))
+    return modules, special
+
+
+# ---------------------------------------------------------------- stacks
+
+def parse_disassembly(path):
+    """Returns {function: (frame bytes, [(callee, bytes pushed at the call)], indirect calls)}."""
+    functions = {}
+    current = None
+    with open(path, errors='replace') as f:
+        for line in f:
+            m = re.match(r'^[0-9a-fA-F]+ <(\w+)>:', line)
+            if m:
+                current = [0, [], 0, 0]        # frame, calls, indirect, pushed after the prologue
+                functions[m.group(1).lstrip('_')] = current
+                prologue = True
+                continue
+            if current is None or ':' not in line:
+                continue
+            text = line.split('\t')[-1].strip().lower()
+            if not text:
+                continue
+            op = text.split()[0]
+            args = text[len(op):].strip()
+            pushed = 0
+            if op == 'lnk':
+                current[0] += int(args.lstrip('#'), 0) + 2       # LNK also pushes w14
+                continue
+            if op in ('push', 'push.w'):
+                pushed = 2
+            elif op == 'push.d':
+                pushed = 4
+            elif op == 'push.s':
+                pushed = 10
+            elif op in ('mov', 'mov.w', 'mov.b') and args.endswith('[w15++]'):
+                pushed = 2
+            elif op == 'mov.d' and args.endswith('[w15++]'):
+                pushed = 4
+            if pushed:
+                if prologue:
+                    current[0] += pushed
+                else:
+                    current[3] += pushed
+                continue
+            prologue = False
+            if op in ('pop', 'pop.w') or (op.startswith('mov') and args.startswith('[--w15]')):
+                current[3] = max(0, current[3] - (4 if op.endswith('.d') else 2))
+            elif op in ('sub', 'sub.w') and 'w15' in args:
+                n = re.search(r'#(0x[0-9a-f]+|\d+)', args)
+                if n:
+                    current[3] = max(0, current[3] - int(n.group(1), 0))
+            elif op in ('call', 'rcall'):
+                target = re.search(r'<(\w+)(\+0x[0-9a-f]+)?>', args)
+                if target and not target.group(2):
+                    current[1].append((target.group(1).lstrip('_'), current[3]))
+                elif re.match(r'w\d+', args):
+                    current[2] += 1
+            elif op == 'goto' and re.match(r'w\d+', args):
+                current[2] += 1
+    return {name: (f[0], f[1], f[2]) for name, f in functions.items()}
+
+
+def worst_stack(functions, entry, cache, busy):
+    """Worst case bytes below entry, and the path. Recursion is cut and reported."""
+    if entry in cache:
+        return cache[entry]
+    if entry not in functions or entry in busy:
+        return 0, [entry + (' (recursion)' if entry in busy else '')]
+    busy.add(entry)
+    frame, calls, _ = functions[entry]
+    best, path = frame, [entry]
+    for callee, pushed in calls:
+        below, callee_path = worst_stack(functions, callee, cache, busy)
+        if frame + pushed + CALL_BYTES + below > best:
+            best, path = frame + pushed + CALL_BYTES + below, [entry] + callee_path
+    busy.discard(entry)
+    cache[entry] = (best, path)
+    return cache[entry]
+
+
+def indirect_below(functions, entry, seen):
+    """Functions doing calls through a pointer, reachable from entry."""
+    if entry in seen or entry not in functions:
+        return []
+    seen.add(entry)
+    found = [entry] if functions[entry][2] else []
+    for callee, _ in functions[entry][1]:
+        found += indirect_below(functions, callee, seen)
+    return found
+
+
+def task_stacks():
+    """(task function, name, words) from the start_task calls in rtos_pilot.c."""
+    minimal = 0
+    with open(FREERTOS_CONFIG, errors='replace') as f:
+        m = re.search(r'^#define configMINIMAL_STACK_SIZE\s+\(\s*(\d+)\s*\)', f.read(), re.M)
+        if m:
+            minimal = int(m.group(1))
+    with open(os.path.join(PILOT, 'rtos_pilot.c'), errors='replace') as f:
+        source = f.read()
+    tasks = []
+    for m in re.finditer(r'start_task\(\s*(\w+),\s*"(\w+)",\s*\(\s*configMINIMAL_STACK_SIZE \* (\d+)\s*\)', source):
+        tasks.append((m.group(1), m.group(2), minimal * int(m.group(3))))
+    return tasks, minimal
+
+
+# ---------------------------------------------------------------- report
+
+def main():
+    parser = argparse.ArgumentParser(description='Static RAM and stack budget of rtos_pilot.')
+    parser.add_argument('map', help='map file of xc16-ld')
+    parser.add_argument('-d', dest='disassembly', help='output of xc16-objdump -d')
+    parser.add_argument('-n', type=int, default=3, help='largest variables shown per module')
+    options = parser.parse_args()
+
+    modules, special = parse_map(options.map)
+    total = sum(m[0] for m in modules.values())
+    print('Static RAM per module (bytes)')
+    for module, (size, variables) in sorted(modules.items(), key=lambda m: -m[1][0]):
+        largest = ', '.join('%s %d' % (name, s) for s, name in sorted(variables, reverse=True)[:options.n])
+        print('  %-28s %6d  %s' % (module, size, largest))
+    for name, size in sorted(special.items()):
+        print('  %-28s %6d' % (name, size))
+        total += size
+    print('  %-28s %6d of %d, %d left' % ('total', total, RAM_BYTES, RAM_BYTES - total))
+
+    if not options.disassembly:
+        return 0
+
+    functions = parse_disassembly(options.disassembly)
+    cache = {}
+    interrupts = [f for f in functions if f.endswith('Interrupt')]
+    interrupt, interrupt_path = 0, []
+    for f in interrupts:
+        size, path = worst_stack(functions, f, cache, set())
+        if size > interrupt:
+            interrupt, interrupt_path = size, path
+    interrupt += INTERRUPT_BYTES if interrupts else 0
+
+    tasks, minimal = task_stacks()
+    status = 0
+    print('\nWorst case stack per task (bytes), with a context switch (%d) and the deepest interrupt (%d: %s)'
+          % (CONTEXT_BYTES, interrupt, ' > '.join(interrupt_path) or '-'))
+    for entry, name, words in tasks:
+        if entry not in functions:
+            print('  %-12s not in the disassembly' % name)
+            continue
+        size, path = worst_stack(functions, entry, cache, set())
+        need = size + CONTEXT_BYTES + interrupt
+        have = words * STACK_WORD
+        verdict = 'ok' if need <= have else 'TOO SMALL'
+        if need > have:
+            status = 1
+        suggested = (need * 5 // 4 + STACK_WORD * minimal - 1) // (STACK_WORD * minimal) if minimal else 0   # 25% margin
+        print('  %-12s %5d of %5d  %-9s suggested %d x configMINIMAL_STACK_SIZE' % (name, need, have, verdict, suggested))
+        print('               ' + ' > '.join(path))
+        pointers = indirect_below(functions, entry, set())
+        if pointers:
+            print('               calls through a pointer in: ' + ', '.join(sorted(set(pointers))))
+    return status
+
+
+if __name__ == '__main__':
+    sys.exit(main())
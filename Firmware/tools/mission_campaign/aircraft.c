@@ -0,0 +1,395 @@
+/*!
+ *  6-DOF fixed-wing model of mission_campaign.
+ *
+ *  A 1.2kg trainer of 1.4m span with ailerons, elevator, rudder and a
+ *  propeller, cruising at 12m/s. The rigid body is integrated in body axes
+ *  at 250Hz: gravity, the thrust of the propeller and the aerodynamic forces
+ *  and moments of a linear model in alpha, beta, the rates and the control
+ *  surfaces, with the lift bounded at the stall. The wind of host_environment
+ *  moves the air mass.
+ *
+ *  The controls are the pulses task_control.c sends to servo_set_us, decoded
+ *  with the AILERON mixing of control_mix_out. The sensors are sampled like
+ *  the sensor task of the MPU6000 board does: the gyroscopes and
+ *  accelerometers at 50Hz, the pressure height at 2Hz with the same vertical
+ *  speed filter, the GPS at 5Hz; aircraft_errors is added to them.
+ *
+ *  Also has the parts of the firmware task_control.c and ahrs_kalman_2x3.c
+ *  call outside of host.c: the tasks themselves don't run on the host.
+ *
+ *  @file     aircraft.c
+ *  @date     18-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS/FreeRTOS.h"
+
+#include "servo/servo.h"
+#include "ppm_in/ppm_in.h"
+#include "pid/pid.h"
+
+#include "common.h"
+#include "sensors.h"
+#include "sensor_health.h"
+#include "configuration.h"
+#include "task_control.h"
+#include "handler_navigation.h"
+#include "hil.h"
+
+#include "host.h"
+#include "aircraft.h"
+
+#define SUBSTEPS 5            //!< per control tick: the rigid body runs at 250Hz
+
+// airframe
+#define MASS 1.2f             //!< kg
+#define AREA 0.30f            //!< wing area, m^2
+#define SPAN 1.40f            //!< m
+#define CHORD 0.22f           //!< m
+#define IXX 0.045f            //!< kg m^2
+#define IYY 0.060f
+#define IZZ 0.090f
+#define RHO 1.225f            //!< air density, kg/m^3
+
+// aerodynamic derivatives, per rad; the control surfaces are positive for
+// right roll, nose up and right yaw, like the outputs of task_control.c
+#define CL0 0.25f
+#define CL_ALPHA 4.5f
+#define CL_Q 6.0f
+#define CL_ELEVATOR -0.3f
+#define CL_MAX 1.1f           //!< stall
+#define CD0 0.03f
+#define CD_K 0.061f           //!< induced drag, 1 / (pi e AR)
+#define CY_BETA -0.35f
+#define CY_RUDDER -0.15f
+#define CROLL_BETA -0.06f
+#define CROLL_P -0.45f
+#define CROLL_R 0.10f
+#define CROLL_AILERON 0.22f
+#define CM0 0.03f
+#define CM_ALPHA -0.7f
+#define CM_Q -10.0f
+#define CM_ELEVATOR 0.8f
+#define CN_BETA 0.07f
+#define CN_P -0.04f
+#define CN_R -0.12f
+#define CN_AILERON -0.01f
+#define CN_RUDDER 0.05f
+
+// propeller: the thrust drops linearly to 0 at the pitch speed
+#define THRUST_STATIC 8.0f    //!< N at full throttle
+#define PROPELLER_SPEED 22.0f //!< m/s
+
+#define US_PER_RAD 630.0f     //!< see control_wing_desired_to_servos
+
+extern float latitude_meter_per_radian;
+
+struct AircraftErrors aircraft_errors;
+
+
+/*!
+ *   Aircraft state: position and height, body velocity and rates,
+ *   attitude as a quaternion (body to NED).
+ */
+static struct
+{
+	double latitude_rad, longitude_rad;
+	float down_m;
+	float u, v, w;
+	float p, q, r;
+	float q0, q1, q2, q3;
+	float force_x, force_y, force_z;   //!< of the last step without gravity: what the accelerometers measure
+	float last_height_m;               //!< of the vertical speed filter
+	float impact_ms;                   //!< largest sinking speed at a ground contact
+} body;
+
+
+/*
+ *   The parts of the firmware task_control.c and the AHRS call.
+ */
+struct SensorHealth sensor_health;
+volatile struct HilData hil;
+
+void servo_init()
+{
+}
+
+void servo_turbopwm()
+{
+}
+
+void ppm_in_update_status_ticks_50hz()
+{
+}
+
+void hil_update_rc_status_50hz()
+{
+}
+
+void hil_send_servos()
+{
+}
+
+void uart1_puts(char *str)
+{
+	(void)str;
+}
+
+int magnetometer_heading(float sin_roll, float cos_roll, float sin_pitch, float cos_pitch, float *heading)
+{
+	(void)sin_roll; (void)cos_roll; (void)sin_pitch; (void)cos_pitch; (void)heading;
+	return 0;
+}
+
+
+/*!
+ *   The control configuration of configuration_default(), with the auto
+ *   throttle on and its cruise setting for this airframe: the motor stick
+ *   stays at idle. The aircraft flies level at the cruising speed.
+ */
+void aircraft_init(double latitude_rad, double longitude_rad, float heading_rad)
+{
+	int i;
+
+	config.control.channel_ap = 3;
+	config.control.channel_motor = 2;
+	config.control.channel_pitch = 0;
+	config.control.channel_roll = 1;
+	config.control.channel_yaw = 4;
+	config.control.manual_trim = 0;
+	config.control.servo_mix = AILERON;
+	config.control.aileron_differential = 0;
+	config.control.stabilization_with_altitude_hold = 0;
+	config.control.autopilot_auto_throttle = 1;
+	config.control.auto_throttle_cruise_pct = 35;
+	config.control.auto_throttle_min_pct = 0;
+	config.control.auto_throttle_max_pct = 100;
+	config.control.auto_throttle_p_gain = 8;
+	pid_init(&config.control.pid_heading2roll, 0.0, 0.7, 0.0, -1.0, 1.0, 0.0);
+	pid_init(&config.control.pid_pitch2elevator, 0.0, 0.7, 0.0, -1.0, 1.0, 0.0);
+	pid_init(&config.control.pid_roll2aileron, 0.0, 0.5, 0.0, -1.0, 1.0, 0.0);
+	pid_init(&config.control.pid_altitude2pitch, 0.0, 0.03, 0.0, -1.0, 1.0, 0.0);
+
+	// control_init takes the neutrals from the sticks: centered, motor at idle
+	for (i = 0; i < 8; i++)
+		ppm.channel[i] = 1500;
+	ppm.channel[config.control.channel_motor] = 1000;
+	ppm.channel[config.control.channel_ap] = 1000;    // autopilot
+
+	memset(&body, 0, sizeof(body));
+	memset(&aircraft_errors, 0, sizeof(aircraft_errors));
+	sensor_health.acc_trusted = 1;
+	body.latitude_rad = latitude_rad;
+	body.longitude_rad = longitude_rad;
+	body.u = (float)config.control.cruising_speed_ms;
+	body.q0 = cosf(heading_rad / 2.0f);
+	body.q3 = sinf(heading_rad / 2.0f);
+	sensor_data.yaw = heading_rad;
+}
+
+
+/*!
+ *   Control surface in rad and throttle 0..1 from the servo pulses, the
+ *   inverse of control_mix_out for AILERON without reversed servos.
+ */
+static void controls(float *aileron, float *elevator, float *rudder, float *throttle)
+{
+	int *neutral = config.control.servo_neutral;
+
+	*aileron = ((float)((int)servo_read_us(0) - neutral[0]) - (float)((int)servo_read_us(1) - neutral[1])) / 2.0f / US_PER_RAD;
+	*elevator = (float)((int)servo_read_us(2) - neutral[2]) / US_PER_RAD;
+	*throttle = BIND((float)((int)servo_read_us(3) - neutral[3]) / 1000.0f, 0.0f, 1.0f);
+	*rudder = -(float)((int)servo_read_us(4) - neutral[4]) / US_PER_RAD;
+}
+
+
+/*!
+ *   Integrates the rigid body over dt seconds.
+ */
+void aircraft_step(float dt)
+{
+	float aileron, elevator, rudder, throttle;
+	float h = dt / SUBSTEPS;
+	int i;
+
+	controls(&aileron, &elevator, &rudder, &throttle);
+
+	for (i = 0; i < SUBSTEPS; i++)
+	{
+		float q0 = body.q0, q1 = body.q1, q2 = body.q2, q3 = body.q3;
+		// body to NED
+		float r11 = q0*q0 + q1*q1 - q2*q2 - q3*q3, r12 = 2.0f*(q1*q2 - q0*q3), r13 = 2.0f*(q1*q3 + q0*q2);
+		float r21 = 2.0f*(q1*q2 + q0*q3), r22 = q0*q0 - q1*q1 + q2*q2 - q3*q3, r23 = 2.0f*(q2*q3 - q0*q1);
+		float r31 = 2.0f*(q1*q3 - q0*q2), r32 = 2.0f*(q2*q3 + q0*q1), r33 = q0*q0 - q1*q1 - q2*q2 + q3*q3;
+		float wind_n = host_environment.wind_north_ms, wind_e = host_environment.wind_east_ms;
+		float ua, va, wa, airspeed, alpha, beta, qbar, cl, cd, thrust, half_span, half_chord, n;
+		float roll_moment, pitch_moment, yaw_moment, v_north, v_east, v_down;
+
+		// air relative velocity in body axes
+		ua = body.u - (r11*wind_n + r21*wind_e);
+		va = body.v - (r12*wind_n + r22*wind_e);
+		wa = body.w - (r13*wind_n + r23*wind_e);
+		airspeed = MAX(sqrtf(ua*ua + va*va + wa*wa), 1.0f);
+		alpha = atan2f(wa, ua);
+		beta = asinf(BIND(va / airspeed, -1.0f, 1.0f));
+		qbar = 0.5f * RHO * airspeed * airspeed;
+		half_span = SPAN / (2.0f * airspeed);
+		half_chord = CHORD / (2.0f * airspeed);
+
+		cl = BIND(CL0 + CL_ALPHA*alpha + CL_Q*half_chord*body.q + CL_ELEVATOR*elevator, -CL_MAX, CL_MAX);
+		cd = CD0 + CD_K*cl*cl;
+		thrust = MAX(throttle * THRUST_STATIC * (1.0f - ua / PROPELLER_SPEED), 0.0f);
+
+		body.force_x = qbar*AREA*(-cd*cosf(alpha) + cl*sinf(alpha)) + thrust;
+		body.force_y = qbar*AREA*(CY_BETA*beta + CY_RUDDER*rudder);
+		body.force_z = qbar*AREA*(-cd*sinf(alpha) - cl*cosf(alpha));
+
+		roll_moment = qbar*AREA*SPAN*(CROLL_BETA*beta + CROLL_P*half_span*body.p + CROLL_R*half_span*body.r + CROLL_AILERON*aileron);
+		pitch_moment = qbar*AREA*CHORD*(CM0 + CM_ALPHA*alpha + CM_Q*half_chord*body.q + CM_ELEVATOR*elevator);
+		yaw_moment = qbar*AREA*SPAN*(CN_BETA*beta + CN_P*half_span*body.p + CN_R*half_span*body.r +
+		                             CN_AILERON*aileron + CN_RUDDER*rudder);
+
+		// NED velocity with the attitude at the start of the step
+		v_north = r11*body.u + r12*body.v + r13*body.w;
+		v_east = r21*body.u + r22*body.v + r23*body.w;
+		v_down = r31*body.u + r32*body.v + r33*body.w;
+
+		body.u += h * (body.r*body.v - body.q*body.w + body.force_x / MASS + G*r31);
+		body.v += h * (body.p*body.w - body.r*body.u + body.force_y / MASS + G*r32);
+		body.w += h * (body.q*body.u - body.p*body.v + body.force_z / MASS + G*r33);
+
+		body.p += h * (roll_moment - (IZZ - IYY)*body.q*body.r) / IXX;
+		body.q += h * (pitch_moment - (IXX - IZZ)*body.p*body.r) / IYY;
+		body.r += h * (yaw_moment - (IYY - IXX)*body.p*body.q) / IZZ;
+
+		body.q0 += h * 0.5f * (-q1*body.p - q2*body.q - q3*body.r);
+		body.q1 += h * 0.5f * ( q0*body.p + q2*body.r - q3*body.q);
+		body.q2 += h * 0.5f * ( q0*body.q - q1*body.r + q3*body.p);
+		body.q3 += h * 0.5f * ( q0*body.r + q1*body.q - q2*body.p);
+		n = 1.0f / sqrtf(body.q0*body.q0 + body.q1*body.q1 + body.q2*body.q2 + body.q3*body.q3);
+		body.q0 *= n;
+		body.q1 *= n;
+		body.q2 *= n;
+		body.q3 *= n;
+
+		body.down_m += h * v_down;
+		body.latitude_rad += h * v_north / latitude_meter_per_radian;
+		body.longitude_rad += h * v_east / (latitude_meter_per_radian * cosf((float)body.latitude_rad));
+
+		// the ground takes away the sinking speed, the accelerometers feel it
+		if (body.down_m > 0.0f)
+		{
+			body.down_m = 0.0f;
+			v_down = r31*body.u + r32*body.v + r33*body.w;
+			if (v_down > 0.0f)
+			{
+				body.impact_ms = MAX(body.impact_ms, v_down);
+				body.u -= r31 * v_down;
+				body.v -= r32 * v_down;
+				body.w -= r33 * v_down;
+				body.force_x -= MASS * r31 * v_down / h;
+				body.force_y -= MASS * r32 * v_down / h;
+				body.force_z -= MASS * r33 * v_down / h;
+			}
+		}
+	}
+}
+
+
+/*!
+ *   Gyroscopes in rad/s and accelerometers in g, into sensor_data like
+ *   read_mpu6000_sensor_data(). The accelerometers measure the forces
+ *   without gravity: -1g on z in level flight.
+ */
+void aircraft_sample_imu()
+{
+	sensor_data.p = body.p + aircraft_errors.gyro_rad_s[0];
+	sensor_data.q = body.q + aircraft_errors.gyro_rad_s[1];
+	sensor_data.r = body.r + aircraft_errors.gyro_rad_s[2];
+	sensor_data.acc_x = body.force_x / (MASS * G) + aircraft_errors.acc_g[0];
+	sensor_data.acc_y = body.force_y / (MASS * G) + aircraft_errors.acc_g[1];
+	sensor_data.acc_z = body.force_z / (MASS * G) + aircraft_errors.acc_g[2];
+}
+
+
+/*!
+ *   Pressure height and the vertical speed filter of the sensor task, every
+ *   dt seconds; the battery is read at the same rate.
+ */
+void aircraft_sample_baro(float dt)
+{
+	sensor_data.pressure_height = -body.down_m + aircraft_errors.baro_m;
+	sensor_data.vertical_speed = sensor_data.vertical_speed * 0.9f + (sensor_data.pressure_height - body.last_height_m) / dt * 0.1f;
+	body.last_height_m = sensor_data.pressure_height;
+	sensor_data.battery1_voltage_10 = (unsigned int)MAX(host_environment.battery_v * 10.0f + 0.5f, 0.0f);
+}
+
+
+/*!
+ *   A GPS fix with the errors of host_environment. Without a fix the GPS
+ *   task flies on the cruising speed.
+ */
+void aircraft_sample_gps()
+{
+	float q0 = body.q0, q1 = body.q1, q2 = body.q2, q3 = body.q3;
+	float v_north = (q0*q0 + q1*q1 - q2*q2 - q3*q3)*body.u + 2.0f*(q1*q2 - q0*q3)*body.v + 2.0f*(q1*q3 + q0*q2)*body.w;
+	float v_east = 2.0f*(q1*q2 + q0*q3)*body.u + (q0*q0 - q1*q1 + q2*q2 - q3*q3)*body.v + 2.0f*(q2*q3 - q0*q1)*body.w;
+
+	if (host_environment.gps_lost)
+	{
+		sensor_data.gps.satellites_in_view = 0;
+		sensor_data.gps.status = VOID;
+		if (navigation_data.airborne)
+			sensor_data.gps.speed_ms = config.control.cruising_speed_ms;
+		return;
+	}
+
+	sensor_data.gps.satellites_in_view = 9;
+	sensor_data.gps.status = ACTIVE;
+	sensor_data.gps.latitude_rad = body.latitude_rad + host_environment.gps_error_north_m / latitude_meter_per_radian;
+	sensor_data.gps.longitude_rad = body.longitude_rad +
+	                                host_environment.gps_error_east_m / (latitude_meter_per_radian * cosf((float)body.latitude_rad));
+	sensor_data.gps.speed_ms = sqrtf(v_north*v_north + v_east*v_east);
+	sensor_data.gps.heading_rad = atan2f(v_east, v_north);
+	if (sensor_data.gps.heading_rad < 0.0f)
+		sensor_data.gps.heading_rad += 2.0f * PI;
+	sensor_data.gps.height_m = (int)-body.down_m;
+}
+
+
+/*!
+ *   The true position, the GPS can be off or lost.
+ */
+void aircraft_position(double *latitude_rad, double *longitude_rad)
+{
+	*latitude_rad = body.latitude_rad;
+	*longitude_rad = body.longitude_rad;
+}
+
+
+/*!
+ *   The largest sinking speed (m/s) at a ground contact since the last call.
+ */
+float aircraft_ground_impact()
+{
+	float impact = body.impact_ms;
+
+	body.impact_ms = 0.0f;
+	return impact;
+}
+
+
+/*!
+ *   The true roll and pitch, to compare with the AHRS.
+ */
+void aircraft_attitude(float *roll, float *pitch)
+{
+	float q0 = body.q0, q1 = body.q1, q2 = body.q2, q3 = body.q3;
+
+	*roll = atan2f(2.0f*(q2*q3 + q0*q1), q0*q0 - q1*q1 - q2*q2 + q3*q3);
+	*pitch = -asinf(BIND(2.0f*(q1*q3 - q0*q2), -1.0f, 1.0f));
+}
@@ -0,0 +1,32 @@
+/*!
+ *  6-DOF fixed-wing model of mission_campaign: flies on the servo outputs of
+ *  task_control.c and feeds the sensors the AHRS and the navigation read.
+ *
+ *  @file     aircraft.h
+ *  @date     18-oct-2026
+ *  @since    0.6
+ */
+
+#ifndef AIRCRAFT_H
+#define AIRCRAFT_H
+
+//! Sensor errors, set by the campaign before every sample.
+struct AircraftErrors
+{
+	float gyro_rad_s[3];    //!< added to p, q and r: bias and noise
+	float acc_g[3];         //!< added to acc_x, acc_y and acc_z
+	float baro_m;           //!< added to the pressure height
+};
+
+extern struct AircraftErrors aircraft_errors;
+
+void aircraft_init(double latitude_rad, double longitude_rad, float heading_rad);
+void aircraft_step(float dt);
+void aircraft_sample_imu();
+void aircraft_sample_baro(float dt);
+void aircraft_sample_gps();
+void aircraft_position(double *latitude_rad, double *longitude_rad);
+void aircraft_attitude(float *roll, float *pitch);
+float aircraft_ground_impact();
+
+#endif // AIRCRAFT_H
@@ -0,0 +1,535 @@
+/*!
+ *  mission_campaign: flies a flightplan many times on the host, every run in
+ *  other weather, in parallel processes.
+ *
+ *  mission_campaign [-runs n] [-jobs n] [-seed s] [-t seconds] [-wind m/s]
+ *                   [-dropout percent] [-noise m] [-gyro deg/s] [-acc g] [-baro m]
+ *                   [-sag V/min] [-home latitude longitude] [-v] plan
+ *
+ *  The plan holds WN or ND lines, like for gluonscript_check. Every run
+ *  flies it for 600s (-t) from the home position (default: the first
+ *  absolute waypoint), heading north at the cruising speed. The 6-DOF
+ *  aircraft of aircraft.c flies on the servo outputs of the real control
+ *  loop, control_wing_navigate() of task_control.c at 50Hz, which flies on
+ *  the attitude of the real AHRS, ahrs_filter() of ahrs_kalman_2x3.c, fed
+ *  by the simulated gyroscopes, accelerometers and pressure height. The real
+ *  gluonscript, navigation, watcher and geofence code run above them. The
+ *  disturbances of a run only depend on seed + run, run k of -seed s is
+ *  run 0 of -seed s+k:
+ *   - wind up to -wind m/s (default 8) from a random direction, with gusts
+ *     of 20%
+ *   - GPS dropouts of 2 to 10s, with a chance of -dropout percent (default
+ *     2) every second
+ *   - GPS position noise of -noise m (default 3)
+ *   - gyroscope noise of -gyro deg/s (default 0.5) and a bias of up to as
+ *     much per axis
+ *   - accelerometer noise of -acc g (default 0.05)
+ *   - pressure height noise of -baro m (default 0.5)
+ *   - the battery drops -sag V per minute (default 0.1) from 12.6V
+ *  Every run is a process of its own, -jobs of them at a time (default: the
+ *  number of processors). Reported per run (-v) and summarized over the
+ *  campaign (default 100 runs):
+ *   - the waypoints reached
+ *   - the maximum cross-track error on the FROM_TO, FLARE_TO and GLIDE_TO
+ *     legs, of the true position
+ *   - the times the maximum range and the geofence were crossed
+ *   - the times it hit the ground sinking faster than 3m/s: a crash, the
+ *     model flies on
+ *   - the largest roll or pitch error of the AHRS, after the first 10s
+ *   - the CPU time of the run per simulated second on this host: the
+ *     gluonscript, navigation, watcher, geofence, control and AHRS code,
+ *     the aircraft and the statistics
+ *  Exits with 1 when a run crossed the maximum range or the geofence,
+ *  crashed, or didn't finish.
+ *
+ *  Build from Firmware/:
+ *    gcc -std=gnu99 -O2 -Wall -Wextra -DHOST_TASK_CONTROL -o mission_campaign -Itools/gluonscript_check \
+ *        -Ilib -Irtos_pilot tools/mission_campaign/mission_campaign.c tools/mission_campaign/aircraft.c \
+ *        tools/gluonscript_check/host.c rtos_pilot/task_control.c rtos_pilot/ahrs_kalman_2x3.c \
+ *        rtos_pilot/autotune.c rtos_pilot/gluonscript.c rtos_pilot/handler_alarms.c \
+ *        rtos_pilot/handler_flightplan_switch.c rtos_pilot/handler_geofence.c \
+ *        rtos_pilot/handler_maximum_range.c rtos_pilot/handler_navigation.c rtos_pilot/handler_trigger.c \
+ *        rtos_pilot/handler_watch.c rtos_pilot/dubins_path.c rtos_pilot/wind_estimator.c \
+ *        rtos_pilot/gain_schedule.c lib/pid/pid.c lib/matrix/matrix.c lib/quaternion/quaternion.c \
+ *        lib/fastmath/fastmath.c -lm
+ *
+ *  @file     mission_campaign.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "common.h"
+#include "sensors.h"
+#include "configuration.h"
+#include "gluonscript.h"
+#include "handler_navigation.h"
+#include "handler_watch.h"
+#include "handler_geofence.h"
+#include "handler_maximum_range.h"
+#include "task_control.h"
+#include "ahrs.h"
+
+#include "host.h"
+#include "aircraft.h"
+
+#define CONTROL_HZ 50
+#define BATTERY_FULL_V 12.6f
+#define BARO_HZ 2
+#define AHRS_SETTLE_S 10.0f
+#define CRASH_SINK_MS 3.0f
+
+void navigation_set_home();
+void control_wing_navigate(float dt, int altitude_controllable);
+
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+//! The disturbances every run draws its own from.
+struct Campaign
+{
+	unsigned long seed;
+	int runs;
+	float seconds;
+	float max_wind_ms;
+	float dropout_pct;
+	float gps_noise_m;
+	float gyro_noise_rad_s;          //!< also the largest bias
+	float acc_noise_g;
+	float baro_noise_m;
+	float battery_sag_v;             //!< per minute
+};
+
+//! What a run sends back to the parent.
+struct RunResult
+{
+	int run;
+	int waypoints_reached;
+	float max_crosstrack_error_m;
+	int range_violations;
+	int fence_violations;
+	int crashes;
+	float max_attitude_error_deg;
+	float cpu_us_per_s;
+};
+
+static struct Campaign campaign = { 1, 100, 600.0f, 8.0f, 2.0f, 3.0f, DEG2RAD(0.5f), 0.05f, 0.5f, 0.1f };
+static double home_latitude_rad = 0.0, home_longitude_rad = 0.0;
+static unsigned long random_state;
+
+
+/*!
+ *   Deterministic pseudo random numbers (LCG), returns 0..1
+ */
+static float random_uniform()
+{
+	random_state = random_state * 1103515245UL + 12345UL;
+	return (float)((random_state >> 16) & 0x7FFF) / 32767.0f;
+}
+
+/*!
+ *   Approximately normal distributed noise with zero mean and unit variance
+ */
+static float random_noise()
+{
+	return (random_uniform() + random_uniform() + random_uniform() - 1.5f) * 2.0f;
+}
+
+
+static double elapsed_us(struct timespec *start, struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e6 + (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+
+static int is_absolute(int opcode)
+{
+	return opcode == FROM_TO_ABS || opcode == FLY_TO_ABS || opcode == CIRCLE_ABS ||
+	       opcode == CIRCLE_TO_ABS || opcode == FLARE_TO_ABS || opcode == GLIDE_TO_ABS;
+}
+
+
+/*!
+ *   Reads the plan into the (host) flash, the home position is the first
+ *   absolute waypoint unless it was given.
+ */
+static int load_plan(const char *filename, int home_given)
+{
+	char buffer[256], *s, *star;
+	int n = 0, line, opcode;
+	struct GluonscriptCode code;
+	FILE *f = fopen(filename, "r");
+
+	if (f == NULL)
+	{
+		perror(filename);
+		return 0;
+	}
+
+	while (fgets(buffer, sizeof(buffer), f) != NULL)
+	{
+		s = buffer[0] == '$' ? buffer + 1 : buffer;
+		if ((star = strchr(s, '*')) != NULL)
+			*star = '\0';
+		if (strncmp(s, "WN;", 3) != 0 && strncmp(s, "ND;", 3) != 0)
+			continue;
+
+		memset(&code, 0, sizeof(code));
+		if (sscanf(s + 3, "%d;%d;%f;%f;%d;%d", &line, &opcode, &code.x, &code.y, &code.a, &code.b) != 6 ||
+		    line < 1 || line > MAX_GLUONSCRIPTCODES)
+		{
+			fprintf(stderr, "%s: can't read %s", filename, buffer);
+			continue;
+		}
+		code.opcode = (unsigned char)opcode;
+		gluonscript_set_code(line - 1, &code);
+		n++;
+	}
+	fclose(f);
+
+	gluonscript_init();
+	for (line = 0; line < gluonscript_data.lines && !home_given; line++)
+	{
+		gluonscript_get_code(line, &code);
+		if (is_absolute(code.opcode))
+		{
+			home_latitude_rad = code.x;
+			home_longitude_rad = code.y;
+			break;
+		}
+	}
+
+	printf("%s: %d lines\n", filename, gluonscript_data.lines);
+	return n > 0;
+}
+
+
+/*!
+ *   Cross-track error (in meters) of the position on the leg from the last
+ *   waypoint to the current one. Only FROM_TO, FLARE_TO and GLIDE_TO follow
+ *   a leg.
+ */
+static float crosstrack_error_m(double latitude_rad, double longitude_rad)
+{
+	struct GluonscriptCode code;
+	float leg_n, leg_e, pos_n, pos_e, leg_length;
+
+	gluonscript_get_code(gluonscript_context.current_codeline, &code);
+	if (code.opcode != FROM_TO_ABS && code.opcode != FLARE_TO_ABS && code.opcode != GLIDE_TO_ABS)
+		return 0.0f;
+
+	leg_n = (code.x - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian;
+	leg_e = (code.y - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian;
+	pos_n = (float)(latitude_rad - navigation_data.last_waypoint_latitude_rad) * latitude_meter_per_radian;
+	pos_e = (float)(longitude_rad - navigation_data.last_waypoint_longitude_rad) * longitude_meter_per_radian;
+
+	leg_length = sqrtf(leg_n*leg_n + leg_e*leg_e);
+	if (leg_length < 1.0f)
+		return 0.0f;
+	return fabsf(leg_n*pos_e - leg_e*pos_n) / leg_length;
+}
+
+
+/*!
+ *   Flies one run, in the child process.
+ */
+static void fly(int run, struct RunResult *result)
+{
+	unsigned long ticks = (unsigned long)(campaign.seconds * GLUONSCRIPT_HZ), tick, control_tick = 0;
+	float wind_speed, wind_from, wind_north, wind_east, e, roll, pitch, gyro_bias[3];
+	float last_waypoint_latitude_rad, last_waypoint_longitude_rad;
+	int dropout_ticks = 0, out_of_range = 0, out_of_fence = 0, out, i, j;
+	double latitude_rad, longitude_rad;
+	struct timespec start, end;
+
+	memset(result, 0, sizeof(*result));
+	result->run = run;
+	random_state = campaign.seed + (unsigned long)run;
+
+	wind_speed = random_uniform() * campaign.max_wind_ms;
+	wind_from = random_uniform() * 2.0f * PI;
+	wind_north = -wind_speed * cosf(wind_from);
+	wind_east = -wind_speed * sinf(wind_from);
+
+	for (j = 0; j < 3; j++)
+		gyro_bias[j] = (random_uniform() * 2.0f - 1.0f) * campaign.gyro_noise_rad_s;
+
+	host_init(home_latitude_rad, home_longitude_rad);
+	aircraft_init(home_latitude_rad, home_longitude_rad, 0.0f);
+	control_init();
+	aircraft_step(1.0f / CONTROL_HZ);
+	aircraft_sample_imu();
+	aircraft_sample_baro(1.0f / BARO_HZ);
+	aircraft_sample_gps();
+	ahrs_init();
+	navigation_init();
+	navigation_set_home();
+	last_waypoint_latitude_rad = navigation_data.last_waypoint_latitude_rad;
+	last_waypoint_longitude_rad = navigation_data.last_waypoint_longitude_rad;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	for (tick = 0; tick < ticks; tick++)
+	{
+		if (dropout_ticks > 0)
+			dropout_ticks--;
+		else if (tick % GLUONSCRIPT_HZ == 0 && random_uniform() * 100.0f < campaign.dropout_pct)
+			dropout_ticks = (int)((2.0f + random_uniform() * 8.0f) * GLUONSCRIPT_HZ);
+		host_environment.gps_lost = dropout_ticks > 0;
+		host_environment.gps_error_north_m = campaign.gps_noise_m * random_noise();
+		host_environment.gps_error_east_m = campaign.gps_noise_m * random_noise();
+		host_environment.battery_v = BATTERY_FULL_V - campaign.battery_sag_v * (float)tick / (GLUONSCRIPT_HZ * 60.0f);
+
+		// the sensor and control tasks
+		for (i = 0; i < CONTROL_HZ / GLUONSCRIPT_HZ; i++, control_tick++)
+		{
+			host_environment.wind_north_ms = wind_north * (1.0f + 0.2f * random_noise());
+			host_environment.wind_east_ms = wind_east * (1.0f + 0.2f * random_noise());
+			aircraft_step(1.0f / CONTROL_HZ);
+			if (aircraft_ground_impact() > CRASH_SINK_MS)
+				result->crashes++;
+
+			for (j = 0; j < 3; j++)
+			{
+				aircraft_errors.gyro_rad_s[j] = gyro_bias[j] + campaign.gyro_noise_rad_s * random_noise();
+				aircraft_errors.acc_g[j] = campaign.acc_noise_g * random_noise();
+			}
+			aircraft_sample_imu();
+			if (control_tick % (CONTROL_HZ / BARO_HZ) == 0)
+			{
+				aircraft_errors.baro_m = campaign.baro_noise_m * random_noise();
+				aircraft_sample_baro(1.0f / BARO_HZ);
+			}
+			ahrs_filter(1.0f / CONTROL_HZ);
+
+			watch_check();
+			geofence_check();
+			control_state.flight_mode = AUTOPILOT;
+			control_wing_navigate(1.0f / CONTROL_HZ, config.control.stabilization_with_altitude_hold);
+
+			aircraft_attitude(&roll, &pitch);
+			e = RAD2DEG(MAX(fabsf(sensor_data.roll - roll), fabsf(sensor_data.pitch - pitch)));
+			if ((float)control_tick >= AHRS_SETTLE_S * CONTROL_HZ && e > result->max_attitude_error_deg)
+				result->max_attitude_error_deg = e;
+		}
+
+		// the GPS task
+		aircraft_sample_gps();
+		gluonscript_do();
+		gluonscript_prefetch();
+
+		aircraft_position(&latitude_rad, &longitude_rad);
+		e = crosstrack_error_m(latitude_rad, longitude_rad);
+		if (e > result->max_crosstrack_error_m)
+			result->max_crosstrack_error_m = e;
+
+		// navigation moves the last waypoint when the current one is reached
+		if (last_waypoint_latitude_rad != navigation_data.last_waypoint_latitude_rad ||
+		    last_waypoint_longitude_rad != navigation_data.last_waypoint_longitude_rad)
+		{
+			result->waypoints_reached++;
+			last_waypoint_latitude_rad = navigation_data.last_waypoint_latitude_rad;
+			last_waypoint_longitude_rad = navigation_data.last_waypoint_longitude_rad;
+		}
+
+		if (maximum_range.active)
+		{
+			out = navigation_distance_between_meter(longitude_rad, navigation_data.home_longitude_rad,
+			                                        latitude_rad, navigation_data.home_latitude_rad) > maximum_range.maximum_range;
+			if (out && !out_of_range)
+				result->range_violations++;
+			out_of_range = out;
+		}
+
+		if (geofence.active)
+		{
+			out = geofence_violated(latitude_rad, longitude_rad);
+			if (out && !out_of_fence)
+				result->fence_violations++;
+			out_of_fence = out;
+		}
+	}
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	result->cpu_us_per_s = (float)(elapsed_us(&start, &end) / campaign.seconds);
+}
+
+
+static void report(struct RunResult *result, unsigned char *finished, double wall_s, int jobs, int verbose)
+{
+	int run, flown = 0, min_waypoints = 0, max_waypoints = 0, worst_crosstrack_run = -1, worst_cpu_run = -1;
+	int range_runs = 0, fence_runs = 0, crash_runs = 0, worst_attitude_run = -1;
+	double waypoints = 0.0, crosstrack = 0.0, attitude = 0.0, cpu = 0.0;
+
+	if (verbose)
+		printf("  run  waypoints  cross-track(m)  range  fence  crash  ahrs(deg)  cpu(us/s)\n");
+	for (run = 0; run < campaign.runs; run++)
+	{
+		struct RunResult *r = &result[run];
+		if (!finished[run])
+			continue;
+		if (verbose)
+			printf("%5d  %9d  %14.1f  %5d  %5d  %5d  %9.1f  %9.1f\n", run, r->waypoints_reached, r->max_crosstrack_error_m,
+			       r->range_violations, r->fence_violations, r->crashes, r->max_attitude_error_deg, r->cpu_us_per_s);
+
+		if (flown++ == 0)
+			min_waypoints = max_waypoints = r->waypoints_reached;
+		min_waypoints = MIN(min_waypoints, r->waypoints_reached);
+		max_waypoints = MAX(max_waypoints, r->waypoints_reached);
+		waypoints += r->waypoints_reached;
+		crosstrack += r->max_crosstrack_error_m;
+		attitude += r->max_attitude_error_deg;
+		cpu += r->cpu_us_per_s;
+		if (worst_crosstrack_run < 0 || r->max_crosstrack_error_m > result[worst_crosstrack_run].max_crosstrack_error_m)
+			worst_crosstrack_run = run;
+		if (worst_attitude_run < 0 || r->max_attitude_error_deg > result[worst_attitude_run].max_attitude_error_deg)
+			worst_attitude_run = run;
+		if (worst_cpu_run < 0 || r->cpu_us_per_s > result[worst_cpu_run].cpu_us_per_s)
+			worst_cpu_run = run;
+		range_runs += r->range_violations > 0;
+		fence_runs += r->fence_violations > 0;
+		crash_runs += r->crashes > 0;
+	}
+
+	printf("%d of %d runs of %.0fs in %.1fs, %d jobs\n", flown, campaign.runs, campaign.seconds, wall_s, jobs);
+	if (flown == 0)
+		return;
+	printf("waypoints reached: min %d, mean %.1f, max %d\n", min_waypoints, waypoints / flown, max_waypoints);
+	printf("max cross-track error: mean %.1fm, worst %.1fm in run %d\n", crosstrack / flown,
+	       result[worst_crosstrack_run].max_crosstrack_error_m, worst_crosstrack_run);
+	printf("max AHRS attitude error: mean %.1f deg, worst %.1f deg in run %d\n", attitude / flown,
+	       result[worst_attitude_run].max_attitude_error_deg, worst_attitude_run);
+	printf("runs over the maximum range: %d, out of the geofence: %d, crashed: %d\n", range_runs, fence_runs, crash_runs);
+	printf("cpu: mean %.1f us per simulated second, worst %.1f in run %d\n", cpu / flown,
+	       result[worst_cpu_run].cpu_us_per_s, worst_cpu_run);
+}
+
+
+int main(int argc, char *argv[])
+{
+	int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN), home_given = 0, verbose = 0;
+	int running = 0, next = 0, failed = 0, status, i, fd[2];
+	const char *plan_file = NULL;
+	pid_t pid, *child_pid;
+	int *child_run;
+	struct RunResult *result, r;
+	unsigned char *finished;
+	struct timespec start, end;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-runs") == 0 && i + 1 < argc)
+			campaign.runs = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-jobs") == 0 && i + 1 < argc)
+			jobs = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+			campaign.seed = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			campaign.seconds = atof(argv[++i]);
+		else if (strcmp(argv[i], "-wind") == 0 && i + 1 < argc)
+			campaign.max_wind_ms = atof(argv[++i]);
+		else if (strcmp(argv[i], "-dropout") == 0 && i + 1 < argc)
+			campaign.dropout_pct = atof(argv[++i]);
+		else if (strcmp(argv[i], "-noise") == 0 && i + 1 < argc)
+			campaign.gps_noise_m = atof(argv[++i]);
+		else if (strcmp(argv[i], "-gyro") == 0 && i + 1 < argc)
+			campaign.gyro_noise_rad_s = DEG2RAD(atof(argv[++i]));
+		else if (strcmp(argv[i], "-acc") == 0 && i + 1 < argc)
+			campaign.acc_noise_g = atof(argv[++i]);
+		else if (strcmp(argv[i], "-baro") == 0 && i + 1 < argc)
+			campaign.baro_noise_m = atof(argv[++i]);
+		else if (strcmp(argv[i], "-sag") == 0 && i + 1 < argc)
+			campaign.battery_sag_v = atof(argv[++i]);
+		else if (strcmp(argv[i], "-home") == 0 && i + 2 < argc)
+		{
+			home_latitude_rad = DEG2RAD(atof(argv[++i]));
+			home_longitude_rad = DEG2RAD(atof(argv[++i]));
+			home_given = 1;
+		}
+		else if (strcmp(argv[i], "-v") == 0)
+			verbose = 1;
+		else
+			plan_file = argv[i];
+	}
+	if (plan_file == NULL || campaign.runs < 1 || campaign.seconds <= 0.0f)
+	{
+		fprintf(stderr, "usage: mission_campaign [-runs n] [-jobs n] [-seed s] [-t seconds] [-wind m/s]\n"
+		                "                        [-dropout percent] [-noise m] [-gyro deg/s] [-acc g] [-baro m]\n"
+		                "                        [-sag V/min] [-home latitude longitude] [-v] plan\n");
+		return 2;
+	}
+	jobs = MAX(jobs, 1);
+
+	host_init(0.0, 0.0);
+	if (!load_plan(plan_file, home_given))
+		return 2;
+
+	result = calloc(campaign.runs, sizeof(struct RunResult));
+	finished = calloc(campaign.runs, 1);
+	child_pid = calloc(jobs, sizeof(pid_t));
+	child_run = calloc(jobs, sizeof(int));
+	if (pipe(fd) != 0)
+	{
+		perror("pipe");
+		return 2;
+	}
+
+	// a result is smaller than PIPE_BUF: the writes of the children don't mix
+	fflush(stdout);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while (next < campaign.runs || running > 0)
+	{
+		if (next < campaign.runs && running < jobs)
+		{
+			pid = fork();
+			if (pid == 0)
+			{
+				close(fd[0]);
+				if (freopen("/dev/null", "w", stdout) == NULL)    // the OSD messages
+					_exit(2);
+				fly(next, &r);
+				_exit(write(fd[1], &r, sizeof(r)) == sizeof(r) ? 0 : 2);
+			}
+			if (pid < 0)
+			{
+				perror("fork");
+				break;
+			}
+			child_pid[running] = pid;
+			child_run[running++] = next++;
+			continue;
+		}
+
+		pid = wait(&status);
+		if (pid < 0)
+			break;
+		for (i = 0; i < running && child_pid[i] != pid; i++)
+			;
+		if (i == running)
+			continue;
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && read(fd[0], &r, sizeof(r)) == sizeof(r))
+		{
+			result[r.run] = r;
+			finished[r.run] = 1;
+		}
+		else
+		{
+			printf("run %d didn't finish\n", child_run[i]);
+			failed++;
+		}
+		child_pid[i] = child_pid[--running];
+		child_run[i] = child_run[running];
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	report(result, finished, elapsed_us(&start, &end) / 1e6, jobs, verbose);
+
+	for (i = 0; i < campaign.runs; i++)
+		failed += finished[i] && (result[i].range_violations > 0 || result[i].fence_violations > 0 || result[i].crashes > 0);
+	return failed > 0;
+}
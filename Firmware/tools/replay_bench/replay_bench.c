@@ -0,0 +1,709 @@
+/*!
+ *  replay_bench: replays sensor traces through the attitude, control and
+ *  navigation kernels of the firmware on the host, against a baseline.
+ *
+ *  replay_bench [-n repeats] [-tolerance factor] [-baseline file] [-update] trace...
+ *  replay_bench -record swing|circuit file
+ *
+ *  A trace has a line per sample of the 50Hz control loop, ';' separated:
+ *    time_s;p;q;r;acc_x;acc_y;acc_z;gps_speed_ms;gps_heading_rad;satellites;
+ *    latitude_rad;longitude_rad;vertical_speed_ms;roll_rad;pitch_rad
+ *  with the rates in rad/s and the accelerations in g, like sensor_data.
+ *  The attitude at the end is the reference: the true one for the traces
+ *  written with -record, the one of the pilot for a converted flight log.
+ *  Lines starting with # are comments.
+ *
+ *  Every trace is replayed in its own process, so the static state of the
+ *  kernels starts from zero every time, through:
+ *   - ahrs_filter() of ahrs_kalman_2x3.c (or ahrs_quaternion.c when built
+ *     with -DAHRS_QUATERNION): RMS roll and pitch error in degrees after 10s
+ *   - pid_update() on the roll of the trace: maximum difference with a
+ *     textbook PID with the same gains
+ *   - navigation_heading_rad_fromto() and navigation_distance_between_meter()
+ *     from the GPS position to a point 800m away: maximum error in degrees
+ *     and meters against atan2 and the haversine formula
+ *  The time per call is the best of the repeats in RUNS processes, the
+ *  error comes from the first repeat. The heap may not grow during the replay.
+ *  A result fails when it is slower than tolerance (default 2) times the
+ *  baseline, when its error grew, or when it allocated memory. Results not
+ *  in the baseline are reported as new. -update writes the results into the
+ *  baseline file instead, and keeps the results of the kernels not run.
+ *  The times only compare on the same machine and compiler.
+ *  Exits with 1 when a result failed.
+ *
+ *  Build from Firmware/:
+ *    gcc -std=gnu99 -O2 -Wall -Wextra -o replay_bench -Itools/gluonscript_check -Ilib -Irtos_pilot \
+ *        tools/replay_bench/replay_bench.c tools/gluonscript_check/host.c rtos_pilot/gluonscript.c \
+ *        rtos_pilot/handler_alarms.c rtos_pilot/handler_flightplan_switch.c rtos_pilot/handler_geofence.c \
+ *        rtos_pilot/handler_maximum_range.c rtos_pilot/handler_navigation.c rtos_pilot/handler_trigger.c \
+ *        rtos_pilot/handler_watch.c rtos_pilot/dubins_path.c rtos_pilot/wind_estimator.c \
+ *        rtos_pilot/gain_schedule.c rtos_pilot/ahrs_kalman_2x3.c lib/pid/pid.c lib/matrix/matrix.c \
+ *        lib/quaternion/quaternion.c lib/fastmath/fastmath.c -lm
+ *  Run from Firmware/:
+ *    ./replay_bench tools/replay_bench/traces/swing.csv tools/replay_bench/traces/circuit.csv
+ *
+ *  @file     replay_bench.c
+ *  @date     17-oct-2026
+ *  @since    0.6
+ */
+
+#include <malloc.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "pid/pid.h"
+
+#include "common.h"
+#include "ahrs.h"
+#include "sensors.h"
+#include "sensor_health.h"
+#include "configuration.h"
+#include "handler_navigation.h"
+
+#include "host.h"
+
+#ifdef AHRS_QUATERNION
+	#define AHRS_NAME "ahrs_quaternion"
+#else
+	#define AHRS_NAME "ahrs_kalman_2x3"
+#endif
+
+#define CONTROL_HZ 50
+#define SETTLE_S 10.0f
+#define TARGET_DISTANCE_M 800.0
+#define EARTH_RADIUS_M 6371000.0
+#define KERNELS 4
+#define RUNS 3                    //!< processes per trace, the fastest counts
+#define MAX_RESULTS 64
+
+extern float cos_latitude;
+extern float latitude_meter_per_radian;
+extern float longitude_meter_per_radian;
+
+//! One line of a trace.
+struct Sample
+{
+	float time_s;
+	float p, q, r;
+	float acc_x, acc_y, acc_z;
+	float gps_speed_ms, gps_heading_rad;
+	int satellites;
+	double latitude_rad, longitude_rad;
+	float vertical_speed_ms;
+	float roll_rad, pitch_rad;
+};
+
+struct Result
+{
+	char kernel[24];
+	char trace[24];
+	long calls;
+	double ns_per_call;
+	double error;
+	long heap_bytes;
+};
+
+struct Trace
+{
+	const char *name;
+	struct Sample *sample;
+	int samples;
+};
+
+static volatile float sink;
+
+/*
+ *   The parts of the firmware the kernels call, outside of the gluonscript_check stubs.
+ */
+struct SensorHealth sensor_health;
+
+int magnetometer_heading(float sin_roll, float cos_roll, float sin_pitch, float cos_pitch, float *heading)
+{
+	(void)sin_roll; (void)cos_roll; (void)sin_pitch; (void)cos_pitch; (void)heading;
+	return 0;
+}
+
+
+void uart1_puts(char *str)
+{
+	fputs(str, stderr);
+}
+
+
+static double now_s()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+
+static long heap_in_use()
+{
+	return (long)mallinfo2().uordblks;
+}
+
+
+/*
+ *   Reading and recording traces.
+ */
+
+static int read_trace(const char *path, struct Trace *trace)
+{
+	FILE *f = fopen(path, "r");
+	char line[512];
+	int size = 0;
+
+	if (f == NULL)
+	{
+		perror(path);
+		return 0;
+	}
+	trace->name = strrchr(path, '/') != NULL ? strrchr(path, '/') + 1 : path;
+	trace->sample = NULL;
+	trace->samples = 0;
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		struct Sample *s;
+
+		if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+			continue;
+		if (trace->samples == size)
+		{
+			size = size ? size * 2 : 1024;
+			trace->sample = realloc(trace->sample, (size_t)size * sizeof(struct Sample));
+		}
+		s = &trace->sample[trace->samples];
+		if (sscanf(line, "%f;%f;%f;%f;%f;%f;%f;%f;%f;%d;%lf;%lf;%f;%f;%f",
+		           &s->time_s, &s->p, &s->q, &s->r, &s->acc_x, &s->acc_y, &s->acc_z,
+		           &s->gps_speed_ms, &s->gps_heading_rad, &s->satellites,
+		           &s->latitude_rad, &s->longitude_rad, &s->vertical_speed_ms,
+		           &s->roll_rad, &s->pitch_rad) != 15)
+		{
+			fprintf(stderr, "%s: line %d: 15 fields expected\n", path, trace->samples + 1);
+			fclose(f);
+			return 0;
+		}
+		trace->samples++;
+	}
+	fclose(f);
+	return trace->samples > 0;
+}
+
+
+//! Deterministic noise: the sum of 4 uniform numbers, standard deviation sd.
+static float noise(float sd)
+{
+	static unsigned long state = 12345;
+	float sum = 0.0f;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		state = (state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+		sum += (float)state / (float)0x7FFFFFFF - 0.5f;
+	}
+	return sum * sd * 1.7320508f;
+}
+
+
+/*!
+ *   Writes a 40s trace of a plane at 15m/s:
+ *    - swing: flying straight north-east, swinging in roll (+-30 deg, 8s)
+ *      and pitch (+-15 deg, 11s)
+ *    - circuit: banking up to 35 deg left and right (20s), coordinated
+ *      turns, gentle climbs and descents
+ *  The gyros have a bias of 1 and -0.5 deg/s on p and q and white noise,
+ *  the GPS updates at 5Hz.
+ */
+static int record(const char *kind, const char *path)
+{
+	const float dt = 1.0f / CONTROL_HZ, airspeed = 15.0f;
+	double latitude = DEG2RAD(50.9), longitude = DEG2RAD(4.0);
+	float heading = DEG2RAD(45.0f), gps_speed = 0.0f, gps_heading = 0.0f;
+	double gps_latitude = latitude, gps_longitude = longitude;
+	int circuit = strcmp(kind, "circuit") == 0, i;
+	FILE *f;
+
+	if (! circuit && strcmp(kind, "swing") != 0)
+	{
+		fprintf(stderr, "record: swing or circuit\n");
+		return 2;
+	}
+	f = fopen(path, "w");
+	if (f == NULL)
+	{
+		perror(path);
+		return 2;
+	}
+	fprintf(f, "# %s trace of replay_bench -record, 50Hz\n", kind);
+	fprintf(f, "# time_s;p;q;r;acc_x;acc_y;acc_z;gps_speed_ms;gps_heading_rad;satellites;"
+	           "latitude_rad;longitude_rad;vertical_speed_ms;roll_rad;pitch_rad\n");
+
+	for (i = 0; i < 40 * CONTROL_HZ; i++)
+	{
+		float t = (float)i * dt;
+		float roll, pitch, roll_dot, pitch_dot, yaw_dot, p, q, r;
+
+		if (circuit)
+		{
+			roll = DEG2RAD(35.0f) * sinf(2.0f*PI/20.0f * t);
+			roll_dot = DEG2RAD(35.0f) * 2.0f*PI/20.0f * cosf(2.0f*PI/20.0f * t);
+			pitch = DEG2RAD(5.0f) * sinf(2.0f*PI/13.0f * t);
+			pitch_dot = DEG2RAD(5.0f) * 2.0f*PI/13.0f * cosf(2.0f*PI/13.0f * t);
+			yaw_dot = G / airspeed * tanf(roll);
+		}
+		else
+		{
+			roll = DEG2RAD(30.0f) * sinf(2.0f*PI/8.0f * t);
+			roll_dot = DEG2RAD(30.0f) * 2.0f*PI/8.0f * cosf(2.0f*PI/8.0f * t);
+			pitch = DEG2RAD(15.0f) * sinf(2.0f*PI/11.0f * t);
+			pitch_dot = DEG2RAD(15.0f) * 2.0f*PI/11.0f * cosf(2.0f*PI/11.0f * t);
+			yaw_dot = 0.0f;
+		}
+
+		// inverse euler kinematics
+		p = roll_dot - yaw_dot * sinf(pitch);
+		q = pitch_dot * cosf(roll) + yaw_dot * sinf(roll) * cosf(pitch);
+		r = -pitch_dot * sinf(roll) + yaw_dot * cosf(roll) * cosf(pitch);
+
+		heading += yaw_dot * dt;
+		if (heading >= 2.0f*PI)
+			heading -= 2.0f*PI;
+		else if (heading < 0.0f)
+			heading += 2.0f*PI;
+		latitude += airspeed * cosf(pitch) * cosf(heading) * dt / latitude_meter_per_radian;
+		longitude += airspeed * cosf(pitch) * sinf(heading) * dt / (latitude_meter_per_radian * cos(latitude));
+		if (i % (CONTROL_HZ / 5) == 0)
+		{
+			gps_latitude = latitude;
+			gps_longitude = longitude;
+			gps_speed = airspeed * cosf(pitch) + noise(0.2f);
+			gps_heading = heading;
+		}
+
+		// the measurement model of ahrs_kalman_2x3.c, without vertical speed
+		fprintf(f, "%.2f;%.5f;%.5f;%.5f;%.4f;%.4f;%.4f;%.2f;%.4f;%d;%.9f;%.9f;%.2f;%.5f;%.5f\n",
+		        t, p + DEG2RAD(1.0f) + noise(DEG2RAD(0.5f)), q - DEG2RAD(0.5f) + noise(DEG2RAD(0.5f)),
+		        r + noise(DEG2RAD(0.5f)),
+		        sinf(pitch) + noise(0.02f),
+		        r * airspeed / G - cosf(pitch) * sinf(roll) + noise(0.02f),
+		        -q * airspeed / G - cosf(pitch) * cosf(roll) + noise(0.02f),
+		        gps_speed, gps_heading, 8, gps_latitude, gps_longitude,
+		        airspeed * sinf(pitch), roll, pitch);
+	}
+	fclose(f);
+	return 0;
+}
+
+
+/*
+ *   The kernels. Each one replays the whole trace per repeat and keeps the
+ *   outputs of the first one for the error.
+ */
+
+static void result_init(struct Result *result, const char *kernel, const struct Trace *trace)
+{
+	snprintf(result->kernel, sizeof(result->kernel), "%s", kernel);
+	snprintf(result->trace, sizeof(result->trace), "%s", trace->name);
+	result->calls = trace->samples;
+	result->ns_per_call = 1e99;
+	result->error = 0.0;
+	result->heap_bytes = 0;
+}
+
+
+static void result_time(struct Result *result, double start_s, long heap_before)
+{
+	double ns = (now_s() - start_s) * 1e9 / (double)result->calls;
+
+	if (ns < result->ns_per_call)
+		result->ns_per_call = ns;
+	result->heap_bytes += heap_in_use() - heap_before;
+}
+
+
+static void replay_ahrs(const struct Trace *trace, int repeats, float *out, struct Result *result)
+{
+	const float dt = 1.0f / CONTROL_HZ;
+	double sum_squared = 0.0;
+	int i, n = 0, repeat;
+
+	result_init(result, AHRS_NAME, trace);
+	for (repeat = 0; repeat < repeats; repeat++)
+	{
+		const struct Sample *s = trace->sample;
+		long heap = heap_in_use();
+		double start = now_s();
+
+		sensor_data.acc_x = s->acc_x;
+		sensor_data.acc_y = s->acc_y;
+		sensor_data.acc_z = s->acc_z;
+		sensor_data.yaw = s->gps_heading_rad;
+		ahrs_init();
+		for (i = 0; i < trace->samples; i++, s++)
+		{
+			sensor_data.p = s->p;
+			sensor_data.q = s->q;
+			sensor_data.r = s->r;
+			sensor_data.acc_x = s->acc_x;
+			sensor_data.acc_y = s->acc_y;
+			sensor_data.acc_z = s->acc_z;
+			sensor_data.gps.speed_ms = s->gps_speed_ms;
+			sensor_data.gps.heading_rad = s->gps_heading_rad;
+			sensor_data.gps.satellites_in_view = s->satellites;
+			sensor_data.vertical_speed = s->vertical_speed_ms;
+			ahrs_filter(dt);
+			out[2*i] = sensor_data.roll;
+			out[2*i + 1] = sensor_data.pitch;
+		}
+		result_time(result, start, heap);
+
+		if (repeat == 0)
+		{
+			for (i = 0; i < trace->samples; i++)
+			{
+				double roll_error = RAD2DEG(out[2*i] - trace->sample[i].roll_rad);
+				double pitch_error = RAD2DEG(out[2*i + 1] - trace->sample[i].pitch_rad);
+
+				if (trace->sample[i].time_s - trace->sample[0].time_s < SETTLE_S)
+					continue;
+				sum_squared += roll_error*roll_error + pitch_error*pitch_error;
+				n++;
+			}
+			result->error = n > 0 ? sqrt(sum_squared / (2.0 * n)) : 0.0;
+		}
+	}
+}
+
+
+static void replay_pid(const struct Trace *trace, int repeats, float *out, struct Result *result)
+{
+	const float dt = 1.0f / CONTROL_HZ;
+	double i_state = 0.0, last_position = 0.0;
+	struct pid pid;
+	int i, repeat;
+
+	result_init(result, "pid_update", trace);
+	for (repeat = 0; repeat < repeats; repeat++)
+	{
+		const struct Sample *s = trace->sample;
+		long heap = heap_in_use();
+		double start = now_s();
+
+		pid_init(&pid, 0.1f, 1.2f, 0.3f, -0.5f, 0.5f, 0.0f);
+		for (i = 0; i < trace->samples; i++, s++)
+			out[i] = pid_update(&pid, s->roll_rad, dt);
+		result_time(result, start, heap);
+	}
+
+	for (i = 0; i < trace->samples; i++)
+	{
+		double position = trace->sample[i].roll_rad;
+		double reference;
+
+		i_state = BIND(i_state + position * dt, -0.5, 0.5);
+		reference = 1.2 * position + 0.3 * i_state + 0.1 * (position - last_position) / dt;
+		last_position = position;
+		result->error = MAX(result->error, fabs(out[i] - reference));
+	}
+}
+
+
+//! The point the navigation kernels aim at: TARGET_DISTANCE_M north-east of the start.
+static void target(const struct Trace *trace, double *latitude, double *longitude)
+{
+	*latitude = trace->sample[0].latitude_rad + TARGET_DISTANCE_M * M_SQRT1_2 / latitude_meter_per_radian;
+	*longitude = trace->sample[0].longitude_rad + TARGET_DISTANCE_M * M_SQRT1_2 / longitude_meter_per_radian;
+}
+
+
+static void replay_heading(const struct Trace *trace, int repeats, float *out, struct Result *result)
+{
+	double target_latitude, target_longitude;
+	int i, repeat;
+
+	result_init(result, "navigation_heading", trace);
+	target(trace, &target_latitude, &target_longitude);
+	for (repeat = 0; repeat < repeats; repeat++)
+	{
+		const struct Sample *s = trace->sample;
+		long heap = heap_in_use();
+		double start = now_s();
+
+		for (i = 0; i < trace->samples; i++, s++)
+			out[i] = navigation_heading_rad_fromto((float)(s->longitude_rad - target_longitude),
+			                                       (float)(s->latitude_rad - target_latitude));
+		result_time(result, start, heap);
+	}
+
+	for (i = 0; i < trace->samples; i++)
+	{
+		const struct Sample *s = &trace->sample[i];
+		double bearing = atan2((target_longitude - s->longitude_rad) * cos(s->latitude_rad), target_latitude - s->latitude_rad);
+		double error = fabs(out[i] - (bearing < 0.0 ? bearing + 2.0*M_PI : bearing));
+
+		if (error > M_PI)
+			error = 2.0*M_PI - error;
+		result->error = MAX(result->error, RAD2DEG(error));
+	}
+}
+
+
+static void replay_distance(const struct Trace *trace, int repeats, float *out, struct Result *result)
+{
+	double target_latitude, target_longitude;
+	int i, repeat;
+
+	result_init(result, "navigation_distance", trace);
+	target(trace, &target_latitude, &target_longitude);
+	for (repeat = 0; repeat < repeats; repeat++)
+	{
+		const struct Sample *s = trace->sample;
+		long heap = heap_in_use();
+		double start = now_s();
+
+		for (i = 0; i < trace->samples; i++, s++)
+			out[i] = navigation_distance_between_meter((float)s->longitude_rad, (float)target_longitude,
+			                                           (float)s->latitude_rad, (float)target_latitude);
+		result_time(result, start, heap);
+	}
+
+	for (i = 0; i < trace->samples; i++)
+	{
+		const struct Sample *s = &trace->sample[i];
+		double a = sin((target_latitude - s->latitude_rad) / 2.0) * sin((target_latitude - s->latitude_rad) / 2.0) +
+		           cos(s->latitude_rad) * cos(target_latitude) *
+		           sin((target_longitude - s->longitude_rad) / 2.0) * sin((target_longitude - s->longitude_rad) / 2.0);
+
+		result->error = MAX(result->error, fabs(out[i] - 2.0 * EARTH_RADIUS_M * atan2(sqrt(a), sqrt(1.0 - a))));
+	}
+}
+
+
+/*!
+ *   Replays one trace in a child process, the results come back through a pipe.
+ *   @return the number of results, 0 when the child failed
+ */
+static int replay(const char *path, int repeats, struct Result *result)
+{
+	int fd[2], n = 0;
+	pid_t child;
+
+	if (pipe(fd) != 0)
+		return 0;
+	child = fork();
+	if (child == 0)
+	{
+		struct Trace trace;
+		struct Result r[KERNELS];
+		float *out;
+
+		close(fd[0]);
+		if (! read_trace(path, &trace))
+			_exit(1);
+		out = malloc(2 * (size_t)trace.samples * sizeof(float));
+		host_init(trace.sample[0].latitude_rad, trace.sample[0].longitude_rad);
+		memset(&sensor_health, 0, sizeof(sensor_health));
+		sensor_health.acc_trusted = 1;
+		cos_latitude = cosf((float)trace.sample[0].latitude_rad);
+		longitude_meter_per_radian = latitude_meter_per_radian * cos_latitude;
+
+		replay_ahrs(&trace, repeats, out, &r[0]);
+		replay_pid(&trace, repeats, out, &r[1]);
+		replay_heading(&trace, repeats, out, &r[2]);
+		replay_distance(&trace, repeats, out, &r[3]);
+		sink = out[0];
+		if (write(fd[1], r, sizeof(r)) != (ssize_t)sizeof(r))
+			_exit(1);
+		_exit(0);
+	}
+	close(fd[1]);
+	if (child > 0)
+	{
+		int status;
+		ssize_t bytes = read(fd[0], result, KERNELS * sizeof(struct Result));
+
+		waitpid(child, &status, 0);
+		if (bytes == (ssize_t)(KERNELS * sizeof(struct Result)) && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+			n = KERNELS;
+	}
+	close(fd[0]);
+	return n;
+}
+
+
+/*
+ *   The baseline: "kernel trace ns_per_call error" per line.
+ */
+
+static int read_baseline(const char *path, struct Result *baseline)
+{
+	FILE *f = fopen(path, "r");
+	char line[256];
+	int n = 0;
+
+	if (f == NULL)
+		return 0;
+	while (n < MAX_RESULTS && fgets(line, sizeof(line), f) != NULL)
+	{
+		struct Result *b = &baseline[n];
+
+		if (line[0] == '#')
+			continue;
+		memset(b, 0, sizeof(*b));
+		if (sscanf(line, "%23s %23s %lf %lf", b->kernel, b->trace, &b->ns_per_call, &b->error) == 4)
+			n++;
+	}
+	fclose(f);
+	return n;
+}
+
+
+static struct Result *find(struct Result *results, int n, const struct Result *r)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (strcmp(results[i].kernel, r->kernel) == 0 && strcmp(results[i].trace, r->trace) == 0)
+			return &results[i];
+	return NULL;
+}
+
+
+static int write_baseline(const char *path, struct Result *baseline, int n)
+{
+	FILE *f = fopen(path, "w");
+	int i;
+
+	if (f == NULL)
+	{
+		perror(path);
+		return 0;
+	}
+	fprintf(f, "# replay_bench baseline, written by replay_bench -update\n");
+	fprintf(f, "# kernel trace ns_per_call error\n");
+	for (i = 0; i < n; i++)
+		fprintf(f, "%s %s %.1f %.6g\n", baseline[i].kernel, baseline[i].trace, baseline[i].ns_per_call, baseline[i].error);
+	fclose(f);
+	return 1;
+}
+
+
+/*!
+ *   @return what is wrong with the result, NULL when nothing
+ */
+static const char *regression(const struct Result *r, const struct Result *b, double tolerance)
+{
+	if (r->heap_bytes > 0)
+		return "ALLOCATES";
+	if (b == NULL)
+		return NULL;
+	if (r->error > b->error * 1.001 + 1e-9)
+		return "LESS ACCURATE";
+	if (r->ns_per_call > b->ns_per_call * tolerance)
+		return "SLOWER";
+	return NULL;
+}
+
+
+static void usage()
+{
+	fprintf(stderr, "usage: replay_bench [-n repeats] [-tolerance factor] [-baseline file] [-update] trace...\n"
+	                "       replay_bench -record swing|circuit file\n");
+	exit(2);
+}
+
+
+int main(int argc, char *argv[])
+{
+	static struct Result results[MAX_RESULTS], baseline[MAX_RESULTS];
+	const char *baseline_path = "tools/replay_bench/baseline.txt";
+	double tolerance = 2.0;
+	int repeats = 1000, update = 0, failed = 0;
+	int i, n = 0, baselines;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (strcmp(argv[i], "-record") == 0 && argc == i + 3)
+			return record(argv[i + 1], argv[i + 2]);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			repeats = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+			tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "-baseline") == 0 && i + 1 < argc)
+			baseline_path = argv[++i];
+		else if (strcmp(argv[i], "-update") == 0)
+			update = 1;
+		else
+			usage();
+	}
+	if (i == argc)
+		usage();
+
+	baselines = read_baseline(baseline_path, baseline);
+	for (; i < argc; i++)
+	{
+		int got, run;
+
+		if (n + KERNELS > MAX_RESULTS)
+			break;
+		got = replay(argv[i], repeats, &results[n]);
+		for (run = 1; run < RUNS && got > 0; run++)
+		{
+			struct Result again[KERNELS];
+			int k;
+
+			got = replay(argv[i], repeats, again);
+			for (k = 0; k < got; k++)
+				results[n + k].ns_per_call = MIN(results[n + k].ns_per_call, again[k].ns_per_call);
+		}
+		if (got == 0)
+		{
+			fprintf(stderr, "%s: replay failed\n", argv[i]);
+			failed = 1;
+		}
+		n += got;
+	}
+
+	printf("%-20s %-12s %7s %10s %10s %12s %12s\n", "kernel", "trace", "calls", "ns/call", "baseline", "error", "baseline");
+	for (i = 0; i < n; i++)
+	{
+		const struct Result *r = &results[i];
+		const struct Result *b = find(baseline, baselines, r);
+		const char *problem = update ? NULL : regression(r, b, tolerance);
+
+		if (b != NULL)
+			printf("%-20s %-12s %7ld %10.1f %10.1f %12.6g %12.6g", r->kernel, r->trace, r->calls,
+			       r->ns_per_call, b->ns_per_call, r->error, b->error);
+		else
+			printf("%-20s %-12s %7ld %10.1f %10s %12.6g %12s", r->kernel, r->trace, r->calls,
+			       r->ns_per_call, "new", r->error, "new");
+		printf("%s%s\n", problem ? "  " : "", problem ? problem : "");
+		if (problem)
+			failed = 1;
+	}
+
+	if (update)
+	{
+		for (i = 0; i < n; i++)
+		{
+			struct Result *b = find(baseline, baselines, &results[i]);
+
+			if (b != NULL)
+				*b = results[i];
+			else if (baselines < MAX_RESULTS)
+				baseline[baselines++] = results[i];
+		}
+		if (! write_baseline(baseline_path, baseline, baselines))
+			return 2;
+		printf("baseline written to %s\n", baseline_path);
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""uplink: sends command lines to the pilot as acknowledged uplink frames.
+
+    uplink.py [-b 57600] [-t 0.3] [-r 10] port commands.txt
+
+commands.txt has one command per line, as typed in a terminal and without
+checksum: WN;1;..., SC, .... Empty lines and lines starting with # are
+skipped. Every command is sent as
+    $#sequence;command*checksum
+and the pilot executes them in order, each one once (see uplink_receive() in
+communication_csv.c). The sending is go-back-N: frames are sent while the
+bytes in flight fit in the free space the pilot reported in its last
+KA or KN, a KN or a timeout without any ack sends again from the oldest
+frame that wasn't acknowledged. KR starts the upload at sequence 0, RU
+reports the statistics of the pilot at the end.
+
+Needs pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+import serial
+
+SEQUENCES = 256
+START_WINDOW = 128             # bytes in flight until the pilot reported its free space
+RESERVE = 16                   # of the free space, for the lines that are not ours
+
+
+def checksum(body):
+    value = 0
+    for c in body:
+        value ^= ord(c)
+    return '%02x' % value
+
+
+def frame(sequence, command):
+    body = '#%d;%s' % (sequence % SEQUENCES, command)
+    return '$%s*%s\r\n' % (body, checksum(body))
+
+
+def parse(line):
+    """$XX;a;b*cs: the fields, None for other lines or a bad checksum"""
+    start = line.find('$')
+    if start < 0:
+        return None
+    body, _, cs = line[start + 1:].partition('*')
+    if cs[:2].lower() != checksum(body):
+        return None
+    return body.split(';')
+
+
+class Link:
+    def __init__(self, port, baudrate, verbose):
+        self.port = serial.Serial(port, baudrate, timeout=0.02)
+        self.pending = b''
+        self.verbose = verbose
+
+    def send(self, text):
+        if self.verbose:
+            print('> ' + text.strip())
+        self.port.write(text.encode('ascii'))
+
+    def lines(self):
+        """Complete lines received until now"""
+        self.pending += self.port.read(self.port.in_waiting or 1)
+        *complete, self.pending = self.pending.split(b'\n')
+        for line in complete:
+            line = line.decode('ascii', errors='replace').strip()
+            if self.verbose and line:
+                print('< ' + line)
+            yield line
+
+    def request(self, command, answer, timeout):
+        """Sends command (with checksum) until a line starting with answer comes back"""
+        for attempt in range(5):
+            self.send('$%s*%s\r\n' % (command, checksum(command)))
+            end = time.time() + timeout
+            while time.time() < end:
+                for line in self.lines():
+                    fields = parse(line)
+                    if fields and fields[0] == answer:
+                        return fields
+        return None
+
+
+def upload(link, commands, timeout, retries):
+    """Go-back-N over the commands. Returns the number of retransmissions."""
+    base = 0                   # oldest frame not acknowledged
+    next_frame = 0             # next frame to send
+    credit = START_WINDOW
+    in_flight = []             # bytes of the frames base...next_frame-1
+    last_progress = time.time()
+    attempts = 0
+    resent = 0
+
+    while base < len(commands):
+        while next_frame < len(commands):
+            text = frame(next_frame, commands[next_frame])
+            if in_flight and (sum(in_flight) + len(text) > credit - RESERVE or len(in_flight) >= SEQUENCES // 2):
+                break
+            link.send(text)
+            in_flight.append(len(text))
+            next_frame += 1
+
+        go_back = False
+        for line in link.lines():
+            fields = parse(line)
+            if not fields or fields[0] not in ('KA', 'KN') or len(fields) < 3:
+                continue
+            sequence, free = int(fields[1]), int(fields[2])
+            credit = free              # less than that: the frames in flight may be in the buffer already
+            # the sequence is modulo SEQUENCES: the frame it is, from base on
+            offset = (sequence - base) % SEQUENCES
+            if fields[0] == 'KA':
+                if offset < next_frame - base:
+                    del in_flight[:offset + 1]
+                    base += offset + 1
+                    last_progress = time.time()
+                    attempts = 0
+            else:
+                if offset < next_frame - base:
+                    del in_flight[:offset]
+                    base += offset
+                    last_progress = time.time()
+                go_back = True
+
+        if not go_back and base < next_frame and time.time() - last_progress > timeout:
+            attempts += 1
+            if attempts > retries:
+                raise RuntimeError('no answer for frame %d: %s' % (base, commands[base]))
+            go_back = True
+            last_progress = time.time()
+        if go_back and base < next_frame:
+            resent += next_frame - base
+            next_frame = base
+            in_flight = []
+    return resent
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Sends command lines to the pilot as acknowledged uplink frames.')
+    parser.add_argument('port')
+    parser.add_argument('commands', help='one command per line, without checksum')
+    parser.add_argument('-b', dest='baudrate', type=int, default=57600)
+    parser.add_argument('-t', dest='timeout', type=float, default=0.3, help='seconds without an ack before sending again')
+    parser.add_argument('-r', dest='retries', type=int, default=10, help='timeouts in a row before giving up')
+    parser.add_argument('-v', dest='verbose', action='store_true', help='print every line')
+    options = parser.parse_args()
+
+    with open(options.commands) as f:
+        commands = [line.strip() for line in f if line.strip() and not line.startswith('#')]
+    if not commands:
+        print('no commands in ' + options.commands, file=sys.stderr)
+        return 1
+
+    link = Link(options.port, options.baudrate, options.verbose)
+    if link.request('KR', 'KR', options.timeout) is None:
+        print('no answer to KR: old firmware or no connection', file=sys.stderr)
+        return 1
+
+    start = time.time()
+    try:
+        resent = upload(link, commands, options.timeout, options.retries)
+    except RuntimeError as error:
+        print(error, file=sys.stderr)
+        return 1
+    print('%d commands in %.1fs, %d frames sent again' % (len(commands), time.time() - start, resent))
+
+    stats = link.request('RU', 'KS', options.timeout)
+    if stats and len(stats) >= 5:
+        print('pilot: %s frames, %s duplicates, %s nacks, %s bytes overrun' % tuple(stats[1:5]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())